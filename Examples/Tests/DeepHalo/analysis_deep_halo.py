@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the deep-halo mode of the FDTD time loop
+(warpx.deep_halo_steps = 4), using the input file inputs_3d. With B pushed by
+half steps around the E push, each Fourier mode of the Yee scheme is a
+leapfrog oscillator: starting from B = 0, the standing wave
+Ey = E0 cos(kx x) cos(kz z) evolves exactly as E0 cos(n theta), with
+cos(theta) = 1 - (omega dt)^2 / 2 and omega the frequency given by the Yee
+stencil. Any guard cell that is not up to date when it is read breaks this
+solution, so that Ey is checked to round-off.
+"""
+import sys
+
+import numpy as np
+import yt
+
+c = 299792458.
+E0 = 1.e5
+wavelength = 8.e-6
+k = 2. * np.pi / wavelength
+max_step = 50
+
+ds = yt.load(sys.argv[1])
+ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+dx = (ds.domain_right_edge - ds.domain_left_edge).v / ds.domain_dimensions
+dt = float(ds.current_time) / max_step
+
+# Yee frequency of the mode, and phase after max_step steps
+Kx = 2. / dx[0] * np.sin(k * dx[0] / 2.)
+Kz = 2. / dx[2] * np.sin(k * dx[2] / 2.)
+omega = c * np.sqrt(Kx**2 + Kz**2)
+theta = np.arccos(1. - (omega * dt)**2 / 2.)
+
+# Ey is nodal along x and z: the plotfile averages it to the cell centers,
+# which multiplies each cosine by cos(k d/2)
+xc = ds.domain_left_edge[0].v + dx[0] * (np.arange(ds.domain_dimensions[0]) + 0.5)
+zc = ds.domain_left_edge[2].v + dx[2] * (np.arange(ds.domain_dimensions[2]) + 0.5)
+Ey_th = E0 * np.cos(max_step * theta) \
+    * np.cos(k * dx[0] / 2.) * np.cos(k * xc)[:, np.newaxis, np.newaxis] \
+    * np.cos(k * dx[2] / 2.) * np.cos(k * zc)[np.newaxis, np.newaxis, :] \
+    * np.ones(ds.domain_dimensions)
+Ey = ad['boxlib', 'Ey'].v
+
+err = np.max(np.abs(Ey - Ey_th)) / E0
+print("max relative error on Ey: ", err)
+assert err < 1.e-9
+assert np.max(np.abs(ad['boxlib', 'Ex'].v)) < 1.e-9 * E0
+assert np.max(np.abs(ad['boxlib', 'Ez'].v)) < 1.e-9 * E0
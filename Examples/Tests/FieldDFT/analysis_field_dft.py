@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the FieldDFT reduced diagnostic, using the input file
+inputs_3d, in a run restarted from the checkpoint at step 100. The spectra
+written at the checkpoints and at the end of the run must match the discrete
+Fourier transforms, over all the steps before them, of the standing wave
+E0 sin(k z) cos(omega t) at the nodes along z where Ey is sampled.
+"""
+import sys
+
+import numpy as np
+import yt
+
+sys.path.insert(0, '../../../../warpx/Examples/')
+from analysis_default_restart import check_restart
+
+c = 299792458.
+E0 = 1.e5
+wavelength = 8.e-6
+dz = 8.e-6 / 64
+k = 2. * np.pi / wavelength
+frequencies = [c / wavelength, 1.5 * c / wavelength]
+
+for step in [100, 150]:
+    ds = yt.load("diags/reducedfiles/dft_plt{:06d}".format(step))
+    ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+    dt = float(ds.current_time) / step
+    t = dt * np.arange(1, step + 1)
+    # Ey is nodal along z: the cell iz holds Ey at z = iz * dz
+    z = dz * np.arange(ds.domain_dimensions[2])
+    F_max = 0.5 * E0 * step * dt
+    for n, f in enumerate(frequencies):
+        F = ad['boxlib', 'Ey_f{}_re'.format(n)].v[0, 0, :] \
+            + 1j * ad['boxlib', 'Ey_f{}_im'.format(n)].v[0, 0, :]
+        F_th = E0 * np.sin(k * z) * np.sum(np.cos(c * k * t) * np.exp(-2j * np.pi * f * t)) * dt
+        err = np.max(np.abs(F - F_th)) / F_max
+        print("step {}, frequency {}: max relative error on the transform of Ey: {}".format(step, n, err))
+        assert err < 3.e-2
+
+# the fields after the restart are those of the original run
+check_restart(sys.argv[1])
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the integrals computed by the FieldIntegralEngine, using the
+input files inputs_3d and inputs_2d: uniform E and B fields in a periodic box
+with a mesh refinement patch. The volume and surface integrals of
+RawEFieldReduction and RawBFieldReduction, and in 3D the voltage, current and
+power of PortReduction, must be those of the continuous fields, which holds only
+if each edge and face is counted once, on the finest level that covers it, with
+the same weights for all the components.
+"""
+import sys
+
+import numpy as np
+import yt
+
+mu0 = 1.25663706212e-06
+E0 = 1.e3
+B0 = 1.e-3
+L = 16.e-6
+H0 = B0 / mu0
+
+def last_row (name):
+    return np.atleast_2d(np.loadtxt("diags/reducedfiles/" + name + ".txt"))[-1, 2:]
+
+def check (label, value, expected, scale):
+    err = abs(value - expected) / scale
+    print("{}: {} (expected {}), relative error {}".format(label, value, expected, err))
+    assert err < 1.e-10
+
+dim = yt.load(sys.argv[1]).dimensionality
+vol = L**dim
+
+Evol = last_row("Evol")
+for n, c in enumerate("xyz"):
+    check("volume integral of E" + c, Evol[n], E0 * vol, E0 * vol)
+
+# in 2D, B = (B0, B0, B0)
+Bvol = last_row("Bvol")
+if dim == 2:
+    for n, c in enumerate("xyz"):
+        check("volume integral of B" + c, Bvol[n], B0 * vol, B0 * vol)
+    sys.exit(0)
+
+check("volume integral of Bx", Bvol[0], 0., B0 * L**3)
+check("volume integral of By", Bvol[1], 0., B0 * L**3)
+check("volume integral of Bz", Bvol[2], B0 * L**3, B0 * L**3)
+
+# Ex and Ey are on the nodes of the plane z = 0, Ez is not
+Esurf = last_row("Esurf")
+check("surface integral of Ex", Esurf[0], E0 * L**2, E0 * L**2)
+check("surface integral of Ey", Esurf[1], E0 * L**2, E0 * L**2)
+check("surface integral of Ez", Esurf[2], 0., E0 * L**2)
+
+V, I, P = last_row("ports")
+check("voltage", V, E0 * 12.e-6, E0 * 12.e-6)
+check("current", I, 0., H0 * 32.e-6)
+check("power", P, E0 * H0 * L**2, E0 * H0 * L**2)
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the FieldLineRecorder reduced diagnostic, using the input
+file inputs_3d. The recorded file must hold exactly one record per step,
+in order, although the samples were only written in chunks before the
+checkpoints and at the end of the run, and the recorded Ey must match the
+standing wave E0 sin(k z) cos(omega t) at the nodes along z it is sampled at.
+"""
+import numpy as np
+
+c = 299792458.
+E0 = 1.e5
+wavelength = 8.e-6
+max_step = 150
+dz = 8.e-6 / 64
+
+with open("diags/reducedfiles/zline.bin", "rb") as f:
+    raw = f.read()
+end = raw.index(b"end_header\n") + len(b"end_header\n")
+header = raw[:end].decode().splitlines()
+fields = next(l.split()[1:] for l in header if l.startswith("fields"))
+points = [l.split() for l in header if l.startswith("point")]
+n_points = len(points)
+n_fields = len(fields)
+assert n_points == 16
+assert fields == ["Ey", "Bx"]
+
+data = np.frombuffer(raw[end:], dtype=np.float64)
+record_size = 2 + n_points * n_fields
+assert data.size % record_size == 0
+data = data.reshape(-1, record_size)
+steps = data[:, 0]
+t = data[:, 1]
+print("records: ", len(steps))
+assert np.array_equal(steps, np.arange(1, max_step + 1))
+
+# Ey is nodal along z: point n is sampled at the node of its cell, z = iz * dz
+Ey = data[:, 2:].reshape(-1, n_points, n_fields)[:, :, fields.index("Ey")]
+z = np.array([int(p[7]) * dz for p in points])
+k = 2. * np.pi / wavelength
+Ey_th = E0 * np.sin(k * z)[np.newaxis, :] * np.cos(c * k * t)[:, np.newaxis]
+err = np.max(np.abs(Ey - Ey_th)) / E0
+print("max relative error on Ey: ", err)
+assert err < 2.e-2
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the active set of boxes of the 2nd-order LLG scheme,
+using the input file inputs_3d. Without damping and without coupling, M
+precesses around the bias field on each face at the Larmor angular frequency
+|gamma| mu0 H_bias(face), and is static where there is no bias field.
+
+The bias field on the faces of each orientation follows from the deck
+geometry: the z-faces carry Hz_bias, and the x- and y-faces its average over
+the two neighbouring z-faces, i.e. half of the field on the faces next to the
+bounds of the layer. With f_full and f_half the fractions of the magnetic
+faces under the full and half field,
+<Mx> = Ms (1 - f_full (1 - cos(omega t)) - f_half (1 - cos(omega t / 2))).
+The test checks <Mx> and |<My>| against this solution, i.e. that the frozen
+boxes do not perturb the boxes that keep iterating, and checks with the
+LoadBalanceCosts diagnostic that the boxes away from the layer did fewer M
+updates per LLG solve than the boxes of the layer.
+"""
+import numpy as np
+
+Ms = 1.4e5
+gamma = 1.759e11
+mu0 = 1.25663706212e-06
+H_bias = 3.e4
+max_iter = 100
+
+# deck geometry
+n_cell = np.array([16, 16, 64])
+lo = np.array([-1.5e-6, -1.5e-6, -6.e-6])
+dx = (np.array([1.5e-6, 1.5e-6, 6.e-6]) - lo) / n_cell
+max_grid_size = 8
+magnetic = lambda x: x < -0.05e-6
+biased = lambda z: (z > -1.3e-6) * (z < -0.2e-6)
+x_nodes = lo[0] + np.arange(n_cell[0]) * dx[0]
+x_cells = lo[0] + (np.arange(n_cell[0]) + 0.5) * dx[0]
+z_nodes = lo[2] + np.arange(n_cell[2] + 1) * dx[2]
+# Hz_bias / H_bias on the z-faces, and averaged on the x- and y-faces
+h_zface = 1. * biased(z_nodes[:-1])
+h_xyface = 0.5 * (biased(z_nodes[:-1]) + biased(z_nodes[1:]))
+# magnetic faces of each orientation, and those under the full and half field
+n_xface = np.count_nonzero(magnetic(x_nodes)) * n_cell[1] * n_cell[2]
+n_yzface = np.count_nonzero(magnetic(x_cells)) * n_cell[1] * n_cell[2]
+n_faces = n_xface + 2 * n_yzface
+n_per_layer = np.array([n_xface, n_yzface, n_yzface]) // n_cell[2]
+n_full = (n_per_layer[0] + n_per_layer[1]) * np.count_nonzero(h_xyface == 1.) \
+         + n_per_layer[2] * np.count_nonzero(h_zface == 1.)
+n_half = (n_per_layer[0] + n_per_layer[1]) * np.count_nonzero(h_xyface == 0.5)
+f_full = n_full / n_faces
+f_half = n_half / n_faces
+print("fraction of the magnetic faces under the full and half bias field: ", f_full, f_half)
+assert n_full > 0 and n_half > 0
+
+mag = np.loadtxt("diags/reducedfiles/mag.txt")
+iters = np.loadtxt("diags/reducedfiles/iters.txt", ndmin=2)
+
+# columns: [1] time, [2:5] Mx_avg My_avg Mz_avg
+t = mag[:, 1]
+M = mag[:, 2:5] / Ms
+omega = gamma * mu0 * H_bias
+Mx_th = 1. - f_full * (1. - np.cos(omega * t)) - f_half * (1. - np.cos(0.5 * omega * t))
+My_th = f_full * np.sin(omega * t) + f_half * np.sin(0.5 * omega * t)
+err_x = np.max(np.abs(M[:, 0] - Mx_th))
+err_y = np.max(np.abs(np.abs(M[:, 1]) - np.abs(My_th)))
+print("max error on <Mx>/Ms: ", err_x, " on |<My>|/Ms: ", err_y)
+# one layer of faces is a fraction 128/24576 ~ 5e-3 of the magnetic faces
+assert err_x < 1.e-3
+assert err_y < 1.e-3
+assert np.max(np.abs(M[:, 2])) < 1.e-6
+
+# columns: [2] n_solves, [4] max_iterations, [5] mean_iterations
+print("max iterations: ", np.max(iters[:, 4]), " mean: ", np.mean(iters[:, 5]))
+assert np.all(iters[:, 2] > 0)
+assert np.max(iters[:, 4]) < max_iter
+
+# M updates per LLG solve of each box
+data = np.genfromtxt("diags/reducedfiles/LBC.txt", ndmin=2)
+with open("diags/reducedfiles/LBC.txt") as f:
+    header = f.readline().split()[2:]
+# number of data fields per box, from the header (the GPU ID is only written on GPU)
+n_data_fields = len(set([''.join([l for l in w if not l.isdigit()]) for w in header]))
+names = [w.split(']')[1].rsplit('_', 1)[0] for w in header[:n_data_fields]]
+data = data[-1, 2:]
+k_low = data[names.index('k_low_box')::n_data_fields]
+n_mag = data[names.index('num_magnetic_faces')::n_data_fields]
+updates = data[names.index('llg_updates_per_solve')::n_data_fields]
+# boxes of the biased layer, and magnetic boxes more than one box away from it
+# (the active set keeps the neighbours of the boxes that have not converged)
+k_layer = max_grid_size * np.unique(np.nonzero(h_xyface)[0] // max_grid_size)
+assert k_layer.size == 1
+layer = (n_mag > 0) * (k_low == k_layer[0])
+far = (n_mag > 0) * (np.abs(k_low - k_layer[0]) > max_grid_size)
+print("M updates per solve of the boxes of the layer: ", updates[layer])
+print("M updates per solve of the far boxes: ", updates[far])
+assert np.count_nonzero(layer) > 0 and np.count_nonzero(far) > 0
+assert np.max(updates[far]) < np.min(updates[layer])
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the Anderson acceleration of the 2nd-order LLG scheme,
+using the input file inputs_3d: a non-uniform M, with a strong exchange
+coupling, precesses around a bias field. The exchange field makes the
+fixed-point iterations of the scheme converge slowly.
+
+The regression test runs with macroscopic.mag_anderson_depth = 3, and the
+script runs the same input file with macroscopic.mag_anderson_depth = 0
+(plain fixed-point iterations). The test checks that the Anderson mixing
+lowers the mean number of iterations per call of the scheme, and that both
+runs converge to the same M.
+"""
+import sys
+
+import numpy as np
+import post_processing_utils
+
+max_iter = 100
+fields = ['Mx_xface', 'My_xface', 'Mz_xface']
+
+def mean_iterations():
+    # columns: [2] n_solves, [3] total_iterations, [4] max_iterations
+    iters = np.loadtxt("diags/reducedfiles/iters.txt", ndmin=2)
+    assert np.all(iters[:, 2] > 0)
+    assert np.max(iters[:, 4]) < max_iter
+    return np.sum(iters[:, 3]) / np.sum(iters[:, 2])
+
+fn = sys.argv[1]
+# read the iterations before the reference run, which writes the same reduced diagnostics
+mean_anderson = mean_iterations()
+
+ref = post_processing_utils.run_variant("inputs_3d", ["macroscopic.mag_anderson_depth=0"],
+                                        "plt", "diags/ref_plt")
+mean_picard = mean_iterations()
+
+print("mean iterations per call, Anderson depth 3: ", mean_anderson)
+print("mean iterations per call, fixed-point: ", mean_picard)
+assert mean_anderson < mean_picard
+
+# both runs converge to macroscopic.mag_tol = 1e-10
+post_processing_utils.check_fields_match(fn, ref, fields, rtol=1.e-7)
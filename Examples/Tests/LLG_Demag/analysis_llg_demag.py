@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the demagnetizing field of the 2nd-order LLG scheme,
+using the input file inputs_3d. The film is saturated along x by the bias
+field; without damping, the small tilt of M towards z precesses at the
+Kittel frequency of the uniform mode,
+    omega = |gamma| mu0 sqrt((H + (Ny - Nx) Ms) (H + (Nz - Nx) Ms)),
+with the demagnetizing factors N of the rectangular prism (Aharoni, 1998).
+Without the demagnetizing field, the frequency would be |gamma| mu0 H, more
+than twice lower. The test measures the period of <Mz> and checks that |M|
+stays equal to Ms.
+"""
+import numpy as np
+
+Ms = 1.4e5
+gamma = 1.759e11
+mu0 = 1.25663706212e-06
+H_bias = 3.e4
+max_iter = 100
+
+
+def aharoni_Nz(a, b, c):
+    """Demagnetizing factor along z of the prism of half-sizes a, b, c along x, y, z"""
+    abc = np.sqrt(a*a + b*b + c*c)
+    ab = np.sqrt(a*a + b*b)
+    bc = np.sqrt(b*b + c*c)
+    ac = np.sqrt(a*a + c*c)
+    res = ((b*b - c*c) / (2.*b*c) * np.log((abc - a) / (abc + a))
+           + (a*a - c*c) / (2.*a*c) * np.log((abc - b) / (abc + b))
+           + b / (2.*c) * np.log((ab + a) / (ab - a))
+           + a / (2.*c) * np.log((ab + b) / (ab - b))
+           + c / (2.*a) * np.log((bc - b) / (bc + b))
+           + c / (2.*b) * np.log((ac - a) / (ac + a))
+           + 2. * np.arctan(a*b / (c*abc))
+           + (a**3 + b**3 - 2.*c**3) / (3.*a*b*c)
+           + (a*a + b*b - 2.*c*c) / (3.*a*b*c) * abc
+           + c / (a*b) * (ac + bc)
+           - (ab**3 + bc**3 + ac**3) / (3.*a*b*c))
+    return res / np.pi
+
+
+a, b, c = 4.e-8, 4.e-8, 0.5e-8
+Nx = aharoni_Nz(b, c, a)
+Ny = aharoni_Nz(c, a, b)
+Nz = aharoni_Nz(a, b, c)
+print("demagnetizing factors: ", Nx, Ny, Nz)
+assert abs(Nx + Ny + Nz - 1.) < 1.e-6
+
+omega_kittel = gamma * mu0 * np.sqrt((H_bias + (Ny - Nx) * Ms) * (H_bias + (Nz - Nx) * Ms))
+
+mag = np.loadtxt("diags/reducedfiles/mag.txt")
+iters = np.loadtxt("diags/reducedfiles/iters.txt", ndmin=2)
+
+# columns: [1] time, [2:5] Mx_avg My_avg Mz_avg
+t = mag[:, 1]
+M = mag[:, 2:5] / Ms
+# period of <Mz> from its first two zero crossings, at a quarter and three quarters of the period
+crossings = np.where(np.diff(np.sign(M[:, 2])) != 0)[0]
+assert len(crossings) >= 2
+t0 = [t[n] - M[n, 2] * (t[n+1] - t[n]) / (M[n+1, 2] - M[n, 2]) for n in crossings[:2]]
+omega = np.pi / (t0[1] - t0[0])
+print("omega: ", omega, " Kittel: ", omega_kittel, " without demagnetizing field: ", gamma * mu0 * H_bias)
+assert abs(omega / omega_kittel - 1.) < 5.e-2
+
+err_norm = np.max(np.abs(np.sqrt(np.sum(M**2, axis=1)) - 1.))
+print("max error on |<M>|/Ms: ", err_norm)
+assert err_norm < 2.e-2
+
+# columns: [2] n_solves, [4] max_iterations
+print("max iterations: ", np.max(iters[:, 4]))
+assert np.all(iters[:, 2] > 0)
+assert np.max(iters[:, 4]) < max_iter
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the convergence check of the 2nd-order LLG scheme, using
+the input file inputs_3d. The max error between two iterations is reduced in
+the M-update kernels, and only checked every mag_iter_check_interval = 3
+iterations.
+
+A uniform macrospin with damping alpha starts perpendicular to the bias field
+H_bias along z. Its polar angle follows tan(theta/2) = exp(-alpha omega t)
+while it precesses at omega = |gamma| mu0 H_bias / (1 + alpha^2), so that
+M = Ms (sin(theta) cos(omega t), sin(theta) sin(omega t), cos(theta)).
+The test checks M against this solution, and against a reference run that
+checks the convergence at every iteration: the iterations that are not
+checked must not change the converged M.
+"""
+import sys
+
+import numpy as np
+import post_processing_utils
+import yt
+
+Ms = 1.4e5
+gamma = 1.759e11
+mu0 = 1.25663706212e-06
+H_bias = 3.e4
+alpha = 0.2
+fields = ['Mx_xface', 'My_xface', 'Mz_xface']
+
+fn = sys.argv[1]
+ds = yt.load(fn)
+ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+t = float(ds.current_time)
+
+omega = gamma * mu0 * H_bias / (1. + alpha**2)
+theta = 2. * np.arctan(np.exp(-alpha * omega * t))
+M_th = Ms * np.array([np.sin(theta) * np.cos(omega * t),
+                      np.sin(theta) * np.sin(omega * t),
+                      np.cos(theta)])
+for n, field in enumerate(fields):
+    M = ad['boxlib', field].v
+    # M stays uniform
+    assert np.max(np.abs(M - np.mean(M))) < 1.e-10 * Ms
+    err = abs(np.mean(M) - M_th[n]) / Ms
+    print(field + ": error on <M>/Ms: ", err)
+    assert err < 1.e-2
+
+# reference run, with the convergence checked at every iteration
+ref = post_processing_utils.run_variant("inputs_3d", ["macroscopic.mag_iter_check_interval=1"],
+                                        "plt", "diags/ref_plt")
+post_processing_utils.check_fields_match(fn, ref, fields, rtol=1.e-6)
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the 2nd-order LLG scheme built with
+USE_LLG_MIXED_PRECISION=TRUE, where M of the previous time and of the previous
+iteration are stored in single precision, using the input file inputs_3d of the
+LLG_IterCheck test: a damped macrospin, uniform over the periodic domain, that
+relaxes towards a static bias field along z.
+
+The regression test runs with Anderson mixing (macroscopic.mag_anderson_depth),
+and the script runs the same input file with the plain fixed-point iterations.
+The polar angle of M follows tan(theta/2) = exp(-alpha omega t) while it
+precesses at omega = |gamma| mu0 H_bias / (1 + alpha^2). The test checks that
+both runs agree with this solution, that |M| stays at Ms and that they agree
+with each other to a few times the tolerance of the iterations.
+"""
+import sys
+
+import numpy as np
+import post_processing_utils
+import yt
+
+Ms = 1.4e5
+gamma = 1.759e11
+mu0 = 1.25663706212e-06
+H_bias = 3.e4
+alpha = 0.2
+fields = ['Mx_xface', 'My_xface', 'Mz_xface']
+
+def error_to_theory(fn):
+    ds = yt.load(fn)
+    ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+    t = float(ds.current_time)
+    omega = gamma * mu0 * H_bias / (1. + alpha**2)
+    theta = 2. * np.arctan(np.exp(-alpha * omega * t))
+    M_th = Ms * np.array([np.sin(theta) * np.cos(omega * t),
+                          np.sin(theta) * np.sin(omega * t),
+                          np.cos(theta)])
+    M = [ad['boxlib', field].v for field in fields]
+    # M stays uniform and saturated, to the single-precision rounding of the iterations
+    for n in range(3):
+        assert np.max(np.abs(M[n] - np.mean(M[n]))) < 1.e-5 * Ms
+    assert np.max(np.abs(np.sqrt(M[0]**2 + M[1]**2 + M[2]**2) - Ms)) < 1.e-5 * Ms
+    err = max(abs(np.mean(M[n]) - M_th[n]) / Ms for n in range(3))
+    print(fn + ": error on <M>/Ms: ", err)
+    return err
+
+fn = sys.argv[1]
+err_anderson = error_to_theory(fn)
+
+fn_fp = post_processing_utils.run_variant("inputs_3d", ["macroscopic.mag_anderson_depth=0"],
+                                          "plt", "diags/fixed_point_plt")
+err_fp = error_to_theory(fn_fp)
+
+assert err_anderson < 1.e-2
+assert err_fp < 1.e-2
+post_processing_utils.check_fields_match(fn, fn_fp, fields, rtol=1.e-4, atol=1.e-4 * Ms)
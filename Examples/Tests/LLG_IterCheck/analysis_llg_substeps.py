@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the LLG substeps (warpx.mag_substeps), using the input
+file inputs_3d of the LLG_IterCheck test: a damped macrospin, uniform over the
+periodic domain, that relaxes towards a static bias field along z.
+
+The regression test runs with warpx.mag_substeps = 1, and the script runs the
+same input file with warpx.mag_substeps = 4. The polar angle of M follows
+tan(theta/2) = exp(-alpha omega t) while it precesses at
+omega = |gamma| mu0 H_bias / (1 + alpha^2). The test checks that both runs
+agree with this solution and with each other, and that the 4 substeps reduce
+the error of the 2nd-order scheme (by 16 in theory, at least by 4 here).
+"""
+import sys
+
+import numpy as np
+import post_processing_utils
+import yt
+
+Ms = 1.4e5
+gamma = 1.759e11
+mu0 = 1.25663706212e-06
+H_bias = 3.e4
+alpha = 0.2
+fields = ['Mx_xface', 'My_xface', 'Mz_xface']
+
+def error_to_theory(fn):
+    ds = yt.load(fn)
+    ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+    t = float(ds.current_time)
+    omega = gamma * mu0 * H_bias / (1. + alpha**2)
+    theta = 2. * np.arctan(np.exp(-alpha * omega * t))
+    M_th = Ms * np.array([np.sin(theta) * np.cos(omega * t),
+                          np.sin(theta) * np.sin(omega * t),
+                          np.cos(theta)])
+    err = 0.
+    for n, field in enumerate(fields):
+        M = ad['boxlib', field].v
+        # M stays uniform
+        assert np.max(np.abs(M - np.mean(M))) < 1.e-10 * Ms
+        err = max(err, abs(np.mean(M) - M_th[n]) / Ms)
+    print(fn + ": error on <M>/Ms: ", err)
+    return err
+
+fn = sys.argv[1]
+err_1 = error_to_theory(fn)
+
+fn_4 = post_processing_utils.run_variant("inputs_3d", ["warpx.mag_substeps=4"],
+                                         "plt", "diags/substeps4_plt")
+err_4 = error_to_theory(fn_4)
+
+assert err_1 < 1.e-2
+assert err_4 < 0.25 * err_1
+post_processing_utils.check_fields_match(fn, fn_4, fields, rtol=1.e-2)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the London superconductor model combined with the LLG model,
+using the input file inputs_3d. A plane wave pulse crosses a ferromagnetic film
+and is reflected by a superconducting slab. The test checks that:
+- the fields probed in vacuum and in the superconductor stay finite,
+- the pulse has reached the superconductor and is screened 5 penetration depths
+  inside it,
+- the magnitude of the average magnetization does not exceed Ms,
+- when the pulse hits the superconductor (plotfile at step 600), the London
+  current J and the field B_sc vanish outside the superconductor, J is screened
+  inside it, and B_sc = lambda^2 mu0 curl J holds on every box, including the
+  boxes that the London update skips.
+"""
+import numpy as np
+import yt
+
+Ms = 1.4e5
+
+vac = np.loadtxt("diags/reducedfiles/vac.txt")
+sc = np.loadtxt("diags/reducedfiles/sc.txt")
+mag = np.loadtxt("diags/reducedfiles/mag.txt", ndmin=2)
+
+# columns: [5:8] Ex Ey Ez, [8:11] Bx By Bz
+assert np.all(np.isfinite(vac[:, 5:11]))
+assert np.all(np.isfinite(sc[:, 5:11]))
+assert np.all(np.isfinite(mag))
+
+Ey_vac = np.max(np.abs(vac[:, 6]))
+Ey_sc = np.max(np.abs(sc[:, 6]))
+print("max |Ey| in vacuum: ", Ey_vac)
+print("max |Ey| in the superconductor: ", Ey_sc)
+# the pulse amplitude is 1e3 V/m at the source
+assert Ey_vac > 1.e2
+# exp(-5) ~ 7e-3, with margin for the standing wave in front of the slab
+assert Ey_sc < 5.e-2 * Ey_vac
+
+# columns: [2:5] Mx_avg My_avg Mz_avg
+M_avg = np.sqrt(np.sum(mag[:, 2:5]**2, axis=1))
+print("max |<M>| / Ms: ", np.max(M_avg) / Ms)
+assert np.all(M_avg <= Ms * (1. + 1.e-3))
+assert np.all(M_avg > 0.5 * Ms)
+
+# London current and B_sc, when the pulse hits the superconductor
+lambda_L = 200.e-9
+mu0 = 1.25663706212e-06
+sc_lo = 2.0e-6
+ds = yt.load("diags/plt000600")
+ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+dz = (ds.domain_right_edge[2].v - ds.domain_left_edge[2].v) / ds.domain_dimensions[2]
+z = ds.domain_left_edge[2].v + (np.arange(ds.domain_dimensions[2]) + 0.5) * dz
+# the pulse is uniform in x and y: J is along y and B_sc along x, functions of z only
+jy = ad['boxlib', 'jy'].v[0, 0, :]
+Bx_sc = ad['boxlib', 'Bx_sc'].v[0, 0, :]
+assert np.all(ad['boxlib', 'jy'].v == jy[np.newaxis, np.newaxis, :])
+jy_max = np.max(np.abs(jy))
+Bx_sc_max = np.max(np.abs(Bx_sc))
+print("max |jy|: ", jy_max, ", max |Bx_sc|: ", Bx_sc_max)
+assert jy_max > 0. and Bx_sc_max > 0.
+
+outside = z < sc_lo - dz
+assert np.all(ad['boxlib', 'jx'].v[:, :, outside] == 0.)
+assert np.all(ad['boxlib', 'jy'].v[:, :, outside] == 0.)
+assert np.all(ad['boxlib', 'jz'].v[:, :, outside] == 0.)
+assert np.all(ad['boxlib', 'Bx_sc'].v[:, :, outside] == 0.)
+assert np.all(ad['boxlib', 'By_sc'].v[:, :, outside] == 0.)
+assert np.all(ad['boxlib', 'Bz_sc'].v[:, :, outside] == 0.)
+
+# 5 penetration depths inside the superconductor
+deep = z > sc_lo + 5. * lambda_L
+print("max |jy| 5 penetration depths inside / max |jy|: ", np.max(np.abs(jy[deep])) / jy_max)
+assert np.max(np.abs(jy[deep])) < 5.e-2 * jy_max
+
+# With the Yee stencil, Bx_sc = lambda^2 mu0 dJy/dz on the x-faces, and the cell-centered
+# jy is the average of its two z-nodes: Bx_sc(k) + Bx_sc(k+1) = 2 lambda^2 mu0 (jy(k+1) - jy(k)) / dz
+lhs = Bx_sc[:-1] + Bx_sc[1:]
+rhs = 2. * lambda_L**2 * mu0 * (jy[1:] - jy[:-1]) / dz
+err = np.max(np.abs(lhs - rhs)) / Bx_sc_max
+print("relative error on B_sc = lambda^2 mu0 curl J: ", err)
+assert err < 1.e-10
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the load balancing of a run with the LLG and London models,
+using the input file inputs_3d with the heuristic costs and a load balance every
+100 steps (see the runtime parameters of the LLG_London_load_balance test).
+
+The heuristic costs of the boxes of the magnetic film are much larger than the
+others, so the boxes must move between the ranks. The script checks that:
+- the LoadBalanceCosts diagnostic counts the magnetic faces and the
+  superconducting edges, and the rank of some boxes changes,
+- the fields, the magnetization, the London current and B_sc agree with a run
+  of inputs_3d without load balancing, at step 600 and at the end.
+"""
+import glob
+import sys
+
+import numpy as np
+
+import post_processing_utils
+
+fn = sys.argv[1]
+
+# read the costs before the reference run, which writes the same reduced diagnostics
+data = np.genfromtxt("diags/reducedfiles/LBC.txt")
+with open("diags/reducedfiles/LBC.txt") as f:
+    header = f.readline().split()[2:]
+# number of data fields per box, from the header (the GPU ID is only written on GPU)
+n_data_fields = len(set([''.join([l for l in w if not l.isdigit()]) for w in header]))
+names = [w.split(']')[1].rsplit('_', 1)[0] for w in header[:n_data_fields]]
+data = data[:, 2:]
+proc = data[:, names.index('proc_box')::n_data_fields]
+n_mag = data[:, names.index('num_magnetic_faces')::n_data_fields]
+n_sc = data[:, names.index('num_superconducting_edges')::n_data_fields]
+print("ranks of the boxes: ", proc[0], " -> ", proc[-1])
+print("magnetic faces of the boxes: ", n_mag[0])
+print("superconducting edges of the boxes: ", n_sc[0])
+assert np.count_nonzero(n_mag[0]) == 2
+assert np.count_nonzero(n_sc[0]) == 3
+assert np.any(proc[-1] != proc[0])
+
+fields = ['Ex', 'Ey', 'Ez', 'Hx', 'Hy', 'Hz', 'Bx', 'By', 'Bz', 'jx', 'jy', 'jz',
+          'Bx_sc', 'By_sc', 'Bz_sc', 'Mx_xface', 'My_xface', 'Mz_xface']
+ref = post_processing_utils.run_variant("inputs_3d", [], "plt", "diags/ref_plt")
+post_processing_utils.check_fields_match(fn, ref, fields, rtol=1.e-12)
+ref_600 = sorted(glob.glob("diags/ref_plt[0-9]*"))[0]
+post_processing_utils.check_fields_match("diags/plt000600", ref_600, fields, rtol=1.e-12)
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the MagnetizationReduction reduced diagnostic, using the
+input file inputs_3d. M is uniform, saturated and aligned with the bias field
+and the anisotropy axis, so that it does not evolve. The statistics reduced in
+the M-update kernels (kern, in_kernel = 1) and in a separate pass over M
+(pass, in_kernel = 0) must then agree, and match the analytical values:
+<M> = Ms (1,0,1)/sqrt(2), no exchange energy, an anisotropy energy K V, a
+Zeeman energy -mu0 Ms H0 V and no drift of |M|. The energies are sums over the
+faces, so that they also check that each face is counted once across the boxes.
+"""
+import numpy as np
+
+Ms = 1.4e5
+H0 = 3.e4
+K = 2.e3
+mu0 = 1.25663706212e-06
+axis = np.array([0.7071067811865476, 0.0, 0.7071067811865476])
+V = (3.e-6)**3
+m = np.array([1., 0., 1.]) / np.sqrt(2.)
+
+pass_ = np.loadtxt("diags/reducedfiles/pass.txt", ndmin=2)
+kern = np.loadtxt("diags/reducedfiles/kern.txt", ndmin=2)
+
+# columns: [0] step, [1] time, [2:5] Mx_avg My_avg Mz_avg, [5] exchange, [6] anisotropy,
+# [7] zeeman energies, [8] max drift, [9] n_solves, [10] n_updates
+assert pass_.shape == kern.shape
+assert pass_.shape[0] == 4
+assert np.all(pass_[:, 0] == kern[:, 0])
+
+E_anisotropy = K * np.dot(m, axis)**2 * V
+E_zeeman = -mu0 * Ms * H0 * V
+for name, d in [("pass", pass_), ("kern", kern)]:
+    err_M = np.max(np.abs(d[:, 2:5] - Ms * m)) / Ms
+    err_anisotropy = np.max(np.abs(d[:, 6] / E_anisotropy - 1.))
+    err_zeeman = np.max(np.abs(d[:, 7] / E_zeeman - 1.))
+    print(name, ": error on <M>/Ms: ", err_M, ", on the anisotropy energy: ", err_anisotropy,
+          ", on the Zeeman energy: ", err_zeeman, ", max drift: ", np.max(d[:, 8]))
+    assert err_M < 1.e-12
+    assert np.max(np.abs(d[:, 5])) < 1.e-10 * abs(E_zeeman)
+    assert err_anisotropy < 1.e-10
+    assert err_zeeman < 1.e-10
+    assert np.max(d[:, 8]) < 1.e-12
+    assert np.all(d[:, 9] > 0)
+    assert np.all(d[:, 10] >= d[:, 9])
+
+# both modes see the same M and count the same solves and updates
+err = np.max(np.abs(kern[:, 2:8] - pass_[:, 2:8]) / np.array([Ms, Ms, Ms, abs(E_zeeman), abs(E_zeeman), abs(E_zeeman)]))
+print("max difference between the kern and pass statistics: ", err)
+assert err < 1.e-10
+assert np.all(kern[:, 9:11] == pass_[:, 9:11])
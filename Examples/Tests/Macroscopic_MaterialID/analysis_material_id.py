@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks the description of the medium by material IDs
+(macroscopic.materials and macroscopic.material_id_function), with the LLG
+model, using the input file inputs_3d.
+
+The script runs inputs_3d_dense, which gives the same medium with one parser
+function per property, and checks that the sigma, epsilon, mu, Ms and alpha
+of the plotfile, rebuilt from the material IDs, are identical to the dense
+properties, and that the E, H and M fields agree.
+"""
+import sys
+
+import numpy as np
+import yt
+
+import post_processing_utils
+
+fn = sys.argv[1]
+
+ref = post_processing_utils.run_variant("inputs_3d_dense", [], "diag1", "diags/ref_dense")
+
+# the dense functions take exactly the values of the material table
+properties = ['sigma', 'epsilon', 'mu', 'mag_Ms_xface', 'mag_Ms_yface', 'mag_Ms_zface',
+              'mag_alpha_xface', 'mag_alpha_zface']
+post_processing_utils.check_fields_match(fn, ref, properties, rtol=0.)
+
+fields = ['Ex', 'Ey', 'Ez', 'Hx', 'Hy', 'Hz',
+          'Mx_xface', 'My_xface', 'Mz_xface', 'Mx_zface', 'My_zface', 'Mz_zface']
+post_processing_utils.check_fields_match(fn, ref, fields, rtol=1.e-12)
+
+# the three materials are all in the domain: the comparison is not trivial
+ds = yt.load(fn)
+ad = ds.covering_grid(level=0, left_edge=ds.domain_left_edge, dims=ds.domain_dimensions)
+assert np.unique(ad['boxlib', 'epsilon'].v).size == 3
+assert np.unique(ad['boxlib', 'mu'].v).size == 2
+assert np.unique(ad['boxlib', 'mag_Ms_zface'].v).size == 2
@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+This script checks that the precomputed coefficients of the macroscopic E-update
+(macroscopic.precompute_coefficients = 1) are computed again when the time step
+changes. The run of the regression test, inputs_dt_change.py, performs an
+E-update at half the time step between two series of steps. The script runs it
+again without the precomputed coefficients and checks that the fields agree.
+"""
+import glob
+import os
+import sys
+
+import post_processing_utils
+
+fields = ['Ex', 'Ey', 'Ez', 'Bx', 'By', 'Bz']
+
+fn = sys.argv[1]
+
+command = "python3 inputs_dt_change.py macroscopic.precompute_coefficients=0 diag1.file_prefix=diags/ref_diag1"
+print("Running: " + command)
+assert(os.system(command) == 0)
+ref = sorted(glob.glob("diags/ref_diag1[0-9]*"))[-1]
+
+post_processing_utils.check_fields_match(fn, ref, fields, rtol=1.e-10)
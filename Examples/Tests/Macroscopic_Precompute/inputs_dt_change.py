@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+#
+# Copyright 2022 The WarpX Community
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script runs the input file inputs_3d with an E-update at half the time step
+# between two series of steps, so that the precomputed coefficients of the macroscopic
+# E-update (macroscopic.precompute_coefficients = 1) are computed again twice.
+# The additional arguments are passed to WarpX as runtime parameters.
+
+import sys
+
+from pywarpx import geometry, libwarpx
+
+# the geometry selects the WarpX library to load, the parameters are read from inputs_3d
+geometry.dims = '3'
+geometry.prob_lo = [-8.e-6, -8.e-6, -32.e-6]
+
+libwarpx.initialize(['warpx', 'inputs_3d'] + sys.argv[1:])
+
+libwarpx.evolve(20)
+dt = libwarpx.libwarpx_so.warpx_getdt(0)
+libwarpx.libwarpx_so.warpx_FillBoundaryB()
+libwarpx.libwarpx_so.warpx_EvolveE(0.5*dt)
+libwarpx.evolve(20)
@@ -6,6 +6,9 @@
 
 ## This file contains functions that are used in multiple CI analysis scripts.
 
+import glob
+import os
+
 import numpy as np
 import yt
 
@@ -128,3 +131,36 @@ def check_random_filter(fn, filtered_fn, random_fraction, dim, species_name):
     random_filter_expression = 'np.isin(ids + 0.1*cpus,' \
                                           'ids_filtered_warpx + 0.1*cpus_filtered_warpx)'
     check_particle_filter(fn, filtered_fn, random_filter_expression, dim, species_name)
+
+## This function runs the executable of the test, which the regression framework copies in the
+## test directory, on the input file inputs with the additional runtime parameters args, and
+## returns the last plotfile written by the diagnostic diag_name with the file prefix prefix.
+## It is used to compare a run against a reference run of the same input file.
+def run_variant(inputs, args, diag_name, prefix):
+    executables = glob.glob("*.ex")
+    assert(len(executables) == 1)
+    command = "./" + executables[0] + " " + inputs + " " + " ".join(args) \
+        + " " + diag_name + ".file_prefix=" + prefix
+    print("Running: " + command)
+    assert(os.system(command) == 0)
+    return sorted(glob.glob(prefix + "[0-9]*"))[-1]
+
+## This function checks that the fields of two plotfiles agree: for each field, the max difference
+## relative to the max of the field in fn1 (or atol if the field vanishes) is below rtol.
+## It returns the max relative difference over all the fields.
+def check_fields_match(fn1, fn2, fields, rtol, atol=0.):
+    ds1 = yt.load( fn1 )
+    ds2 = yt.load( fn2 )
+    assert(np.all(ds1.domain_dimensions == ds2.domain_dimensions))
+    ad1 = ds1.covering_grid(level=0, left_edge=ds1.domain_left_edge, dims=ds1.domain_dimensions)
+    ad2 = ds2.covering_grid(level=0, left_edge=ds2.domain_left_edge, dims=ds2.domain_dimensions)
+    max_err = 0.
+    for field in fields:
+        f1 = ad1['boxlib', field].v
+        f2 = ad2['boxlib', field].v
+        scale = max(np.max(np.abs(f1)), atol)
+        err = np.max(np.abs(f1 - f2)) / scale if scale > 0. else np.max(np.abs(f1 - f2))
+        print(field + ": max relative difference between " + fn1 + " and " + fn2 + ": " + str(err))
+        assert(err <= rtol)
+        max_err = max(max_err, err)
+    return max_err
@@ -671,12 +671,14 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& gri
     pml_B_fp[2] = std::make_unique<MultiFab>(amrex::convert( ba,
         WarpX::GetInstance().getBfield_fp(0,2).ixType().toIntVect() ), dm, ncompb, ngb );
 #ifdef WARPX_MAG_LLG
-    pml_H_fp[0] = std::make_unique<MultiFab>(amrex::convert( ba,
-        WarpX::GetInstance().getHfield_fp(0,0).ixType().toIntVect() ), dm, 2, ngb );
-    pml_H_fp[1] = std::make_unique<MultiFab>(amrex::convert( ba,
-        WarpX::GetInstance().getHfield_fp(0,1).ixType().toIntVect() ), dm, 2, ngb );
-    pml_H_fp[2] = std::make_unique<MultiFab>(amrex::convert( ba,
-        WarpX::GetInstance().getHfield_fp(0,2).ixType().toIntVect() ), dm, 2, ngb );
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        pml_H_fp[0] = std::make_unique<MultiFab>(amrex::convert( ba,
+            WarpX::GetInstance().getHfield_fp(0,0).ixType().toIntVect() ), dm, 2, ngb );
+        pml_H_fp[1] = std::make_unique<MultiFab>(amrex::convert( ba,
+            WarpX::GetInstance().getHfield_fp(0,1).ixType().toIntVect() ), dm, 2, ngb );
+        pml_H_fp[2] = std::make_unique<MultiFab>(amrex::convert( ba,
+            WarpX::GetInstance().getHfield_fp(0,2).ixType().toIntVect() ), dm, 2, ngb );
+    }
 #endif
 
     if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
@@ -689,28 +691,38 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& gri
         auto& warpx = WarpX::GetInstance();
         auto& macroscopic_properties = warpx.m_macroscopic_properties;
 
-        // Initialize sigma, conductivity
-        if (macroscopic_properties->m_sigma_s == "constant") {
-            pml_sigma_fp->setVal(macroscopic_properties->m_sigma);
-        } else if (macroscopic_properties->m_sigma_s == "parse_sigma_function") {
-            macroscopic_properties->InitializeMacroMultiFabUsingParser(pml_sigma_fp.get(),
-                macroscopic_properties->m_sigma_parser->compile<3>(), lev);
-        }
+        if (macroscopic_properties->use_material_id()) {
+            // Properties of the material at each point of the PML
+            macroscopic_properties->InitializeMacroMultiFabUsingMaterialId(pml_sigma_fp.get(),
+                macroscopic_properties->m_sigma_table, lev);
+            macroscopic_properties->InitializeMacroMultiFabUsingMaterialId(pml_eps_fp.get(),
+                macroscopic_properties->m_epsilon_table, lev);
+            macroscopic_properties->InitializeMacroMultiFabUsingMaterialId(pml_mu_fp.get(),
+                macroscopic_properties->m_mu_table, lev);
+        } else {
+            // Initialize sigma, conductivity
+            if (macroscopic_properties->m_sigma_s == "constant") {
+                pml_sigma_fp->setVal(macroscopic_properties->m_sigma);
+            } else if (macroscopic_properties->m_sigma_s == "parse_sigma_function") {
+                macroscopic_properties->InitializeMacroMultiFabUsingParser(pml_sigma_fp.get(),
+                    macroscopic_properties->m_sigma_parser->compile<3>(), lev);
+            }
 
-        // Initialize epsilon, permittivity
-        if (macroscopic_properties->m_epsilon_s == "constant") {
-            pml_eps_fp->setVal(macroscopic_properties->m_epsilon);
-        } else if (macroscopic_properties->m_epsilon_s == "parse_epsilon_function") {
-            macroscopic_properties->InitializeMacroMultiFabUsingParser(pml_eps_fp.get(),
-                macroscopic_properties->m_epsilon_parser->compile<3>(), lev);
-        }
+            // Initialize epsilon, permittivity
+            if (macroscopic_properties->m_epsilon_s == "constant") {
+                pml_eps_fp->setVal(macroscopic_properties->m_epsilon);
+            } else if (macroscopic_properties->m_epsilon_s == "parse_epsilon_function") {
+                macroscopic_properties->InitializeMacroMultiFabUsingParser(pml_eps_fp.get(),
+                    macroscopic_properties->m_epsilon_parser->compile<3>(), lev);
+            }
 
-        // Initialize mu, permeability
-        if (macroscopic_properties->m_mu_s == "constant") {
-            pml_mu_fp->setVal(macroscopic_properties->m_mu);
-        } else if (macroscopic_properties->m_mu_s == "parse_mu_function") {
-            macroscopic_properties->InitializeMacroMultiFabUsingParser(pml_mu_fp.get(),
-                macroscopic_properties->m_mu_parser->compile<3>(), lev);
+            // Initialize mu, permeability
+            if (macroscopic_properties->m_mu_s == "constant") {
+                pml_mu_fp->setVal(macroscopic_properties->m_mu);
+            } else if (macroscopic_properties->m_mu_s == "parse_mu_function") {
+                macroscopic_properties->InitializeMacroMultiFabUsingParser(pml_mu_fp.get(),
+                    macroscopic_properties->m_mu_parser->compile<3>(), lev);
+            }
         }
 
     }
@@ -722,9 +734,11 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& gri
     pml_B_fp[1]->setVal(0.0);
     pml_B_fp[2]->setVal(0.0);
 #ifdef WARPX_MAG_LLG
-    pml_H_fp[0]->setVal(0.0);
-    pml_H_fp[1]->setVal(0.0);
-    pml_H_fp[2]->setVal(0.0);
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        pml_H_fp[0]->setVal(0.0);
+        pml_H_fp[1]->setVal(0.0);
+        pml_H_fp[2]->setVal(0.0);
+    }
 #endif
 
     pml_j_fp[0] = std::make_unique<MultiFab>(amrex::convert( ba,
@@ -866,12 +880,14 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& gri
         pml_B_cp[2] = std::make_unique<MultiFab>(amrex::convert( cba,
             WarpX::GetInstance().getBfield_cp(1,2).ixType().toIntVect() ), cdm, ncompb, ngb );
 #ifdef WARPX_MAG_LLG
-        pml_H_cp[0] = std::make_unique<MultiFab>(amrex::convert( cba,
-            WarpX::GetInstance().getHfield_cp(1,0).ixType().toIntVect() ), cdm, 2, ngb );
-        pml_H_cp[1] = std::make_unique<MultiFab>(amrex::convert( cba,
-            WarpX::GetInstance().getHfield_cp(1,1).ixType().toIntVect() ), cdm, 2, ngb );
-        pml_H_cp[2] = std::make_unique<MultiFab>(amrex::convert( cba,
-            WarpX::GetInstance().getHfield_cp(1,2).ixType().toIntVect() ), cdm, 2, ngb );
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            pml_H_cp[0] = std::make_unique<MultiFab>(amrex::convert( cba,
+                WarpX::GetInstance().getHfield_cp(1,0).ixType().toIntVect() ), cdm, 2, ngb );
+            pml_H_cp[1] = std::make_unique<MultiFab>(amrex::convert( cba,
+                WarpX::GetInstance().getHfield_cp(1,1).ixType().toIntVect() ), cdm, 2, ngb );
+            pml_H_cp[2] = std::make_unique<MultiFab>(amrex::convert( cba,
+                WarpX::GetInstance().getHfield_cp(1,2).ixType().toIntVect() ), cdm, 2, ngb );
+        }
 #endif
 
 
@@ -919,9 +935,11 @@ PML::PML (const int lev, const BoxArray& grid_ba, const DistributionMapping& gri
         pml_B_cp[1]->setVal(0.0);
         pml_B_cp[2]->setVal(0.0);
 #ifdef WARPX_MAG_LLG
-        pml_H_cp[0]->setVal(0.0);
-        pml_H_cp[1]->setVal(0.0);
-        pml_H_cp[2]->setVal(0.0);
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            pml_H_cp[0]->setVal(0.0);
+            pml_H_cp[1]->setVal(0.0);
+            pml_H_cp[2]->setVal(0.0);
+        }
 #endif
 
         if (m_dive_cleaning)
@@ -1573,9 +1591,11 @@ PML::CheckPoint (const std::string& dir) const
         VisMF::AsyncWrite(*pml_B_fp[1], dir+"_By_fp");
         VisMF::AsyncWrite(*pml_B_fp[2], dir+"_Bz_fp");
 #ifdef WARPX_MAG_LLG
-        VisMF::AsyncWrite(*pml_H_fp[0], dir+"_Hx_fp");
-        VisMF::AsyncWrite(*pml_H_fp[1], dir+"_Hy_fp");
-        VisMF::AsyncWrite(*pml_H_fp[2], dir+"_Hz_fp");
+        if (pml_H_fp[0]) {
+            VisMF::AsyncWrite(*pml_H_fp[0], dir+"_Hx_fp");
+            VisMF::AsyncWrite(*pml_H_fp[1], dir+"_Hy_fp");
+            VisMF::AsyncWrite(*pml_H_fp[2], dir+"_Hz_fp");
+        }
 #endif
     }
 
@@ -1588,9 +1608,11 @@ PML::CheckPoint (const std::string& dir) const
         VisMF::AsyncWrite(*pml_B_cp[1], dir+"_By_cp");
         VisMF::AsyncWrite(*pml_B_cp[2], dir+"_Bz_cp");
 #ifdef WARPX_MAG_LLG
-        VisMF::AsyncWrite(*pml_H_cp[0], dir+"_Hx_cp");
-        VisMF::AsyncWrite(*pml_H_cp[1], dir+"_Hy_cp");
-        VisMF::AsyncWrite(*pml_H_cp[2], dir+"_Hz_cp");
+        if (pml_H_cp[0]) {
+            VisMF::AsyncWrite(*pml_H_cp[0], dir+"_Hx_cp");
+            VisMF::AsyncWrite(*pml_H_cp[1], dir+"_Hy_cp");
+            VisMF::AsyncWrite(*pml_H_cp[2], dir+"_Hz_cp");
+        }
 #endif
     }
 }
@@ -1607,9 +1629,11 @@ PML::Restart (const std::string& dir)
         VisMF::Read(*pml_B_fp[1], dir+"_By_fp");
         VisMF::Read(*pml_B_fp[2], dir+"_Bz_fp");
 #ifdef WARPX_MAG_LLG
-        VisMF::Read(*pml_H_fp[0], dir+"_Hx_fp");
-        VisMF::Read(*pml_H_fp[1], dir+"_Hy_fp");
-        VisMF::Read(*pml_H_fp[2], dir+"_Hz_fp");
+        if (pml_H_fp[0]) {
+            VisMF::Read(*pml_H_fp[0], dir+"_Hx_fp");
+            VisMF::Read(*pml_H_fp[1], dir+"_Hy_fp");
+            VisMF::Read(*pml_H_fp[2], dir+"_Hz_fp");
+        }
 #endif
     }
 
@@ -1622,9 +1646,11 @@ PML::Restart (const std::string& dir)
         VisMF::Read(*pml_B_cp[1], dir+"_By_cp");
         VisMF::Read(*pml_B_cp[2], dir+"_Bz_cp");
 #ifdef WARPX_MAG_LLG
-        VisMF::Read(*pml_H_cp[0], dir+"_Hx_cp");
-        VisMF::Read(*pml_H_cp[1], dir+"_Hy_cp");
-        VisMF::Read(*pml_H_cp[2], dir+"_Hz_cp");
+        if (pml_H_cp[0]) {
+            VisMF::Read(*pml_H_cp[0], dir+"_Hx_cp");
+            VisMF::Read(*pml_H_cp[1], dir+"_Hy_cp");
+            VisMF::Read(*pml_H_cp[2], dir+"_Hz_cp");
+        }
 #endif
     }
 }
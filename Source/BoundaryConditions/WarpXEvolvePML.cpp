@@ -12,6 +12,7 @@
 #   include "BoundaryConditions/PML_RZ.H"
 #endif
 #include "PML_current.H"
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX_PML_kernels.H"
 
@@ -86,23 +87,21 @@ WarpX::DampPML_Cartesian (const int lev, PatchType patch_type)
         const auto& pml_G = (patch_type == PatchType::fine) ? pml[lev]->GetG_fp() : pml[lev]->GetG_cp();
         const auto& sigba = (patch_type == PatchType::fine) ? pml[lev]->GetMultiSigmaBox_fp()
                                                             : pml[lev]->GetMultiSigmaBox_cp();
-#if WARPX_MAG_LLG
-        const auto& pml_H = (patch_type == PatchType::fine) ? pml[lev]->GetH_fp() : pml[lev]->GetH_cp();
+        // With the LLG model, the PML damps H instead of B
+        std::array<amrex::MultiFab*,3> pml_M = pml_B;
+#ifdef WARPX_MAG_LLG
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            pml_M = (patch_type == PatchType::fine) ? pml[lev]->GetH_fp() : pml[lev]->GetH_cp();
+        }
 #endif
 
         const amrex::IntVect Ex_stag = pml_E[0]->ixType().toIntVect();
         const amrex::IntVect Ey_stag = pml_E[1]->ixType().toIntVect();
         const amrex::IntVect Ez_stag = pml_E[2]->ixType().toIntVect();
 
-#if WARPX_MAG_LLG
-        const amrex::IntVect Hx_stag = pml_H[0]->ixType().toIntVect();
-        const amrex::IntVect Hy_stag = pml_H[1]->ixType().toIntVect();
-        const amrex::IntVect Hz_stag = pml_H[2]->ixType().toIntVect();
-#else
-        const amrex::IntVect Bx_stag = pml_B[0]->ixType().toIntVect();
-        const amrex::IntVect By_stag = pml_B[1]->ixType().toIntVect();
-        const amrex::IntVect Bz_stag = pml_B[2]->ixType().toIntVect();
-#endif
+        const amrex::IntVect Bx_stag = pml_M[0]->ixType().toIntVect();
+        const amrex::IntVect By_stag = pml_M[1]->ixType().toIntVect();
+        const amrex::IntVect Bz_stag = pml_M[2]->ixType().toIntVect();
         amrex::IntVect F_stag;
         if (pml_F) {
             F_stag = pml_F->ixType().toIntVect();
@@ -128,15 +127,9 @@ WarpX::DampPML_Cartesian (const int lev, PatchType patch_type)
             auto const& pml_Exfab = pml_E[0]->array(mfi);
             auto const& pml_Eyfab = pml_E[1]->array(mfi);
             auto const& pml_Ezfab = pml_E[2]->array(mfi);
-#ifndef WARPX_MAG_LLG
-            auto const& pml_Bxfab = pml_B[0]->array(mfi);
-            auto const& pml_Byfab = pml_B[1]->array(mfi);
-            auto const& pml_Bzfab = pml_B[2]->array(mfi);
-#else
-            auto const& pml_Hxfab = pml_H[0]->array(mfi);
-            auto const& pml_Hyfab = pml_H[1]->array(mfi);
-            auto const& pml_Hzfab = pml_H[2]->array(mfi);
-#endif
+            auto const& pml_Bxfab = pml_M[0]->array(mfi);
+            auto const& pml_Byfab = pml_M[1]->array(mfi);
+            auto const& pml_Bzfab = pml_M[2]->array(mfi);
 
 
             amrex::Real const * AMREX_RESTRICT sigma_fac_x = sigba[mfi].sigma_fac[0].data();
@@ -184,7 +177,6 @@ WarpX::DampPML_Cartesian (const int lev, PatchType patch_type)
                                   dive_cleaning);
             });
 
-#ifndef WARPX_MAG_LLG
             amrex::ParallelFor(tbx, tby, tbz,
             [=] AMREX_GPU_DEVICE (int i, int j, int k) {
 
@@ -204,24 +196,6 @@ WarpX::DampPML_Cartesian (const int lev, PatchType patch_type)
                                   sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
                                   divb_cleaning);
             });
-#else
-            amrex::ParallelFor(tbx, tby, tbz,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_bx(i, j, k, pml_Hxfab, Hx_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  divb_cleaning);
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_by(i, j, k, pml_Hyfab, Hy_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  divb_cleaning);
-            },
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-                warpx_damp_pml_bz(i, j, k, pml_Hzfab, Hz_stag, sigma_fac_x, sigma_fac_y, sigma_fac_z,
-                                  sigma_star_fac_x, sigma_star_fac_y, sigma_star_fac_z, x_lo, y_lo, z_lo,
-                                  divb_cleaning);
-            });
-#endif
 
             // For warpx_damp_pml_F(), mfi.nodaltilebox is used in the ParallelFor loop and here we
             // use mfi.tilebox. However, it does not matter because in damp_pml, where nodaltilebox
@@ -13,9 +13,10 @@
 CellCenterFunctor::CellCenterFunctor(amrex::MultiFab const * mf_src, int lev,
                                      amrex::IntVect crse_ratio,
                                      bool convertRZmodes2cartesian, int ncomp,
-                                     int scomp)
+                                     int scomp, bool partial_src)
     : ComputeDiagFunctor(ncomp, crse_ratio), m_mf_src(mf_src), m_lev(lev),
-      m_convertRZmodes2cartesian(convertRZmodes2cartesian), m_scomp(scomp)
+      m_convertRZmodes2cartesian(convertRZmodes2cartesian), m_scomp(scomp),
+      m_partial_src(partial_src)
 {}
 
 void
@@ -43,6 +44,8 @@ CellCenterFunctor::operator()(amrex::MultiFab& mf_dst, int dcomp, const int /*i_
 #else
     // In cartesian geometry, coarsen and interpolate from simulation MultiFab, m_mf_src,
     // to output diagnostic MultiFab, mf_dst.
+    // The cells of mf_dst that m_mf_src does not cover are not written by the copy in Coarsen
+    if (m_partial_src) mf_dst.setVal(0._rt, dcomp, nComp(), mf_dst.nGrowVect());
     CoarsenIO::Coarsen( mf_dst, *m_mf_src, dcomp, m_scomp, nComp(), mf_dst.nGrowVect(), m_crse_ratio);
     amrex::ignore_unused(m_lev, m_convertRZmodes2cartesian);
 #endif
@@ -119,38 +119,49 @@ Diagnostics::BaseReadParameters ()
     }
 
 #ifdef WARPX_MAG_LLG
-    // mag_Ms can be written to file only if WarpX::em_solver_medium == MediumForEM::Macroscopic
+    // H and M can be written to file only if WarpX::magnetic_model == MagneticModel::LLG
+    for (const auto& var : {"Hx", "Hy", "Hz",
+                            "Mx_xface", "Mx_yface", "Mx_zface",
+                            "My_xface", "My_yface", "My_zface",
+                            "Mz_xface", "Mz_yface", "Mz_zface"}) {
+        if (WarpXUtilStr::is_in(m_varnames, var)) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                WarpX::magnetic_model == MagneticModel::LLG,
+                std::string(var) + " in plotfiles only works with algo.magnetic_model=llg");
+        }
+    }
+    // mag_Ms can be written to file only if WarpX::magnetic_model == MagneticModel::LLG
     if (WarpXUtilStr::is_in(m_varnames, "mag_Ms_xface") || WarpXUtilStr::is_in(m_varnames, "mag_Ms_yface") || WarpXUtilStr::is_in(m_varnames, "mag_Ms_zface"))
     {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-            WarpX::em_solver_medium == MediumForEM::Macroscopic,
-            "mag_Ms in plotfiles only works with algo.em_solver_medium=macroscopic");
+            WarpX::magnetic_model == MagneticModel::LLG,
+            "mag_Ms in plotfiles only works with algo.magnetic_model=llg");
     }
-    // mag_alpha can be written to file only if WarpX::em_solver_medium == MediumForEM::Macroscopic
+    // mag_alpha can be written to file only if WarpX::magnetic_model == MagneticModel::LLG
     if (WarpXUtilStr::is_in(m_varnames, "mag_alpha_xface") || WarpXUtilStr::is_in(m_varnames, "mag_alpha_yface") || WarpXUtilStr::is_in(m_varnames, "mag_alpha_zface"))
     {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-            WarpX::em_solver_medium == MediumForEM::Macroscopic,
-            "mag_alpha in plotfiles only works with algo.em_solver_medium=macroscopic");
+            WarpX::magnetic_model == MagneticModel::LLG,
+            "mag_alpha in plotfiles only works with algo.magnetic_model=llg");
     }
-    // mag_exchange can be written to file only if WarpX::em_solver_medium == MediumForEM::Macroscopic
+    // mag_exchange can be written to file only if WarpX::magnetic_model == MagneticModel::LLG
     if (WarpXUtilStr::is_in(m_varnames, "mag_exchange_xface") || WarpXUtilStr::is_in(m_varnames, "mag_exchange_yface") || WarpXUtilStr::is_in(m_varnames, "mag_exchange_zface"))
     {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-            WarpX::em_solver_medium == MediumForEM::Macroscopic,
-            "mag_exchange in plotfiles only works with algo.em_solver_medium=macroscopic");
+            WarpX::magnetic_model == MagneticModel::LLG,
+            "mag_exchange in plotfiles only works with algo.magnetic_model=llg");
         if (mag_exchange_coupling == 0){
             std::stringstream warnMsg;
             warnMsg << "Magnetic exchange coupling turned OFF, and exchange constant A is not parsed";
             WarpX::GetInstance().RecordWarning("Macroscopic properties",warnMsg.str(), WarnPriority::high);
         }
     }
-    // mag_anisotropy can be written to file only if WarpX::em_solver_medium == MediumForEM::Macroscopic
+    // mag_anisotropy can be written to file only if WarpX::magnetic_model == MagneticModel::LLG
     if (WarpXUtilStr::is_in(m_varnames, "mag_anisotropy_xface") || WarpXUtilStr::is_in(m_varnames, "mag_anisotropy_yface") || WarpXUtilStr::is_in(m_varnames, "mag_anisotropy_zface"))
     {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-            WarpX::em_solver_medium == MediumForEM::Macroscopic,
-            "mag_anisotropy in plotfiles only works with algo.em_solver_medium=macroscopic");
+            WarpX::magnetic_model == MagneticModel::LLG,
+            "mag_anisotropy in plotfiles only works with algo.magnetic_model=llg");
         if (mag_anisotropy_coupling == 0){
             std::stringstream warnMsg;
             warnMsg << "Magnetic anisotropy field turned OFF, and anisotropy constant Ku is not parsed";
@@ -529,6 +540,10 @@ Diagnostics::FilterComputePackFlush (int step, bool force_flush)
     MovingWindowAndGalileanDomainShift (step);
 
     if ( DoComputeAndPack (step, force_flush) ) {
+#if (defined WARPX_MAG_LLG) && !(defined WARPX_DIM_RZ)
+        // the full diagnostics, the checkpoints and the BTD read B
+        WarpX::GetInstance().SyncLLGBfield();
+#endif
         ComputeAndPack();
     }
 
@@ -6,6 +6,7 @@
 #include "Particles/PinnedMemoryParticleContainer.H"
 #include "Utils/Interpolate.H"
 #include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 
@@ -532,12 +533,16 @@ FlushFormatPlotfile::WriteAllRawFields(
         WriteRawMF( warpx.getBfield_fp(lev, 1), dm, raw_pltname, default_level_prefix, "By_fp", lev, plot_raw_fields_guards);
         WriteRawMF( warpx.getBfield_fp(lev, 2), dm, raw_pltname, default_level_prefix, "Bz_fp", lev, plot_raw_fields_guards);
 #ifdef WARPX_MAG_LLG
-        WriteRawMF( warpx.getHfield_fp(lev, 0), dm, raw_pltname, default_level_prefix, "Hx_fp", lev, plot_raw_fields_guards);
-        WriteRawMF( warpx.getHfield_fp(lev, 1), dm, raw_pltname, default_level_prefix, "Hy_fp", lev, plot_raw_fields_guards);
-        WriteRawMF( warpx.getHfield_fp(lev, 2), dm, raw_pltname, default_level_prefix, "Hz_fp", lev, plot_raw_fields_guards);
-        WriteRawMF( warpx.getMfield_fp(lev, 0), dm, raw_pltname, default_level_prefix, "M_xface_fp", lev, plot_raw_fields_guards);
-        WriteRawMF( warpx.getMfield_fp(lev, 1), dm, raw_pltname, default_level_prefix, "M_yface_fp", lev, plot_raw_fields_guards);
-        WriteRawMF( warpx.getMfield_fp(lev, 2), dm, raw_pltname, default_level_prefix, "M_zface_fp", lev, plot_raw_fields_guards);
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            WriteRawMF( warpx.getHfield_fp(lev, 0), dm, raw_pltname, default_level_prefix, "Hx_fp", lev, plot_raw_fields_guards);
+            WriteRawMF( warpx.getHfield_fp(lev, 1), dm, raw_pltname, default_level_prefix, "Hy_fp", lev, plot_raw_fields_guards);
+            WriteRawMF( warpx.getHfield_fp(lev, 2), dm, raw_pltname, default_level_prefix, "Hz_fp", lev, plot_raw_fields_guards);
+            // M only covers the magnetic boxes: it is written on all the boxes of the level, zero on the others
+            const amrex::IntVect ng_M = plot_raw_fields_guards ? warpx.getMfield_fp(lev, 0).nGrowVect() : amrex::IntVect(0);
+            WriteRawMF( *warpx.MakeDenseMfield(lev, 0, ng_M), dm, raw_pltname, default_level_prefix, "M_xface_fp", lev, plot_raw_fields_guards);
+            WriteRawMF( *warpx.MakeDenseMfield(lev, 1, ng_M), dm, raw_pltname, default_level_prefix, "M_yface_fp", lev, plot_raw_fields_guards);
+            WriteRawMF( *warpx.MakeDenseMfield(lev, 2, ng_M), dm, raw_pltname, default_level_prefix, "M_zface_fp", lev, plot_raw_fields_guards);
+        }
 #endif
         if (warpx.get_pointer_F_fp(lev))
         {
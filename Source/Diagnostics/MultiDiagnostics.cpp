@@ -100,6 +100,16 @@ MultiDiagnostics::FilterComputePackFlushLastTimestep (int step)
     }
 }
 
+bool
+MultiDiagnostics::DoCheckpoint (int step) const
+{
+    for (int i = 0; i < ndiags; ++i){
+        if (diags_types[i] != DiagTypes::BackTransformed &&
+            alldiags[i]->IsCheckpoint() && alldiags[i]->DoComputeAndPack(step)) return true;
+    }
+    return false;
+}
+
 void
 MultiDiagnostics::NewIteration ()
 {
@@ -0,0 +1,387 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "FieldDFT.H"
+
+#include "RawFields.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_Array4.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_BoxList.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace amrex;
+
+// constructor
+FieldDFT::FieldDFT (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if (defined WARPX_DIM_RZ)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "FieldDFT reduced diagnostics does not work for RZ coordinate.");
+#endif
+
+    // read number of levels
+    int nLevel = 0;
+    ParmParse pp_amr("amr");
+    pp_amr.query("max_level", nLevel);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(nLevel == 0,
+        "FieldDFT reduced diagnostics does not work with mesh refinement.");
+
+    ParmParse pp_rd_name(rd_name);
+    getArrWithParser(pp_rd_name, "frequencies", m_frequencies);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!m_frequencies.empty(),
+        "FieldDFT: at least one frequency must be given");
+
+    m_field_names = {"Ex", "Ey", "Ez", "Bx", "By", "Bz"};
+    pp_rd_name.queryarr("fields", m_field_names);
+
+    // the region defaults to the whole domain
+    queryArrWithParser(pp_rd_name, "region_lo", m_region_lo, 0, AMREX_SPACEDIM);
+    queryArrWithParser(pp_rd_name, "region_hi", m_region_hi, 0, AMREX_SPACEDIM);
+
+    // the frequencies are written at each output
+    m_data = m_frequencies;
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (int n = 0; n < static_cast<int>(m_frequencies.size()); ++n)
+            {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]f" << n << "(Hz)";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+void FieldDFT::InitData ()
+{
+    auto & warpx = WarpX::GetInstance();
+    const Geometry& gm = warpx.Geom(0);
+    const Box& domain = gm.Domain();
+    const auto prob_lo = gm.ProbLoArray();
+    const auto prob_hi = gm.ProbHiArray();
+    const auto dxinv = gm.InvCellSizeArray();
+
+    // abort on the unknown field names, now that the fields are allocated
+    for (auto const& name : m_field_names)
+    {
+        int comp = 0;
+        RawFields::Get(name, 0, comp, "FieldDFT");
+    }
+
+    // cells that contain the region; the points on the upper boundary of the domain go to
+    // its last cells
+    if (m_region_lo.empty()) m_region_lo.assign(prob_lo.begin(), prob_lo.end());
+    if (m_region_hi.empty()) m_region_hi.assign(prob_hi.begin(), prob_hi.end());
+    IntVect lo, hi;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+            m_region_lo[idim] <= m_region_hi[idim]
+            && m_region_lo[idim] >= prob_lo[idim] && m_region_hi[idim] <= prob_hi[idim],
+            "FieldDFT: the region must be in the simulation domain, with region_lo <= region_hi");
+        lo[idim] = static_cast<int>(std::floor((m_region_lo[idim] - prob_lo[idim]) * dxinv[idim]));
+        hi[idim] = static_cast<int>(std::floor((m_region_hi[idim] - prob_lo[idim]) * dxinv[idim]));
+        lo[idim] = std::min(lo[idim], domain.bigEnd(idim));
+        hi[idim] = std::min(hi[idim], domain.bigEnd(idim));
+    }
+    m_region = Box(lo, hi);
+
+    DefineAccumulators(m_acc, m_src_index);
+    m_acc.setVal(0._rt);
+    m_dm = warpx.DistributionMap(0);
+
+    std::stringstream ss;
+    ss << "FieldDFT " << m_rd_name << ": " << m_field_names.size() << " fields at "
+       << m_frequencies.size() << " frequencies on " << m_region.numPts() << " cells, "
+       << static_cast<double>(m_region.numPts()) * NComp() * sizeof(Real) / (1024.*1024.)
+       << " MB of accumulators";
+    amrex::Print() << Utils::TextMsg::Info(ss.str());
+}
+
+void FieldDFT::DefineAccumulators (amrex::MultiFab& acc, amrex::Vector<int>& src_index) const
+{
+    auto & warpx = WarpX::GetInstance();
+    const BoxArray& ba = warpx.boxArray(0);
+    const DistributionMapping& dm = warpx.DistributionMap(0);
+
+    // each box of the accumulators lives on the rank of the level-0 box that contains it
+    BoxList bl;
+    Vector<int> pmap;
+    src_index.clear();
+    for (int i = 0; i < static_cast<int>(ba.size()); ++i)
+    {
+        const Box b = ba[i] & m_region;
+        if (b.ok())
+        {
+            bl.push_back(b);
+            pmap.push_back(dm[i]);
+            src_index.push_back(i);
+        }
+    }
+    acc.define(BoxArray(bl), DistributionMapping(pmap), NComp(), 0);
+}
+
+void FieldDFT::LoadBalance ()
+{
+    // called at every step: only act when the boxes moved
+    if (m_acc.empty() || WarpX::GetInstance().DistributionMap(0) == m_dm) return;
+
+    MultiFab acc;
+    Vector<int> src_index;
+    DefineAccumulators(acc, src_index);
+    acc.setVal(0._rt);
+    acc.ParallelCopy(m_acc, 0, 0, NComp());
+    m_acc = std::move(acc);
+    m_src_index = std::move(src_index);
+    m_dm = WarpX::GetInstance().DistributionMap(0);
+}
+
+void FieldDFT::ResetPhases (amrex::Real t, amrex::Real dt)
+{
+    const int n_freq = static_cast<int>(m_frequencies.size());
+    m_phase.resize(2*n_freq);
+    m_rotation.resize(2*n_freq);
+    for (int n = 0; n < n_freq; ++n)
+    {
+        const Real omega = 2._rt * MathConst::pi * m_frequencies[n];
+        m_phase[2*n] = std::cos(omega * t);
+        m_phase[2*n+1] = -std::sin(omega * t);
+        m_rotation[2*n] = std::cos(omega * dt);
+        m_rotation[2*n+1] = -std::sin(omega * dt);
+    }
+    m_phase_dt = dt;
+    m_n_rotations = 0;
+}
+
+void FieldDFT::ComputeDiags (int step)
+{
+    WARPX_PROFILE("FieldDFT::ComputeDiags()");
+
+    auto & warpx = WarpX::GetInstance();
+    const Real t = warpx.gett_new(0);
+    const Real dt = warpx.getdt(0);
+
+    // advance the phase factors to t by one rotation; recompute them from the time at the
+    // first step, when dt changed, and every m_reset_interval steps
+    if (m_phase.empty() || dt != m_phase_dt || m_n_rotations >= m_reset_interval)
+    {
+        ResetPhases(t, dt);
+    }
+    else
+    {
+        for (int n = 0; n < static_cast<int>(m_frequencies.size()); ++n)
+        {
+            const Real re = m_phase[2*n];
+            const Real im = m_phase[2*n+1];
+            m_phase[2*n] = re * m_rotation[2*n] - im * m_rotation[2*n+1];
+            m_phase[2*n+1] = re * m_rotation[2*n+1] + im * m_rotation[2*n];
+        }
+        ++m_n_rotations;
+    }
+    m_phase_d.resize(m_phase.size());
+    Gpu::copyAsync(Gpu::hostToDevice, m_phase.begin(), m_phase.end(), m_phase_d.begin());
+
+    // accumulate F(t) exp(-i omega t) dt
+    const int n_freq = static_cast<int>(m_frequencies.size());
+    Real const* const AMREX_RESTRICT phase = m_phase_d.data();
+    for (int f = 0; f < static_cast<int>(m_field_names.size()); ++f)
+    {
+        int comp = 0;
+        MultiFab const* mf = RawFields::Get(m_field_names[f], 0, comp, "FieldDFT");
+        amrex::Vector<int> const* box_index = RawFields::BoxIndex(m_field_names[f], 0);
+        const int acc_comp = 2 * f * n_freq;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(m_acc, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            // the fields that are not stored on a box are zero there
+            const int K = box_index ? (*box_index)[m_src_index[mfi.index()]] : m_src_index[mfi.index()];
+            if (K < 0) continue;
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const acc = m_acc.array(mfi);
+            Array4<Real const> const fld = mf->const_array(K);
+            ParallelFor(bx, n_freq, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+            {
+                const Real v = fld(i, j, k, comp) * dt;
+                acc(i, j, k, acc_comp + 2*n) += v * phase[2*n];
+                acc(i, j, k, acc_comp + 2*n+1) += v * phase[2*n+1];
+            });
+        }
+    }
+    ++m_n_samples;
+
+    if (m_intervals.contains(step+1))
+    {
+        WriteSpectra(step);
+    }
+}
+
+void FieldDFT::FlushBuffers ()
+{
+    // istep was advanced at the end of the step
+    const int step = WarpX::GetInstance().getistep(0) - 1;
+    if (m_acc.empty() || step == m_written_step) return;
+    WriteSpectra(step);
+}
+
+void FieldDFT::WriteSpectra (int step)
+{
+    WARPX_PROFILE("FieldDFT::WriteSpectra()");
+
+    auto & warpx = WarpX::GetInstance();
+    Vector<std::string> varnames;
+    for (auto const& name : m_field_names)
+    {
+        for (int n = 0; n < static_cast<int>(m_frequencies.size()); ++n)
+        {
+            varnames.push_back(name + "_f" + std::to_string(n) + "_re");
+            varnames.push_back(name + "_f" + std::to_string(n) + "_im");
+        }
+    }
+    const std::string filename = amrex::Concatenate(m_path + m_rd_name + "_plt", step+1, 6);
+    amrex::WriteSingleLevelPlotfile(filename, m_acc, varnames, warpx.Geom(0),
+                                    warpx.gett_new(0), step+1);
+    m_written_step = step;
+}
+
+std::string FieldDFT::CheckpointPrefix (const std::string& dir) const
+{
+    return dir + "/reduced_diags/" + m_rd_name;
+}
+
+void FieldDFT::WriteCheckpointData (const std::string& dir) const
+{
+    WARPX_PROFILE("FieldDFT::WriteCheckpointData()");
+
+    if (m_acc.empty()) return;
+
+    const std::string prefix = CheckpointPrefix(dir);
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if (!UtilCreateDirectory(prefix, 0755)) { CreateDirectoryFailed(prefix); }
+
+        const std::string header_name = prefix + "/Header";
+        std::ofstream ofs{header_name, std::ofstream::out | std::ofstream::trunc};
+        if (!ofs.good()) { amrex::FileOpenFailed(header_name); }
+        ofs.precision(17);
+
+        // the fields, frequencies and region, to check that the restart transforms the same
+        ofs << m_field_names.size();
+        for (auto const& name : m_field_names) { ofs << " " << name; }
+        ofs << "\n";
+        ofs << m_frequencies.size();
+        for (auto const f : m_frequencies) { ofs << " " << f; }
+        ofs << "\n";
+        ofs << m_region << "\n";
+
+        // the state of the accumulation
+        ofs << m_n_samples << "\n";
+        ofs << m_phase_dt << " " << m_n_rotations << "\n";
+        ofs << m_phase.size();
+        for (auto const p : m_phase) { ofs << " " << p; }
+        ofs << "\n";
+        ofs << m_rotation.size();
+        for (auto const r : m_rotation) { ofs << " " << r; }
+        ofs << "\n";
+    }
+    // the directory exists before the ranks write their accumulators
+    ParallelDescriptor::Barrier();
+
+    VisMF::Write(m_acc, prefix + "/acc");
+}
+
+void FieldDFT::ReadCheckpointData (const std::string& dir)
+{
+    WARPX_PROFILE("FieldDFT::ReadCheckpointData()");
+
+    const std::string prefix = CheckpointPrefix(dir);
+    const std::string header_name = prefix + "/Header";
+    if (!amrex::FileExists(header_name))
+    {
+        WarpX::GetInstance().RecordWarning("Diagnostics",
+            "FieldDFT " + m_rd_name + ": the checkpoint " + dir
+            + " has no transforms of this diagnostics, they restart from zero",
+            WarnPriority::high);
+        return;
+    }
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(header_name, fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream is(fileCharPtrString, std::istringstream::in);
+    is.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+
+    std::size_t n = 0;
+    is >> n;
+    std::vector<std::string> field_names(n);
+    for (auto& name : field_names) { is >> name; }
+    is >> n;
+    std::vector<Real> frequencies(n);
+    for (auto& f : frequencies) { is >> f; }
+    Box region;
+    is >> region;
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        field_names == m_field_names && frequencies == m_frequencies && region == m_region,
+        "FieldDFT " + m_rd_name + ": the fields, frequencies and region must be those of the checkpoint");
+
+    is >> m_n_samples;
+    is >> m_phase_dt >> m_n_rotations;
+    is >> n;
+    m_phase.resize(n);
+    for (auto& p : m_phase) { is >> p; }
+    is >> n;
+    m_rotation.resize(n);
+    for (auto& r : m_rotation) { is >> r; }
+
+    // the boxes of the checkpoint may be distributed differently
+    MultiFab acc;
+    VisMF::Read(acc, prefix + "/acc");
+    m_acc.ParallelCopy(acc, 0, 0, NComp());
+
+    std::stringstream ss;
+    ss << "FieldDFT " << m_rd_name << ": restarting the transforms after " << m_n_samples << " steps";
+    amrex::Print() << Utils::TextMsg::Info(ss.str());
+}
@@ -0,0 +1,258 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "FieldIntegralEngine.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "WarpX.H"
+
+#include <AMReX_Gpu.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_Loop.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Tuple.H>
+
+#include <algorithm>
+#include <utility>
+
+using namespace amrex;
+
+namespace
+{
+    constexpr int n_fields = static_cast<int>(FieldIntegralEngine::Field::NFields);
+}
+
+void
+FieldIntegralEngine::AddTerm (int out, Field field, RangeFunc range, FactorFunc factor,
+                              Field partner, int partner_dir)
+{
+    AMREX_ALWAYS_ASSERT(out >= 0 && out < m_n_outputs);
+    m_terms.push_back(Term{out, field, std::move(range), std::move(factor), partner, partner_dir, nullptr});
+}
+
+void
+FieldIntegralEngine::AddParserTerm (int out, Field field, amrex::Parser const& parser,
+                                    FactorFunc factor)
+{
+    AddTerm(out, field,
+        [] (Geometry const& geom, IndexType ixtype) {
+            return amrex::convert(geom.Domain(), ixtype);
+        },
+        std::move(factor));
+    m_terms.back().parser = &parser;
+}
+
+bool
+FieldIntegralEngine::HasH ()
+{
+#ifdef WARPX_MAG_LLG
+    return WarpX::magnetic_model == MagneticModel::LLG;
+#else
+    return false;
+#endif
+}
+
+amrex::MultiFab const*
+FieldIntegralEngine::GetField (Field field, int lev)
+{
+    auto & warpx = WarpX::GetInstance();
+    const int f = static_cast<int>(field);
+    if (f < static_cast<int>(Field::Bx)) return warpx.get_pointer_Efield_aux(lev, f);
+    if (f < static_cast<int>(Field::Hx)) return warpx.get_pointer_Bfield_aux(lev, f - static_cast<int>(Field::Bx));
+#ifdef WARPX_MAG_LLG
+    if (HasH() && f < n_fields) return warpx.get_pointer_Hfield_aux(lev, f - static_cast<int>(Field::Hx));
+#endif
+    return nullptr;
+}
+
+void
+FieldIntegralEngine::Build ()
+{
+    WARPX_PROFILE("FieldIntegralEngine::Build()");
+
+    auto & warpx = WarpX::GetInstance();
+    const int n_levels = warpx.finestLevel() + 1;
+    m_segments.clear();
+    m_segments.resize(m_n_outputs);
+    m_ba.resize(n_levels);
+    m_dm.resize(n_levels);
+
+    // the parsers are compiled once, for the host and the device
+    Vector<ParserExecutor<3>> parsers(m_terms.size());
+    for (int t = 0; t < static_cast<int>(m_terms.size()); ++t)
+    {
+        if (m_terms[t].parser) parsers[t] = m_terms[t].parser->compile<3>();
+    }
+
+    for (int lev = 0; lev < n_levels; ++lev)
+    {
+        const Geometry& geom = warpx.Geom(lev);
+        const Box& domain = geom.Domain();
+        m_ba[lev] = warpx.boxArray(lev);
+        m_dm[lev] = warpx.DistributionMap(lev);
+
+        // the indices covered by the next level are counted there
+        BoxArray fine_ba;
+        if (lev < n_levels - 1)
+        {
+            fine_ba = warpx.boxArray(lev+1);
+            fine_ba.coarsen(warpx.refRatio(lev));
+        }
+
+        for (MFIter mfi(m_ba[lev], m_dm[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& vbx = mfi.validbox();
+            for (int t = 0; t < static_cast<int>(m_terms.size()); ++t)
+            {
+                Term const& term = m_terms[t];
+                MultiFab const* mf = GetField(term.field, lev);
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(mf != nullptr,
+                    "FieldIntegralEngine: the H fields require algo.magnetic_model = llg");
+                const IndexType ixtype = mf->ixType();
+
+                // each box owns the indices of its cells; the nodes on the upper boundary of
+                // a non-periodic domain belong to the last boxes
+                Box own = vbx;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+                {
+                    if (ixtype.nodeCentered(idim) && !geom.isPeriodic(idim)
+                        && vbx.bigEnd(idim) == domain.bigEnd(idim))
+                    {
+                        own.growHi(idim, 1);
+                    }
+                }
+                const Box range = term.range(geom, ixtype);
+                const Box b = Box(range.smallEnd(), range.bigEnd()) & own;
+                if (!b.ok()) continue;
+
+                Weight weight{};
+                weight.factor = term.factor(geom);
+                weight.has_parser = (term.parser != nullptr);
+                if (weight.has_parser)
+                {
+                    weight.parser = parsers[t];
+                    weight.problo = geom.ProbLoArray();
+                    weight.dx = geom.CellSizeArray();
+                    weight.nodal = ixtype.toIntVect();
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        weight.periodic[idim] = geom.isPeriodic(idim);
+                    }
+                    weight.domain = domain;
+                }
+
+                // the parts of b that are not covered by the next level: the cell of a node
+                // on the upper boundary of the domain is the last cell
+                BoxList parts(b);
+                if (!fine_ba.empty())
+                {
+                    Box cells = b;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+                    {
+                        cells.setSmall(idim, std::min(b.smallEnd(idim), domain.bigEnd(idim)));
+                        cells.setBig(idim, std::min(b.bigEnd(idim), domain.bigEnd(idim)));
+                    }
+                    parts = fine_ba.complementIn(cells);
+                    for (Box& part : parts)
+                    {
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+                        {
+                            if (part.bigEnd(idim) == domain.bigEnd(idim)) part.growHi(idim, 1);
+                        }
+                        part &= b;
+                    }
+                }
+
+                for (Box const& part : parts)
+                {
+                    if (!part.ok()) continue;
+                    Box seg_box = part;
+                    if (weight.has_parser)
+                    {
+                        // trim the part to the bounding box of its indices of nonzero weight
+                        IntVect lo = part.bigEnd();
+                        IntVect hi = part.smallEnd();
+                        bool any = false;
+                        amrex::LoopOnCpu(part, [&] (int i, int j, int k)
+                        {
+                            amrex::ignore_unused(j, k);
+                            const IntVect iv(AMREX_D_DECL(i, j, k));
+                            if (weight(iv) == 0._rt) return;
+                            lo = amrex::min(lo, iv);
+                            hi = amrex::max(hi, iv);
+                            any = true;
+                        });
+                        if (!any) continue;
+                        seg_box = Box(lo, hi);
+                    }
+                    m_segments[term.out].push_back(Segment{lev, mfi.index(), t, seg_box, weight});
+                }
+            }
+        }
+    }
+}
+
+bool
+FieldIntegralEngine::NeedsRebuild () const
+{
+    auto & warpx = WarpX::GetInstance();
+    const int n_levels = warpx.finestLevel() + 1;
+    if (n_levels != static_cast<int>(m_ba.size())) return true;
+    for (int lev = 0; lev < n_levels; ++lev)
+    {
+        if (warpx.DistributionMap(lev) != m_dm[lev] || warpx.boxArray(lev) != m_ba[lev]) return true;
+    }
+    return false;
+}
+
+void
+FieldIntegralEngine::Evaluate (amrex::Vector<amrex::Real>& result)
+{
+    WARPX_PROFILE("FieldIntegralEngine::Evaluate()");
+
+    result.assign(m_n_outputs, 0._rt);
+    for (int out = 0; out < m_n_outputs; ++out)
+    {
+        Vector<Segment> const& segments = m_segments[out];
+        const int n_segments = static_cast<int>(segments.size());
+
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for if (Gpu::notInLaunchRegion())
+#endif
+        for (int s = 0; s < n_segments; ++s)
+        {
+            Segment const& seg = segments[s];
+            Term const& term = m_terms[seg.term];
+            Array4<Real const> const fld = GetField(term.field, seg.lev)->const_array(seg.index);
+            const bool has_partner = (term.partner != Field::NFields);
+            Array4<Real const> const partner = has_partner ?
+                GetField(term.partner, seg.lev)->const_array(seg.index) : fld;
+            const IntVect shift = IntVect::TheDimensionVector(term.partner_dir);
+            Weight const weight = seg.weight;
+
+            reduce_op.eval(seg.box, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    amrex::ignore_unused(j, k);
+                    const IntVect iv(AMREX_D_DECL(i, j, k));
+                    Real v = weight(iv) * fld(iv);
+                    if (has_partner) v *= 0.5_rt * (partner(iv) + partner(iv - shift));
+                    return v;
+                });
+        }
+        result[out] = amrex::get<0>(reduce_data.value(reduce_op));
+    }
+
+    ParallelDescriptor::ReduceRealSum(result.data(), m_n_outputs);
+}
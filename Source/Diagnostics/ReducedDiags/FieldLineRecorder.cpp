@@ -0,0 +1,349 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "FieldLineRecorder.H"
+
+#include "RawFields.H"
+
+#include "Utils/IntervalsParser.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_Array4.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+// constructor
+FieldLineRecorder::FieldLineRecorder (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if (defined WARPX_DIM_RZ)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "FieldLineRecorder reduced diagnostics does not work for RZ coordinate.");
+#endif
+
+    // the points are defined as for the FieldProbe Point and Line geometries
+    ParmParse pp_rd_name(rd_name);
+    std::string probe_geometry_str = "Point";
+    pp_rd_name.query("probe_geometry", probe_geometry_str);
+
+    Real x_probe = 0._rt, y_probe = 0._rt, z_probe = 0._rt;
+    Real x1_probe = 0._rt, y1_probe = 0._rt, z1_probe = 0._rt;
+    int resolution = 1;
+#if !defined(WARPX_DIM_1D_Z)
+    getWithParser(pp_rd_name, "x_probe", x_probe);
+#endif
+#if defined(WARPX_DIM_3D)
+    getWithParser(pp_rd_name, "y_probe", y_probe);
+#endif
+    getWithParser(pp_rd_name, "z_probe", z_probe);
+    if (probe_geometry_str == "Point")
+    {
+        m_probe_geometry = DetectorGeometry::Point;
+    }
+    else if (probe_geometry_str == "Line")
+    {
+        m_probe_geometry = DetectorGeometry::Line;
+#if !defined(WARPX_DIM_1D_Z)
+        getWithParser(pp_rd_name, "x1_probe", x1_probe);
+#endif
+#if defined(WARPX_DIM_3D)
+        getWithParser(pp_rd_name, "y1_probe", y1_probe);
+#endif
+        getWithParser(pp_rd_name, "z1_probe", z1_probe);
+        getWithParser(pp_rd_name, "resolution", resolution);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(resolution >= 2,
+            "FieldLineRecorder: resolution must be at least 2 for a Line geometry");
+    }
+    else
+    {
+        amrex::Abort(Utils::TextMsg::Err(
+            "FieldLineRecorder: invalid probe geometry '" + probe_geometry_str
+            + "'. Valid geometries are Point or Line."));
+    }
+
+    for (int n = 0; n < resolution; ++n)
+    {
+        Real const f = (resolution > 1) ? static_cast<Real>(n) / static_cast<Real>(resolution - 1) : 0._rt;
+        Real const x = x_probe + f * (x1_probe - x_probe);
+        Real const y = y_probe + f * (y1_probe - y_probe);
+        Real const z = z_probe + f * (z1_probe - z_probe);
+        amrex::ignore_unused(x, y);
+#if defined(WARPX_DIM_1D_Z)
+        m_points.push_back(RealVect(z));
+#elif defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
+        m_points.push_back(RealVect(x, z));
+#else
+        m_points.push_back(RealVect(x, y, z));
+#endif
+    }
+
+    m_field_names = {"Ex", "Ey", "Ez", "Bx", "By", "Bz"};
+    pp_rd_name.queryarr("fields", m_field_names);
+
+    pp_rd_name.query("buffer_size", m_buffer_size);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_buffer_size >= 1,
+        "FieldLineRecorder: buffer_size must be positive");
+    // the buffers are gathered with MPI counts of type int
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        static_cast<double>(m_buffer_size) * m_points.size() * m_field_names.size() < INT_MAX,
+        "FieldLineRecorder: buffer_size is too large for the number of points and fields");
+
+    // the data are binary: the empty text file created by ReducedDiags is replaced
+    // by a .bin file, unless an extension was given
+    if (!pp_rd_name.contains("extension"))
+    {
+        if (ParallelDescriptor::IOProcessor() && m_IsNotRestart)
+        {
+            std::remove((m_path + m_rd_name + "." + m_extension).c_str());
+        }
+        m_extension = "bin";
+    }
+}
+// end constructor
+
+void FieldLineRecorder::InitData ()
+{
+    auto & warpx = WarpX::GetInstance();
+    const Geometry& gm = warpx.Geom(0);
+    const Box& domain = gm.Domain();
+    const auto prob_lo = gm.ProbLoArray();
+    const auto dxinv = gm.InvCellSizeArray();
+
+    // abort on the unknown field names, now that the fields are allocated
+    for (auto const& name : m_field_names)
+    {
+        int comp = 0;
+        RawFields::Get(name, 0, comp, "FieldLineRecorder");
+    }
+
+    // each point is attached to the cell that contains it, as the raw FieldProbe;
+    // the points on the upper boundary of the domain go to its last cells
+    m_cells.clear();
+    for (auto const& p : m_points)
+    {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(gm.ProbDomain().contains(p.dataPtr()),
+            "FieldLineRecorder: the points must be in the simulation domain");
+        IntVect iv;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            iv[idim] = static_cast<int>(std::floor((p[idim] - prob_lo[idim]) * dxinv[idim]));
+            iv[idim] = std::min(std::max(iv[idim], domain.smallEnd(idim)), domain.bigEnd(idim));
+        }
+        m_cells.push_back(iv);
+    }
+
+    BuildLocalPoints();
+
+    if (ParallelDescriptor::IOProcessor() && m_IsNotRestart)
+    {
+        // write the header: a text block terminated by "end_header"
+        std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out | std::ofstream::binary};
+        ofs << "# WarpX FieldLineRecorder\n";
+        ofs << "n_points " << m_points.size() << "\n";
+        ofs << "fields";
+        for (auto const& name : m_field_names) ofs << " " << name;
+        ofs << "\n";
+        ofs << "record float64 step time [point][field]\n";
+        ofs << std::setprecision(17);
+        for (int n = 0; n < static_cast<int>(m_points.size()); ++n)
+        {
+            ofs << "point " << n;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) ofs << " " << m_points[n][idim];
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) ofs << " " << m_cells[n][idim];
+            ofs << "\n";
+        }
+        ofs << "end_header\n";
+        ofs.close();
+    }
+}
+
+void FieldLineRecorder::BuildLocalPoints ()
+{
+    auto & warpx = WarpX::GetInstance();
+    const BoxArray& ba = warpx.boxArray(0);
+    m_dm = warpx.DistributionMap(0);
+
+    m_local_boxes.clear();
+    m_local_ids.clear();
+    amrex::Vector<IntVect> local_cells;
+    for (MFIter mfi(ba, m_dm); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        LocalBox lb{mfi.index(), static_cast<int>(m_local_ids.size()), 0};
+        for (int n = 0; n < static_cast<int>(m_cells.size()); ++n)
+        {
+            if (vbx.contains(m_cells[n]))
+            {
+                m_local_ids.push_back(n);
+                local_cells.push_back(m_cells[n]);
+                ++lb.count;
+            }
+        }
+        if (lb.count > 0) m_local_boxes.push_back(lb);
+    }
+
+    m_local_cells.resize(local_cells.size());
+    Gpu::copyAsync(Gpu::hostToDevice, local_cells.begin(), local_cells.end(), m_local_cells.begin());
+    m_sample.resize(m_local_ids.size() * m_field_names.size());
+    Gpu::streamSynchronize();
+}
+
+void FieldLineRecorder::LoadBalance ()
+{
+    // called at every step: only act when the boxes moved
+    if (m_cells.empty() || WarpX::GetInstance().DistributionMap(0) == m_dm) return;
+
+    // the buffered samples belong to the previous rank-local point set
+    FlushBuffers();
+    BuildLocalPoints();
+}
+
+void FieldLineRecorder::ComputeDiags (int step)
+{
+    auto & warpx = WarpX::GetInstance();
+
+    if (m_intervals.contains(step+1))
+    {
+        const int n_fields = static_cast<int>(m_field_names.size());
+        IntVect const* const AMREX_RESTRICT cells = m_local_cells.data();
+        Real* const AMREX_RESTRICT sample = m_sample.data();
+        for (int f = 0; f < n_fields; ++f)
+        {
+            int comp = 0;
+            amrex::MultiFab const* mf = RawFields::Get(m_field_names[f], 0, comp, "FieldLineRecorder");
+            amrex::Vector<int> const* box_index = RawFields::BoxIndex(m_field_names[f], 0);
+            for (auto const& lb : m_local_boxes)
+            {
+                const int offset = lb.offset;
+                const int K = box_index ? (*box_index)[lb.box_index] : lb.box_index;
+                if (K < 0)
+                {
+                    // the field is not stored on this box, where it is zero
+                    ParallelFor(lb.count, [=] AMREX_GPU_DEVICE (int n)
+                    {
+                        sample[(offset + n) * n_fields + f] = 0._rt;
+                    });
+                    continue;
+                }
+                Array4<Real const> const arr = mf->const_array(K);
+                ParallelFor(lb.count, [=] AMREX_GPU_DEVICE (int n)
+                {
+                    sample[(offset + n) * n_fields + f] = arr(cells[offset + n], comp);
+                });
+            }
+        }
+
+        // append the sample to the host buffer
+        const std::size_t old_size = m_buffer.size();
+        m_buffer.resize(old_size + m_sample.size());
+        Gpu::copyAsync(Gpu::deviceToHost, m_sample.begin(), m_sample.end(), m_buffer.begin() + old_size);
+        Gpu::streamSynchronize();
+        m_buffer_steps.push_back(step+1);
+        m_buffer_times.push_back(warpx.gett_new(0));
+    }
+
+    // all the ranks have the same number of buffered samples
+    if (static_cast<int>(m_buffer_steps.size()) >= m_buffer_size)
+    {
+        FlushBuffers();
+    }
+}
+
+void FieldLineRecorder::FlushBuffers ()
+{
+    const int n_samples = static_cast<int>(m_buffer_steps.size());
+    if (n_samples == 0) return;
+
+    WARPX_PROFILE("FieldLineRecorder::FlushBuffers()");
+
+    const int n_procs = ParallelDescriptor::NProcs();
+    const int io_proc = ParallelDescriptor::IOProcessorNumber();
+    const bool is_io = ParallelDescriptor::IOProcessor();
+
+    // gather the ids of the points of each rank, then their buffered samples
+    int n_local = static_cast<int>(m_local_ids.size());
+    amrex::Vector<int> n_local_all(is_io ? n_procs : 0, 0);
+    ParallelDescriptor::Gather(&n_local, 1, n_local_all.data(), 1, io_proc);
+
+    amrex::Vector<int> ids_disp(is_io ? n_procs : 0, 0);
+    amrex::Vector<int> data_count(is_io ? n_procs : 0, 0);
+    amrex::Vector<int> data_disp(is_io ? n_procs : 0, 0);
+    const int n_fields = static_cast<int>(m_field_names.size());
+    int n_ids = 0;
+    int n_data = 0;
+    if (is_io)
+    {
+        for (int r = 0; r < n_procs; ++r)
+        {
+            ids_disp[r] = n_ids;
+            data_disp[r] = n_data;
+            data_count[r] = n_local_all[r] * n_samples * n_fields;
+            n_ids += n_local_all[r];
+            n_data += data_count[r];
+        }
+    }
+    amrex::Vector<int> ids_all(n_ids);
+    amrex::Vector<Real> data_all(n_data);
+    ParallelDescriptor::Gatherv(m_local_ids.data(), n_local,
+                                ids_all.data(), n_local_all, ids_disp, io_proc);
+    ParallelDescriptor::Gatherv(m_buffer.data(), static_cast<int>(m_buffer.size()),
+                                data_all.data(), data_count, data_disp, io_proc);
+
+    if (is_io)
+    {
+        // one record per sample: step, time, and the fields at each point, in the order of the points
+        const std::size_t record_size = 2 + m_points.size() * n_fields;
+        std::vector<double> records(record_size * n_samples, 0.);
+        for (int s = 0; s < n_samples; ++s)
+        {
+            double* const record = records.data() + s * record_size;
+            record[0] = static_cast<double>(m_buffer_steps[s]);
+            record[1] = static_cast<double>(m_buffer_times[s]);
+            for (int r = 0; r < n_procs; ++r)
+            {
+                Real const* const rank_sample = data_all.data() + data_disp[r]
+                                                + static_cast<std::size_t>(s) * n_local_all[r] * n_fields;
+                for (int j = 0; j < n_local_all[r]; ++j)
+                {
+                    const int id = ids_all[ids_disp[r] + j];
+                    for (int f = 0; f < n_fields; ++f)
+                    {
+                        record[2 + id * n_fields + f] = static_cast<double>(rank_sample[j * n_fields + f]);
+                    }
+                }
+            }
+        }
+
+        std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
+                          std::ofstream::out | std::ofstream::app | std::ofstream::binary};
+        ofs.write(reinterpret_cast<char const*>(records.data()),
+                  static_cast<std::streamsize>(records.size() * sizeof(double)));
+        ofs.close();
+    }
+
+    m_buffer.clear();
+    m_buffer_steps.clear();
+    m_buffer_times.clear();
+}
@@ -0,0 +1,135 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "LLGIterations.H"
+
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/TextMsg.H"
+#include "WarpX.H"
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+using namespace amrex;
+
+// constructor
+LLGIterations::LLGIterations (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if (defined WARPX_DIM_RZ) || !(defined WARPX_MAG_LLG)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "LLGIterations reduced diagnostics requires USE_LLG=TRUE and does not work for RZ coordinate.");
+#endif
+
+    ParmParse pp_rd_name(rd_name);
+    pp_rd_name.query("history_length", m_history_length);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_history_length >= 0,
+        "LLGIterations: history_length must be non-negative");
+
+    // number of calls, total/max/mean number of iterations, time per iteration, last residual, residual history
+    const int noutputs = 6 + m_history_length;
+    m_data.resize(noutputs, 0.0_rt);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]n_solves()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]total_iterations()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]max_iterations()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]mean_iterations()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time_per_iteration(s)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]last_residual()";
+            for (int i = 0; i < m_history_length; ++i)
+            {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]residual_iter" + std::to_string(i+1) + "()";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+// function that gathers the LLG iteration statistics
+void LLGIterations::ComputeDiags (int step)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    std::fill(m_data.begin(), m_data.end(), 0.0_rt);
+
+#if !(defined WARPX_DIM_RZ) && (defined WARPX_MAG_LLG)
+    // get a reference to WarpX instance
+    auto & warpx = WarpX::GetInstance();
+
+    int n_solves = 0;
+    int n_iter_total = 0;
+    int n_iter_max = 0;
+    Real iter_time = 0.0_rt;
+    // the residual history is the one of the last call on the finest level that ran the scheme
+    const Vector<Real>* last_residuals = nullptr;
+    for (int lev = 0; lev <= warpx.finestLevel(); ++lev)
+    {
+        FiniteDifferenceSolver* solver = warpx.get_pointer_fdtd_solver_fp(lev);
+        if (!solver) continue;
+        LLGIterationStats const& stats = solver->getLLGIterationStats();
+        n_solves += stats.n_solves;
+        n_iter_total += stats.n_iter_total;
+        n_iter_max = std::max(n_iter_max, stats.n_iter_max);
+        iter_time += stats.iter_time;
+        if (stats.n_solves > 0) last_residuals = &stats.last_residuals;
+    }
+    // the wall-clock time is the same on all ranks up to the load imbalance, report the max
+    ParallelDescriptor::ReduceRealMax(iter_time, ParallelDescriptor::IOProcessorNumber());
+
+    m_data[0] = n_solves;
+    m_data[1] = n_iter_total;
+    m_data[2] = n_iter_max;
+    m_data[3] = (n_solves > 0) ? Real(n_iter_total) / n_solves : 0.0_rt;
+    m_data[4] = (n_iter_total > 0) ? iter_time / n_iter_total : 0.0_rt;
+    m_data[5] = -1.0_rt;
+    if (last_residuals)
+    {
+        // the last iteration is always checked
+        if (!last_residuals->empty()) m_data[5] = last_residuals->back();
+        for (int i = 0; i < m_history_length; ++i)
+        {
+            m_data[6+i] = (i < static_cast<int>(last_residuals->size())) ? (*last_residuals)[i] : 0.0_rt;
+        }
+    }
+
+    // the statistics are accumulated between two outputs
+    for (int lev = 0; lev <= warpx.finestLevel(); ++lev)
+    {
+        FiniteDifferenceSolver* solver = warpx.get_pointer_fdtd_solver_fp(lev);
+        if (solver) solver->ResetLLGIterationStats();
+    }
+#endif
+}
@@ -7,6 +7,9 @@
 #include "LoadBalanceCosts.H"
 
 #include "Diagnostics/ReducedDiags/ReducedDiags.H"
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "FieldSolver/London/London.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Utils/IntervalsParser.H"
 #include "Utils/TextMsg.H"
@@ -118,6 +121,12 @@ void LoadBalanceCosts::ComputeDiags (int step)
         warpx.ComputeCostsHeuristic(costs);
     }
 
+    // the magnetic and superconducting columns of the material-aware cost model (level 0 only)
+#if defined(WARPX_MAG_LLG) && !defined(WARPX_DIM_RZ)
+    const bool has_llg = (WarpX::magnetic_model == MagneticModel::LLG);
+#endif
+    const bool has_london = (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon);
+
     // keep track of correct index in array over all boxes on all levels
     // shift index for m_data
     int shift_m_data = 0;
@@ -146,8 +155,22 @@ void LoadBalanceCosts::ComputeDiags (int step)
 #endif
             m_data[shift_m_data + mfi.index()*m_nDataFields + 6] = tbx.d_numPts(); // note: difference to volume
             m_data[shift_m_data + mfi.index()*m_nDataFields + 7] = countBoxMacroParticles(mfi, lev);
+#if defined(WARPX_MAG_LLG) && !defined(WARPX_DIM_RZ)
+            if (has_llg && lev == 0) {
+                MacroscopicProperties const& macroscopic = warpx.GetMacroscopicProperties();
+                if (macroscopic.is_magnetic_box(mfi)) {
+                    m_data[shift_m_data + mfi.index()*m_nDataFields + 8] = macroscopic.NumMagneticFaces(mfi);
+                    m_data[shift_m_data + mfi.index()*m_nDataFields + 9] =
+                        warpx.get_pointer_fdtd_solver_fp(lev)->LLGBoxUpdatesPerSolve(mfi.index());
+                }
+            }
+#endif
+            if (has_london && lev == 0) {
+                m_data[shift_m_data + mfi.index()*m_nDataFields + 10] =
+                    warpx.getLondon().NumSuperconductingEdges(mfi.index());
+            }
 #ifdef AMREX_USE_GPU
-            m_data[shift_m_data + mfi.index()*m_nDataFields + 8] = amrex::Gpu::Device::deviceId();
+            m_data[shift_m_data + mfi.index()*m_nDataFields + 11] = amrex::Gpu::Device::deviceId();
 #endif
             // ...
         }
@@ -222,13 +245,13 @@ void LoadBalanceCosts::ComputeDiags (int step)
     }
 
     /* m_data now contains up-to-date values for:
-     *  [[cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles(, gpu_ID [if GPU run]) ] of box 0 at level 0,
-     *   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles(, gpu_ID [if GPU run]) ] of box 1 at level 0,
-     *   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles(, gpu_ID [if GPU run]) ] of box 2 at level 0,
+     *  [[cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles, num_magnetic_faces,
+     *    llg_updates_per_solve, num_superconducting_edges(, gpu_ID [if GPU run]) ] of box 0 at level 0,
+     *   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles, num_magnetic_faces,
+     *    llg_updates_per_solve, num_superconducting_edges(, gpu_ID [if GPU run]) ] of box 1 at level 0,
      *   ...
-     *   [cost, proc, lev, i_low, j_low, k_low num_cells, num_macro_particles(, gpu_ID [if GPU run]) ] of box 0 at level 1,
-     *   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles(, gpu_ID [if GPU run]) ] of box 1 at level 1,
-     *   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles(, gpu_ID [if GPU run]) ] of box 2 at level 1,
+     *   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles, num_magnetic_faces,
+     *    llg_updates_per_solve, num_superconducting_edges(, gpu_ID [if GPU run]) ] of box 0 at level 1,
      *   ...]
      * and m_data_string contains:
      *  [hostname of box 0 at level 0,
@@ -292,8 +315,9 @@ void LoadBalanceCosts::WriteToFile (int step) const
         std::ofstream ofstmp(fileTmpName, std::ofstream::out);
 
         // write header row
-        // for each box on each level we saved 9(10) data fields:
-        //   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles(, gpu_ID_box), hostname]
+        // for each box on each level we saved 12(13) data fields:
+        //   [cost, proc, lev, i_low, j_low, k_low, num_cells, num_macro_particles, num_magnetic_faces,
+        //    llg_updates_per_solve, num_superconducting_edges(, gpu_ID_box), hostname]
         // nDataFieldsToWrite = below accounts for the Real data fields (m_nDataFields), then 1 string output to write
         int nDataFieldsToWrite = m_nDataFields + 1;
 
@@ -321,6 +345,12 @@ void LoadBalanceCosts::WriteToFile (int step) const
             ofstmp << "[" << c++ << "]num_cells_" + std::to_string(boxNumber) + "()";
             ofstmp << m_sep;
             ofstmp << "[" << c++ << "]num_macro_particles_" + std::to_string(boxNumber) + "()";
+            ofstmp << m_sep;
+            ofstmp << "[" << c++ << "]num_magnetic_faces_" + std::to_string(boxNumber) + "()";
+            ofstmp << m_sep;
+            ofstmp << "[" << c++ << "]llg_updates_per_solve_" + std::to_string(boxNumber) + "()";
+            ofstmp << m_sep;
+            ofstmp << "[" << c++ << "]num_superconducting_edges_" + std::to_string(boxNumber) + "()";
 #ifdef AMREX_USE_GPU
             ofstmp << m_sep;
             ofstmp << "[" << c++ << "]gpu_ID_box_" + std::to_string(boxNumber) + "()";
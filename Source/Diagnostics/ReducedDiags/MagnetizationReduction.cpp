@@ -0,0 +1,155 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "MagnetizationReduction.H"
+
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
+#include "FieldSolver/FiniteDifferenceSolver/LLGMagnetizationStats.H"
+#include "Utils/IntervalsParser.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "WarpX.H"
+
+#include <AMReX_Geometry.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Vector.H>
+
+#include <array>
+#include <fstream>
+#include <string>
+
+using namespace amrex;
+
+// constructor
+MagnetizationReduction::MagnetizationReduction (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if (defined WARPX_DIM_RZ) || !(defined WARPX_MAG_LLG)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "MagnetizationReduction reduced diagnostics requires USE_LLG=TRUE and does not work for RZ coordinate.");
+#endif
+
+    ParmParse pp_rd_name(rd_name);
+    pp_rd_name.query("in_kernel", m_in_kernel);
+
+    // average Mx, My, Mz, exchange/anisotropy/Zeeman energy, max drift, number of solves and M-updates
+    m_data.resize(9, 0.0_rt);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]Mx_avg(A/m)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]My_avg(A/m)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]Mz_avg(A/m)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]exchange_energy(J)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]anisotropy_energy(J)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]zeeman_energy(J)";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]max_M_drift()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]n_solves()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]n_updates()";
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+void MagnetizationReduction::InitData ()
+{
+#if !(defined WARPX_DIM_RZ) && (defined WARPX_MAG_LLG)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(WarpX::magnetic_model == MagneticModel::LLG,
+        "MagnetizationReduction reduced diagnostics requires algo.magnetic_model = llg");
+
+    auto & warpx = WarpX::GetInstance();
+    FiniteDifferenceSolver* solver = warpx.get_pointer_fdtd_solver_fp(0);
+    if (m_in_kernel && solver)
+    {
+        // the next step is istep+1
+        solver->RequestLLGMagnetizationStats(m_intervals.nextContains(warpx.getistep(0)));
+    }
+#endif
+}
+
+// function that reduces the statistics of M
+void MagnetizationReduction::ComputeDiags (int step)
+{
+#if !(defined WARPX_DIM_RZ) && (defined WARPX_MAG_LLG)
+    // get a reference to WarpX instance
+    auto & warpx = WarpX::GetInstance();
+    // the LLG solver only runs on level 0
+    FiniteDifferenceSolver* solver = warpx.get_pointer_fdtd_solver_fp(0);
+    if (!solver) return;
+
+    // the kernels of the next output step reduce its statistics
+    if (m_in_kernel) solver->RequestLLGMagnetizationStats(m_intervals.nextContains(step+1));
+
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // separate pass over M, unless the kernels of this step already reduced the statistics
+    if (!m_in_kernel || solver->LLGMagnetizationStatsStep() != step+1)
+    {
+        std::array<MultiFab*, 3> Mfield;
+        std::array<MultiFab*, 3> H_biasfield;
+        for (int i = 0; i < 3; ++i)
+        {
+            Mfield[i] = warpx.get_pointer_Mfield_fp(0, i);
+            H_biasfield[i] = warpx.get_pointer_H_biasfield_fp(0, i);
+        }
+        solver->ComputeLLGMagnetizationStats(Mfield, H_biasfield, warpx.Geom(0).periodicity(),
+                                             warpx.GetMacroscopicProperties(), step+1);
+    }
+
+    // all the sums, then the max drift, which is the last slot
+    Vector<Real> stats = solver->GetLLGMagnetizationStats();
+    ParallelDescriptor::ReduceRealSum(stats.data(), LLGMagnetizationStats::MaxDrift);
+    ParallelDescriptor::ReduceRealMax(stats[LLGMagnetizationStats::MaxDrift]);
+
+    // each of the three face orientations tiles the magnetic volume: a face is a third of a cell
+    const auto dx = warpx.Geom(0).CellSizeArray();
+    const Real dV = AMREX_D_TERM(dx[0], *dx[1], *dx[2]) / 3._rt;
+    const Real n_faces = stats[LLGMagnetizationStats::NFaces];
+    const Real inv_n_faces = (n_faces > 0._rt) ? 1._rt / n_faces : 0._rt;
+
+    m_data[0] = stats[LLGMagnetizationStats::SumMx] * inv_n_faces;
+    m_data[1] = stats[LLGMagnetizationStats::SumMy] * inv_n_faces;
+    m_data[2] = stats[LLGMagnetizationStats::SumMz] * inv_n_faces;
+    m_data[3] = stats[LLGMagnetizationStats::ExchangeEnergy] * dV;
+    m_data[4] = stats[LLGMagnetizationStats::AnisotropyEnergy] * dV;
+    m_data[5] = stats[LLGMagnetizationStats::ZeemanEnergy] * dV;
+    m_data[6] = stats[LLGMagnetizationStats::MaxDrift];
+
+    // the counts are the same on all ranks
+    m_data[7] = static_cast<Real>(solver->LLGSolveCount() - m_prev_solves);
+    m_data[8] = static_cast<Real>(solver->LLGUpdateCount() - m_prev_updates);
+    m_prev_solves = solver->LLGSolveCount();
+    m_prev_updates = solver->LLGUpdateCount();
+#else
+    amrex::ignore_unused(step);
+#endif
+}
@@ -7,24 +7,30 @@
 #include "MultiReducedDiags.H"
 
 #include "BeamRelevant.H"
+#include "FieldDFT.H"
 #include "FieldEnergy.H"
+#include "FieldLineRecorder.H"
 #include "FieldMaximum.H"
 #include "FieldProbe.H"
 #include "FieldMomentum.H"
 #include "FieldReduction.H"
+#include "LLGIterations.H"
 #include "LoadBalanceCosts.H"
 #include "LoadBalanceEfficiency.H"
+#include "MagnetizationReduction.H"
 #include "ParticleEnergy.H"
 #include "ParticleExtrema.H"
 #include "ParticleHistogram.H"
 #include "ParticleMomentum.H"
 #include "ParticleNumber.H"
+#include "PortReduction.H"
 #include "RhoMaximum.H"
 #include "RawEFieldReduction.H"
 #include "RawBFieldReduction.H"
 #include "Utils/IntervalsParser.H"
 #include "Utils/TextMsg.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "WarpX.H"
 
 #include <AMReX.H>
 #include <AMReX_ParallelDescriptor.H>
@@ -57,6 +63,8 @@ MultiReducedDiags::MultiReducedDiags ()
             {"FieldMomentum",         [](CS s){return std::make_unique<FieldMomentum>(s);}},
             {"FieldMaximum",          [](CS s){return std::make_unique<FieldMaximum>(s);}},
             {"FieldProbe",            [](CS s){return std::make_unique<FieldProbe>(s);}},
+            {"FieldLineRecorder",     [](CS s){return std::make_unique<FieldLineRecorder>(s);}},
+            {"FieldDFT",              [](CS s){return std::make_unique<FieldDFT>(s);}},
             {"FieldReduction",        [](CS s){return std::make_unique<FieldReduction>(s);}},
             {"RhoMaximum",            [](CS s){return std::make_unique<RhoMaximum>(s);}},
             {"BeamRelevant",          [](CS s){return std::make_unique<BeamRelevant>(s);}},
@@ -66,7 +74,10 @@ MultiReducedDiags::MultiReducedDiags ()
             {"ParticleNumber",        [](CS s){return std::make_unique<ParticleNumber>(s);}},
             {"ParticleExtrema",       [](CS s){return std::make_unique<ParticleExtrema>(s);}},
             {"RawEFieldReduction",    [](CS s){return std::make_unique<RawEFieldReduction>(s);}},
-            {"RawBFieldReduction",    [](CS s){return std::make_unique<RawBFieldReduction>(s);}}
+            {"RawBFieldReduction",    [](CS s){return std::make_unique<RawBFieldReduction>(s);}},
+            {"PortReduction",         [](CS s){return std::make_unique<PortReduction>(s);}},
+            {"LLGIterations",         [](CS s){return std::make_unique<LLGIterations>(s);}},
+            {"MagnetizationReduction",[](CS s){return std::make_unique<MagnetizationReduction>(s);}}
         };
     // loop over all reduced diags and fill m_multi_rd with requested reduced diags
     std::transform(m_rd_names.begin(), m_rd_names.end(), std::back_inserter(m_multi_rd),
@@ -105,11 +116,40 @@ void MultiReducedDiags::LoadBalance () {
     }
 }
 
+void MultiReducedDiags::FlushBuffers () {
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd] -> FlushBuffers();
+    }
+}
+
+void MultiReducedDiags::WriteCheckpointData (const std::string& dir) const {
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd] -> WriteCheckpointData(dir);
+    }
+}
+
+void MultiReducedDiags::ReadCheckpointData (const std::string& dir) {
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd] -> ReadCheckpointData(dir);
+    }
+}
+
 // call functions to compute diags
 void MultiReducedDiags::ComputeDiags (int step)
 {
     WARPX_PROFILE("MultiReducedDiags::ComputeDiags()");
 
+#if (defined WARPX_MAG_LLG) && !(defined WARPX_DIM_RZ)
+    // B is read by FieldEnergy, FieldProbe, FieldDFT, ...
+    WarpX::GetInstance().SyncLLGBfield();
+#endif
+
     // loop over all reduced diags
     for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
     {
@@ -0,0 +1,274 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "PortReduction.H"
+
+#include "Utils/IntervalsParser.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/WarpXUtil.H"
+
+#include <AMReX_Box.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_IntVect.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+#if defined(WARPX_DIM_3D)
+namespace
+{
+    /** Tolerance on the positions that fall on a node or a cell center, in cell sizes */
+    constexpr Real tol = 1.e-6_rt;
+
+    Real Index (Geometry const& geom, int dir, Real x)
+    {
+        return (x - geom.ProbLo(dir)) * geom.InvCellSize(dir);
+    }
+    /** First and last nodes in [x0, x1] */
+    int FirstNode (Geometry const& geom, int dir, Real x0) { return static_cast<int>(std::ceil(Index(geom, dir, x0) - tol)); }
+    int LastNode (Geometry const& geom, int dir, Real x1) { return static_cast<int>(std::floor(Index(geom, dir, x1) + tol)); }
+    /** First and last cells whose centers are in [x0, x1] */
+    int FirstCell (Geometry const& geom, int dir, Real x0) { return static_cast<int>(std::ceil(Index(geom, dir, x0) - 0.5_rt - tol)); }
+    int LastCell (Geometry const& geom, int dir, Real x1) { return static_cast<int>(std::floor(Index(geom, dir, x1) - 0.5_rt + tol)); }
+    /** Node nearest to x, and cell that contains x */
+    int NearestNode (Geometry const& geom, int dir, Real x) { return static_cast<int>(std::lround(Index(geom, dir, x))); }
+    int ContainingCell (Geometry const& geom, int dir, Real x) { return static_cast<int>(std::floor(Index(geom, dir, x) + tol)); }
+
+    int GetDirection (amrex::ParmParse const& pp, std::string const& port, std::string const& key)
+    {
+        std::string dir_string;
+        pp.get(key.c_str(), dir_string);
+        if (dir_string == "x" || dir_string == "X") return 0;
+        if (dir_string == "y" || dir_string == "Y") return 1;
+        if (dir_string == "z" || dir_string == "Z") return 2;
+        amrex::Abort(Utils::TextMsg::Err(
+            "PortReduction: " + key + " of port " + port + " must be x, y or z"));
+        return -1;
+    }
+
+    std::array<Real, 3> GetPoint (amrex::ParmParse const& pp, std::string const& key)
+    {
+        std::vector<Real> v;
+        getArrWithParser(pp, key.c_str(), v, 0, 3);
+        return {v[0], v[1], v[2]};
+    }
+}
+#endif
+
+// constructor
+PortReduction::PortReduction (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+#if !defined(WARPX_DIM_3D)
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(false,
+        "PortReduction reduced diagnostics only works in 3D.");
+#endif
+
+    ParmParse pp_rd_name(rd_name);
+    std::vector<std::string> port_names;
+    pp_rd_name.getarr("port_names", port_names);
+
+    std::vector<std::string> columns;
+    for (auto const& name : port_names)
+    {
+        AddPort(name, columns);
+    }
+    m_data.resize(m_engine.NOutputs(), 0._rt);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << c++ << "]step()";
+            ofs << m_sep;
+            ofs << "[" << c++ << "]time(s)";
+            for (auto const& column : columns)
+            {
+                ofs << m_sep;
+                ofs << "[" << c++ << "]" << column;
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+void PortReduction::AddPort (std::string const& name, std::vector<std::string>& columns)
+{
+#if defined(WARPX_DIM_3D)
+    ParmParse pp_port(m_rd_name + "." + name);
+
+    // without the LLG model, H = B / mu0
+    const bool has_h = FieldIntegralEngine::HasH();
+    const Real h_scale = has_h ? 1._rt : 1._rt / PhysConst::mu0;
+    auto h_field = [has_h] (int dir) {
+        return has_h ? FieldIntegralEngine::H(dir) : FieldIntegralEngine::B(dir);
+    };
+
+    // voltage: V = phi(start) - phi(end), integral of E along the edges of a grid line
+    if (pp_port.contains("voltage_start"))
+    {
+        const auto start = GetPoint(pp_port, "voltage_start");
+        const auto end = GetPoint(pp_port, "voltage_end");
+        int dir = -1;
+        for (int idim = 0; idim < 3; ++idim)
+        {
+            if (start[idim] != end[idim])
+            {
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(dir < 0,
+                    "PortReduction: the voltage line of port " + name + " must be along x, y or z");
+                dir = idim;
+            }
+        }
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(dir >= 0,
+            "PortReduction: the voltage line of port " + name + " has a zero length");
+        const Real lo = std::min(start[dir], end[dir]);
+        const Real hi = std::max(start[dir], end[dir]);
+        const Real sign = (end[dir] > start[dir]) ? 1._rt : -1._rt;
+
+        const int out = m_engine.AddOutput();
+        m_engine.AddTerm(out, FieldIntegralEngine::E(dir),
+            [=] (Geometry const& geom, IndexType) {
+                IntVect a, b;
+                for (int idim = 0; idim < 3; ++idim) {
+                    a[idim] = b[idim] = NearestNode(geom, idim, start[idim]);
+                }
+                a[dir] = FirstCell(geom, dir, lo);
+                b[dir] = LastCell(geom, dir, hi);
+                return Box(a, b);
+            },
+            [=] (Geometry const& geom) {
+                return sign * geom.CellSize(dir);
+            });
+        columns.push_back(name + "_V(V)");
+    }
+
+    // current: loop integral of H, counterclockwise around the normal, on the dual edges
+    // around the nodes of the rectangle
+    if (pp_port.contains("current_normal"))
+    {
+        const int n = GetDirection(pp_port, name, "current_normal");
+        const int t1 = (n+1) % 3;
+        const int t2 = (n+2) % 3;
+        const auto lo = GetPoint(pp_port, "current_lo");
+        const auto hi = GetPoint(pp_port, "current_hi");
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(lo[n] == hi[n],
+            "PortReduction: the current rectangle of port " + name + " must be normal to current_normal");
+
+        const int out = m_engine.AddOutput();
+        // sides along t1, at the lower and upper bounds in t2, then sides along t2
+        for (int side = 0; side < 2; ++side)
+        {
+            const bool upper = (side == 1);
+            m_engine.AddTerm(out, h_field(t1),
+                [=] (Geometry const& geom, IndexType) {
+                    IntVect a, b;
+                    a[n] = b[n] = ContainingCell(geom, n, lo[n]);
+                    a[t1] = FirstNode(geom, t1, lo[t1]);
+                    b[t1] = LastNode(geom, t1, hi[t1]);
+                    a[t2] = b[t2] = upper ? LastNode(geom, t2, hi[t2]) : FirstNode(geom, t2, lo[t2]) - 1;
+                    return Box(a, b);
+                },
+                [=] (Geometry const& geom) {
+                    return (upper ? -1._rt : 1._rt) * h_scale * geom.CellSize(t1);
+                });
+            m_engine.AddTerm(out, h_field(t2),
+                [=] (Geometry const& geom, IndexType) {
+                    IntVect a, b;
+                    a[n] = b[n] = ContainingCell(geom, n, lo[n]);
+                    a[t1] = b[t1] = upper ? LastNode(geom, t1, hi[t1]) : FirstNode(geom, t1, lo[t1]) - 1;
+                    a[t2] = FirstNode(geom, t2, lo[t2]);
+                    b[t2] = LastNode(geom, t2, hi[t2]);
+                    return Box(a, b);
+                },
+                [=] (Geometry const& geom) {
+                    return (upper ? 1._rt : -1._rt) * h_scale * geom.CellSize(t2);
+                });
+        }
+        columns.push_back(name + "_I(A)");
+    }
+
+    // power: flux of E x H through the rectangle, along the normal, on the plane of nodes
+    // nearest to it; H is averaged over the two faces around the plane
+    if (pp_port.contains("power_normal"))
+    {
+        const int n = GetDirection(pp_port, name, "power_normal");
+        const int t1 = (n+1) % 3;
+        const int t2 = (n+2) % 3;
+        const auto lo = GetPoint(pp_port, "power_lo");
+        const auto hi = GetPoint(pp_port, "power_hi");
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(lo[n] == hi[n],
+            "PortReduction: the power rectangle of port " + name + " must be normal to power_normal");
+
+        const int out = m_engine.AddOutput();
+        // S_n = E_t1 H_t2 - E_t2 H_t1
+        for (int term = 0; term < 2; ++term)
+        {
+            const int e_dir = (term == 0) ? t1 : t2;
+            const int h_dir = (term == 0) ? t2 : t1;
+            const Real sign = (term == 0) ? 1._rt : -1._rt;
+            m_engine.AddTerm(out, FieldIntegralEngine::E(e_dir),
+                [=] (Geometry const& geom, IndexType) {
+                    IntVect a, b;
+                    a[n] = b[n] = NearestNode(geom, n, lo[n]);
+                    a[e_dir] = FirstCell(geom, e_dir, lo[e_dir]);
+                    b[e_dir] = LastCell(geom, e_dir, hi[e_dir]);
+                    a[h_dir] = FirstNode(geom, h_dir, lo[h_dir]);
+                    b[h_dir] = LastNode(geom, h_dir, hi[h_dir]);
+                    return Box(a, b);
+                },
+                [=] (Geometry const& geom) {
+                    return sign * h_scale * geom.CellSize(t1) * geom.CellSize(t2);
+                },
+                h_field(h_dir), n);
+        }
+        columns.push_back(name + "_P(W)");
+    }
+
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!columns.empty() && columns.back().rfind(name + "_", 0) == 0,
+        "PortReduction: port " + name + " needs voltage_start, current_normal or power_normal");
+#else
+    amrex::ignore_unused(name, columns);
+#endif
+}
+
+void PortReduction::InitData ()
+{
+    m_engine.Build();
+}
+
+void PortReduction::LoadBalance ()
+{
+    // called at every step: only act when the grids changed
+    if (m_engine.NeedsRebuild()) m_engine.Build();
+}
+
+void PortReduction::ComputeDiags (int step)
+{
+    // Judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    amrex::Vector<amrex::Real> values;
+    m_engine.Evaluate(values);
+    m_data.assign(values.begin(), values.end());
+}
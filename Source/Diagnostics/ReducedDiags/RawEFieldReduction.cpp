@@ -13,10 +13,12 @@
 
 #include <AMReX_Algorithm.H>
 #include <AMReX_BLassert.H>
+#include <AMReX_Geometry.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Vector.H>
 
 #include <algorithm>
+#include <iterator>
 #include <ostream>
 
 #include <regex>
@@ -33,13 +35,6 @@ RawEFieldReduction::RawEFieldReduction (std::string rd_name)
         "RawEFieldReduction reduced diagnostics does not work for RZ coordinate.");
 #endif
 
-    // read number of levels
-    int nLevel = 0;
-    amrex::ParmParse pp_amr("amr");
-    pp_amr.query("max_level", nLevel);
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nLevel == 0,
-        "RawEFieldReduction reduced diagnostics does not work with mesh refinement.");
-
     constexpr int noutputs = 3; // Three outputs in the Raw Efield reduction diagnostic (Ex, Ey, Ez)
     // resize data array
     m_data.resize(noutputs, 0.0_rt);
@@ -88,6 +83,38 @@ RawEFieldReduction::RawEFieldReduction (std::string rd_name)
         AMREX_ASSERT(m_scaling_factor.size() == AMREX_SPACEDIM);
     }
 
+    if (m_reduction_type == ReductionType::Sum)
+    {
+        // the integrals are weighted sums over the edges, in boxes trimmed once per grid
+        // layout to the edges where the parser is nonzero
+        const int integral_type = m_integral_type;
+        const std::vector<int> surface_normal(std::begin(m_surface_normal), std::end(m_surface_normal));
+        for (int dir = 0; dir < 3; ++dir)
+        {
+#if (AMREX_SPACEDIM==2)
+            const amrex::Real scaling_factor = (dir == 0) ? m_scaling_factor[0] :
+                                               (dir == 2) ? m_scaling_factor[1] : 1._rt;
+#else
+            const amrex::Real scaling_factor = m_scaling_factor[dir];
+#endif
+            const int out = m_engine.AddOutput();
+            m_engine.AddParserTerm(out, FieldIntegralEngine::E(dir), *m_parser,
+                [=] (amrex::Geometry const& geom) -> amrex::Real {
+                    const auto dx = geom.CellSizeArray();
+                    // multiply the sum by the cell volume, or by the cell face area
+                    if (integral_type == IntegrationType::Volume) {
+                        return AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+                    }
+#if (AMREX_SPACEDIM==2)
+                    return scaling_factor * (surface_normal[0]*dx[1] + surface_normal[1]*dx[0]);
+#else
+                    return scaling_factor * (surface_normal[0]*dx[1]*dx[2] + surface_normal[1]*dx[2]*dx[0]
+                                             + surface_normal[2]*dx[0]*dx[1]);
+#endif
+                });
+        }
+    }
+
     if (amrex::ParallelDescriptor::IOProcessor())
     {
         if ( m_IsNotRestart )
@@ -126,6 +153,19 @@ void RawEFieldReduction::ComputeDiags (int step)
     }
     else if (m_reduction_type == ReductionType::Sum)
     {
-        ComputeRawEFieldReduction<amrex::ReduceOpSum>();
+        amrex::Vector<amrex::Real> values;
+        m_engine.Evaluate(values);
+        m_data.assign(values.begin(), values.end());
     }
 }
+
+void RawEFieldReduction::InitData ()
+{
+    if (m_reduction_type == ReductionType::Sum) { m_engine.Build(); }
+}
+
+void RawEFieldReduction::LoadBalance ()
+{
+    // called at every step: only act when the grids changed
+    if (m_reduction_type == ReductionType::Sum && m_engine.NeedsRebuild()) { m_engine.Build(); }
+}
@@ -0,0 +1,70 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "RawFields.H"
+
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "WarpX.H"
+
+#include <AMReX.H>
+
+#include <array>
+#include <string>
+
+amrex::MultiFab const*
+RawFields::Get (std::string const& name, int lev, int& comp, std::string const& caller)
+{
+    auto & warpx = WarpX::GetInstance();
+    comp = 0;
+    if (name == "Ex") return warpx.get_pointer_Efield_fp(lev, 0);
+    if (name == "Ey") return warpx.get_pointer_Efield_fp(lev, 1);
+    if (name == "Ez") return warpx.get_pointer_Efield_fp(lev, 2);
+    if (name == "Bx") return warpx.get_pointer_Bfield_fp(lev, 0);
+    if (name == "By") return warpx.get_pointer_Bfield_fp(lev, 1);
+    if (name == "Bz") return warpx.get_pointer_Bfield_fp(lev, 2);
+    if (name == "jx") return warpx.get_pointer_current_fp(lev, 0);
+    if (name == "jy") return warpx.get_pointer_current_fp(lev, 1);
+    if (name == "jz") return warpx.get_pointer_current_fp(lev, 2);
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG)
+    {
+        if (name == "Hx") return warpx.get_pointer_Hfield_fp(lev, 0);
+        if (name == "Hy") return warpx.get_pointer_Hfield_fp(lev, 1);
+        if (name == "Hz") return warpx.get_pointer_Hfield_fp(lev, 2);
+        // Mi_jface is the component i of M, stored on the j faces
+        std::array<std::string, 3> const comps = {"Mx", "My", "Mz"};
+        std::array<std::string, 3> const faces = {"_xface", "_yface", "_zface"};
+        for (int icomp = 0; icomp < 3; ++icomp) {
+            for (int iface = 0; iface < 3; ++iface) {
+                if (name == comps[icomp] + faces[iface]) {
+                    comp = icomp;
+                    return warpx.get_pointer_Mfield_fp(lev, iface);
+                }
+            }
+        }
+    }
+#endif
+    amrex::Abort(Utils::TextMsg::Err(
+        caller + ": field '" + name + "' is not supported. Valid fields are "
+        "Ex Ey Ez Bx By Bz jx jy jz, and with algo.magnetic_model = llg Hx Hy Hz and Mx_xface ... Mz_zface."));
+    return nullptr;
+}
+
+amrex::Vector<int> const*
+RawFields::BoxIndex (std::string const& name, int lev)
+{
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG && name.size() == 8 && name[0] == 'M')
+    {
+        return &WarpX::GetInstance().getMagneticBoxIndex(lev);
+    }
+#else
+    amrex::ignore_unused(name, lev);
+#endif
+    return nullptr;
+}
@@ -79,6 +79,26 @@ void ReducedDiags::LoadBalance ()
     // load balancing operations
 }
 
+void ReducedDiags::FlushBuffers ()
+{
+    // Defines an empty function FlushBuffers() to be overwritten if needed.
+    // Function used by the diagnostics that write their data in chunks,
+    // so that the output is complete at checkpoints and at the end of the run
+}
+
+void ReducedDiags::WriteCheckpointData (const std::string& /*dir*/) const
+{
+    // Defines an empty function WriteCheckpointData() to be overwritten if needed.
+    // Function used by the diagnostics that accumulate data over the run,
+    // so that a restart continues the accumulation
+}
+
+void ReducedDiags::ReadCheckpointData (const std::string& /*dir*/)
+{
+    // Defines an empty function ReadCheckpointData() to be overwritten if needed.
+    // Function used to restore the data written by WriteCheckpointData()
+}
+
 void ReducedDiags::BackwardCompatibility ()
 {
     amrex::ParmParse pp_rd_name(m_rd_name);
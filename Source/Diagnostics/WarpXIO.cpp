@@ -16,6 +16,7 @@
 #include "Parallelization/WarpXCommUtil.H"
 #include "Utils/CoarsenIO.H"
 #include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 
@@ -235,7 +236,9 @@ WarpX::InitFromCheckpoint ()
             Efield_fp[lev][i]->setVal(0.0);
             Bfield_fp[lev][i]->setVal(0.0);
 #ifdef WARPX_MAG_LLG
-            Mfield_fp[lev][i]->setVal(0.0);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                Mfield_fp[lev][i]->setVal(0.0);
+            }
 #endif
         }
 
@@ -243,14 +246,13 @@ WarpX::InitFromCheckpoint ()
             for (int i = 0; i < 3; ++i) {
                 Efield_aux[lev][i]->setVal(0.0);
                 Bfield_aux[lev][i]->setVal(0.0);
-#ifdef WARPX_MAG_LLG
-                Mfield_aux[lev][i]->setVal(0.0);
-#endif
                 current_cp[lev][i]->setVal(0.0);
                 Efield_cp[lev][i]->setVal(0.0);
                 Bfield_cp[lev][i]->setVal(0.0);
 #ifdef WARPX_MAG_LLG
-                Mfield_cp[lev][i]->setVal(0.0);
+                if (WarpX::magnetic_model == MagneticModel::LLG) {
+                    Mfield_cp[lev][i]->setVal(0.0);
+                }
 #endif
             }
         }
@@ -270,24 +272,28 @@ WarpX::InitFromCheckpoint ()
                     amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_fp"));
 
 #ifdef WARPX_MAG_LLG
-        VisMF::Read(*Hfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_fp"));
-        VisMF::Read(*Hfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_fp"));
-        VisMF::Read(*Hfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_fp"));
-        VisMF::Read(*Mfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_fp"));
-        VisMF::Read(*Mfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_fp"));
-        VisMF::Read(*Mfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_fp"));
-        VisMF::Read(*H_biasfield_fp[lev][0],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_fp"));
-        VisMF::Read(*H_biasfield_fp[lev][1],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_fp"));
-        VisMF::Read(*H_biasfield_fp[lev][2],
-                    amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_fp"));
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            VisMF::Read(*Hfield_fp[lev][0],
+                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_fp"));
+            VisMF::Read(*Hfield_fp[lev][1],
+                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_fp"));
+            VisMF::Read(*Hfield_fp[lev][2],
+                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_fp"));
+            // M is checkpointed on the magnetic boxes only (see WarpX::CompactMfield), which are
+            // not known yet: it is copied to all the boxes, and zero on the others, until InitData
+            const std::array<std::string, 3> M_names = {"Mx_fp", "My_fp", "Mz_fp"};
+            for (int i = 0; i < 3; ++i) {
+                MultiFab M_chk;
+                VisMF::Read(M_chk, amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, M_names[i]));
+                Mfield_fp[lev][i]->ParallelCopy(M_chk, 0, 0, Mfield_fp[lev][i]->nComp());
+            }
+            VisMF::Read(*H_biasfield_fp[lev][0],
+                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_fp"));
+            VisMF::Read(*H_biasfield_fp[lev][1],
+                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_fp"));
+            VisMF::Read(*H_biasfield_fp[lev][2],
+                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_fp"));
+        }
 #endif
         if (WarpX::fft_do_time_averaging)
         {
@@ -332,26 +338,28 @@ WarpX::InitFromCheckpoint ()
                         amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Bz_cp"));
 
 #ifdef WARPX_MAG_LLG
-            VisMF::Read(*Hfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_cp"));
-            VisMF::Read(*Hfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_cp"));
-            VisMF::Read(*Hfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_cp"));
-
-            VisMF::Read(*Mfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_cp"));
-            VisMF::Read(*Mfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_cp"));
-            VisMF::Read(*Mfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_cp"));
-
-            VisMF::Read(*H_biasfield_cp[lev][0],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_cp"));
-            VisMF::Read(*H_biasfield_cp[lev][1],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_cp"));
-            VisMF::Read(*H_biasfield_cp[lev][2],
-                        amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_cp"));
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                VisMF::Read(*Hfield_cp[lev][0],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hx_cp"));
+                VisMF::Read(*Hfield_cp[lev][1],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hy_cp"));
+                VisMF::Read(*Hfield_cp[lev][2],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hz_cp"));
+
+                VisMF::Read(*Mfield_cp[lev][0],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mx_cp"));
+                VisMF::Read(*Mfield_cp[lev][1],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "My_cp"));
+                VisMF::Read(*Mfield_cp[lev][2],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Mz_cp"));
+
+                VisMF::Read(*H_biasfield_cp[lev][0],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hxbias_cp"));
+                VisMF::Read(*H_biasfield_cp[lev][1],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hybias_cp"));
+                VisMF::Read(*H_biasfield_cp[lev][2],
+                            amrex::MultiFabFileFullPrefix(lev, restart_chkfile, level_prefix, "Hzbias_cp"));
+            }
 #endif
             if (WarpX::fft_do_time_averaging)
             {
@@ -126,13 +126,14 @@ WarpX::Evolve (int numsteps)
             if (do_electrostatic == ElectrostaticSolverAlgo::None) {
                 // Not called at each iteration, so exchange all guard cells
                 FillBoundaryE(guard_cells.ng_alloc_EB);
-#ifndef WARPX_MAG_LLG
-                FillBoundaryB(guard_cells.ng_alloc_EB);
-#endif
+                if (WarpX::magnetic_model == MagneticModel::LLG) {
 #ifdef WARPX_MAG_LLG
-                FillBoundaryH(guard_cells.ng_alloc_EB);
-                FillBoundaryM(guard_cells.ng_alloc_EB);
+                    FillBoundaryH(guard_cells.ng_alloc_EB);
+                    FillBoundaryM(guard_cells.ng_alloc_EB);
 #endif
+                } else {
+                    FillBoundaryB(guard_cells.ng_alloc_EB);
+                }
                 UpdateAuxilaryData();
                 FillBoundaryAux(guard_cells.ng_UpdateAux);
             }
@@ -154,14 +155,20 @@ WarpX::Evolve (int numsteps)
                 // Particles have p^{n-1/2} and x^{n}.
 
                 // E and B are up-to-date inside the domain only
-                FillBoundaryE(guard_cells.ng_FieldGather);
-#ifndef WARPX_MAG_LLG
-                FillBoundaryB(guard_cells.ng_FieldGather);
-#endif
+                // (in the deep-halo mode, the field updates exchange the halo when they need it)
+                if (!m_deep_halo.SkipsExchange(1)) {
+                    FillBoundaryE(guard_cells.ng_FieldGather);
+                }
+                if (WarpX::magnetic_model == MagneticModel::LLG) {
 #ifdef WARPX_MAG_LLG
-                FillBoundaryH(guard_cells.ng_FieldGather);
-                FillBoundaryM(guard_cells.ng_FieldGather);
+                    if (!m_deep_halo.SkipsExchange(2)) {
+                        FillBoundaryH(guard_cells.ng_FieldGather);
+                        FillBoundaryM(guard_cells.ng_FieldGather);
+                    }
 #endif
+                } else if (!m_deep_halo.SkipsExchange(1)) {
+                    FillBoundaryB(guard_cells.ng_FieldGather);
+                }
                 // E and B: enough guard cells to update Aux or call Field Gather in fp and cp
                 // Need to update Aux on lower levels, to interpolate to higher levels.
                 if (fft_do_time_averaging)
@@ -269,6 +276,9 @@ WarpX::Evolve (int numsteps)
         if (do_back_transformed_diagnostics) {
             std::unique_ptr<MultiFab> cell_centered_data = nullptr;
             if (WarpX::do_back_transformed_fields) {
+#if (defined WARPX_MAG_LLG) && !(defined WARPX_DIM_RZ)
+                SyncLLGBfield();
+#endif
                 cell_centered_data = GetCellCenteredData();
             }
             myBFD->writeLabFrameData(cell_centered_data.get(), *mypc, geom[0], cur_time, dt[0]);
@@ -353,6 +363,8 @@ WarpX::Evolve (int numsteps)
             reduced_diags->LoadBalance();
             reduced_diags->ComputeDiags(step);
             reduced_diags->WriteToFile(step);
+            // the buffered reduced diags data is written before a checkpoint they can restart from
+            if (multi_diags->DoCheckpoint(step)) reduced_diags->FlushBuffers();
         }
         multi_diags->FilterComputePackFlush( step );
 
@@ -387,6 +399,8 @@ WarpX::Evolve (int numsteps)
 
         // End loop on time steps
     }
+    m_deep_halo.PrintReport();
+    if (reduced_diags->m_plot_rd != 0) reduced_diags->FlushBuffers();
     multi_diags->FilterComputePackFlushLastTimestep( istep[0] );
 
     if (do_back_transformed_diagnostics) {
@@ -413,15 +427,15 @@ WarpX::OneStep_nosub (Real cur_time)
     if (WarpX::yee_coupled_solver_algo != CoupledYeeSolver::MaxwellLondon) {
         PushParticlesandDepose(cur_time);
     }
-#ifndef WARPX_MAG_LLG
     if (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
-        amrex::Print() << " in evolve london j\n";
-        m_london->EvolveLondonJ(dt[0]); // J^(n-1/2) to J^(n+1/2) using E^(n)
-        EvolveBLondon(0.5_rt * dt[0], DtType::FirstHalf); // We now have B^{n+1/2}
+        // J^(n-1/2) to J^(n+1/2) using E^(n), and B^{n+1/2} from J^(n+1/2), in one pass
+        // With the LLG model, this is done before the first half H/M update, which also reads E^(n):
+        // the superconductor is non-magnetic, so H is advanced there with curl E / mu as in the
+        // rest of the non-magnetic medium, and the E update below reads curl H^(n+1/2) - J^(n+1/2)
+        EvolveBLondon(dt[0], DtType::FirstHalf);
         FillBoundaryJ(guard_cells.ng_alloc_EB);
         // fill boundary here
     }
-#endif
 
     ExecutePythonCallback("afterdeposition");
 
@@ -496,34 +510,25 @@ WarpX::OneStep_nosub (Real cur_time)
         EvolveG(0.5_rt * dt[0], DtType::FirstHalf);
         FillBoundaryF(guard_cells.ng_FieldSolverF);
         FillBoundaryG(guard_cells.ng_FieldSolverG);
-#ifndef WARPX_MAG_LLG
-        EvolveB(0.5_rt * dt[0], DtType::FirstHalf); // We now have B^{n+1/2}
-        FillBoundaryB(guard_cells.ng_FieldSolver);
-        // ApplyExternalFieldExcitation
-        ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::FirstHalf); // apply B external excitation; soft source to be fixed
-#endif
-
-#ifdef WARPX_MAG_LLG
-#ifndef WARPX_DIM_RZ
-        if (WarpX::em_solver_medium == MediumForEM::Macroscopic) { //evolveM is not applicable to vacuum
-            if (mag_time_scheme_order==1){
-                MacroscopicEvolveHM(0.5*dt[0]); // we now have M^{n+1/2} and H^{n+1/2}
-            } else if (mag_time_scheme_order==2){
-                MacroscopicEvolveHM_2nd(0.5*dt[0]); // we now have M^{n+1/2} and H^{n+1/2}
-            } else {
-                amrex::Abort("unsupported mag_time_scheme_order for M field");
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+#if (defined WARPX_MAG_LLG) && !(defined WARPX_DIM_RZ)
+            // The LLG model requires a macroscopic medium, which is checked in ReadParameters
+            MacroscopicEvolveHMSubsteps(0.5_rt*dt[0]); // we now have M^{n+1/2} and H^{n+1/2}
+            if (!m_deep_halo.SkipsExchange(2)) {
+                FillBoundaryH(guard_cells.ng_FieldSolver);
+                FillBoundaryM(guard_cells.ng_FieldSolver);
             }
-            FillBoundaryH(guard_cells.ng_FieldSolver);
-            FillBoundaryM(guard_cells.ng_FieldSolver);
             // ApplyExternalFieldExcitation
             ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal, DtType::FirstHalf); // apply H external excitation; soft source to be fixed
             ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HbiasfieldExternal, DtType::FirstHalf); // apply H external excitation; soft source to be fixed
-
+#endif
         } else {
-            amrex::Abort("unsupported em_solver_medium for M field");
+            EvolveB(0.5_rt * dt[0], DtType::FirstHalf); // We now have B^{n+1/2}
+            if (!m_deep_halo.SkipsExchange(1)) FillBoundaryB(guard_cells.ng_FieldSolver);
+            // ApplyExternalFieldExcitation
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::FirstHalf); // apply B external excitation; soft source to be fixed
         }
-#endif // ifndef WARPX_DIM_RZ
-#endif
+
         if (WarpX::em_solver_medium == MediumForEM::Vacuum) {
             // vacuum medium
             EvolveE(dt[0]); // We now have E^{n+1}
@@ -534,7 +539,7 @@ WarpX::OneStep_nosub (Real cur_time)
             amrex::Abort(Utils::TextMsg::Err("Medium for EM is unknown"));
         }
 
-        FillBoundaryE(guard_cells.ng_FieldSolver);
+        if (!m_deep_halo.SkipsExchange(1)) FillBoundaryE(guard_cells.ng_FieldSolver);
         // ApplyExternalFieldExcitation
         ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternal); // apply E external excitation; soft source to be fixed
         if (WarpX::ApplyExcitationInPML == 1) {
@@ -544,31 +549,9 @@ WarpX::OneStep_nosub (Real cur_time)
 
         EvolveF(0.5_rt * dt[0], DtType::SecondHalf);
         EvolveG(0.5_rt * dt[0], DtType::SecondHalf);
-#ifndef WARPX_MAG_LLG
-        EvolveB(0.5_rt * dt[0], DtType::SecondHalf); // We now have B^{n+1}
-
-        // Synchronize E and B fields on nodal points
-        NodalSync(Efield_fp, Efield_cp);
-        NodalSync(Bfield_fp, Bfield_cp);
-        // E and B are up-to-date in the domain, but all guard cells are
-        // outdated.
-        if (safe_guard_cells) {
-            FillBoundaryB(guard_cells.ng_alloc_EB);
-        }
-        // ApplyExternalFieldExcitation
-        ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::SecondHalf); // redundant for hs; need to fix the way to increment ss
-#endif
-
-#ifdef WARPX_MAG_LLG
-#ifndef WARPX_DIM_RZ
-        if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
-            if (mag_time_scheme_order==1){
-                MacroscopicEvolveHM(0.5*dt[0]); // we now have M^{n+1} and H^{n+1}
-            } else if (mag_time_scheme_order==2){
-                MacroscopicEvolveHM_2nd(0.5*dt[0]); // we now have M^{n+1} and H^{n+1}
-            } else {
-                amrex::Abort("unsupported mag_time_scheme_order for M field");
-            }
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+#if (defined WARPX_MAG_LLG) && !(defined WARPX_DIM_RZ)
+            MacroscopicEvolveHMSubsteps(0.5_rt*dt[0]); // we now have M^{n+1} and H^{n+1}
             // H and M are up-to-date in the domain, but all guard cells are
             // outdated.
             if ( safe_guard_cells ){
@@ -578,23 +561,34 @@ WarpX::OneStep_nosub (Real cur_time)
             // ApplyExternalFieldExcitation
             ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal, DtType::SecondHalf); // redundant for hs; need to fix the way to increment ss
             ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HbiasfieldExternal, DtType::SecondHalf); // apply H external excitation; soft source to be fixed
-        }
-        else {
-            amrex::Abort("unsupported em_solver_medium for M field");
-        }
-#endif // ifndef WARPX_DIM_RZ
 #endif
+        } else {
+            EvolveB(0.5_rt * dt[0], DtType::SecondHalf); // We now have B^{n+1}
+
+            // Synchronize E and B fields on nodal points
+            NodalSync(Efield_fp, Efield_cp);
+            NodalSync(Bfield_fp, Bfield_cp);
+            // E and B are up-to-date in the domain, but all guard cells are
+            // outdated.
+            if (safe_guard_cells) {
+                FillBoundaryB(guard_cells.ng_alloc_EB);
+            }
+            // ApplyExternalFieldExcitation
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal, DtType::SecondHalf); // redundant for hs; need to fix the way to increment ss
+        }
         if (do_pml) {
             FillBoundaryF(guard_cells.ng_alloc_F);
             DampPML();
             NodalSyncPML();
             FillBoundaryE(guard_cells.ng_MovingWindow);
             FillBoundaryF(guard_cells.ng_MovingWindow);
-#ifndef WARPX_MAG_LLG
-            FillBoundaryB(guard_cells.ng_MovingWindow);
-#else
-            FillBoundaryH(guard_cells.ng_MovingWindow);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+#ifdef WARPX_MAG_LLG
+                FillBoundaryH(guard_cells.ng_MovingWindow);
 #endif
+            } else {
+                FillBoundaryB(guard_cells.ng_MovingWindow);
+            }
             }
     } // !PSATD
 
@@ -1080,6 +1074,7 @@ WarpX::HandleSignals()
     // SIGNAL_REQUESTS_BREAK is handled directly in WarpX::Evolve
 
     if (SignalHandling::TestAndResetActionRequestFlag(SignalHandling::SIGNAL_REQUESTS_CHECKPOINT)) {
+        if (reduced_diags->m_plot_rd != 0) reduced_diags->FlushBuffers();
         multi_diags->FilterComputePackFlushLastTimestep( istep[0] );
     }
 }
@@ -0,0 +1,333 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "Demagnetization.H"
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "WarpX.H"
+
+#include <AMReX_BoxArray.H>
+#include <AMReX_DistributionMapping.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+#include <cmath>
+#include <limits>
+
+using namespace amrex;
+
+namespace {
+
+    /** Newell's f function, for the diagonal components of the demagnetization tensor */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    double NewellF (double x, double y, double z)
+    {
+        x = std::abs(x); y = std::abs(y); z = std::abs(z);
+        double const x2 = x*x, y2 = y*y, z2 = z*z;
+        double const R = std::sqrt(x2 + y2 + z2);
+        double res = (2.*x2 - y2 - z2) * R / 6.;
+        if (x2 + z2 > 0.) res += 0.5 * y * (z2 - x2) * std::asinh(y / std::sqrt(x2 + z2));
+        if (x2 + y2 > 0.) res += 0.5 * z * (y2 - x2) * std::asinh(z / std::sqrt(x2 + y2));
+        if (x * R > 0.) res -= x * y * z * std::atan(y * z / (x * R));
+        return res;
+    }
+
+    /** Newell's g function, for the off-diagonal components of the demagnetization tensor */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    double NewellG (double x, double y, double z)
+    {
+        double const sign = ((x < 0.) != (y < 0.)) ? -1. : 1.;
+        x = std::abs(x); y = std::abs(y); z = std::abs(z);
+        double const x2 = x*x, y2 = y*y, z2 = z*z;
+        double const R = std::sqrt(x2 + y2 + z2);
+        double res = - x * y * R / 3.;
+        if (x2 + y2 > 0.) res += x * y * z * std::asinh(z / std::sqrt(x2 + y2));
+        if (y2 + z2 > 0.) res += y / 6. * (3.*z2 - y2) * std::asinh(x / std::sqrt(y2 + z2));
+        if (x2 + z2 > 0.) res += x / 6. * (3.*z2 - x2) * std::asinh(y / std::sqrt(x2 + z2));
+        if (z * R > 0.) res -= z * z2 / 6. * std::atan(x * y / (z * R));
+        if (y * R > 0.) res -= 0.5 * z * y2 * std::atan(x * z / (y * R));
+        if (x * R > 0.) res -= 0.5 * z * x2 * std::atan(y * z / (x * R));
+        return sign * res;
+    }
+
+    /** Component (a,b) of the Newell tensor between two cells of size (da,db,dc) separated by (A,B,C),
+     *  with a the first axis, b the second one and c the remaining one. The diagonal component
+     *  uses f and the off-diagonal one uses g; far from the source the dipole limit is used instead,
+     *  since the second differences of f and g lose all their digits to cancellation there. */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    double NewellTensor (bool diagonal, double A, double B, double C,
+                         double da, double db, double dc)
+    {
+        double const pi = 3.14159265358979323846;
+        double const r2 = A*A + B*B + C*C;
+        double const dmax = amrex::max(da, amrex::max(db, dc));
+        if (r2 > 1600. * dmax * dmax) {
+            double const r = std::sqrt(r2);
+            double const vol = da * db * dc / (4. * pi * r2 * r);
+            return diagonal ? vol * (1. - 3. * A * A / r2) : - vol * 3. * A * B / r2;
+        }
+        // weights of the second difference in each direction
+        double const w[3] = {-1., 2., -1.};
+        double res = 0.;
+        for (int kc = -1; kc <= 1; ++kc) {
+            for (int kb = -1; kb <= 1; ++kb) {
+                for (int ka = -1; ka <= 1; ++ka) {
+                    double const wt = w[ka+1] * w[kb+1] * w[kc+1];
+                    double const a = A + ka * da, b = B + kb * db, c = C + kc * dc;
+                    res += wt * (diagonal ? NewellF(a, b, c) : NewellG(a, b, c));
+                }
+            }
+        }
+        return res / (4. * pi * da * db * dc);
+    }
+}
+
+Demagnetization::Demagnetization ()
+{
+    amrex::Print() << " Demagnetization class is constructed\n";
+}
+
+Demagnetization::~Demagnetization ()
+{
+    if (m_owns_fft) {
+        AnyFFT::DestroyPlan(m_forward_plan);
+        AnyFFT::DestroyPlan(m_backward_plan);
+    }
+}
+
+void
+Demagnetization::InitData ()
+{
+    WARPX_PROFILE("Demagnetization::InitData()");
+
+#ifndef WARPX_DIM_3D
+    amrex::Abort(Utils::TextMsg::Err("The demagnetizing field is only implemented in 3D"));
+#else
+
+    auto & warpx = WarpX::GetInstance();
+    auto & macroscopic_properties = warpx.GetMacroscopicProperties();
+    Box const& domain = warpx.Geom(0).Domain();
+
+    // cell-centered bounding box of the magnetic faces: the face i touches the cells i-1 and i
+    ReduceOps<ReduceOpMin, ReduceOpMin, ReduceOpMin, ReduceOpMax, ReduceOpMax, ReduceOpMax> reduce_op;
+    ReduceData<int, int, int, int, int, int> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    for (int idir = 0; idir < 3; ++idir) {
+        // M is only stored on the magnetic boxes, the loop runs over the boxes of H
+        MultiFab const& Hface = warpx.getHfield_fp(0, idir);
+        for (MFIter mfi(Hface, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            if (!macroscopic_properties.is_magnetic_box(mfi)) continue;
+            MaterialPropertyArray const Ms = macroscopic_properties.getmag_Ms_arr(idir, mfi);
+            reduce_op.eval(mfi.tilebox(), reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    int constexpr big = std::numeric_limits<int>::max();
+                    if (Ms(i,j,k) > 0._rt) {
+                        return {i - (idir == 0), j - (idir == 1), k - (idir == 2), i, j, k};
+                    }
+                    return {big, big, big, -big, -big, -big};
+                });
+        }
+    }
+    ReduceTuple const hv = reduce_data.value(reduce_op);
+    int bounds[6] = {amrex::get<0>(hv), amrex::get<1>(hv), amrex::get<2>(hv),
+                     amrex::get<3>(hv), amrex::get<4>(hv), amrex::get<5>(hv)};
+    ParallelDescriptor::ReduceIntMin(bounds, 3);
+    ParallelDescriptor::ReduceIntMax(bounds + 3, 3);
+
+    m_has_magnetic_region = (bounds[0] <= bounds[3]);
+    if (!m_has_magnetic_region) {
+        amrex::Print() << " Demagnetization: no magnetic material on level 0, the demagnetizing field is zero\n";
+        return;
+    }
+    m_mag_box = Box(IntVect(bounds[0], bounds[1], bounds[2]),
+                    IntVect(bounds[3], bounds[4], bounds[5])) & domain;
+
+    IntVect const mag_size = m_mag_box.length();
+    m_padded_box = Box(m_mag_box.smallEnd(), m_mag_box.smallEnd() + 2*mag_size - 1);
+    IntVect spectral_size = 2*mag_size;
+    spectral_size[0] = mag_size[0] + 1; // R2C only stores nx/2+1 modes along x
+    m_spectral_box = Box(m_mag_box.smallEnd(), m_mag_box.smallEnd() + spectral_size - 1);
+    amrex::Print() << " Demagnetization: magnetic bounding box " << m_mag_box
+                   << ", FFT on the padded box " << m_padded_box << "\n";
+
+    // the padded box lives on the IO rank only
+    BoxArray const padded_ba(m_padded_box);
+    DistributionMapping const padded_dm(Vector<int>{ParallelDescriptor::IOProcessorNumber()});
+    m_padded = std::make_unique<MultiFab>(padded_ba, padded_dm, 6, 0);
+    m_owns_fft = ParallelDescriptor::IOProcessor();
+
+    if (m_owns_fft) {
+        m_fft_real = std::make_unique<FArrayBox>(m_padded_box, 1);
+        m_fft_complex = std::make_unique<SpectralFab>(m_spectral_box, 1);
+        m_kernel_k = std::make_unique<SpectralFab>(m_spectral_box, 6);
+        m_field_k = std::make_unique<SpectralFab>(m_spectral_box, 3);
+        m_forward_plan = AnyFFT::CreatePlan(
+            m_padded_box.length(), m_fft_real->dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>(m_fft_complex->dataPtr()),
+            AnyFFT::direction::R2C, AMREX_SPACEDIM);
+        m_backward_plan = AnyFFT::CreatePlan(
+            m_padded_box.length(), m_fft_real->dataPtr(),
+            reinterpret_cast<AnyFFT::Complex*>(m_fft_complex->dataPtr()),
+            AnyFFT::direction::C2R, AMREX_SPACEDIM);
+        for (int comp = 0; comp < 6; ++comp) ComputeKernelComponent(comp);
+    }
+#endif
+}
+
+void
+Demagnetization::ComputeKernelComponent (int comp)
+{
+#ifdef WARPX_DIM_3D
+    auto const dx = WarpX::GetInstance().Geom(0).CellSizeArray();
+    IntVect const lo = m_padded_box.smallEnd();
+    IntVect const n = m_mag_box.length();
+    // axes (a,b,c) of the component: the tensor is symmetric, and f is symmetric in its last two arguments
+    int const axes[6][3] = {{0,1,2}, {1,2,0}, {2,0,1}, {0,1,2}, {0,2,1}, {1,2,0}};
+    int const ia = axes[comp][0], ib = axes[comp][1], ic = axes[comp][2];
+    bool const diagonal = (comp < 3);
+    double const da = dx[ia], db = dx[ib], dc = dx[ic];
+
+    Array4<Real> const& kr = m_fft_real->array();
+    ParallelFor(m_padded_box,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k)
+        {
+            // displacement between the cells, with the wrap-around of the circular convolution
+            int const idx[3] = {i - lo[0], j - lo[1], k - lo[2]};
+            double d[3];
+            for (int dir = 0; dir < 3; ++dir) {
+                int const m = (idx[dir] < n[dir]) ? idx[dir] : idx[dir] - 2*n[dir];
+                d[dir] = m * static_cast<double>(dx[dir]);
+            }
+            kr(i,j,k) = static_cast<Real>(NewellTensor(diagonal, d[ia], d[ib], d[ic], da, db, dc));
+        });
+    Gpu::streamSynchronize();
+    AnyFFT::Execute(m_forward_plan);
+
+    Array4<GpuComplex<Real> const> const& ck = m_fft_complex->const_array();
+    Array4<GpuComplex<Real>> const& kk = m_kernel_k->array();
+    ParallelFor(m_spectral_box,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k)
+        {
+            kk(i,j,k,comp) = ck(i,j,k);
+        });
+    Gpu::streamSynchronize();
+#else
+    amrex::ignore_unused(comp);
+#endif
+}
+
+void
+Demagnetization::AllocateCellFields (MultiFab const& Mface)
+{
+    BoxArray const cell_ba = amrex::convert(Mface.boxArray(), IntVect::TheCellVector());
+    if (m_Mcell && m_Mcell->boxArray() == cell_ba
+        && m_Mcell->DistributionMap() == Mface.DistributionMap()) return;
+    m_Mcell = std::make_unique<MultiFab>(cell_ba, Mface.DistributionMap(), 3, 0);
+    m_Hdemag = std::make_unique<MultiFab>(cell_ba, Mface.DistributionMap(), 3, 1);
+    m_Hdemag->setVal(0._rt);
+    m_Hdemag_last = std::make_unique<MultiFab>(cell_ba, Mface.DistributionMap(), 3, 1);
+    m_has_Hdemag_last = false;
+}
+
+void
+Demagnetization::PredictDemagField ()
+{
+    WARPX_PROFILE("Demagnetization::PredictDemagField()");
+
+    if (!m_has_magnetic_region) return;
+
+    bool const has_last = m_has_Hdemag_last;
+    for (MFIter mfi(*m_Hdemag, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        Array4<Real> const& Hd = m_Hdemag->array(mfi);
+        Array4<Real> const& Hd_last = m_Hdemag_last->array(mfi);
+        ParallelFor(mfi.growntilebox(), 3,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+            {
+                Real const Hd_now = Hd(i,j,k,n);
+                if (has_last) Hd(i,j,k,n) = 2._rt * Hd_now - Hd_last(i,j,k,n);
+                Hd_last(i,j,k,n) = Hd_now;
+            });
+    }
+    m_has_Hdemag_last = true;
+}
+
+void
+Demagnetization::ComputeDemagField (std::array<std::unique_ptr<MultiFab>, 3> const& Mfield)
+{
+    WARPX_PROFILE("Demagnetization::ComputeDemagField()");
+
+    AllocateCellFields(*Mfield[0]);
+    if (!m_has_magnetic_region) return;
+
+    // average the normal component of M from the faces to the cell centers
+    for (MFIter mfi(*m_Mcell, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        Array4<Real> const& Mc = m_Mcell->array(mfi);
+        Array4<Real const> const& M_xface = Mfield[0]->const_array(mfi);
+        Array4<Real const> const& M_yface = Mfield[1]->const_array(mfi);
+        Array4<Real const> const& M_zface = Mfield[2]->const_array(mfi);
+        ParallelFor(mfi.tilebox(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k)
+            {
+                Mc(i,j,k,0) = 0.5_rt * (M_xface(i,j,k,0) + M_xface(i+1,j,k,0));
+                Mc(i,j,k,1) = 0.5_rt * (M_yface(i,j,k,1) + M_yface(i,j+1,k,1));
+                Mc(i,j,k,2) = 0.5_rt * (M_zface(i,j,k,2) + M_zface(i,j,k+1,2));
+            });
+    }
+
+    // gather M on the padded box; the padding stays zero
+    m_padded->setVal(0._rt);
+    m_padded->ParallelCopy(*m_Mcell, 0, 0, 3);
+
+    for (MFIter mfi(*m_padded); mfi.isValid(); ++mfi) {
+        Array4<Real> const& pad = m_padded->array(mfi);
+        Array4<Real> const& fr = m_fft_real->array();
+        Array4<GpuComplex<Real>> const& fc = m_fft_complex->array();
+        Array4<GpuComplex<Real>> const& fk = m_field_k->array();
+        Array4<GpuComplex<Real> const> const& kk = m_kernel_k->const_array();
+
+        for (int comp = 0; comp < 3; ++comp) {
+            ParallelFor(m_padded_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) { fr(i,j,k) = pad(i,j,k,comp); });
+            Gpu::streamSynchronize();
+            AnyFFT::Execute(m_forward_plan);
+            ParallelFor(m_spectral_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) { fk(i,j,k,comp) = fc(i,j,k); });
+        }
+
+        // H_d = -N M, with the normalization of the unnormalized backward transform
+        Real const inv_n = 1._rt / static_cast<Real>(m_padded_box.numPts());
+        ParallelFor(m_spectral_box,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k)
+            {
+                GpuComplex<Real> const Mx = fk(i,j,k,0), My = fk(i,j,k,1), Mz = fk(i,j,k,2);
+                fk(i,j,k,0) = -inv_n * (kk(i,j,k,0)*Mx + kk(i,j,k,3)*My + kk(i,j,k,4)*Mz);
+                fk(i,j,k,1) = -inv_n * (kk(i,j,k,3)*Mx + kk(i,j,k,1)*My + kk(i,j,k,5)*Mz);
+                fk(i,j,k,2) = -inv_n * (kk(i,j,k,4)*Mx + kk(i,j,k,5)*My + kk(i,j,k,2)*Mz);
+            });
+
+        Box const mag_box = m_mag_box;
+        for (int comp = 0; comp < 3; ++comp) {
+            ParallelFor(m_spectral_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) { fc(i,j,k) = fk(i,j,k,comp); });
+            Gpu::streamSynchronize();
+            AnyFFT::Execute(m_backward_plan);
+            // the padding holds the wrap-around of the circular convolution, and is discarded
+            ParallelFor(m_padded_box,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k)
+                {
+                    pad(i,j,k,3+comp) = mag_box.contains(i,j,k) ? fr(i,j,k) : 0._rt;
+                });
+        }
+        Gpu::streamSynchronize();
+    }
+
+    // scatter H_d back, including the ghost cells read by the faces on the box boundaries
+    m_Hdemag->setVal(0._rt);
+    m_Hdemag->ParallelCopy(*m_padded, 3, 0, 3, IntVect(0), m_Hdemag->nGrowVect());
+}
@@ -13,6 +13,7 @@
 #else
 #   include "FiniteDifferenceAlgorithms/CylindricalYeeAlgorithm.H"
 #endif
+#include "FieldSolver/London/London.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
 #include "WarpX.H"
@@ -44,6 +45,9 @@ using namespace amrex;
 
 /**
  * \brief Update the B field, over one timestep
+ *
+ * If london is given, the London current is first evolved over dt in the same loop over the boxes,
+ * and only the boxes that have superconducting nodes are updated: elsewhere J, and thus B, vanish.
  */
 void FiniteDifferenceSolver::EvolveBLondon (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
@@ -55,13 +59,14 @@ void FiniteDifferenceSolver::EvolveBLondon (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& /* Venl */,
     std::array< std::unique_ptr<amrex::iMultiFab>, 3 >& /* flag_info_cell */,
     std::array< std::unique_ptr<amrex::LayoutData<FaceInfoBox> >, 3 >& /* borrowing */,
-    int lev, amrex::Real const dt, amrex::Real const penetration_depth ) {
+    int lev, amrex::Real const dt, amrex::Real const penetration_depth,
+    London* london ) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     amrex::ignore_unused(Bfield, current, Gfield, face_areas,
-                         lev, dt, penetration_depth);
+                         lev, dt, penetration_depth, london);
     amrex::Abort("EvolveBLondon: RZ not implemented");
 #else
     if(m_do_nodal or m_fdtd_algo != MaxwellSolverAlgo::ECT){
@@ -70,15 +75,15 @@ void FiniteDifferenceSolver::EvolveBLondon (
 
     if (m_do_nodal) {
 
-        EvolveBLondonCartesian <CartesianNodalAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth);
+        EvolveBLondonCartesian <CartesianNodalAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth, london);
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveBLondonCartesian <CartesianYeeAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth );
+        EvolveBLondonCartesian <CartesianYeeAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth, london );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveBLondonCartesian <CartesianCKCAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth );
+        EvolveBLondonCartesian <CartesianCKCAlgorithm> ( Bfield, current, Gfield, lev, dt, penetration_depth, london );
     } else {
         amrex::Abort("EvolveBLondon: Unknown algorithm");
     }
@@ -93,21 +98,30 @@ void FiniteDifferenceSolver::EvolveBLondonCartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& current,
     std::unique_ptr<amrex::MultiFab> const& /* Gfield */,
-    int lev, amrex::Real const /* dt */, amrex::Real const penetration_depth ) {
+    int lev, amrex::Real const dt, amrex::Real const penetration_depth,
+    London* london ) {
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
     amrex::Real const lambdasq_mu0_fac = penetration_depth * penetration_depth * PhysConst::mu0;
+    if (london) london->AssertLayoutMatches(*current[0]);
     // Loop through the grids, and over the tiles within each grid
+    // (the superconducting edges are listed per box, so the fused J update loops over whole boxes)
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+    for ( MFIter mfi(*Bfield[0], london ? MFItInfo() : TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+        if (london && !london->HasSuperconductor(mfi)) continue;
+
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
 
+        if (london) {
+            london->EvolveLondonJ(mfi, dt);
+        }
+
         // Extract field data for this grid/tile
         Array4<Real> const& Bx = Bfield[0]->array(mfi);
         Array4<Real> const& By = Bfield[1]->array(mfi);
@@ -145,9 +145,9 @@ void FiniteDifferenceSolver::EvolveECartesian (
         int const n_coefs_z = m_stencil_coefs_z.size();
 
         // Extract tileboxes for which to loop
-        Box const& tex  = mfi.tilebox(Efield[0]->ixType().toIntVect());
-        Box const& tey  = mfi.tilebox(Efield[1]->ixType().toIntVect());
-        Box const& tez  = mfi.tilebox(Efield[2]->ixType().toIntVect());
+        Box const& tex  = UpdateTileBox(mfi, Efield[0]->ixType().toIntVect());
+        Box const& tey  = UpdateTileBox(mfi, Efield[1]->ixType().toIntVect());
+        Box const& tez  = UpdateTileBox(mfi, Efield[2]->ixType().toIntVect());
 
         // Loop over the cells and update the fields
         amrex::ParallelFor(tex, tey, tez,
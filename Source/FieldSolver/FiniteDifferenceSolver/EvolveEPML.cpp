@@ -19,6 +19,7 @@
 #include "Utils/TextMsg.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "WarpX.H"
 
 #include <AMReX.H>
 #include <AMReX_Array4.H>
@@ -95,9 +96,10 @@ void FiniteDifferenceSolver::EvolveEPMLCartesian (
 
     Real c2 = PhysConst::c * PhysConst::c;
 
-#ifdef WARPX_MAG_LLG
-    c2 *= PhysConst::mu0;
-#endif
+    // With the LLG model, Bfield holds H
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        c2 *= PhysConst::mu0;
+    }
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
@@ -21,6 +21,7 @@
 
 #include <AMReX.H>
 #include <AMReX_GpuDevice.H>
+#include <AMReX_MFIter.H>
 #include <AMReX_PODVector.H>
 #include <AMReX_Vector.H>
 
@@ -98,3 +99,10 @@ FiniteDifferenceSolver::FiniteDifferenceSolver (
     amrex::Gpu::synchronize();
 #endif
 }
+
+amrex::Box
+FiniteDifferenceSolver::UpdateTileBox (amrex::MFIter const& mfi, amrex::IntVect const& nodal) const
+{
+    if (m_update_ng == amrex::IntVect::TheZeroVector()) return mfi.tilebox(nodal);
+    return mfi.tilebox(nodal, m_update_ng) & amrex::convert(m_update_domain, nodal);
+}
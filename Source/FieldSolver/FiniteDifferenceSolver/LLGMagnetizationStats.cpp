@@ -0,0 +1,166 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "FiniteDifferenceSolver.H"
+
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
+#include "FieldSolver/FiniteDifferenceSolver/LLGMagnetizationStats.H"
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXConst.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXUtil.H"
+#include "WarpX.H"
+
+#include <AMReX_Box.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_Gpu.H>
+#include <AMReX_GpuLaunch.H>
+#include <AMReX_MFIter.H>
+
+
+using namespace amrex;
+
+#ifndef WARPX_DIM_RZ
+#ifdef WARPX_MAG_LLG
+
+void FiniteDifferenceSolver::BeginLLGMagnetizationStats () {
+
+    m_llg_n_solves_run += 1;
+
+    // the solves of step n run while istep = n-1
+    int const step = WarpX::GetInstance().getistep(0) + 1;
+    m_llg_mag_stats_requests.erase(m_llg_mag_stats_requests.begin(),
+                                   m_llg_mag_stats_requests.lower_bound(step));
+    m_llg_mag_stats_active = (m_llg_mag_stats_requests.count(step) > 0);
+    if (m_llg_mag_stats_active) m_llg_mag_stats_step = step;
+}
+
+amrex::Box FiniteDifferenceSolver::LLGMagnetizationStatsBox (amrex::MFIter const& mfi, int dir) const {
+
+    return MacroscopicProperties::OwnedFaceBox(mfi, dir);
+}
+
+amrex::Vector<amrex::Real> FiniteDifferenceSolver::GetLLGMagnetizationStats () const {
+
+    if (m_llg_mag_stats.empty()) return Vector<Real>(LLGMagnetizationStats::NSlots, 0._rt);
+    return m_llg_mag_stats;
+}
+
+void FiniteDifferenceSolver::ComputeLLGMagnetizationStats (
+    std::array< amrex::MultiFab*, 3 > const& Mfield,
+    std::array< amrex::MultiFab*, 3 > const& H_biasfield,
+    amrex::Periodicity const& period,
+    MacroscopicProperties& macroscopic_properties,
+    int const step) {
+
+    WARPX_PROFILE("FiniteDifferenceSolver::ComputeLLGMagnetizationStats()");
+
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(m_fdtd_algo == MaxwellSolverAlgo::Yee,
+        "Only yee algorithm is compatible for H and M updates.");
+
+    auto &warpx = WarpX::GetInstance();
+    int const mag_exchange_coupling = warpx.mag_LLG_exchange_coupling;
+    int const mag_anisotropy_coupling = warpx.mag_LLG_anisotropy_coupling;
+    amrex::GpuArray<amrex::Real, 3> const& anisotropy_axis = macroscopic_properties.mag_LLG_anisotropy_axis;
+
+    // the exchange term reads the neighbours of the faces on the box boundaries
+    if (mag_exchange_coupling == 1) {
+        for (int i = 0; i < 3; i++) Mfield[i]->FillBoundary(period);
+    }
+
+    LLGMagnetizationStats::ReduceOps reduce_op;
+    LLGMagnetizationStats::ReduceData reduce_data(reduce_op);
+    using ReduceTuple = LLGMagnetizationStats::ReduceTuple;
+
+    amrex::IntVect const Mxface_stag = Mfield[0]->ixType().toIntVect();
+    amrex::IntVect const Myface_stag = Mfield[1]->ixType().toIntVect();
+    amrex::IntVect const Mzface_stag = Mfield[2]->ixType().toIntVect();
+    amrex::IntVect const M_stag[3] = {Mxface_stag, Myface_stag, Mzface_stag};
+
+    // Extract stencil coefficients for calculating the exchange field H_exchange
+    amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
+    int const n_coefs_x = m_stencil_coefs_x.size();
+    amrex::Real const *const AMREX_RESTRICT coefs_y = m_stencil_coefs_y.dataPtr();
+    int const n_coefs_y = m_stencil_coefs_y.size();
+    amrex::Real const *const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
+    int const n_coefs_z = m_stencil_coefs_z.size();
+
+    // M is only stored on the magnetic boxes (see WarpX::CompactMfield), the loop runs over the boxes of H_bias
+    amrex::Vector<int> const& mag_box_index = warpx.getMagneticBoxIndex(0);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*H_biasfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        if (!macroscopic_properties.is_magnetic_box(mfi)) continue;
+        int const mag_index = mag_box_index[mfi.index()];
+
+        Array4<Real> const &Hx_bias = H_biasfield[0]->array(mfi);
+        Array4<Real> const &Hy_bias = H_biasfield[1]->array(mfi);
+        Array4<Real> const &Hz_bias = H_biasfield[2]->array(mfi);
+
+        // one pass per face orientation: M on the faces normal to dir
+        for (int dir = 0; dir < 3; ++dir)
+        {
+            MaterialPropertyArray const mag_Ms_arr = macroscopic_properties.getmag_Ms_arr(dir, mfi);
+            MaterialPropertyArray const mag_exchange_arr = macroscopic_properties.getmag_exchange_arr(dir, mfi);
+            MaterialPropertyArray const mag_anisotropy_arr = macroscopic_properties.getmag_anisotropy_arr(dir, mfi);
+            Array4<Real const> const &M_face = Mfield[dir]->const_array(mag_index);
+            amrex::IntVect const face_stag = M_stag[dir];
+
+            // the valid faces only, counted once by the box that owns them
+            Box const tb = mfi.tilebox(face_stag) & LLGMagnetizationStatsBox(mfi, dir);
+            if (!tb.ok()) continue;
+            reduce_op.eval(tb, reduce_data,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k) -> ReduceTuple {
+
+                    // determine if the material is nonmagnetic or not
+                    if (mag_Ms_arr(i,j,k) <= 0._rt) return LLGMagnetizationStats::None();
+
+                    amrex::Real const Ms = mag_Ms_arr(i,j,k);
+                    amrex::Real const Mx = M_face(i, j, k, 0);
+                    amrex::Real const My = M_face(i, j, k, 1);
+                    amrex::Real const Mz = M_face(i, j, k, 2);
+
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    if (mag_exchange_coupling == 1){
+                        amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_arr(i,j,k) / PhysConst::mu0 / Ms / Ms;
+                        amrex::GpuArray<amrex::Real,3> const lap_M = CartesianYeeAlgorithm::Laplacian_Mag_Vec(
+                            M_face, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z,
+                            mag_Ms_arr(i-1, j, k), mag_Ms_arr(i+1, j, k),
+                            mag_Ms_arr(i, j-1, k), mag_Ms_arr(i, j+1, k),
+                            mag_Ms_arr(i, j, k-1), mag_Ms_arr(i, j, k+1), i, j, k, dir);
+                        M_dot_H_exchange = H_exchange_coeff * (Mx * lap_M[0] + My * lap_M[1] + Mz * lap_M[2]);
+                    }
+
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+                    if (mag_anisotropy_coupling == 1){
+                        amrex::Real const M_dot_anisotropy_axis = Mx * anisotropy_axis[0] + My * anisotropy_axis[1] + Mz * anisotropy_axis[2];
+                        amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_arr(i,j,k) / PhysConst::mu0 / Ms / Ms;
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
+                    }
+
+                    amrex::Real const M_dot_H_bias =
+                          Mx * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, face_stag, Hx_bias)
+                        + My * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, face_stag, Hy_bias)
+                        + Mz * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, face_stag, Hz_bias);
+
+                    return LLGMagnetizationStats::Face(Mx, My, Mz, Ms,
+                        M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
+                });
+        }
+    }
+
+    m_llg_mag_stats = LLGMagnetizationStats::Values(reduce_op, reduce_data);
+    m_llg_mag_stats_step = step;
+}
+
+#endif // ifdef WARPX_MAG_LLG
+#endif // ifndef WARPX_DIM_RZ
@@ -36,11 +36,7 @@ using namespace amrex;
 
 void FiniteDifferenceSolver::MacroscopicEvolveE (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
-#ifndef WARPX_MAG_LLG
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
-#else
-    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Hfield,
-#endif
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     amrex::Real const dt,
@@ -50,37 +46,62 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
-#    ifndef WARPX_MAG_LLG
     amrex::ignore_unused(Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#    else
-    amrex::ignore_unused(Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#endif
     amrex::Abort(Utils::TextMsg::Err(
         "currently macro E-push does not work for RZ"));
 #else
     WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
         !m_do_nodal, "macro E-push does not work for nodal");
 
+    // With the LLG model, Bfield holds H and the curl is taken directly;
+    // otherwise H is computed on the fly as B/mu.
+    if (macroscopic_properties->precompute_coefficients()) {
+
+        // alpha, beta and 1/mu are computed once (and again if dt or the grids change)
+        macroscopic_properties->UpdateECoefficients(dt);
+
+        if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveECartesianPrecomputed <CartesianYeeAlgorithm, FieldAccessorIdentity>
+                               ( Efield, Bfield, Jfield, edge_lengths, macroscopic_properties);
+            } else {
+                MacroscopicEvolveECartesianPrecomputed <CartesianYeeAlgorithm, FieldAccessorMacroscopicInverse>
+                               ( Efield, Bfield, Jfield, edge_lengths, macroscopic_properties);
+            }
+        } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveECartesianPrecomputed <CartesianCKCAlgorithm, FieldAccessorIdentity>
+                               ( Efield, Bfield, Jfield, edge_lengths, macroscopic_properties);
+            } else {
+                MacroscopicEvolveECartesianPrecomputed <CartesianCKCAlgorithm, FieldAccessorMacroscopicInverse>
+                               ( Efield, Bfield, Jfield, edge_lengths, macroscopic_properties);
+            }
+        } else {
+            amrex::Abort(Utils::TextMsg::Err(
+                "MacroscopicEvolveE: Unknown algorithm"));
+        }
 
-    if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
+    } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
         if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
 
-            MacroscopicEvolveECartesian <CartesianYeeAlgorithm, LaxWendroffAlgo>
-#ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#endif
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveECartesian <CartesianYeeAlgorithm, LaxWendroffAlgo, FieldAccessorIdentity>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            } else {
+                MacroscopicEvolveECartesian <CartesianYeeAlgorithm, LaxWendroffAlgo, FieldAccessorMacroscopic>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            }
         }
         if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
 
-            MacroscopicEvolveECartesian <CartesianYeeAlgorithm, BackwardEulerAlgo>
-#ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#endif
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveECartesian <CartesianYeeAlgorithm, BackwardEulerAlgo, FieldAccessorIdentity>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            } else {
+                MacroscopicEvolveECartesian <CartesianYeeAlgorithm, BackwardEulerAlgo, FieldAccessorMacroscopic>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            }
 
         }
 
@@ -90,20 +111,22 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
         // In the templated Yee and CKC calls, the core operations for EvolveE is the same.
         if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
 
-            MacroscopicEvolveECartesian <CartesianCKCAlgorithm, LaxWendroffAlgo>
-#ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#endif
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveECartesian <CartesianCKCAlgorithm, LaxWendroffAlgo, FieldAccessorIdentity>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            } else {
+                MacroscopicEvolveECartesian <CartesianCKCAlgorithm, LaxWendroffAlgo, FieldAccessorMacroscopic>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            }
         } else if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
 
-            MacroscopicEvolveECartesian <CartesianCKCAlgorithm, BackwardEulerAlgo>
-#ifndef WARPX_MAG_LLG
-                       ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#else
-                       ( Efield, Hfield, Jfield, edge_lengths, dt, macroscopic_properties);
-#endif
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveECartesian <CartesianCKCAlgorithm, BackwardEulerAlgo, FieldAccessorIdentity>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            } else {
+                MacroscopicEvolveECartesian <CartesianCKCAlgorithm, BackwardEulerAlgo, FieldAccessorMacroscopic>
+                               ( Efield, Bfield, Jfield, edge_lengths, dt, macroscopic_properties);
+            }
         }
 
     } else {
@@ -117,14 +140,10 @@ void FiniteDifferenceSolver::MacroscopicEvolveE (
 
 #ifndef WARPX_DIM_RZ
 
-template<typename T_Algo, typename T_MacroAlgo>
+template<typename T_Algo, typename T_MacroAlgo, typename T_FieldAccessor>
 void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
-#ifndef WARPX_MAG_LLG
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
-#else
-    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Hfield,
-#endif
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     amrex::Real const dt,
@@ -134,12 +153,6 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
     amrex::ignore_unused(edge_lengths);
 #endif
 
-    amrex::MultiFab& sigma_mf = macroscopic_properties->getsigma_mf();
-    amrex::MultiFab& epsilon_mf = macroscopic_properties->getepsilon_mf();
-#ifndef WARPX_MAG_LLG
-    amrex::MultiFab& mu_mf = macroscopic_properties->getmu_mf();
-#endif
-
     // Index type required for calling CoarsenIO::Interp to interpolate macroscopic
     // properties from their respective staggering to the Ex, Ey, Ez locations
     amrex::GpuArray<int, 3> const& sigma_stag = macroscopic_properties->sigma_IndexType;
@@ -162,11 +175,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         Array4<Real> const& jx = Jfield[0]->array(mfi);
         Array4<Real> const& jy = Jfield[1]->array(mfi);
         Array4<Real> const& jz = Jfield[2]->array(mfi);
-#ifndef WARPX_MAG_LLG
         Array4<Real> const& Bx = Bfield[0]->array(mfi);
         Array4<Real> const& By = Bfield[1]->array(mfi);
         Array4<Real> const& Bz = Bfield[2]->array(mfi);
-#endif
 
 #ifdef AMREX_USE_EB
         amrex::Array4<amrex::Real> const& lx = edge_lengths[0]->array(mfi);
@@ -175,11 +186,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
 #endif
 
         // material prop //
-        amrex::Array4<amrex::Real> const& sigma_arr = sigma_mf.array(mfi);
-        amrex::Array4<amrex::Real> const& eps_arr = epsilon_mf.array(mfi);
-#ifndef WARPX_MAG_LLG
-        amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
-#endif
+        MaterialPropertyArray const sigma_arr = macroscopic_properties->getsigma_arr(mfi);
+        MaterialPropertyArray const eps_arr = macroscopic_properties->getepsilon_arr(mfi);
+        MaterialPropertyArray const mu_arr = macroscopic_properties->getmu_arr(mfi);
 
         // Extract stencil coefficients
         Real const * const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
@@ -189,23 +198,17 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
         Real const * const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
         int const n_coefs_z = m_stencil_coefs_z.size();
 
-#ifndef WARPX_MAG_LLG
-        // This functor computes Hx = Bx/mu
+        // This functor computes Hx = Bx/mu, or returns Hx when Bfield already holds H
         // Note that mu is cell-centered here and will be interpolated/averaged
         // to the location where the B-field and H-field are defined
-        FieldAccessorMacroscopic const Hx(Bx, mu_arr);
-        FieldAccessorMacroscopic const Hy(By, mu_arr);
-        FieldAccessorMacroscopic const Hz(Bz, mu_arr);
-#else
-        Array4<Real> const& Hx = Hfield[0]->array(mfi);
-        Array4<Real> const& Hy = Hfield[1]->array(mfi);
-        Array4<Real> const& Hz = Hfield[2]->array(mfi);
-#endif
+        T_FieldAccessor const Hx(Bx, mu_arr);
+        T_FieldAccessor const Hy(By, mu_arr);
+        T_FieldAccessor const Hz(Bz, mu_arr);
 
         // Extract tileboxes for which to loop
-        Box const& tex  = mfi.tilebox(Efield[0]->ixType().toIntVect());
-        Box const& tey  = mfi.tilebox(Efield[1]->ixType().toIntVect());
-        Box const& tez  = mfi.tilebox(Efield[2]->ixType().toIntVect());
+        Box const& tex  = UpdateTileBox(mfi, Efield[0]->ixType().toIntVect());
+        Box const& tey  = UpdateTileBox(mfi, Efield[1]->ixType().toIntVect());
+        Box const& tez  = UpdateTileBox(mfi, Efield[2]->ixType().toIntVect());
         // starting component to interpolate macro properties to Ex, Ey, Ez locations
         const int scomp = 0;
         // Loop over the cells and update the fields
@@ -270,4 +273,105 @@ void FiniteDifferenceSolver::MacroscopicEvolveECartesian (
     }
 }
 
+template<typename T_Algo, typename T_FieldAccessor>
+void FiniteDifferenceSolver::MacroscopicEvolveECartesianPrecomputed (
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
+    std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
+    std::unique_ptr<MacroscopicProperties> const& macroscopic_properties)
+{
+#ifndef AMREX_USE_EB
+    amrex::ignore_unused(edge_lengths);
+#endif
+
+    amrex::MultiFab& inv_mu_mf = macroscopic_properties->getinv_mu_mf();
+
+    // Loop through the grids, and over the tiles within each grid
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(*Efield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+
+        // Extract field data for this grid/tile
+        Array4<Real> const& Ex = Efield[0]->array(mfi);
+        Array4<Real> const& Ey = Efield[1]->array(mfi);
+        Array4<Real> const& Ez = Efield[2]->array(mfi);
+        Array4<Real const> const& jx = Jfield[0]->const_array(mfi);
+        Array4<Real const> const& jy = Jfield[1]->const_array(mfi);
+        Array4<Real const> const& jz = Jfield[2]->const_array(mfi);
+        Array4<Real const> const& Bx = Bfield[0]->const_array(mfi);
+        Array4<Real const> const& By = Bfield[1]->const_array(mfi);
+        Array4<Real const> const& Bz = Bfield[2]->const_array(mfi);
+
+#ifdef AMREX_USE_EB
+        amrex::Array4<amrex::Real> const& lx = edge_lengths[0]->array(mfi);
+        amrex::Array4<amrex::Real> const& ly = edge_lengths[1]->array(mfi);
+        amrex::Array4<amrex::Real> const& lz = edge_lengths[2]->array(mfi);
+#endif
+
+        // precomputed coefficients //
+        Array4<Real const> const& alpha_x = macroscopic_properties->getalpha_mf(0).const_array(mfi);
+        Array4<Real const> const& alpha_y = macroscopic_properties->getalpha_mf(1).const_array(mfi);
+        Array4<Real const> const& alpha_z = macroscopic_properties->getalpha_mf(2).const_array(mfi);
+        Array4<Real const> const& beta_x = macroscopic_properties->getbeta_mf(0).const_array(mfi);
+        Array4<Real const> const& beta_y = macroscopic_properties->getbeta_mf(1).const_array(mfi);
+        Array4<Real const> const& beta_z = macroscopic_properties->getbeta_mf(2).const_array(mfi);
+        Array4<Real const> const& inv_mu_arr = inv_mu_mf.const_array(mfi);
+
+        // Extract stencil coefficients
+        Real const * const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
+        int const n_coefs_x = m_stencil_coefs_x.size();
+        Real const * const AMREX_RESTRICT coefs_y = m_stencil_coefs_y.dataPtr();
+        int const n_coefs_y = m_stencil_coefs_y.size();
+        Real const * const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
+        int const n_coefs_z = m_stencil_coefs_z.size();
+
+        // This functor computes Hx = Bx*(1/mu), or returns Hx when Bfield already holds H
+        T_FieldAccessor const Hx(Bx, inv_mu_arr);
+        T_FieldAccessor const Hy(By, inv_mu_arr);
+        T_FieldAccessor const Hz(Bz, inv_mu_arr);
+
+        // Extract tileboxes for which to loop
+        Box const& tex  = UpdateTileBox(mfi, Efield[0]->ixType().toIntVect());
+        Box const& tey  = UpdateTileBox(mfi, Efield[1]->ixType().toIntVect());
+        Box const& tez  = UpdateTileBox(mfi, Efield[2]->ixType().toIntVect());
+        // Loop over the cells and update the fields
+        amrex::ParallelFor(tex, tey, tez,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+#ifdef AMREX_USE_EB
+                // Skip field push if this cell is fully covered by embedded boundaries
+                if (lx(i, j, k) <= 0) return;
+#endif
+                Ex(i, j, k) = alpha_x(i, j, k) * Ex(i, j, k)
+                            + beta_x(i, j, k) * ( - T_Algo::DownwardDz(Hy, coefs_z, n_coefs_z, i, j, k,0)
+                                                  + T_Algo::DownwardDy(Hz, coefs_y, n_coefs_y, i, j, k,0)
+                                                  - jx(i, j, k) );
+            },
+
+            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+#ifdef AMREX_USE_EB
+                // Skip field push if this cell is fully covered by embedded boundaries
+                if (ly(i,j,k) <= 0) return;
+#endif
+                Ey(i, j, k) = alpha_y(i, j, k) * Ey(i, j, k)
+                            + beta_y(i, j, k) * ( - T_Algo::DownwardDx(Hz, coefs_x, n_coefs_x, i, j, k,0)
+                                                  + T_Algo::DownwardDz(Hx, coefs_z, n_coefs_z, i, j, k,0)
+                                                  - jy(i, j, k) );
+            },
+
+            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+#ifdef AMREX_USE_EB
+                // Skip field push if this cell is fully covered by embedded boundaries
+                if (lz(i,j,k) <= 0) return;
+#endif
+                Ez(i, j, k) = alpha_z(i, j, k) * Ez(i, j, k)
+                            + beta_z(i, j, k) * ( - T_Algo::DownwardDy(Hx, coefs_y, n_coefs_y, i, j, k,0)
+                                                  + T_Algo::DownwardDx(Hy, coefs_x, n_coefs_x, i, j, k,0)
+                                                  - jz(i, j, k) );
+            }
+        );
+    }
+}
+
 #endif // corresponds to ifndef WARPX_DIM_RZ
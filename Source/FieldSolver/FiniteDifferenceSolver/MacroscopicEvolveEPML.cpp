@@ -1,6 +1,7 @@
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "WarpX.H"
 #ifdef WARPX_DIM_RZ
 #   include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceAlgorithms/CylindricalYeeAlgorithm.H"
 #else
@@ -23,11 +24,7 @@ using namespace amrex;
  */
 void FiniteDifferenceSolver::MacroscopicEvolveEPML (
     std::array< amrex::MultiFab*, 3 > Efield,
-#ifndef WARPX_MAG_LLG
     std::array< amrex::MultiFab*, 3 > const Bfield,
-#else
-    std::array< amrex::MultiFab*, 3 > const Hfield,
-#endif
     std::array< amrex::MultiFab*, 3 > const Jfield,
     amrex::MultiFab* const Ffield,
     MultiSigmaBox const& sigba,
@@ -41,11 +38,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveEPML (
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
-#    ifndef WARPX_MAG_LLG
     amrex::ignore_unused(Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles, macroscopic_properties, eps_mf, mu_mf, sigma_mf);
-#    else
-    amrex::ignore_unused(Efield, Hfield, Jfield, Ffield, sigba, dt, pml_has_particles, macroscopic_properties, eps_mf, mu_mf, sigma_mf);
-#    endif
     amrex::Abort("PML are not implemented in cylindrical geometry.");
 #else
     if (m_do_nodal) {
@@ -55,51 +48,51 @@ void FiniteDifferenceSolver::MacroscopicEvolveEPML (
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
         if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
-            MacroscopicEvolveEPMLCartesian <CartesianYeeAlgorithm, LaxWendroffAlgo> (
-                Efield,
-#ifndef WARPX_MAG_LLG
-                Bfield,
-#else
-                Hfield,
-#endif
-                Jfield, Ffield, sigba, dt, pml_has_particles,
-                macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveEPMLCartesian <CartesianYeeAlgorithm, LaxWendroffAlgo, FieldAccessorIdentity> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            } else {
+                MacroscopicEvolveEPMLCartesian <CartesianYeeAlgorithm, LaxWendroffAlgo, FieldAccessorMacroscopic> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            }
         }
         else if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
-            MacroscopicEvolveEPMLCartesian <CartesianYeeAlgorithm, BackwardEulerAlgo> (
-                Efield,
-#ifndef WARPX_MAG_LLG
-                Bfield,
-#else
-                Hfield,
-#endif
-                Jfield, Ffield, sigba, dt, pml_has_particles,
-                macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveEPMLCartesian <CartesianYeeAlgorithm, BackwardEulerAlgo, FieldAccessorIdentity> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            } else {
+                MacroscopicEvolveEPMLCartesian <CartesianYeeAlgorithm, BackwardEulerAlgo, FieldAccessorMacroscopic> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            }
         }
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
         // Note :: Macroscopic Evolve E for PML is the same for CKC and Yee
         if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
-            MacroscopicEvolveEPMLCartesian <CartesianCKCAlgorithm, LaxWendroffAlgo> (
-                Efield,
-#ifndef WARPX_MAG_LLG
-                Bfield,
-#else
-                Hfield,
-#endif
-                Jfield, Ffield, sigba, dt, pml_has_particles,
-                macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveEPMLCartesian <CartesianCKCAlgorithm, LaxWendroffAlgo, FieldAccessorIdentity> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            } else {
+                MacroscopicEvolveEPMLCartesian <CartesianCKCAlgorithm, LaxWendroffAlgo, FieldAccessorMacroscopic> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            }
         }
         else if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::BackwardEuler) {
-            MacroscopicEvolveEPMLCartesian <CartesianCKCAlgorithm, BackwardEulerAlgo> (
-                Efield,
-#ifndef WARPX_MAG_LLG
-                Bfield,
-#else
-                Hfield,
-#endif
-                Jfield, Ffield, sigba, dt, pml_has_particles,
-                macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                MacroscopicEvolveEPMLCartesian <CartesianCKCAlgorithm, BackwardEulerAlgo, FieldAccessorIdentity> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            } else {
+                MacroscopicEvolveEPMLCartesian <CartesianCKCAlgorithm, BackwardEulerAlgo, FieldAccessorMacroscopic> (
+                    Efield, Bfield, Jfield, Ffield, sigba, dt, pml_has_particles,
+                    macroscopic_properties, eps_mf, mu_mf, sigma_mf);
+            }
         }
 
     } else {
@@ -111,14 +104,10 @@ void FiniteDifferenceSolver::MacroscopicEvolveEPML (
 
 #ifndef WARPX_DIM_RZ
 
-template<typename T_Algo, typename T_MacroAlgo>
+template<typename T_Algo, typename T_MacroAlgo, typename T_FieldAccessor>
 void FiniteDifferenceSolver::MacroscopicEvolveEPMLCartesian (
     std::array< amrex::MultiFab*, 3 > Efield,
-#ifndef WARPX_MAG_LLG
     std::array< amrex::MultiFab*, 3 > const Bfield,
-#else
-    std::array< amrex::MultiFab*, 3 > const Hfield,
-#endif
     std::array< amrex::MultiFab*, 3 > const Jfield,
     amrex::MultiFab* const Ffield,
     MultiSigmaBox const& sigba,
@@ -130,9 +119,6 @@ void FiniteDifferenceSolver::MacroscopicEvolveEPMLCartesian (
 {
 
     amrex::ignore_unused(Ffield);
-#ifdef WARPX_MAG_LLG
-    amrex::ignore_unused(mu_mf);
-#endif
 
     // Index type required for calling CoarsenIO::Interp to interpolate macroscopic
     // properties from their respective staggering to the Ex, Ey, Ez locations
@@ -153,17 +139,13 @@ void FiniteDifferenceSolver::MacroscopicEvolveEPMLCartesian (
         Array4<Real> const& Ex = Efield[0]->array(mfi);
         Array4<Real> const& Ey = Efield[1]->array(mfi);
         Array4<Real> const& Ez = Efield[2]->array(mfi);
-#ifndef WARPX_MAG_LLG
         Array4<Real> const& Bx = Bfield[0]->array(mfi);
         Array4<Real> const& By = Bfield[1]->array(mfi);
         Array4<Real> const& Bz = Bfield[2]->array(mfi);
-#endif
         // material prop //
         amrex::Array4<amrex::Real> const& sigma_arr = sigma_mf->array(mfi);
         amrex::Array4<amrex::Real> const& eps_arr = eps_mf->array(mfi);
-#ifndef WARPX_MAG_LLG
         amrex::Array4<amrex::Real> const& mu_arr = mu_mf->array(mfi);
-#endif
 
         // Extract stencil coefficients
         Real const * const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
@@ -173,18 +155,12 @@ void FiniteDifferenceSolver::MacroscopicEvolveEPMLCartesian (
         Real const * const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
         int const n_coefs_z = m_stencil_coefs_z.size();
 
-#ifndef WARPX_MAG_LLG
-        // This functor computes Hx = Bx/mu
+        // This functor computes Hx = Bx/mu, or returns Hx when Bfield already holds H
         // Note that mu is cell-centered here and will be interpolated/averaged
         // to the location where the B-field and H-field are defined
-        FieldAccessorMacroscopic const Hx(Bx, mu_arr);
-        FieldAccessorMacroscopic const Hy(By, mu_arr);
-        FieldAccessorMacroscopic const Hz(Bz, mu_arr);
-#else
-        Array4<Real> const& Hx = Hfield[0]->array(mfi);
-        Array4<Real> const& Hy = Hfield[1]->array(mfi);
-        Array4<Real> const& Hz = Hfield[2]->array(mfi);
-#endif
+        T_FieldAccessor const Hx(Bx, mu_arr);
+        T_FieldAccessor const Hy(By, mu_arr);
+        T_FieldAccessor const Hz(Bz, mu_arr);
 
         // Extract tileboxes for which to loop
         Box const& tex  = mfi.tilebox(Efield[0]->ixType().toIntVect());
@@ -10,12 +10,18 @@
 #include "FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
 #include "FiniteDifferenceAlgorithms/CartesianCKCAlgorithm.H"
 #include "FiniteDifferenceAlgorithms/CartesianNodalAlgorithm.H"
+#include "FieldSolver/FiniteDifferenceSolver/LLGMagnetizationStats.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#if defined(WARPX_MAG_LLG) && defined(WARPX_USE_PSATD)
+#include "FieldSolver/Demagnetization/Demagnetization.H"
+#endif
 #endif
 #include "Utils/WarpXConst.H"
 #include "Utils/CoarsenIO.H"
 #include "Utils/WarpXUtil.H"
 #include <AMReX_Gpu.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_LayoutData.H>
 
 using namespace amrex;
 
@@ -66,92 +72,117 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
     int M_normalization = warpx.mag_M_normalization;
     int mag_exchange_coupling = warpx.mag_LLG_exchange_coupling;
     int mag_anisotropy_coupling = warpx.mag_LLG_anisotropy_coupling;
+    int maintain_B = warpx.mag_LLG_maintain_B;
+    int demag_coupling = warpx.mag_LLG_demag_coupling;
 
-    // temporary Multifab storing M from previous timestep (old_time) before updating to M(new_time)
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> Mfield_old; // Mfield_old is M(old_time)
+    // temporary Multifab storing M from previous timestep (old_time) before updating to M(new_time);
+    // like M, only on the magnetic boxes: the fab of the box mfi.index() of Hfield is m_llg_scratch_index[mfi.index()]
+    std::array<std::unique_ptr<LLGStorageFab>, 3> Mfield_old; // Mfield_old is M(old_time), in the LLG storage precision
+    DefineLLGScratchLayout(Mfield, Hfield);
 
     amrex::GpuArray<int, 3> const& mu_stag = macroscopic_properties->mu_IndexType;
     amrex::GpuArray<int, 3> const& Hx_stag = macroscopic_properties->Hx_IndexType;
     amrex::GpuArray<int, 3> const& Hy_stag = macroscopic_properties->Hy_IndexType;
     amrex::GpuArray<int, 3> const& Hz_stag = macroscopic_properties->Hz_IndexType;
-    amrex::GpuArray<int, 3> const& Bx_stag = macroscopic_properties->Bx_IndexType;
-    amrex::GpuArray<int, 3> const& By_stag = macroscopic_properties->By_IndexType;
-    amrex::GpuArray<int, 3> const& Bz_stag = macroscopic_properties->Bz_IndexType;
     amrex::GpuArray<int, 3> const& macro_cr= macroscopic_properties->macro_cr_ratio;
     amrex::GpuArray<amrex::Real, 3> const& anisotropy_axis = macroscopic_properties->mag_LLG_anisotropy_axis;
 
     for (int i = 0; i < 3; i++)
     {
         // Mfield_old is M(n)
-        Mfield_old[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
+        Mfield_old[i].reset(new LLGStorageFab(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect()));
         // initialize temporary multifab, Mfield_old, with values from Mfield(old_time)
-        MultiFab::Copy(*Mfield_old[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
+        CopyToLLGScratch(*Mfield_old[i], *Mfield[i]);
     }
 
+#ifdef WARPX_USE_PSATD
+    // demagnetizing field of M(old_time)
+    if (demag_coupling == 1) warpx.getDemagnetization()->ComputeDemagField(Mfield);
+#endif
+
     // obtain the maximum relative amount we let M deviate from Ms before aborting
     amrex::Real mag_normalized_error = macroscopic_properties->getmag_normalized_error();
 
+    // per-box count of the M updates, for the load balancing cost model;
+    // the LLG solver only runs on level 0
+    BeginLLGBoxUpdates(*Hfield[0]);
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(0);
+    // statistics of M^(old_time) for the MagnetizationReduction reduced diagnostic, if requested
+    BeginLLGMagnetizationStats();
+    LLGMagnetizationStats::ReduceOps stats_op;
+    LLGMagnetizationStats::ReduceData stats_data(stats_op);
+    m_llg_n_updates_run += 1;
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
 
-    for (MFIter mfi(*Mfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
-        auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-        auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-        auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
-        auto& mag_alpha_xface_mf = macroscopic_properties->getmag_alpha_mf(0);
-        auto& mag_alpha_yface_mf = macroscopic_properties->getmag_alpha_mf(1);
-        auto& mag_alpha_zface_mf = macroscopic_properties->getmag_alpha_mf(2);
-        auto& mag_gamma_xface_mf = macroscopic_properties->getmag_gamma_mf(0);
-        auto& mag_gamma_yface_mf = macroscopic_properties->getmag_gamma_mf(1);
-        auto& mag_gamma_zface_mf = macroscopic_properties->getmag_gamma_mf(2);
-        auto& mag_exchange_xface_mf = macroscopic_properties->getmag_exchange_mf(0);
-        auto& mag_exchange_yface_mf = macroscopic_properties->getmag_exchange_mf(1);
-        auto& mag_exchange_zface_mf = macroscopic_properties->getmag_exchange_mf(2);
-        auto& mag_anisotropy_xface_mf = macroscopic_properties->getmag_anisotropy_mf(0);
-        auto& mag_anisotropy_yface_mf = macroscopic_properties->getmag_anisotropy_mf(1);
-        auto& mag_anisotropy_zface_mf = macroscopic_properties->getmag_anisotropy_mf(2);
+        // the M update only touches magnetic faces
+        if (!macroscopic_properties->is_magnetic_box(mfi)) continue;
+
+        amrex::HostDevice::Atomic::Add( &m_llg_box_updates[mfi],
+            static_cast<amrex::Real>(mfi.tilebox().numPts()) / static_cast<amrex::Real>(mfi.validbox().numPts()));
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+        }
+        Real wt = amrex::second();
+
 
         // extract material properties
-        Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
-        Array4<Real> const& mag_alpha_xface_arr = mag_alpha_xface_mf.array(mfi);
-        Array4<Real> const& mag_alpha_yface_arr = mag_alpha_yface_mf.array(mfi);
-        Array4<Real> const& mag_alpha_zface_arr = mag_alpha_zface_mf.array(mfi);
-        Array4<Real> const& mag_gamma_xface_arr = mag_gamma_xface_mf.array(mfi);
-        Array4<Real> const& mag_gamma_yface_arr = mag_gamma_yface_mf.array(mfi);
-        Array4<Real> const& mag_gamma_zface_arr = mag_gamma_zface_mf.array(mfi);
-        Array4<Real> const& mag_exchange_xface_arr = mag_exchange_xface_mf.array(mfi);
-        Array4<Real> const& mag_exchange_yface_arr = mag_exchange_yface_mf.array(mfi);
-        Array4<Real> const& mag_exchange_zface_arr = mag_exchange_zface_mf.array(mfi);
-        Array4<Real> const& mag_anisotropy_xface_arr = mag_anisotropy_xface_mf.array(mfi);
-        Array4<Real> const& mag_anisotropy_yface_arr = mag_anisotropy_yface_mf.array(mfi);
-        Array4<Real> const& mag_anisotropy_zface_arr = mag_anisotropy_zface_mf.array(mfi);
+        MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+        MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+        MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
+        MaterialPropertyArray const mag_alpha_xface_arr = macroscopic_properties->getmag_alpha_arr(0, mfi);
+        MaterialPropertyArray const mag_alpha_yface_arr = macroscopic_properties->getmag_alpha_arr(1, mfi);
+        MaterialPropertyArray const mag_alpha_zface_arr = macroscopic_properties->getmag_alpha_arr(2, mfi);
+        MaterialPropertyArray const mag_gamma_xface_arr = macroscopic_properties->getmag_gamma_arr(0, mfi);
+        MaterialPropertyArray const mag_gamma_yface_arr = macroscopic_properties->getmag_gamma_arr(1, mfi);
+        MaterialPropertyArray const mag_gamma_zface_arr = macroscopic_properties->getmag_gamma_arr(2, mfi);
+        MaterialPropertyArray const mag_exchange_xface_arr = macroscopic_properties->getmag_exchange_arr(0, mfi);
+        MaterialPropertyArray const mag_exchange_yface_arr = macroscopic_properties->getmag_exchange_arr(1, mfi);
+        MaterialPropertyArray const mag_exchange_zface_arr = macroscopic_properties->getmag_exchange_arr(2, mfi);
+        MaterialPropertyArray const mag_anisotropy_xface_arr = macroscopic_properties->getmag_anisotropy_arr(0, mfi);
+        MaterialPropertyArray const mag_anisotropy_yface_arr = macroscopic_properties->getmag_anisotropy_arr(1, mfi);
+        MaterialPropertyArray const mag_anisotropy_zface_arr = macroscopic_properties->getmag_anisotropy_arr(2, mfi);
 
         // extract field data
         Array4<Real> const &Hx = Hfield[0]->array(mfi);
         Array4<Real> const &Hy = Hfield[1]->array(mfi);
         Array4<Real> const &Hz = Hfield[2]->array(mfi);
-        Array4<Real> const &M_xface = Mfield[0]->array(mfi);         // note M_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_yface = Mfield[1]->array(mfi);         // note M_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_zface = Mfield[2]->array(mfi);         // note M_zface include x,y,z components at |_z faces
-        Array4<Real> const &M_old_xface = Mfield_old[0]->array(mfi); // note M_old_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_old_yface = Mfield_old[1]->array(mfi); // note M_old_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_old_zface = Mfield_old[2]->array(mfi); // note M_old_zface include x,y,z components at |_z faces
+        int const scratch_index = m_llg_scratch_index[mfi.index()];
+        Array4<Real> const &M_xface = Mfield[0]->array(scratch_index); // note M_xface include x,y,z components at |_x faces
+        Array4<Real> const &M_yface = Mfield[1]->array(scratch_index); // note M_yface include x,y,z components at |_y faces
+        Array4<Real> const &M_zface = Mfield[2]->array(scratch_index); // note M_zface include x,y,z components at |_z faces
+        Array4<LLGStorageReal> const &M_old_xface = Mfield_old[0]->array(scratch_index); // note M_old_xface include x,y,z components at |_x faces
+        Array4<LLGStorageReal> const &M_old_yface = Mfield_old[1]->array(scratch_index); // note M_old_yface include x,y,z components at |_y faces
+        Array4<LLGStorageReal> const &M_old_zface = Mfield_old[2]->array(scratch_index); // note M_old_zface include x,y,z components at |_z faces
         Array4<Real> const &Hx_bias = H_biasfield[0]->array(mfi);    // Hx_bias is the x component at |_x faces
         Array4<Real> const &Hy_bias = H_biasfield[1]->array(mfi);    // Hy_bias is the y component at |_y faces
         Array4<Real> const &Hz_bias = H_biasfield[2]->array(mfi);    // Hz_bias is the z component at |_z faces
+        // cell-centered demagnetizing field, only read when warpx.mag_LLG_demag_coupling = 1
+        Array4<Real const> Hd;
+#ifdef WARPX_USE_PSATD
+        if (demag_coupling == 1) Hd = warpx.getDemagnetization()->getHdemag().const_array(scratch_index);
+#endif
 
         amrex::IntVect Mxface_stag = Mfield[0]->ixType().toIntVect();
         amrex::IntVect Myface_stag = Mfield[1]->ixType().toIntVect();
         amrex::IntVect Mzface_stag = Mfield[2]->ixType().toIntVect();
 
         // extract tileboxes for which to loop
-        Box const &tbx = mfi.tilebox(Hfield[0]->ixType().toIntVect()); /* just define which grid type */
-        Box const &tby = mfi.tilebox(Hfield[1]->ixType().toIntVect());
-        Box const &tbz = mfi.tilebox(Hfield[2]->ixType().toIntVect());
+        Box const &tbx = UpdateTileBox(mfi, Hfield[0]->ixType().toIntVect()); /* just define which grid type */
+        Box const &tby = UpdateTileBox(mfi, Hfield[1]->ixType().toIntVect());
+        Box const &tbz = UpdateTileBox(mfi, Hfield[2]->ixType().toIntVect());
+
+        // whether the kernels reduce the magnetization statistics, and the faces they count
+        bool const mag_stats = m_llg_mag_stats_active;
+        Box const stats_xbx = LLGMagnetizationStatsBox(mfi, 0);
+        Box const stats_ybx = LLGMagnetizationStatsBox(mfi, 1);
+        Box const stats_zbx = LLGMagnetizationStatsBox(mfi, 2);
 
         // Extract stencil coefficients for calculating the exchange field H_exchange and the anisotropy field H_anisotropy
         amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
@@ -162,8 +193,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
         int const n_coefs_z = m_stencil_coefs_z.size();
 
         // loop over cells and update fields
-        amrex::ParallelFor(tbx,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+        auto const update_M_xface =
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) -> LLGMagnetizationStats::ReduceTuple {
+
+                // statistics of M^(old_time) on this face, if requested
+                LLGMagnetizationStats::ReduceTuple stats = LLGMagnetizationStats::None();
 
                 // determine if the material is nonmagnetic or not
                 if (mag_Ms_xface_arr(i,j,k) > 0._rt)
@@ -171,20 +205,25 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                     // when working on M_xface(i,j,k, 0:2) we have direct access to M_xface(i,j,k,0:2) and Hx(i,j,k)
                     // Hy and Hz can be acquired by interpolation
 
-                    // H_bias
-                    amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias);
-                    amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias);
-                    amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias);
-                    if (coupling == 1)
-                    {
-                        // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy ... (only the first two terms are considered here)
-
-                        // H_maxwell - use H^(old_time)
-                        Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx);
-                        Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy);
-                        Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz);
+                    // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                    amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias, Hx)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias);
+                    amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias, Hy)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias);
+                    amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias, Hz)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias);
+
+                    if (demag_coupling == 1){
+                        // H_demag - averaged from the two cells sharing this face
+                        Hx_eff += 0.5_rt * (Hd(i-1, j, k, 0) + Hd(i, j, k, 0));
+                        Hy_eff += 0.5_rt * (Hd(i-1, j, k, 1) + Hd(i, j, k, 1));
+                        Hz_eff += 0.5_rt * (Hd(i-1, j, k, 2) + Hd(i, j, k, 2));
                     }
 
+                    // M.H_exchange and M.H_anisotropy, for the magnetization statistics
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+
                     if (mag_exchange_coupling == 1){
 
                         if (mag_exchange_xface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_xface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
@@ -199,9 +238,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         amrex::Real Ms_lo_z = mag_Ms_xface_arr(i, j, k-1);
                         amrex::Real Ms_hi_z = mag_Ms_xface_arr(i, j, k+1);
 
-                        Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 0); //Last argument is nodality -- xface = 0
-                        Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 0); //Last argument is nodality -- xface = 0
-                        Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 0); //Last argument is nodality -- xface = 0
+                        amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_old_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0); //Last argument is nodality -- xface = 0
+                        Hx_eff += H_exchange_coeff * lap_M[0];
+                        Hy_eff += H_exchange_coeff * lap_M[1];
+                        Hz_eff += H_exchange_coeff * lap_M[2];
+                        M_dot_H_exchange = H_exchange_coeff * (M_old_xface(i, j, k, 0) * lap_M[0] + M_old_xface(i, j, k, 1) * lap_M[1] + M_old_xface(i, j, k, 2) * lap_M[2]);
                     }
 
                     if (mag_anisotropy_coupling == 1){
@@ -217,6 +258,16 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
                         Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
                         Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
+                    }
+
+                    if (mag_stats && stats_xbx.contains(IntVect(AMREX_D_DECL(i, j, k)))){
+                        // statistics of M^(old_time), see LLGMagnetizationStats.H
+                        amrex::Real const M_dot_H_bias = M_old_xface(i, j, k, 0) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias)
+                                                       + M_old_xface(i, j, k, 1) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias)
+                                                       + M_old_xface(i, j, k, 2) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias);
+                        stats = LLGMagnetizationStats::Face(M_old_xface(i, j, k, 0), M_old_xface(i, j, k, 1), M_old_xface(i, j, k, 2),
+                                                            mag_Ms_xface_arr(i,j,k), M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
                     }
 
                     // magnetic material properties mag_alpha and mag_Ms are defined at faces
@@ -277,10 +328,15 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         }
                     }
                 } // end if (mag_Ms_xface_arr(i,j,k)(i,j,k) > 0...
-            });
+                return stats;
+            };
+        LLGMagnetizationStats::ForEachFace(mag_stats, tbx, stats_op, stats_data, update_M_xface);
 
-        amrex::ParallelFor(tby,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+        auto const update_M_yface =
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) -> LLGMagnetizationStats::ReduceTuple {
+
+                // statistics of M^(old_time) on this face, if requested
+                LLGMagnetizationStats::ReduceTuple stats = LLGMagnetizationStats::None();
 
                 // determine if the material is nonmagnetic or not
                 if (mag_Ms_yface_arr(i,j,k) > 0._rt)
@@ -288,20 +344,25 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                     // when working on M_yface(i,j,k,0:2) we have direct access to M_yface(i,j,k,0:2) and Hy(i,j,k)
                     // Hy and Hz can be acquired by interpolation
 
-                    // H_bias
-                    amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias);
-                    amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias);
-                    amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias);
-                    if (coupling == 1)
-                    {
-                        // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy ... (only the first two terms are considered here)
-
-                        // H_maxwell - use H^(old_time)
-                        Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx);
-                        Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy);
-                        Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz);
+                    // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                    amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias, Hx)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias);
+                    amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias, Hy)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias);
+                    amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias, Hz)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias);
+
+                    if (demag_coupling == 1){
+                        // H_demag - averaged from the two cells sharing this face
+                        Hx_eff += 0.5_rt * (Hd(i, j-1, k, 0) + Hd(i, j, k, 0));
+                        Hy_eff += 0.5_rt * (Hd(i, j-1, k, 1) + Hd(i, j, k, 1));
+                        Hz_eff += 0.5_rt * (Hd(i, j-1, k, 2) + Hd(i, j, k, 2));
                     }
 
+                    // M.H_exchange and M.H_anisotropy, for the magnetization statistics
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+
                     if (mag_exchange_coupling == 1){
 
                         if (mag_exchange_yface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_yface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
@@ -316,9 +377,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         amrex::Real Ms_lo_z = mag_Ms_yface_arr(i, j, k-1);
                         amrex::Real Ms_hi_z = mag_Ms_yface_arr(i, j, k+1);
 
-                        Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 1); //Last argument is nodality -- yface = 1
-                        Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 1); //Last argument is nodality -- yface = 1
-                        Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 1); //Last argument is nodality -- yface = 1
+                        amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_old_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1); //Last argument is nodality -- yface = 1
+                        Hx_eff += H_exchange_coeff * lap_M[0];
+                        Hy_eff += H_exchange_coeff * lap_M[1];
+                        Hz_eff += H_exchange_coeff * lap_M[2];
+                        M_dot_H_exchange = H_exchange_coeff * (M_old_yface(i, j, k, 0) * lap_M[0] + M_old_yface(i, j, k, 1) * lap_M[1] + M_old_yface(i, j, k, 2) * lap_M[2]);
                     }
 
                     if (mag_anisotropy_coupling == 1){
@@ -334,6 +397,16 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
                         Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
                         Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
+                    }
+
+                    if (mag_stats && stats_ybx.contains(IntVect(AMREX_D_DECL(i, j, k)))){
+                        // statistics of M^(old_time), see LLGMagnetizationStats.H
+                        amrex::Real const M_dot_H_bias = M_old_yface(i, j, k, 0) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias)
+                                                       + M_old_yface(i, j, k, 1) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias)
+                                                       + M_old_yface(i, j, k, 2) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias);
+                        stats = LLGMagnetizationStats::Face(M_old_yface(i, j, k, 0), M_old_yface(i, j, k, 1), M_old_yface(i, j, k, 2),
+                                                            mag_Ms_yface_arr(i,j,k), M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
                     }
 
                     // magnetic material properties mag_alpha and mag_Ms are defined at faces
@@ -394,10 +467,15 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         }
                     }
                 } // end if (mag_Ms_yface_arr(i,j,k)(i,j,k) > 0...
-            });
+                return stats;
+            };
+        LLGMagnetizationStats::ForEachFace(mag_stats, tby, stats_op, stats_data, update_M_yface);
 
-        amrex::ParallelFor(tbz,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+        auto const update_M_zface =
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) -> LLGMagnetizationStats::ReduceTuple {
+
+                // statistics of M^(old_time) on this face, if requested
+                LLGMagnetizationStats::ReduceTuple stats = LLGMagnetizationStats::None();
 
                 // determine if the material is nonmagnetic or not
                 if (mag_Ms_zface_arr(i,j,k) > 0._rt)
@@ -405,21 +483,25 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                     // when working on M_zface(i,j,k,0:2) we have direct access to M_zface(i,j,k,0:2) and Hz(i,j,k)
                     // Hy and Hz can be acquired by interpolation
 
-                    // H_bias
-                    amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias);
-                    amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias);
-                    amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias);
-
-                    if (coupling == 1)
-                    {
-                        // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy ... (only the first two terms are considered here)
-
-                        // H_maxwell - use H^(old_time)
-                        Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx);
-                        Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy);
-                        Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz);
+                    // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                    amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias, Hx)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias);
+                    amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias, Hy)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias);
+                    amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias, Hz)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias);
+
+                    if (demag_coupling == 1){
+                        // H_demag - averaged from the two cells sharing this face
+                        Hx_eff += 0.5_rt * (Hd(i, j, k-1, 0) + Hd(i, j, k, 0));
+                        Hy_eff += 0.5_rt * (Hd(i, j, k-1, 1) + Hd(i, j, k, 1));
+                        Hz_eff += 0.5_rt * (Hd(i, j, k-1, 2) + Hd(i, j, k, 2));
                     }
 
+                    // M.H_exchange and M.H_anisotropy, for the magnetization statistics
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+
                     if (mag_exchange_coupling == 1){
 
                         if (mag_exchange_zface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_zface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
@@ -434,9 +516,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         amrex::Real Ms_lo_z = mag_Ms_zface_arr(i, j, k-1);
                         amrex::Real Ms_hi_z = mag_Ms_zface_arr(i, j, k+1);
 
-                        Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 2); //Last argument is nodality -- zface = 2
-                        Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 2); //Last argument is nodality -- zface = 2
-                        Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_old_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 2); //Last argument is nodality -- zface = 2
+                        amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_old_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2); //Last argument is nodality -- zface = 2
+                        Hx_eff += H_exchange_coeff * lap_M[0];
+                        Hy_eff += H_exchange_coeff * lap_M[1];
+                        Hz_eff += H_exchange_coeff * lap_M[2];
+                        M_dot_H_exchange = H_exchange_coeff * (M_old_zface(i, j, k, 0) * lap_M[0] + M_old_zface(i, j, k, 1) * lap_M[1] + M_old_zface(i, j, k, 2) * lap_M[2]);
                     }
 
                     if (mag_anisotropy_coupling == 1){
@@ -452,6 +536,16 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
                         Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
                         Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
+                    }
+
+                    if (mag_stats && stats_zbx.contains(IntVect(AMREX_D_DECL(i, j, k)))){
+                        // statistics of M^(old_time), see LLGMagnetizationStats.H
+                        amrex::Real const M_dot_H_bias = M_old_zface(i, j, k, 0) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias)
+                                                       + M_old_zface(i, j, k, 1) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias)
+                                                       + M_old_zface(i, j, k, 2) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias);
+                        stats = LLGMagnetizationStats::Face(M_old_zface(i, j, k, 0), M_old_zface(i, j, k, 1), M_old_zface(i, j, k, 2),
+                                                            mag_Ms_zface_arr(i,j,k), M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
                     }
 
                     // magnetic material properties mag_alpha and mag_Ms are defined at faces
@@ -512,36 +606,57 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                         }
                     }
                 } // end if (mag_Ms_zface_arr(i,j,k)(i,j,k) > 0...
-            });
+                return stats;
+            };
+        LLGMagnetizationStats::ForEachFace(mag_stats, tbz, stats_op, stats_data, update_M_zface);
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        }
     }
 
-    amrex::MultiFab& mu_mf = macroscopic_properties->getmu_mf();
-    // Update H(new_time) = f(H(old_time), M(new_time), M(old_time), E(old_time))
+    if (m_llg_mag_stats_active) m_llg_mag_stats = LLGMagnetizationStats::Values(stats_op, stats_data);
+
+    // Update H(new_time) = f(H(old_time), M(new_time), M(old_time), E(old_time)),
+    // and B(new_time) = mu0 (M(new_time) + H(new_time)) in the same pass
     for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
-        auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-        auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-        auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
 
         // Extract field data for this grid/tile
-        Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
+        MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+        MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+        MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
         Array4<Real> const &Hx = Hfield[0]->array(mfi);
         Array4<Real> const &Hy = Hfield[1]->array(mfi);
         Array4<Real> const &Hz = Hfield[2]->array(mfi);
+        Array4<Real> const &Bx = Bfield[0]->array(mfi);
+        Array4<Real> const &By = Bfield[1]->array(mfi);
+        Array4<Real> const &Bz = Bfield[2]->array(mfi);
         Array4<Real> const &Ex = Efield[0]->array(mfi);
         Array4<Real> const &Ey = Efield[1]->array(mfi);
         Array4<Real> const &Ez = Efield[2]->array(mfi);
-        Array4<Real> const &M_xface = Mfield[0]->array(mfi);         // note M_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_yface = Mfield[1]->array(mfi);         // note M_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_zface = Mfield[2]->array(mfi);         // note M_zface include x,y,z components at |_z faces
-        Array4<Real> const &M_old_xface = Mfield_old[0]->array(mfi); // note M_old_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_old_yface = Mfield_old[1]->array(mfi); // note M_old_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_old_zface = Mfield_old[2]->array(mfi); // note M_old_zface include x,y,z components at |_z faces
+        // M and M_old are only read on the magnetic faces, and only stored in the magnetic boxes
+        int const scratch_index = m_llg_scratch_index[mfi.index()];
+        Array4<Real> M_xface; // note M_xface include x,y,z components at |_x faces
+        Array4<Real> M_yface; // note M_yface include x,y,z components at |_y faces
+        Array4<Real> M_zface; // note M_zface include x,y,z components at |_z faces
+        Array4<LLGStorageReal> M_old_xface; // note M_old_xface include x,y,z components at |_x faces
+        Array4<LLGStorageReal> M_old_yface; // note M_old_yface include x,y,z components at |_y faces
+        Array4<LLGStorageReal> M_old_zface; // note M_old_zface include x,y,z components at |_z faces
+        if (scratch_index >= 0) {
+            M_xface = Mfield[0]->array(scratch_index);
+            M_yface = Mfield[1]->array(scratch_index);
+            M_zface = Mfield[2]->array(scratch_index);
+            M_old_xface = Mfield_old[0]->array(scratch_index);
+            M_old_yface = Mfield_old[1]->array(scratch_index);
+            M_old_zface = Mfield_old[2]->array(scratch_index);
+        }
 
         // macroscopic parameter
-        amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
+        MaterialPropertyArray const mu_arr = macroscopic_properties->getmu_arr(mfi);
 
         // Extract stencil coefficients
         amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
@@ -555,9 +670,9 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
         amrex::IntVect Hxnodal = Hfield[0]->ixType().toIntVect();
         amrex::IntVect Hynodal = Hfield[1]->ixType().toIntVect();
         amrex::IntVect Hznodal = Hfield[2]->ixType().toIntVect();
-        Box const &tbx = mfi.tilebox(Hxnodal);
-        Box const &tby = mfi.tilebox(Hynodal);
-        Box const &tbz = mfi.tilebox(Hznodal);
+        Box const &tbx = UpdateTileBox(mfi, Hxnodal);
+        Box const &tby = UpdateTileBox(mfi, Hynodal);
+        Box const &tbz = UpdateTileBox(mfi, Hznodal);
 
         amrex::Real const mu0_inv = 1. / PhysConst::mu0;
 
@@ -570,12 +685,18 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                                                              macro_cr, i, j, k, 0);
                     Hx(i, j, k) += 1. / mu_arrx * dt * (T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
                                                       - T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k));
+                    if (maintain_B) {
+                        Bx(i, j, k) = mu_arrx * Hx(i, j, k);
+                    }
                 } else if (mag_Ms_xface_arr(i,j,k) > 0){ // magnetic region
                     Hx(i, j, k) += mu0_inv * dt * (T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
                                                  - T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k));
                     if (coupling == 1) {
                         Hx(i, j, k) += - M_xface(i, j, k, 0) + M_old_xface(i, j, k, 0);
                     }
+                    if (maintain_B) {
+                        Bx(i, j, k) = PhysConst::mu0 * (M_xface(i, j, k, 0) + Hx(i, j, k));
+                    }
                 }
             },
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
@@ -585,12 +706,18 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                                                              macro_cr, i, j, k, 0);
                     Hy(i, j, k) += 1. / mu_arry * dt * (T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
                                                       - T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k));
+                    if (maintain_B) {
+                        By(i, j, k) = mu_arry * Hy(i, j, k);
+                    }
                 } else if (mag_Ms_yface_arr(i,j,k) > 0){ // magnetic region
                     Hy(i, j, k) += mu0_inv * dt * (T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
                                                  - T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k));
                     if (coupling == 1){
                         Hy(i, j, k) += - M_yface(i, j, k, 1) + M_old_yface(i, j, k, 1);
                     }
+                    if (maintain_B) {
+                        By(i, j, k) = PhysConst::mu0 * (M_yface(i, j, k, 1) + Hy(i, j, k));
+                    }
                 }
             },
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
@@ -600,84 +727,84 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian(
                                                              macro_cr, i, j, k, 0);
                     Hz(i, j, k) += 1. / mu_arrz * dt * (T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
                                                       - T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k));
+                    if (maintain_B) {
+                        Bz(i, j, k) = mu_arrz * Hz(i, j, k);
+                    }
                 } else if (mag_Ms_zface_arr(i,j,k) > 0){ // magnetic region
                     Hz(i, j, k) += mu0_inv * dt * (T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
                                                  - T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k));
                     if (coupling == 1){
                         Hz(i, j, k) += - M_zface(i, j, k, 2) + M_old_zface(i, j, k, 2);
                     }
+                    if (maintain_B) {
+                        Bz(i, j, k) = PhysConst::mu0 * (M_zface(i, j, k, 2) + Hz(i, j, k));
+                    }
                 }
             });
     }
+}
 
-    // update B
+void FiniteDifferenceSolver::ComputeBfromHM(
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &Bfield,
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const &Hfield,
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const &Mfield,
+    std::unique_ptr<MacroscopicProperties> const &macroscopic_properties)
+{
+    amrex::GpuArray<int, 3> const& mu_stag = macroscopic_properties->mu_IndexType;
+    amrex::GpuArray<int, 3> const& Hx_stag = macroscopic_properties->Hx_IndexType;
+    amrex::GpuArray<int, 3> const& Hy_stag = macroscopic_properties->Hy_IndexType;
+    amrex::GpuArray<int, 3> const& Hz_stag = macroscopic_properties->Hz_IndexType;
+    amrex::GpuArray<int, 3> const& macro_cr= macroscopic_properties->macro_cr_ratio;
+    // M is only stored on the magnetic boxes, the LLG solver only runs on level 0
+    amrex::Vector<int> const& mag_box_index = WarpX::GetInstance().getMagneticBoxIndex(0);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
     for (MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
-
-        auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-        auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-        auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
-
-        // extract material properties
-        Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
-
-        // Extract field data for this grid/tile
-        Array4<Real> const &Hx = Hfield[0]->array(mfi);
-        Array4<Real> const &Hy = Hfield[1]->array(mfi);
-        Array4<Real> const &Hz = Hfield[2]->array(mfi);
+        MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+        MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+        MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
+        MaterialPropertyArray const mu_arr = macroscopic_properties->getmu_arr(mfi);
         Array4<Real> const &Bx = Bfield[0]->array(mfi);
         Array4<Real> const &By = Bfield[1]->array(mfi);
         Array4<Real> const &Bz = Bfield[2]->array(mfi);
-        Array4<Real> const &M_xface = Mfield[0]->array(mfi); // note M_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_yface = Mfield[1]->array(mfi); // note M_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_zface = Mfield[2]->array(mfi); // note M_zface include x,y,z components at |_z faces
-
-        // Extract tileboxes for which to loop
-        amrex::IntVect Bxnodal = Bfield[0]->ixType().toIntVect();
-        amrex::IntVect Bynodal = Bfield[1]->ixType().toIntVect();
-        amrex::IntVect Bznodal = Bfield[2]->ixType().toIntVect();
-        Box const &tbx = mfi.tilebox(Bxnodal);
-        Box const &tby = mfi.tilebox(Bynodal);
-        Box const &tbz = mfi.tilebox(Bznodal);
+        Array4<Real const> const &Hx = Hfield[0]->const_array(mfi);
+        Array4<Real const> const &Hy = Hfield[1]->const_array(mfi);
+        Array4<Real const> const &Hz = Hfield[2]->const_array(mfi);
+        int const mag_index = mag_box_index[mfi.index()];
+        Array4<Real const> M_xface, M_yface, M_zface;
+        if (mag_index >= 0) {
+            M_xface = Mfield[0]->const_array(mag_index);
+            M_yface = Mfield[1]->const_array(mag_index);
+            M_zface = Mfield[2]->const_array(mag_index);
+        }
+
+        Box const &tbx = mfi.tilebox(Bfield[0]->ixType().toIntVect());
+        Box const &tby = mfi.tilebox(Bfield[1]->ixType().toIntVect());
+        Box const &tbz = mfi.tilebox(Bfield[2]->ixType().toIntVect());
 
-        // macroscopic parameter
-        amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
-
-        // Loop over the cells and update the fields
         amrex::ParallelFor(tbx, tby, tbz,
-
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-
-                if (mag_Ms_xface_arr(i,j,k) == 0._rt){ // nonmagnetic region
-                    amrex::Real mu_arrx = CoarsenIO::Interp( mu_arr, mu_stag, Bx_stag,
-                                                             macro_cr, i, j, k, 0);
-                    Bx(i, j, k) = mu_arrx * Hx(i, j, k);
-                } else if (mag_Ms_xface_arr(i,j,k) > 0){
+                if (mag_Ms_xface_arr(i,j,k) > 0._rt) {
                     Bx(i, j, k) = PhysConst::mu0 * (M_xface(i, j, k, 0) + Hx(i, j, k));
+                } else {
+                    Bx(i, j, k) = CoarsenIO::Interp(mu_arr, mu_stag, Hx_stag, macro_cr, i, j, k, 0) * Hx(i, j, k);
                 }
             },
-
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-
-                if (mag_Ms_yface_arr(i,j,k) == 0._rt){ // nonmagnetic region
-                    amrex::Real mu_arry = CoarsenIO::Interp( mu_arr, mu_stag, By_stag,
-                                                             macro_cr, i, j, k, 0);
-                    By(i, j, k) =  mu_arry * Hy(i, j, k);
-                } else if (mag_Ms_yface_arr(i,j,k) > 0){
+                if (mag_Ms_yface_arr(i,j,k) > 0._rt) {
                     By(i, j, k) = PhysConst::mu0 * (M_yface(i, j, k, 1) + Hy(i, j, k));
+                } else {
+                    By(i, j, k) = CoarsenIO::Interp(mu_arr, mu_stag, Hy_stag, macro_cr, i, j, k, 0) * Hy(i, j, k);
                 }
             },
-
             [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-
-                if (mag_Ms_zface_arr(i,j,k) == 0._rt){ // nonmagnetic region
-                    amrex::Real mu_arrz = CoarsenIO::Interp( mu_arr, mu_stag, Bz_stag,
-                                                             macro_cr, i, j, k, 0);
-                    Bz(i, j, k) = mu_arrz * Hz(i, j, k);
-                } else if (mag_Ms_zface_arr(i,j,k) > 0){
+                if (mag_Ms_zface_arr(i,j,k) > 0._rt) {
                     Bz(i, j, k) = PhysConst::mu0 * (M_zface(i, j, k, 2) + Hz(i, j, k));
+                } else {
+                    Bz(i, j, k) = CoarsenIO::Interp(mu_arr, mu_stag, Hz_stag, macro_cr, i, j, k, 0) * Hz(i, j, k);
                 }
             });
     }
@@ -10,12 +10,28 @@ blank
 #else
 #include "FiniteDifferenceAlgorithms/CartesianYeeAlgorithm.H"
 #endif
+#include "FieldSolver/FiniteDifferenceSolver/LLGMagnetizationStats.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#if defined(WARPX_MAG_LLG) && defined(WARPX_USE_PSATD)
+#include "FieldSolver/Demagnetization/Demagnetization.H"
+#endif
 
 #include "Utils/WarpXConst.H"
 #include "Utils/CoarsenIO.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 #include <AMReX_Gpu.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace amrex;
 
@@ -26,6 +42,39 @@ using namespace amrex;
 #ifndef WARPX_DIM_RZ
 #ifdef WARPX_MAG_LLG
 
+namespace {
+    /** Reach of the guard-cell reads of the M update: one face for the averages of H,
+     *  and two faces for the one-sided exchange Laplacian at the edge of a material */
+    constexpr int llg_guard_reach = 2;
+
+    /** Boxes of the tilebox tb updated in the given pass of an iteration: in pass 0, the faces
+     *  of tb that do not read the guard cells of the valid box valid_bx; in pass 1, the others */
+    amrex::BoxList LLGPassBoxes (amrex::Box const& tb, amrex::Box const& valid_bx, int const pass)
+    {
+        amrex::Box const interior = tb & amrex::grow(valid_bx, -llg_guard_reach);
+        if (pass == 0) {
+            return interior.ok() ? amrex::BoxList(interior) : amrex::BoxList(tb.ixType());
+        }
+        return interior.ok() ? amrex::boxDiff(tb, interior) : amrex::BoxList(tb);
+    }
+
+    /** Residual f = g - x of the 2nd-order LLG iterations in amrex::Real, with the iterate x
+     *  in the LLG storage precision, on the valid cells and the first ng guard cells */
+    void LLGResidual (amrex::MultiFab& f, amrex::MultiFab const& g, LLGStorageFab const& x,
+                      amrex::IntVect const& ng)
+    {
+        for (amrex::MFIter mfi(f, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            amrex::Array4<amrex::Real> const& f_arr = f.array(mfi);
+            amrex::Array4<amrex::Real const> const& g_arr = g.const_array(mfi);
+            amrex::Array4<LLGStorageReal const> const& x_arr = x.const_array(mfi);
+            amrex::ParallelFor(mfi.growntilebox(ng), f.nComp(),
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    f_arr(i, j, k, n) = g_arr(i, j, k, n) - static_cast<amrex::Real>(x_arr(i, j, k, n));
+                });
+        }
+    }
+}
+
 void FiniteDifferenceSolver::MacroscopicEvolveHM_2nd(
     // The MField here is a vector of three multifabs, with M on each face, and each multifab is a three-component multifab.
     // Each M-multifab has three components, one for each component in x, y, z. (All multifabs are four dimensional, (i,j,k,n)), where, n=1 for E, B, but, n=3 for M_xface, M_yface, M_zface
@@ -65,100 +114,105 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
     int M_normalization = warpx.mag_M_normalization;
     int mag_exchange_coupling = warpx.mag_LLG_exchange_coupling;
     int mag_anisotropy_coupling = warpx.mag_LLG_anisotropy_coupling;
-
-    // build temporary vector<multifab,3> Mfield_prev, Mfield_error, a_temp, a_temp_static, b_temp_static
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> Hfield_old;    // H^(old_time) before the current time step
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> Mfield_old;    // M^(old_time) before the current time step
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> Mfield_prev;   // M^(new_time) of the (r-1)th iteration
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> Mfield_error;  // The error of the M field between the two consecutive iterations
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> a_temp;        // right-hand side of vector a, see the documentation
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> a_temp_static; // α M^(old_time)/|M| in the right-hand side of vector a, see the documentation
-    std::array<std::unique_ptr<amrex::MultiFab>, 3> b_temp_static; // right-hand side of vector b, see the documentation
+    int maintain_B = warpx.mag_LLG_maintain_B;
+    int demag_coupling = warpx.mag_LLG_demag_coupling;
+    int demag_every_iteration = warpx.mag_LLG_demag_every_iteration;
+
+    // history depth of the Anderson acceleration, 0 for the plain fixed-point iteration
+    int const anderson_depth = macroscopic_properties->getmag_anderson_depth();
+    // only iterate on the boxes that have not converged yet, and on their neighbours
+    bool const active_set = macroscopic_properties->getmag_active_set();
+    // the demagnetizing field couples all the boxes, so none of them can be frozen
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!(active_set && demag_coupling == 1),
+        "macroscopic.mag_active_set cannot be combined with warpx.mag_LLG_demag_coupling = 1");
+
+    // persistent scratch data of the 2nd-order scheme, only (re)allocated on regrid or load balance
+    WARPX_PROFILE_VAR("FiniteDifferenceSolver::MacroscopicEvolveHM_2nd::Workspace", blp_llg_workspace);
+    AllocateLLGWorkspace(Mfield, Hfield, anderson_depth);
+    WARPX_PROFILE_VAR_STOP(blp_llg_workspace);
+    // per-box count of the M updates, for the load balancing cost model
+    BeginLLGBoxUpdates(*Hfield[0]);
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    // statistics of M^(old_time) for the MagnetizationReduction reduced diagnostic, if requested;
+    // they are reduced in the kernels of b_temp_static, which see M^(old_time) and its H_eff terms
+    BeginLLGMagnetizationStats();
+    LLGMagnetizationStats::ReduceOps stats_op;
+    LLGMagnetizationStats::ReduceData stats_data(stats_op);
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &Hfield_old = m_llg_Hfield_old;       // H^(old_time) before the current time step
+    std::array<std::unique_ptr<LLGStorageFab>, 3> &Mfield_old = m_llg_Mfield_old;         // M^(old_time) before the current time step
+    std::array<std::unique_ptr<LLGStorageFab>, 3> &Mfield_prev = m_llg_Mfield_prev;       // M^(new_time) of the (r-1)th iteration
+    std::array<std::unique_ptr<LLGStorageFab>, 3> &b_temp_static = m_llg_b_temp_static;   // right-hand side of vector b, see the documentation
+    // Note: M and, except for Hfield_old, the scratch data only cover the magnetic boxes: the loops run
+    // on the layout of H, and the fab of M of the box mfi.index() is m_llg_scratch_index[mfi.index()]
+    // Note: the right-hand side of vector a and its static part α M^(old_time)/|M| are computed
+    // on the fly from Mfield_old in the iteration kernels and are not stored; the error between
+    // two consecutive iterations is reduced inside the M update kernels and is not stored either
 
     amrex::GpuArray<int, 3> const& mu_stag  = macroscopic_properties->mu_IndexType;
-    amrex::GpuArray<int, 3> const& Bx_stag  = macroscopic_properties->Bx_IndexType;
-    amrex::GpuArray<int, 3> const& By_stag  = macroscopic_properties->By_IndexType;
-    amrex::GpuArray<int, 3> const& Bz_stag  = macroscopic_properties->Bz_IndexType;
     amrex::GpuArray<int, 3> const& Hx_stag  = macroscopic_properties->Hx_IndexType;
     amrex::GpuArray<int, 3> const& Hy_stag  = macroscopic_properties->Hy_IndexType;
     amrex::GpuArray<int, 3> const& Hz_stag  = macroscopic_properties->Hz_IndexType;
     amrex::GpuArray<int, 3> const& macro_cr = macroscopic_properties->macro_cr_ratio;
     amrex::GpuArray<amrex::Real, 3> const& anisotropy_axis = macroscopic_properties->mag_LLG_anisotropy_axis;
 
-    // Initialize Hfield_old (H^(old_time)), Mfield_old (M^(old_time)), Mfield_prev (M^[(new_time),r-1]), Mfield_error
+    // Initialize Hfield_old (H^(old_time)), Mfield_old (M^(old_time)), Mfield_prev (M^[(new_time),r-1])
     for (int i = 0; i < 3; i++){
-        Hfield_old[i].reset(new MultiFab(Hfield[i]->boxArray(), Hfield[i]->DistributionMap(), 1, Hfield[i]->nGrow()));
-        Mfield_old[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        Mfield_prev[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        Mfield_error[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        Mfield_error[i]->setVal(0.); // reset Mfield_error to zero
         MultiFab::Copy(*Hfield_old[i], *Hfield[i], 0, 0, 1, Hfield[i]->nGrow());
-        MultiFab::Copy(*Mfield_old[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
-        MultiFab::Copy(*Mfield_prev[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
-    }
-    // initialize a_temp, a_temp_static, b_temp_static
-    for (int i = 0; i < 3; i++){
-        a_temp[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        a_temp_static[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
-        b_temp_static[i].reset(new MultiFab(Mfield[i]->boxArray(), Mfield[i]->DistributionMap(), 3, Mfield[i]->nGrow()));
+        CopyToLLGScratch(*Mfield_old[i], *Mfield[i]);
+        CopyToLLGScratch(*Mfield_prev[i], *Mfield[i]);
     }
 
-    amrex::MultiFab& mu_mf = macroscopic_properties->getmu_mf();
-
-    // calculate the b_temp_static, a_temp_static
-    for (MFIter mfi(*a_temp_static[0], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-
-        auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-        auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-        auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
-        auto& mag_alpha_xface_mf = macroscopic_properties->getmag_alpha_mf(0);
-        auto& mag_alpha_yface_mf = macroscopic_properties->getmag_alpha_mf(1);
-        auto& mag_alpha_zface_mf = macroscopic_properties->getmag_alpha_mf(2);
-        auto& mag_gamma_xface_mf = macroscopic_properties->getmag_gamma_mf(0);
-        auto& mag_gamma_yface_mf = macroscopic_properties->getmag_gamma_mf(1);
-        auto& mag_gamma_zface_mf = macroscopic_properties->getmag_gamma_mf(2);
-        auto& mag_exchange_xface_mf = macroscopic_properties->getmag_exchange_mf(0);
-        auto& mag_exchange_yface_mf = macroscopic_properties->getmag_exchange_mf(1);
-        auto& mag_exchange_zface_mf = macroscopic_properties->getmag_exchange_mf(2);
-        auto& mag_anisotropy_xface_mf = macroscopic_properties->getmag_anisotropy_mf(0);
-        auto& mag_anisotropy_yface_mf = macroscopic_properties->getmag_anisotropy_mf(1);
-        auto& mag_anisotropy_zface_mf = macroscopic_properties->getmag_anisotropy_mf(2);
+#ifdef WARPX_USE_PSATD
+    // demagnetizing field of M(old_time), for b_temp_static
+    if (demag_coupling == 1) warpx.getDemagnetization()->ComputeDemagField(Mfield);
+#endif
+
+
+    // calculate the b_temp_static
+    for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+        // b_temp_static is only used on magnetic faces
+        if (!macroscopic_properties->is_magnetic_box(mfi)) continue;
+        int const scratch_index = m_llg_scratch_index[mfi.index()];
+
 
         // extract material properties
-        Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
-        Array4<Real> const& mag_alpha_xface_arr = mag_alpha_xface_mf.array(mfi);
-        Array4<Real> const& mag_alpha_yface_arr = mag_alpha_yface_mf.array(mfi);
-        Array4<Real> const& mag_alpha_zface_arr = mag_alpha_zface_mf.array(mfi);
-        Array4<Real> const& mag_gamma_xface_arr = mag_gamma_xface_mf.array(mfi);
-        Array4<Real> const& mag_gamma_yface_arr = mag_gamma_yface_mf.array(mfi);
-        Array4<Real> const& mag_gamma_zface_arr = mag_gamma_zface_mf.array(mfi);
-        Array4<Real> const& mag_exchange_xface_arr = mag_exchange_xface_mf.array(mfi);
-        Array4<Real> const& mag_exchange_yface_arr = mag_exchange_yface_mf.array(mfi);
-        Array4<Real> const& mag_exchange_zface_arr = mag_exchange_zface_mf.array(mfi);
-        Array4<Real> const& mag_anisotropy_xface_arr = mag_anisotropy_xface_mf.array(mfi);
-        Array4<Real> const& mag_anisotropy_yface_arr = mag_anisotropy_yface_mf.array(mfi);
-        Array4<Real> const& mag_anisotropy_zface_arr = mag_anisotropy_zface_mf.array(mfi);
+        MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+        MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+        MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
+        MaterialPropertyArray const mag_alpha_xface_arr = macroscopic_properties->getmag_alpha_arr(0, mfi);
+        MaterialPropertyArray const mag_alpha_yface_arr = macroscopic_properties->getmag_alpha_arr(1, mfi);
+        MaterialPropertyArray const mag_alpha_zface_arr = macroscopic_properties->getmag_alpha_arr(2, mfi);
+        MaterialPropertyArray const mag_gamma_xface_arr = macroscopic_properties->getmag_gamma_arr(0, mfi);
+        MaterialPropertyArray const mag_gamma_yface_arr = macroscopic_properties->getmag_gamma_arr(1, mfi);
+        MaterialPropertyArray const mag_gamma_zface_arr = macroscopic_properties->getmag_gamma_arr(2, mfi);
+        MaterialPropertyArray const mag_exchange_xface_arr = macroscopic_properties->getmag_exchange_arr(0, mfi);
+        MaterialPropertyArray const mag_exchange_yface_arr = macroscopic_properties->getmag_exchange_arr(1, mfi);
+        MaterialPropertyArray const mag_exchange_zface_arr = macroscopic_properties->getmag_exchange_arr(2, mfi);
+        MaterialPropertyArray const mag_anisotropy_xface_arr = macroscopic_properties->getmag_anisotropy_arr(0, mfi);
+        MaterialPropertyArray const mag_anisotropy_yface_arr = macroscopic_properties->getmag_anisotropy_arr(1, mfi);
+        MaterialPropertyArray const mag_anisotropy_zface_arr = macroscopic_properties->getmag_anisotropy_arr(2, mfi);
 
         // extract field data
-        Array4<Real> const &M_xface = Mfield[0]->array(mfi);      // note M_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_yface = Mfield[1]->array(mfi);      // note M_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_zface = Mfield[2]->array(mfi);      // note M_zface include x,y,z components at |_z faces
+        Array4<Real> const &M_xface = Mfield[0]->array(scratch_index); // note M_xface include x,y,z components at |_x faces
+        Array4<Real> const &M_yface = Mfield[1]->array(scratch_index); // note M_yface include x,y,z components at |_y faces
+        Array4<Real> const &M_zface = Mfield[2]->array(scratch_index); // note M_zface include x,y,z components at |_z faces
         Array4<Real> const &Hx_bias = H_biasfield[0]->array(mfi); // Hx_bias is the x component at |_x faces
         Array4<Real> const &Hy_bias = H_biasfield[1]->array(mfi); // Hy_bias is the y component at |_y faces
         Array4<Real> const &Hz_bias = H_biasfield[2]->array(mfi); // Hz_bias is the z component at |_z faces
+        // cell-centered demagnetizing field, only read when warpx.mag_LLG_demag_coupling = 1 (on the layout of M)
+        Array4<Real const> Hd;
+#ifdef WARPX_USE_PSATD
+        if (demag_coupling == 1) Hd = warpx.getDemagnetization()->getHdemag().const_array(scratch_index);
+#endif
         Array4<Real> const &Hx_old = Hfield_old[0]->array(mfi);   // Hx_old is the x component at |_x faces
         Array4<Real> const &Hy_old = Hfield_old[1]->array(mfi);   // Hy_old is the y component at |_y faces
         Array4<Real> const &Hz_old = Hfield_old[2]->array(mfi);   // Hz_old is the z component at |_z faces
 
-        // extract field data of a_temp_static and b_temp_static
-        Array4<Real> const &a_temp_static_xface = a_temp_static[0]->array(mfi);
-        Array4<Real> const &a_temp_static_yface = a_temp_static[1]->array(mfi);
-        Array4<Real> const &a_temp_static_zface = a_temp_static[2]->array(mfi);
-        Array4<Real> const &b_temp_static_xface = b_temp_static[0]->array(mfi);
-        Array4<Real> const &b_temp_static_yface = b_temp_static[1]->array(mfi);
-        Array4<Real> const &b_temp_static_zface = b_temp_static[2]->array(mfi);
+        // extract field data of b_temp_static
+        Array4<LLGStorageReal> const &b_temp_static_xface = b_temp_static[0]->array(scratch_index);
+        Array4<LLGStorageReal> const &b_temp_static_yface = b_temp_static[1]->array(scratch_index);
+        Array4<LLGStorageReal> const &b_temp_static_zface = b_temp_static[2]->array(scratch_index);
 
         // extract tileboxes for which to loop
         amrex::IntVect Mxface_stag = Mfield[0]->ixType().toIntVect();
@@ -168,6 +222,12 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
         Box const &tby = mfi.tilebox(Myface_stag);
         Box const &tbz = mfi.tilebox(Mzface_stag);
 
+        // whether the kernels reduce the magnetization statistics, and the faces they count
+        bool const mag_stats = m_llg_mag_stats_active;
+        Box const stats_xbx = LLGMagnetizationStatsBox(mfi, 0);
+        Box const stats_ybx = LLGMagnetizationStatsBox(mfi, 1);
+        Box const stats_zbx = LLGMagnetizationStatsBox(mfi, 2);
+
         // Extract stencil coefficients for calculating the exchange field H_exchange and the anisotropy field H_anisotropy
         amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
         int const n_coefs_x = m_stencil_coefs_x.size();
@@ -177,8 +237,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
         int const n_coefs_z = m_stencil_coefs_z.size();
 
         // loop over cells and update fields
-        amrex::ParallelFor(tbx,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+        auto const b_temp_static_xface_kernel =
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) -> LLGMagnetizationStats::ReduceTuple {
+
+                // statistics of M^(old_time) on this face, if requested
+                LLGMagnetizationStats::ReduceTuple stats = LLGMagnetizationStats::None();
 
                 // determine if the material is nonmagnetic or not
                 if (mag_Ms_xface_arr(i,j,k) > 0._rt){
@@ -186,20 +249,25 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                     // when working on M_xface(i,j,k, 0:2) we have direct access to M_xface(i,j,k,0:2) and Hx(i,j,k)
                     // Hy and Hz can be acquired by interpolation
 
-                    // H_bias
-                    amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias);
-                    amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias);
-                    amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias);
-
-                    if (coupling == 1){
-                        // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy
-
-                        // H_maxwell - use H^(old_time)
-                        Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_old);
-                        Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_old);
-                        Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_old);
+                    // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                    amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias, Hx)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias);
+                    amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias, Hy)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias);
+                    amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias, Hz)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias);
+
+                    if (demag_coupling == 1){
+                        // H_demag - averaged from the two cells sharing this face
+                        Hx_eff += 0.5_rt * (Hd(i-1, j, k, 0) + Hd(i, j, k, 0));
+                        Hy_eff += 0.5_rt * (Hd(i-1, j, k, 1) + Hd(i, j, k, 1));
+                        Hz_eff += 0.5_rt * (Hd(i-1, j, k, 2) + Hd(i, j, k, 2));
                     }
 
+                    // M.H_exchange and M.H_anisotropy, for the magnetization statistics
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+
                     if (mag_exchange_coupling == 1){
 
                         if (mag_exchange_xface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_xface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
@@ -214,9 +282,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         amrex::Real Ms_lo_z = mag_Ms_xface_arr(i, j, k-1);
                         amrex::Real Ms_hi_z = mag_Ms_xface_arr(i, j, k+1);
 
-                        Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 0); //Last argument is nodality -- xface = 0
-                        Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 0); //Last argument is nodality -- xface = 0
-                        Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 0); //Last argument is nodality -- xface = 0
+                        amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0); //Last argument is nodality -- xface = 0
+                        Hx_eff += H_exchange_coeff * lap_M[0];
+                        Hy_eff += H_exchange_coeff * lap_M[1];
+                        Hz_eff += H_exchange_coeff * lap_M[2];
+                        M_dot_H_exchange = H_exchange_coeff * (M_xface(i, j, k, 0) * lap_M[0] + M_xface(i, j, k, 1) * lap_M[1] + M_xface(i, j, k, 2) * lap_M[2]);
                     }
 
                     if (mag_anisotropy_coupling == 1){
@@ -232,24 +302,22 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
                         Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
                         Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
                     }
 
-                    // 0 = unsaturated; compute |M| locally.  1 = saturated; use M_s
-                    amrex::Real M_magnitude = (M_normalization == 0) ? std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) + std::pow(M_xface(i, j, k, 2), 2._rt))
-                                                              : mag_Ms_xface_arr(i,j,k);
-                    // a_temp_static_coeff does not change in the current step for SATURATED materials; but it does change for UNSATURATED ones
-                    amrex::Real a_temp_static_coeff = mag_alpha_xface_arr(i,j,k) / M_magnitude;
+                    if (mag_stats && stats_xbx.contains(IntVect(AMREX_D_DECL(i, j, k)))){
+                        // statistics of M^(old_time), see LLGMagnetizationStats.H
+                        amrex::Real const M_dot_H_bias = M_xface(i, j, k, 0) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mxface_stag, Hx_bias)
+                                                       + M_xface(i, j, k, 1) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mxface_stag, Hy_bias)
+                                                       + M_xface(i, j, k, 2) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mxface_stag, Hz_bias);
+                        stats = LLGMagnetizationStats::Face(M_xface(i, j, k, 0), M_xface(i, j, k, 1), M_xface(i, j, k, 2),
+                                                            mag_Ms_xface_arr(i,j,k), M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
+                    }
 
                     // calculate the b_temp_static_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
                     // while in real simulations, the input dt is actually dt/2.0)
                     amrex::Real b_temp_static_coeff = - PhysConst::mu0 * amrex::Math::abs(mag_gamma_xface_arr(i,j,k)) / 2._rt;
 
-                    for (int comp=0; comp<3; ++comp) {
-                        // calculate a_temp_static_xface
-                        // all components on x-faces of grid
-                        a_temp_static_xface(i, j, k, comp) = a_temp_static_coeff * M_xface(i, j, k, comp);
-                    }
-
                     // calculate b_temp_static_xface
                     // x component on x-faces of grid
                     b_temp_static_xface(i, j, k, 0) = M_xface(i, j, k, 0) + dt * b_temp_static_coeff * (M_xface(i, j, k, 1) * Hz_eff - M_xface(i, j, k, 2) * Hy_eff);
@@ -260,10 +328,15 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                     // z component on x-faces of grid
                     b_temp_static_xface(i, j, k, 2) = M_xface(i, j, k, 2) + dt * b_temp_static_coeff * (M_xface(i, j, k, 0) * Hy_eff - M_xface(i, j, k, 1) * Hx_eff);
                 }
-            });
+                return stats;
+            };
+        LLGMagnetizationStats::ForEachFace(mag_stats, tbx, stats_op, stats_data, b_temp_static_xface_kernel);
 
-        amrex::ParallelFor(tby,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+        auto const b_temp_static_yface_kernel =
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) -> LLGMagnetizationStats::ReduceTuple {
+
+                // statistics of M^(old_time) on this face, if requested
+                LLGMagnetizationStats::ReduceTuple stats = LLGMagnetizationStats::None();
 
                 // determine if the material is nonmagnetic or not
                 if (mag_Ms_yface_arr(i,j,k) > 0._rt){
@@ -271,20 +344,25 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                     // when working on M_yface(i,j,k,0:2) we have direct access to M_yface(i,j,k,0:2) and Hy(i,j,k)
                     // Hy and Hz can be acquired by interpolation
 
-                    // H_bias
-                    amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias);
-                    amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias);
-                    amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias);
-
-                    if (coupling == 1){
-                        // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy
-
-                        // H_maxwell - use H^(old_time)
-                        Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_old);
-                        Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_old);
-                        Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_old);
+                    // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                    amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias, Hx)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias);
+                    amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias, Hy)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias);
+                    amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias, Hz)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias);
+
+                    if (demag_coupling == 1){
+                        // H_demag - averaged from the two cells sharing this face
+                        Hx_eff += 0.5_rt * (Hd(i, j-1, k, 0) + Hd(i, j, k, 0));
+                        Hy_eff += 0.5_rt * (Hd(i, j-1, k, 1) + Hd(i, j, k, 1));
+                        Hz_eff += 0.5_rt * (Hd(i, j-1, k, 2) + Hd(i, j, k, 2));
                     }
 
+                    // M.H_exchange and M.H_anisotropy, for the magnetization statistics
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+
                     if (mag_exchange_coupling == 1){
 
                         if (mag_exchange_yface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_yface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
@@ -299,9 +377,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         amrex::Real Ms_lo_z = mag_Ms_yface_arr(i, j, k-1);
                         amrex::Real Ms_hi_z = mag_Ms_yface_arr(i, j, k+1);
 
-                        Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 1); //Last argument is nodality -- yface = 1
-                        Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 1); //Last argument is nodality -- yface = 1
-                        Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 1); //Last argument is nodality -- yface = 1
+                        amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1); //Last argument is nodality -- yface = 1
+                        Hx_eff += H_exchange_coeff * lap_M[0];
+                        Hy_eff += H_exchange_coeff * lap_M[1];
+                        Hz_eff += H_exchange_coeff * lap_M[2];
+                        M_dot_H_exchange = H_exchange_coeff * (M_yface(i, j, k, 0) * lap_M[0] + M_yface(i, j, k, 1) * lap_M[1] + M_yface(i, j, k, 2) * lap_M[2]);
                     }
 
                     if (mag_anisotropy_coupling == 1){
@@ -317,24 +397,22 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
                         Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
                         Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
                     }
 
-                    // 0 = unsaturated; compute |M| locally.  1 = saturated; use M_s
-                    // note the unsaturated case is less usefull in real devices
-                    amrex::Real M_magnitude = (M_normalization == 0) ? std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) + std::pow(M_yface(i, j, k, 2), 2._rt))
-                                                              : mag_Ms_yface_arr(i,j,k);
-                    amrex::Real a_temp_static_coeff = mag_alpha_yface_arr(i,j,k) / M_magnitude;
+                    if (mag_stats && stats_ybx.contains(IntVect(AMREX_D_DECL(i, j, k)))){
+                        // statistics of M^(old_time), see LLGMagnetizationStats.H
+                        amrex::Real const M_dot_H_bias = M_yface(i, j, k, 0) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Myface_stag, Hx_bias)
+                                                       + M_yface(i, j, k, 1) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Myface_stag, Hy_bias)
+                                                       + M_yface(i, j, k, 2) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Myface_stag, Hz_bias);
+                        stats = LLGMagnetizationStats::Face(M_yface(i, j, k, 0), M_yface(i, j, k, 1), M_yface(i, j, k, 2),
+                                                            mag_Ms_yface_arr(i,j,k), M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
+                    }
 
                     // calculate the b_temp_static_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
                     // while in real simulations, the input dt is actually dt/2.0)
                     amrex::Real b_temp_static_coeff = - PhysConst::mu0 * amrex::Math::abs(mag_gamma_yface_arr(i,j,k)) / 2._rt;
 
-                    for (int comp=0; comp<3; ++comp) {
-                        // calculate a_temp_static_yface
-                        // all component on y-faces of grid
-                        a_temp_static_yface(i, j, k, comp) = a_temp_static_coeff * M_yface(i, j, k, comp);
-                    }
-
                     // calculate b_temp_static_yface
                     // x component on y-faces of grid
                     b_temp_static_yface(i, j, k, 0) = M_yface(i, j, k, 0) + dt * b_temp_static_coeff * (M_yface(i, j, k, 1) * Hz_eff - M_yface(i, j, k, 2) * Hy_eff);
@@ -345,10 +423,15 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                     // z component on y-faces of grid
                     b_temp_static_yface(i, j, k, 2) = M_yface(i, j, k, 2) + dt * b_temp_static_coeff * (M_yface(i, j, k, 0) * Hy_eff - M_yface(i, j, k, 1) * Hx_eff);
                 }
-            });
+                return stats;
+            };
+        LLGMagnetizationStats::ForEachFace(mag_stats, tby, stats_op, stats_data, b_temp_static_yface_kernel);
 
-        amrex::ParallelFor(tbz,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+        auto const b_temp_static_zface_kernel =
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) -> LLGMagnetizationStats::ReduceTuple {
+
+                // statistics of M^(old_time) on this face, if requested
+                LLGMagnetizationStats::ReduceTuple stats = LLGMagnetizationStats::None();
 
                 // determine if the material is nonmagnetic or not
                 if (mag_Ms_zface_arr(i,j,k) > 0._rt){
@@ -356,20 +439,25 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                     // when working on M_zface(i,j,k,0:2) we have direct access to M_zface(i,j,k,0:2) and Hz(i,j,k)
                     // Hy and Hz can be acquired by interpolation
 
-                    // H_bias
-                    amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias);
-                    amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias);
-                    amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias);
-
-                    if (coupling == 1){
-                        // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy
-
-                        // H_maxwell - use H^(old_time)
-                        Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_old);
-                        Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_old);
-                        Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_old);
+                    // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                    amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias, Hx)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias);
+                    amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias, Hy)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias);
+                    amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias, Hz)
+                                                         : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias);
+
+                    if (demag_coupling == 1){
+                        // H_demag - averaged from the two cells sharing this face
+                        Hx_eff += 0.5_rt * (Hd(i, j, k-1, 0) + Hd(i, j, k, 0));
+                        Hy_eff += 0.5_rt * (Hd(i, j, k-1, 1) + Hd(i, j, k, 1));
+                        Hz_eff += 0.5_rt * (Hd(i, j, k-1, 2) + Hd(i, j, k, 2));
                     }
 
+                    // M.H_exchange and M.H_anisotropy, for the magnetization statistics
+                    amrex::Real M_dot_H_exchange = 0._rt;
+                    amrex::Real M_dot_H_anisotropy = 0._rt;
+
                     if (mag_exchange_coupling == 1){
 
                         if (mag_exchange_zface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_zface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
@@ -384,9 +472,11 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         amrex::Real Ms_lo_z = mag_Ms_zface_arr(i, j, k-1);
                         amrex::Real Ms_hi_z = mag_Ms_zface_arr(i, j, k+1);
 
-                        Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 2); //Last argument is nodality -- zface = 2
-                        Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 2); //Last argument is nodality -- zface = 2
-                        Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 2); //Last argument is nodality -- zface = 2
+                        amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2); //Last argument is nodality -- zface = 2
+                        Hx_eff += H_exchange_coeff * lap_M[0];
+                        Hy_eff += H_exchange_coeff * lap_M[1];
+                        Hz_eff += H_exchange_coeff * lap_M[2];
+                        M_dot_H_exchange = H_exchange_coeff * (M_zface(i, j, k, 0) * lap_M[0] + M_zface(i, j, k, 1) * lap_M[1] + M_zface(i, j, k, 2) * lap_M[2]);
                     }
 
                     if (mag_anisotropy_coupling == 1){
@@ -402,23 +492,22 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
                         Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
                         Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
+                        M_dot_H_anisotropy = H_anisotropy_coeff * M_dot_anisotropy_axis * M_dot_anisotropy_axis;
                     }
 
-                    // 0 = unsaturated; compute |M| locally.  1 = saturated; use M_s
-                    amrex::Real M_magnitude = (M_normalization == 0) ? std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) + std::pow(M_zface(i, j, k, 2), 2._rt))
-                                                              : mag_Ms_zface_arr(i,j,k);
-                    amrex::Real a_temp_static_coeff = mag_alpha_zface_arr(i,j,k) / M_magnitude;
+                    if (mag_stats && stats_zbx.contains(IntVect(AMREX_D_DECL(i, j, k)))){
+                        // statistics of M^(old_time), see LLGMagnetizationStats.H
+                        amrex::Real const M_dot_H_bias = M_zface(i, j, k, 0) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mxface_stag, Mzface_stag, Hx_bias)
+                                                       + M_zface(i, j, k, 1) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Myface_stag, Mzface_stag, Hy_bias)
+                                                       + M_zface(i, j, k, 2) * MacroscopicProperties::face_avg_to_face(i, j, k, 0, Mzface_stag, Mzface_stag, Hz_bias);
+                        stats = LLGMagnetizationStats::Face(M_zface(i, j, k, 0), M_zface(i, j, k, 1), M_zface(i, j, k, 2),
+                                                            mag_Ms_zface_arr(i,j,k), M_dot_H_exchange, M_dot_H_anisotropy, M_dot_H_bias);
+                    }
 
                     // calculate the b_temp_static_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
                     // while in real simulations, the input dt is actually dt/2.0)
                     amrex::Real b_temp_static_coeff = - PhysConst::mu0 * amrex::Math::abs(mag_gamma_zface_arr(i,j,k)) / 2._rt;
 
-                    for (int comp=0; comp<3; ++comp) {
-                        // calculate a_temp_static_zface
-                        // all components on z-faces of grid
-                        a_temp_static_zface(i, j, k, comp) = a_temp_static_coeff * M_zface(i, j, k, comp);
-                    }
-
                     // calculate b_temp_static_zface
                     // x component on z-faces of grid
                     b_temp_static_zface(i, j, k, 0) = M_zface(i, j, k, 0) + dt * b_temp_static_coeff * (M_zface(i, j, k, 1) * Hz_eff - M_zface(i, j, k, 2) * Hy_eff);
@@ -429,464 +518,605 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                     // z component on z-faces of grid
                     b_temp_static_zface(i, j, k, 2) = M_zface(i, j, k, 2) + dt * b_temp_static_coeff * (M_zface(i, j, k, 0) * Hy_eff - M_zface(i, j, k, 1) * Hx_eff);
                 }
-            });
+                return stats;
+            };
+        LLGMagnetizationStats::ForEachFace(mag_stats, tbz, stats_op, stats_data, b_temp_static_zface_kernel);
     }
 
+    if (m_llg_mag_stats_active) m_llg_mag_stats = LLGMagnetizationStats::Values(stats_op, stats_data);
+
     // initialize M_max_iter, M_iter, M_tol, M_iter_error
     // maximum number of iterations allowed
     int M_max_iter = macroscopic_properties->getmag_max_iter();
     int M_iter = 0;
     // relative tolerance stopping criteria for 2nd-order iterative algorithm
     amrex::Real M_tol = macroscopic_properties->getmag_tol();
+    // the convergence (and its global reduction) is only checked every M_iter_check_interval iterations
+    int M_iter_check_interval = macroscopic_properties->getmag_iter_check_interval();
     int stop_iter = 0;
 
+    m_llg_stats.last_residuals.clear();
+    amrex::Real const iter_start_time = amrex::second();
+
+    const auto& period = warpx.Geom(lev).periodicity();
+
+#ifdef WARPX_USE_PSATD
+    // by default, the demagnetizing field of M^(new_time) is extrapolated from the ones of M(old_time) and
+    // of the previous solve, instead of being recomputed (with a gather and serial FFTs) at each iteration
+    if (demag_coupling == 1 && demag_every_iteration == 0) warpx.getDemagnetization()->PredictDemagField();
+#endif
+
+    // all the boxes are active at the first iteration
+    std::fill(m_llg_active_box.begin(), m_llg_active_box.end(), 1);
+    m_llg_exchange_active_only = false;
+    if (active_set) {
+        // the kernels flag the tiles with an error above the tolerance, in one slot per local tile
+        MFIter mfi_tiles(*Hfield[0], TilingIfNotGPU());
+        m_llg_tile_box_index.resize(mfi_tiles.length());
+        for (; mfi_tiles.isValid(); ++mfi_tiles) {
+            m_llg_tile_box_index[mfi_tiles.LocalTileIndex()] = mfi_tiles.index();
+        }
+        m_llg_tile_unconverged.resize(m_llg_tile_box_index.size());
+    }
+
+    // The guard cells of H and M_prev are exchanged while the faces that do not read them are updated.
+    // M_prev is copied from M with its guard cells before the first iteration
+    BeginLLGExchange(lev, Hfield, false, period);
+    bool M_prev_exchange_pending = false;
+
     // begin the iteration
+    WARPX_PROFILE_VAR("FiniteDifferenceSolver::MacroscopicEvolveHM_2nd::Iterations", blp_llg_iterations);
     while (!stop_iter){
 
-        warpx.FillBoundaryH(warpx.getngEB());
-
-        for (MFIter mfi(*Mfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
-
-            auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-            auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-            auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
-            auto& mag_alpha_xface_mf = macroscopic_properties->getmag_alpha_mf(0);
-            auto& mag_alpha_yface_mf = macroscopic_properties->getmag_alpha_mf(1);
-            auto& mag_alpha_zface_mf = macroscopic_properties->getmag_alpha_mf(2);
-            auto& mag_gamma_xface_mf = macroscopic_properties->getmag_gamma_mf(0);
-            auto& mag_gamma_yface_mf = macroscopic_properties->getmag_gamma_mf(1);
-            auto& mag_gamma_zface_mf = macroscopic_properties->getmag_gamma_mf(2);
-            auto& mag_exchange_xface_mf = macroscopic_properties->getmag_exchange_mf(0);
-            auto& mag_exchange_yface_mf = macroscopic_properties->getmag_exchange_mf(1);
-            auto& mag_exchange_zface_mf = macroscopic_properties->getmag_exchange_mf(2);
-            auto& mag_anisotropy_xface_mf = macroscopic_properties->getmag_anisotropy_mf(0);
-            auto& mag_anisotropy_yface_mf = macroscopic_properties->getmag_anisotropy_mf(1);
-            auto& mag_anisotropy_zface_mf = macroscopic_properties->getmag_anisotropy_mf(2);
+#ifdef WARPX_USE_PSATD
+        // with mag_LLG_demag_every_iteration, demagnetizing field of M^[(new_time),r-1], which Mfield holds
+        // at this point (it is on the layout of Mfield); at the first iteration it is the one of M(old_time)
+        if (demag_coupling == 1 && demag_every_iteration == 1 && M_iter > 0) {
+            warpx.getDemagnetization()->ComputeDemagField(Mfield);
+        }
+#endif
 
-            // extract material properties
-            Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-            Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-            Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
-            Array4<Real> const& mag_alpha_xface_arr = mag_alpha_xface_mf.array(mfi);
-            Array4<Real> const& mag_alpha_yface_arr = mag_alpha_yface_mf.array(mfi);
-            Array4<Real> const& mag_alpha_zface_arr = mag_alpha_zface_mf.array(mfi);
-            Array4<Real> const& mag_gamma_xface_arr = mag_gamma_xface_mf.array(mfi);
-            Array4<Real> const& mag_gamma_yface_arr = mag_gamma_yface_mf.array(mfi);
-            Array4<Real> const& mag_gamma_zface_arr = mag_gamma_zface_mf.array(mfi);
-            Array4<Real> const& mag_exchange_xface_arr = mag_exchange_xface_mf.array(mfi);
-            Array4<Real> const& mag_exchange_yface_arr = mag_exchange_yface_mf.array(mfi);
-            Array4<Real> const& mag_exchange_zface_arr = mag_exchange_zface_mf.array(mfi);
-            Array4<Real> const& mag_anisotropy_xface_arr = mag_anisotropy_xface_mf.array(mfi);
-            Array4<Real> const& mag_anisotropy_yface_arr = mag_anisotropy_yface_mf.array(mfi);
-            Array4<Real> const& mag_anisotropy_zface_arr = mag_anisotropy_zface_mf.array(mfi);
-
-            // extract field data
-            Array4<Real> const &M_xface = Mfield[0]->array(mfi);      // note M_xface include x,y,z components at |_x faces
-            Array4<Real> const &M_yface = Mfield[1]->array(mfi);      // note M_yface include x,y,z components at |_y faces
-            Array4<Real> const &M_zface = Mfield[2]->array(mfi);      // note M_zface include x,y,z components at |_z faces
-            Array4<Real> const &Hx_bias = H_biasfield[0]->array(mfi); // Hx_bias is the x component at |_x faces
-            Array4<Real> const &Hy_bias = H_biasfield[1]->array(mfi); // Hy_bias is the y component at |_y faces
-            Array4<Real> const &Hz_bias = H_biasfield[2]->array(mfi); // Hz_bias is the z component at |_z faces
-            Array4<Real> const &Hx = Hfield[0]->array(mfi);           // Hx is the x component at |_x faces
-            Array4<Real> const &Hy = Hfield[1]->array(mfi);           // Hy is the y component at |_y faces
-            Array4<Real> const &Hz = Hfield[2]->array(mfi);           // Hz is the z component at |_z faces
-
-            // extract field data of Mfield_prev, Mfield_error, a_temp, a_temp_static, and b_temp_static
-            Array4<Real> const &M_prev_xface = Mfield_prev[0]->array(mfi);
-            Array4<Real> const &M_prev_yface = Mfield_prev[1]->array(mfi);
-            Array4<Real> const &M_prev_zface = Mfield_prev[2]->array(mfi);
-            Array4<Real> const &M_old_xface = Mfield_old[0]->array(mfi);
-            Array4<Real> const &M_old_yface = Mfield_old[1]->array(mfi);
-            Array4<Real> const &M_old_zface = Mfield_old[2]->array(mfi);
-            Array4<Real> const &M_error_xface = Mfield_error[0]->array(mfi);
-            Array4<Real> const &M_error_yface = Mfield_error[1]->array(mfi);
-            Array4<Real> const &M_error_zface = Mfield_error[2]->array(mfi);
-            Array4<Real> const &a_temp_xface = a_temp[0]->array(mfi);
-            Array4<Real> const &a_temp_yface = a_temp[1]->array(mfi);
-            Array4<Real> const &a_temp_zface = a_temp[2]->array(mfi);
-            Array4<Real> const &a_temp_static_xface = a_temp_static[0]->array(mfi);
-            Array4<Real> const &a_temp_static_yface = a_temp_static[1]->array(mfi);
-            Array4<Real> const &a_temp_static_zface = a_temp_static[2]->array(mfi);
-            Array4<Real> const &b_temp_static_xface = b_temp_static[0]->array(mfi);
-            Array4<Real> const &b_temp_static_yface = b_temp_static[1]->array(mfi);
-            Array4<Real> const &b_temp_static_zface = b_temp_static[2]->array(mfi);
-
-            // extract tileboxes for which to loop
-            amrex::IntVect Hxnodal = Hfield[0]->ixType().toIntVect();
-            amrex::IntVect Hynodal = Hfield[1]->ixType().toIntVect();
-            amrex::IntVect Hznodal = Hfield[2]->ixType().toIntVect();
-            Box const &tbx = mfi.tilebox(Hxnodal); /* just define which grid type */
-            Box const &tby = mfi.tilebox(Hynodal);
-            Box const &tbz = mfi.tilebox(Hznodal);
+        // max error between Mfield and Mfield_prev over all three faces, reduced in the M update kernels
+        amrex::ReduceOps<amrex::ReduceOpMax> reduce_op;
+        amrex::ReduceData<amrex::Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        // with the active set, the kernels also flag the tiles that have not converged
+        if (active_set) {
+            int* const AMREX_RESTRICT flags = m_llg_tile_unconverged.data();
+            amrex::ParallelFor(static_cast<int>(m_llg_tile_unconverged.size()),
+                [=] AMREX_GPU_DEVICE (int t) { flags[t] = 0; });
+        }
 
-            // Extract stencil coefficients for calculating the exchange field H_exchange and the anisotropy field H_anisotropy
-            amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
-            int const n_coefs_x = m_stencil_coefs_x.size();
-            amrex::Real const *const AMREX_RESTRICT coefs_y = m_stencil_coefs_y.dataPtr();
-            int const n_coefs_y = m_stencil_coefs_y.size();
-            amrex::Real const *const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
-            int const n_coefs_z = m_stencil_coefs_z.size();
+        // pass 0 updates the faces away from the box boundaries while the guard cells are in flight,
+        // pass 1 the boundary strips once the exchange is complete
+        for (int pass = 0; pass < 2; ++pass){
 
-            // loop over cells and update fields
-            amrex::ParallelFor(tbx,
-                [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+            if (pass == 1) {
+                EndLLGExchange(lev, Hfield, M_prev_exchange_pending);
+                M_prev_exchange_pending = false;
+            }
 
-                    // determine if the material is nonmagnetic or not
-                    if (mag_Ms_xface_arr(i,j,k) > 0._rt){
+            for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
 
-                        // when working on M_xface(i,j,k, 0:2) we have direct access to M_xface(i,j,k,0:2) and Hx(i,j,k)
-                        // Hy and Hz can be acquired by interpolation
+                // the M update only touches magnetic faces
+                if (!macroscopic_properties->is_magnetic_box(mfi)) continue;
+                // and, with the active set, the boxes that are not frozen
+                if (active_set && !m_llg_active_box[mfi.index()]) continue;
 
-                        // H_bias
-                        amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hxnodal, Hx_bias);
-                        amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hxnodal, Hy_bias);
-                        amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hxnodal, Hz_bias);
+                int* const tile_unconverged = active_set ? m_llg_tile_unconverged.data() + mfi.LocalTileIndex() : nullptr;
 
-                        if (coupling == 1){
-                            // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy
+                if (pass == 0) {
+                    m_llg_box_updates[mfi] += static_cast<amrex::Real>(mfi.tilebox().numPts())
+                                              / static_cast<amrex::Real>(mfi.validbox().numPts());
+                }
 
-                            // H_maxwell - use H^[(new_time),r-1]
-                            Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hxnodal, Hx);
-                            Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hxnodal, Hy);
-                            Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hxnodal, Hz);
-                        }
+                if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+                {
+                    amrex::Gpu::synchronize();
+                }
+                Real wt = amrex::second();
+
+                // extract material properties
+                MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+                MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+                MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
+                MaterialPropertyArray const mag_alpha_xface_arr = macroscopic_properties->getmag_alpha_arr(0, mfi);
+                MaterialPropertyArray const mag_alpha_yface_arr = macroscopic_properties->getmag_alpha_arr(1, mfi);
+                MaterialPropertyArray const mag_alpha_zface_arr = macroscopic_properties->getmag_alpha_arr(2, mfi);
+                MaterialPropertyArray const mag_gamma_xface_arr = macroscopic_properties->getmag_gamma_arr(0, mfi);
+                MaterialPropertyArray const mag_gamma_yface_arr = macroscopic_properties->getmag_gamma_arr(1, mfi);
+                MaterialPropertyArray const mag_gamma_zface_arr = macroscopic_properties->getmag_gamma_arr(2, mfi);
+                MaterialPropertyArray const mag_exchange_xface_arr = macroscopic_properties->getmag_exchange_arr(0, mfi);
+                MaterialPropertyArray const mag_exchange_yface_arr = macroscopic_properties->getmag_exchange_arr(1, mfi);
+                MaterialPropertyArray const mag_exchange_zface_arr = macroscopic_properties->getmag_exchange_arr(2, mfi);
+                MaterialPropertyArray const mag_anisotropy_xface_arr = macroscopic_properties->getmag_anisotropy_arr(0, mfi);
+                MaterialPropertyArray const mag_anisotropy_yface_arr = macroscopic_properties->getmag_anisotropy_arr(1, mfi);
+                MaterialPropertyArray const mag_anisotropy_zface_arr = macroscopic_properties->getmag_anisotropy_arr(2, mfi);
+
+                // extract field data, M and the demagnetizing field are on the magnetic boxes only
+                int const scratch_index = m_llg_scratch_index[mfi.index()];
+                Array4<Real> const &M_xface = Mfield[0]->array(scratch_index); // note M_xface include x,y,z components at |_x faces
+                Array4<Real> const &M_yface = Mfield[1]->array(scratch_index); // note M_yface include x,y,z components at |_y faces
+                Array4<Real> const &M_zface = Mfield[2]->array(scratch_index); // note M_zface include x,y,z components at |_z faces
+                Array4<Real> const &Hx_bias = H_biasfield[0]->array(mfi); // Hx_bias is the x component at |_x faces
+                Array4<Real> const &Hy_bias = H_biasfield[1]->array(mfi); // Hy_bias is the y component at |_y faces
+                Array4<Real> const &Hz_bias = H_biasfield[2]->array(mfi); // Hz_bias is the z component at |_z faces
+                // cell-centered demagnetizing field, only read when warpx.mag_LLG_demag_coupling = 1
+                Array4<Real const> Hd;
+#ifdef WARPX_USE_PSATD
+                if (demag_coupling == 1) Hd = warpx.getDemagnetization()->getHdemag().const_array(scratch_index);
+#endif
+                Array4<Real> const &Hx = Hfield[0]->array(mfi);           // Hx is the x component at |_x faces
+                Array4<Real> const &Hy = Hfield[1]->array(mfi);           // Hy is the y component at |_y faces
+                Array4<Real> const &Hz = Hfield[2]->array(mfi);           // Hz is the z component at |_z faces
+
+                // extract field data of Mfield_prev, Mfield_old, and b_temp_static
+                Array4<LLGStorageReal> const &M_prev_xface = Mfield_prev[0]->array(scratch_index);
+                Array4<LLGStorageReal> const &M_prev_yface = Mfield_prev[1]->array(scratch_index);
+                Array4<LLGStorageReal> const &M_prev_zface = Mfield_prev[2]->array(scratch_index);
+                Array4<LLGStorageReal> const &M_old_xface = Mfield_old[0]->array(scratch_index);
+                Array4<LLGStorageReal> const &M_old_yface = Mfield_old[1]->array(scratch_index);
+                Array4<LLGStorageReal> const &M_old_zface = Mfield_old[2]->array(scratch_index);
+                Array4<LLGStorageReal> const &b_temp_static_xface = b_temp_static[0]->array(scratch_index);
+                Array4<LLGStorageReal> const &b_temp_static_yface = b_temp_static[1]->array(scratch_index);
+                Array4<LLGStorageReal> const &b_temp_static_zface = b_temp_static[2]->array(scratch_index);
+
+                // extract tileboxes for which to loop
+                amrex::IntVect Hxnodal = Hfield[0]->ixType().toIntVect();
+                amrex::IntVect Hynodal = Hfield[1]->ixType().toIntVect();
+                amrex::IntVect Hznodal = Hfield[2]->ixType().toIntVect();
+                Box const &tbx = mfi.tilebox(Hxnodal); /* just define which grid type */
+                Box const &tby = mfi.tilebox(Hynodal);
+                Box const &tbz = mfi.tilebox(Hznodal);
+
+                // Extract stencil coefficients for calculating the exchange field H_exchange and the anisotropy field H_anisotropy
+                amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
+                int const n_coefs_x = m_stencil_coefs_x.size();
+                amrex::Real const *const AMREX_RESTRICT coefs_y = m_stencil_coefs_y.dataPtr();
+                int const n_coefs_y = m_stencil_coefs_y.size();
+                amrex::Real const *const AMREX_RESTRICT coefs_z = m_stencil_coefs_z.dataPtr();
+                int const n_coefs_z = m_stencil_coefs_z.size();
+
+                // loop over cells and update fields
+                auto const update_M_xface =
+                    [=] AMREX_GPU_DEVICE(int i, int j, int k) -> ReduceTuple {
+
+                        // relative change of M between two consecutive iterations on this face
+                        amrex::Real M_iter_error = 0._rt;
+
+                        // determine if the material is nonmagnetic or not
+                        if (mag_Ms_xface_arr(i,j,k) > 0._rt){
+
+                            // when working on M_xface(i,j,k, 0:2) we have direct access to M_xface(i,j,k,0:2) and Hx(i,j,k)
+                            // Hy and Hz can be acquired by interpolation
+
+                            // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                            amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hxnodal, Hxnodal, Hx_bias, Hx)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hxnodal, Hx_bias);
+                            amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hynodal, Hxnodal, Hy_bias, Hy)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hxnodal, Hy_bias);
+                            amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hznodal, Hxnodal, Hz_bias, Hz)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hxnodal, Hz_bias);
+
+                            if (demag_coupling == 1){
+                                // H_demag - averaged from the two cells sharing this face
+                                Hx_eff += 0.5_rt * (Hd(i-1, j, k, 0) + Hd(i, j, k, 0));
+                                Hy_eff += 0.5_rt * (Hd(i-1, j, k, 1) + Hd(i, j, k, 1));
+                                Hz_eff += 0.5_rt * (Hd(i-1, j, k, 2) + Hd(i, j, k, 2));
+                            }
 
-                        if (mag_exchange_coupling == 1){
+                            if (mag_exchange_coupling == 1){
 
-                            if (mag_exchange_xface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_xface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
+                                if (mag_exchange_xface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_xface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
 
-                            // H_exchange - use M^[(new_time),r-1]
-                            amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_xface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_xface_arr(i,j,k) / mag_Ms_xface_arr(i,j,k);
+                                // H_exchange - use M^[(new_time),r-1]
+                                amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_xface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_xface_arr(i,j,k) / mag_Ms_xface_arr(i,j,k);
 
-                            amrex::Real Ms_lo_x = mag_Ms_xface_arr(i-1, j, k);
-                            amrex::Real Ms_hi_x = mag_Ms_xface_arr(i+1, j, k);
-                            amrex::Real Ms_lo_y = mag_Ms_xface_arr(i, j-1, k);
-                            amrex::Real Ms_hi_y = mag_Ms_xface_arr(i, j+1, k);
-                            amrex::Real Ms_lo_z = mag_Ms_xface_arr(i, j, k-1);
-                            amrex::Real Ms_hi_z = mag_Ms_xface_arr(i, j, k+1);
+                                amrex::Real Ms_lo_x = mag_Ms_xface_arr(i-1, j, k);
+                                amrex::Real Ms_hi_x = mag_Ms_xface_arr(i+1, j, k);
+                                amrex::Real Ms_lo_y = mag_Ms_xface_arr(i, j-1, k);
+                                amrex::Real Ms_hi_y = mag_Ms_xface_arr(i, j+1, k);
+                                amrex::Real Ms_lo_z = mag_Ms_xface_arr(i, j, k-1);
+                                amrex::Real Ms_hi_z = mag_Ms_xface_arr(i, j, k+1);
 
-                            Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 0); //Last argument is nodality -- xface = 0
-                            Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 0); //Last argument is nodality -- xface = 0
-                            Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 0); //Last argument is nodality -- xface = 0
-                        }
+                                amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_prev_xface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0); //Last argument is nodality -- xface = 0
+                                Hx_eff += H_exchange_coeff * lap_M[0];
+                                Hy_eff += H_exchange_coeff * lap_M[1];
+                                Hz_eff += H_exchange_coeff * lap_M[2];
+                            }
 
-                        if (mag_anisotropy_coupling == 1){
+                            if (mag_anisotropy_coupling == 1){
 
-                            if (mag_anisotropy_xface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_anisotropy_xface_arr(i,j,k) is 0.0 while including the anisotropy coupling term H_anisotropy for H_eff");
+                                if (mag_anisotropy_xface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_anisotropy_xface_arr(i,j,k) is 0.0 while including the anisotropy coupling term H_anisotropy for H_eff");
 
-                            // H_anisotropy - use M^[(new_time),r-1]
-                            amrex::Real M_dot_anisotropy_axis = 0.0;
-                            for (int comp=0; comp<3; ++comp) {
-                                M_dot_anisotropy_axis += M_xface(i, j, k, comp) * anisotropy_axis[comp];
+                                // H_anisotropy - use M^[(new_time),r-1]
+                                amrex::Real M_dot_anisotropy_axis = 0.0;
+                                for (int comp=0; comp<3; ++comp) {
+                                    M_dot_anisotropy_axis += M_xface(i, j, k, comp) * anisotropy_axis[comp];
+                                }
+                                amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_xface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_xface_arr(i,j,k) / mag_Ms_xface_arr(i,j,k);
+                                Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
+                                Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
+                                Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
                             }
-                            amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_xface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_xface_arr(i,j,k) / mag_Ms_xface_arr(i,j,k);
-                            Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
-                            Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
-                            Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
-                        }
 
-                        // calculate the a_temp_dynamic_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
-                        // while in real simulations, the input dt is actually dt/2.0)
-                        amrex::Real a_temp_dynamic_coeff = PhysConst::mu0 * amrex::Math::abs(mag_gamma_xface_arr(i,j,k)) / 2._rt;
+                            // calculate the a_temp_dynamic_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
+                            // while in real simulations, the input dt is actually dt/2.0)
+                            amrex::Real a_temp_dynamic_coeff = PhysConst::mu0 * amrex::Math::abs(mag_gamma_xface_arr(i,j,k)) / 2._rt;
 
-                        amrex::GpuArray<amrex::Real,3> H_eff;
-                        H_eff[0] = Hx_eff;
-                        H_eff[1] = Hy_eff;
-                        H_eff[2] = Hz_eff;
+                            amrex::GpuArray<amrex::Real,3> H_eff;
+                            H_eff[0] = Hx_eff;
+                            H_eff[1] = Hy_eff;
+                            H_eff[2] = Hz_eff;
 
-                        for (int comp=0; comp<3; ++comp) {
-                            // calculate a_temp_xface
-                            // all components on x-faces of grid
-                            a_temp_xface(i, j, k, comp) = (M_normalization != 0) ? -(dt * a_temp_dynamic_coeff * H_eff[comp] + a_temp_static_xface(i, j, k, comp))
-                                                                                 : -(dt * a_temp_dynamic_coeff * H_eff[comp] + 0.5 * a_temp_static_xface(i, j, k, comp)
-                                                                                     + 0.5 * mag_alpha_xface_arr(i,j,k) * 1. / std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) + std::pow(M_xface(i, j, k, 2), 2._rt)) * M_old_xface(i, j, k, comp));
-                        }
+                            // 0 = unsaturated; compute |M| locally.  1 = saturated; use M_s
+                            amrex::Real M_old_magnitude = (M_normalization == 0) ? std::sqrt(std::pow(M_old_xface(i, j, k, 0), 2._rt) + std::pow(M_old_xface(i, j, k, 1), 2._rt) + std::pow(M_old_xface(i, j, k, 2), 2._rt))
+                                                                         : mag_Ms_xface_arr(i,j,k);
+                            // a_temp_static_coeff does not change in the current step for SATURATED materials; but it does change for UNSATURATED ones
+                            amrex::Real a_temp_static_coeff = mag_alpha_xface_arr(i,j,k) / M_old_magnitude;
 
-                        for (int comp=0; comp<3; ++comp) {
-                            // update M_xface from a and b using the updateM_field
-                            // all components on x-faces of grid
-                            M_xface(i, j, k, comp) = MacroscopicProperties::updateM_field(i, j, k, comp, a_temp_xface, b_temp_static_xface);
-                        }
-
-                        // temporary normalized magnitude of M_xface field at the fixed point
-                        // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
-                        amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) + std::pow(M_xface(i, j, k, 2), 2._rt)) / mag_Ms_xface_arr(i,j,k);
-                        if (M_normalization == 1){
-                            // saturated case; if |M| has drifted from M_s too much, abort.  Otherwise, normalize
-                            // check the normalized error
-                            if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
-                                amrex::Abort("Exceed the normalized error of the M_xface field");
+                            // right-hand side of vector a; all components on x-faces of grid
+                            amrex::GpuArray<amrex::Real,3> a_temp;
+                            for (int comp=0; comp<3; ++comp) {
+                                // static part α M^(old_time)/|M|
+                                amrex::Real const a_temp_static = a_temp_static_coeff * M_old_xface(i, j, k, comp);
+                                a_temp[comp] = (M_normalization != 0) ? -(dt * a_temp_dynamic_coeff * H_eff[comp] + a_temp_static)
+                                                                      : -(dt * a_temp_dynamic_coeff * H_eff[comp] + 0.5 * a_temp_static
+                                                                          + 0.5 * mag_alpha_xface_arr(i,j,k) * 1. / std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) + std::pow(M_xface(i, j, k, 2), 2._rt)) * M_old_xface(i, j, k, comp));
                             }
-                            // normalize the M_xface field
-                            M_xface(i, j, k, 0) /= M_magnitude_normalized;
-                            M_xface(i, j, k, 1) /= M_magnitude_normalized;
-                            M_xface(i, j, k, 2) /= M_magnitude_normalized;
-                        }
-                        else if (M_normalization == 0){
-                            // check the normalized error
-                            if (M_magnitude_normalized > (1._rt + mag_normalized_error)){
-                                amrex::Abort("Caution: Unsaturated material has M_xface exceeding the saturation magnetization");
+
+                            for (int comp=0; comp<3; ++comp) {
+                                // update M_xface from a and b using the updateM_field
+                                // all components on x-faces of grid
+                                M_xface(i, j, k, comp) = MacroscopicProperties::updateM_field(i, j, k, comp, a_temp, b_temp_static_xface);
                             }
-                            else if (M_magnitude_normalized > 1._rt && M_magnitude_normalized <= 1._rt + mag_normalized_error){
+
+                            // temporary normalized magnitude of M_xface field at the fixed point
+                            // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
+                            amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) + std::pow(M_xface(i, j, k, 2), 2._rt)) / mag_Ms_xface_arr(i,j,k);
+                            if (M_normalization == 1){
+                                // saturated case; if |M| has drifted from M_s too much, abort.  Otherwise, normalize
+                                // check the normalized error
+                                if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
+                                    amrex::Abort("Exceed the normalized error of the M_xface field");
+                                }
                                 // normalize the M_xface field
                                 M_xface(i, j, k, 0) /= M_magnitude_normalized;
                                 M_xface(i, j, k, 1) /= M_magnitude_normalized;
                                 M_xface(i, j, k, 2) /= M_magnitude_normalized;
                             }
-                        }
+                            else if (M_normalization == 0){
+                                // check the normalized error
+                                if (M_magnitude_normalized > (1._rt + mag_normalized_error)){
+                                    amrex::Abort("Caution: Unsaturated material has M_xface exceeding the saturation magnetization");
+                                }
+                                else if (M_magnitude_normalized > 1._rt && M_magnitude_normalized <= 1._rt + mag_normalized_error){
+                                    // normalize the M_xface field
+                                    M_xface(i, j, k, 0) /= M_magnitude_normalized;
+                                    M_xface(i, j, k, 1) /= M_magnitude_normalized;
+                                    M_xface(i, j, k, 2) /= M_magnitude_normalized;
+                                }
+                            }
 
-                        // calculate M_error_xface
-                        // x,y,z component on M-error on x-faces of grid
-                        for (int icomp = 0; icomp < 3; ++icomp) {
-                            M_error_xface(i, j, k, icomp) = amrex::Math::abs((M_xface(i, j, k, icomp) - M_prev_xface(i, j, k, icomp))) / mag_Ms_xface_arr(i,j,k);
+                            // max over the x,y,z components of the M-error on x-faces of grid
+                            for (int icomp = 0; icomp < 3; ++icomp) {
+                                M_iter_error = amrex::max(M_iter_error, amrex::Math::abs((M_xface(i, j, k, icomp) - M_prev_xface(i, j, k, icomp))) / mag_Ms_xface_arr(i,j,k));
+                            }
                         }
-                    }
-                });
+                        // all the faces above the tolerance write the same value
+                        if (tile_unconverged && M_iter_error > M_tol) *tile_unconverged = 1;
+                        return {M_iter_error};
+                    };
+                for (Box const& bx : LLGPassBoxes(tbx, amrex::convert(mfi.validbox(), Hxnodal), pass)) {
+                    reduce_op.eval(bx, reduce_data, update_M_xface);
+                }
 
-            amrex::ParallelFor(tby,
-                [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+                auto const update_M_yface =
+                    [=] AMREX_GPU_DEVICE(int i, int j, int k) -> ReduceTuple {
 
-                    // determine if the material is nonmagnetic or not
-                    if (mag_Ms_yface_arr(i,j,k) > 0._rt){
+                        // relative change of M between two consecutive iterations on this face
+                        amrex::Real M_iter_error = 0._rt;
 
-                        // when working on M_yface(i,j,k,0:2) we have direct access to M_yface(i,j,k,0:2) and Hy(i,j,k)
-                        // Hy and Hz can be acquired by interpolation
+                        // determine if the material is nonmagnetic or not
+                        if (mag_Ms_yface_arr(i,j,k) > 0._rt){
 
-                        // H_bias
-                        amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hynodal, Hx_bias);
-                        amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hynodal, Hy_bias);
-                        amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hynodal, Hz_bias);
+                            // when working on M_yface(i,j,k,0:2) we have direct access to M_yface(i,j,k,0:2) and Hy(i,j,k)
+                            // Hy and Hz can be acquired by interpolation
 
-                        if (coupling == 1){
-                            // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy
+                            // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                            amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hxnodal, Hynodal, Hx_bias, Hx)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hynodal, Hx_bias);
+                            amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hynodal, Hynodal, Hy_bias, Hy)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hynodal, Hy_bias);
+                            amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hznodal, Hynodal, Hz_bias, Hz)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hynodal, Hz_bias);
 
-                            // H_maxwell - use H^[(new_time),r-1]
-                            Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hynodal, Hx);
-                            Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hynodal, Hy);
-                            Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hynodal, Hz);
-                        }
+                            if (demag_coupling == 1){
+                                // H_demag - averaged from the two cells sharing this face
+                                Hx_eff += 0.5_rt * (Hd(i, j-1, k, 0) + Hd(i, j, k, 0));
+                                Hy_eff += 0.5_rt * (Hd(i, j-1, k, 1) + Hd(i, j, k, 1));
+                                Hz_eff += 0.5_rt * (Hd(i, j-1, k, 2) + Hd(i, j, k, 2));
+                            }
 
-                        if (mag_exchange_coupling == 1){
+                            if (mag_exchange_coupling == 1){
 
-                            if (mag_exchange_yface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_yface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
+                                if (mag_exchange_yface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_yface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
 
-                            // H_exchange - use M^[(new_time),r-1]
-                            amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_yface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_yface_arr(i,j,k) / mag_Ms_yface_arr(i,j,k);
+                                // H_exchange - use M^[(new_time),r-1]
+                                amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_yface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_yface_arr(i,j,k) / mag_Ms_yface_arr(i,j,k);
 
-                            amrex::Real Ms_lo_x = mag_Ms_yface_arr(i-1, j, k);
-                            amrex::Real Ms_hi_x = mag_Ms_yface_arr(i+1, j, k);
-                            amrex::Real Ms_lo_y = mag_Ms_yface_arr(i, j-1, k);
-                            amrex::Real Ms_hi_y = mag_Ms_yface_arr(i, j+1, k);
-                            amrex::Real Ms_lo_z = mag_Ms_yface_arr(i, j, k-1);
-                            amrex::Real Ms_hi_z = mag_Ms_yface_arr(i, j, k+1);
+                                amrex::Real Ms_lo_x = mag_Ms_yface_arr(i-1, j, k);
+                                amrex::Real Ms_hi_x = mag_Ms_yface_arr(i+1, j, k);
+                                amrex::Real Ms_lo_y = mag_Ms_yface_arr(i, j-1, k);
+                                amrex::Real Ms_hi_y = mag_Ms_yface_arr(i, j+1, k);
+                                amrex::Real Ms_lo_z = mag_Ms_yface_arr(i, j, k-1);
+                                amrex::Real Ms_hi_z = mag_Ms_yface_arr(i, j, k+1);
 
-                            Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 1); //Last argument is nodality -- yface = 1
-                            Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 1); //Last argument is nodality -- yface = 1
-                            Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 1); //Last argument is nodality -- yface = 1
-                        }
+                                amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_prev_yface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1); //Last argument is nodality -- yface = 1
+                                Hx_eff += H_exchange_coeff * lap_M[0];
+                                Hy_eff += H_exchange_coeff * lap_M[1];
+                                Hz_eff += H_exchange_coeff * lap_M[2];
+                            }
 
-                        if (mag_anisotropy_coupling == 1){
+                            if (mag_anisotropy_coupling == 1){
 
-                            if (mag_anisotropy_yface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_anisotropy_yface_arr(i,j,k) is 0.0 while including the anisotropy coupling term H_anisotropy for H_eff");
+                                if (mag_anisotropy_yface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_anisotropy_yface_arr(i,j,k) is 0.0 while including the anisotropy coupling term H_anisotropy for H_eff");
 
-                            // H_anisotropy - use M^[(new_time),r-1]
-                            amrex::Real M_dot_anisotropy_axis = 0.0;
-                            for (int comp=0; comp<3; ++comp) {
-                                M_dot_anisotropy_axis += M_yface(i, j, k, comp) * anisotropy_axis[comp];
+                                // H_anisotropy - use M^[(new_time),r-1]
+                                amrex::Real M_dot_anisotropy_axis = 0.0;
+                                for (int comp=0; comp<3; ++comp) {
+                                    M_dot_anisotropy_axis += M_yface(i, j, k, comp) * anisotropy_axis[comp];
+                                }
+                                amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_yface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_yface_arr(i,j,k) / mag_Ms_yface_arr(i,j,k);
+                                Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
+                                Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
+                                Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
                             }
-                            amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_yface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_yface_arr(i,j,k) / mag_Ms_yface_arr(i,j,k);
-                            Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
-                            Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
-                            Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
-                        }
 
-                        // calculate the a_temp_dynamic_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
-                        // while in real simulations, the input dt is actually dt/2.0)
-                        amrex::Real a_temp_dynamic_coeff = PhysConst::mu0 * amrex::Math::abs(mag_gamma_yface_arr(i,j,k)) / 2._rt;
+                            // calculate the a_temp_dynamic_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
+                            // while in real simulations, the input dt is actually dt/2.0)
+                            amrex::Real a_temp_dynamic_coeff = PhysConst::mu0 * amrex::Math::abs(mag_gamma_yface_arr(i,j,k)) / 2._rt;
 
-                        amrex::GpuArray<amrex::Real,3> H_eff;
-                        H_eff[0] = Hx_eff;
-                        H_eff[1] = Hy_eff;
-                        H_eff[2] = Hz_eff;
+                            amrex::GpuArray<amrex::Real,3> H_eff;
+                            H_eff[0] = Hx_eff;
+                            H_eff[1] = Hy_eff;
+                            H_eff[2] = Hz_eff;
 
-                        for (int comp=0; comp<3; ++comp) {
-                            // calculate a_temp_yface
-                            // all components on y-faces of grid
-                            a_temp_yface(i, j, k, comp) = (M_normalization != 0) ? -(dt * a_temp_dynamic_coeff * H_eff[comp] + a_temp_static_yface(i, j, k, comp))
-                                                                                 : -(dt * a_temp_dynamic_coeff * H_eff[comp] + 0.5 * a_temp_static_yface(i, j, k, comp)
-                                                                                     + 0.5 * mag_alpha_yface_arr(i,j,k) * 1. / std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) + std::pow(M_yface(i, j, k, 2), 2._rt)) * M_old_yface(i, j, k, comp));
-                        }
+                            // 0 = unsaturated; compute |M| locally.  1 = saturated; use M_s
+                            amrex::Real M_old_magnitude = (M_normalization == 0) ? std::sqrt(std::pow(M_old_yface(i, j, k, 0), 2._rt) + std::pow(M_old_yface(i, j, k, 1), 2._rt) + std::pow(M_old_yface(i, j, k, 2), 2._rt))
+                                                                         : mag_Ms_yface_arr(i,j,k);
+                            // a_temp_static_coeff does not change in the current step for SATURATED materials; but it does change for UNSATURATED ones
+                            amrex::Real a_temp_static_coeff = mag_alpha_yface_arr(i,j,k) / M_old_magnitude;
 
-                        for (int comp=0; comp<3; ++comp) {
-                            // update M_yface from a and b using the updateM_field
-                            // all components on y-faces of grid
-                            M_yface(i, j, k, comp) = MacroscopicProperties::updateM_field(i, j, k, comp, a_temp_yface, b_temp_static_yface);
-                        }
-
-                        // temporary normalized magnitude of M_yface field at the fixed point
-                        // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
-                        amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) + std::pow(M_yface(i, j, k, 2), 2._rt)) / mag_Ms_yface_arr(i,j,k);
-
-                        if (M_normalization == 1){
-                            // saturated case; if |M| has drifted from M_s too much, abort.  Otherwise, normalize
-                            // check the normalized error
-                            if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
-                                amrex::Abort("Exceed the normalized error of the M_yface field");
+                            // right-hand side of vector a; all components on y-faces of grid
+                            amrex::GpuArray<amrex::Real,3> a_temp;
+                            for (int comp=0; comp<3; ++comp) {
+                                // static part α M^(old_time)/|M|
+                                amrex::Real const a_temp_static = a_temp_static_coeff * M_old_yface(i, j, k, comp);
+                                a_temp[comp] = (M_normalization != 0) ? -(dt * a_temp_dynamic_coeff * H_eff[comp] + a_temp_static)
+                                                                      : -(dt * a_temp_dynamic_coeff * H_eff[comp] + 0.5 * a_temp_static
+                                                                          + 0.5 * mag_alpha_yface_arr(i,j,k) * 1. / std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) + std::pow(M_yface(i, j, k, 2), 2._rt)) * M_old_yface(i, j, k, comp));
                             }
-                            // normalize the M_yface field
-                            M_yface(i, j, k, 0) /= M_magnitude_normalized;
-                            M_yface(i, j, k, 1) /= M_magnitude_normalized;
-                            M_yface(i, j, k, 2) /= M_magnitude_normalized;
-                        }
-                        else if (M_normalization == 0){
-                            // check the normalized error
-                            if (M_magnitude_normalized > 1._rt + mag_normalized_error){
-                                amrex::Abort("Caution: Unsaturated material has M_yface exceeding the saturation magnetization");
+
+                            for (int comp=0; comp<3; ++comp) {
+                                // update M_yface from a and b using the updateM_field
+                                // all components on y-faces of grid
+                                M_yface(i, j, k, comp) = MacroscopicProperties::updateM_field(i, j, k, comp, a_temp, b_temp_static_yface);
                             }
-                            else if (M_magnitude_normalized > 1._rt && M_magnitude_normalized <= 1._rt + mag_normalized_error){
+
+                            // temporary normalized magnitude of M_yface field at the fixed point
+                            // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
+                            amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) + std::pow(M_yface(i, j, k, 2), 2._rt)) / mag_Ms_yface_arr(i,j,k);
+
+                            if (M_normalization == 1){
+                                // saturated case; if |M| has drifted from M_s too much, abort.  Otherwise, normalize
+                                // check the normalized error
+                                if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
+                                    amrex::Abort("Exceed the normalized error of the M_yface field");
+                                }
                                 // normalize the M_yface field
                                 M_yface(i, j, k, 0) /= M_magnitude_normalized;
                                 M_yface(i, j, k, 1) /= M_magnitude_normalized;
                                 M_yface(i, j, k, 2) /= M_magnitude_normalized;
                             }
-                        }
+                            else if (M_normalization == 0){
+                                // check the normalized error
+                                if (M_magnitude_normalized > 1._rt + mag_normalized_error){
+                                    amrex::Abort("Caution: Unsaturated material has M_yface exceeding the saturation magnetization");
+                                }
+                                else if (M_magnitude_normalized > 1._rt && M_magnitude_normalized <= 1._rt + mag_normalized_error){
+                                    // normalize the M_yface field
+                                    M_yface(i, j, k, 0) /= M_magnitude_normalized;
+                                    M_yface(i, j, k, 1) /= M_magnitude_normalized;
+                                    M_yface(i, j, k, 2) /= M_magnitude_normalized;
+                                }
+                            }
 
-                        // calculate M_error_yface
-                        // x,y,z component on y-faces of grid
-                        for (int icomp = 0; icomp < 3; ++icomp) {
-                            M_error_yface(i, j, k, icomp) = amrex::Math::abs((M_yface(i, j, k, icomp) - M_prev_yface(i, j, k, icomp))) / mag_Ms_yface_arr(i,j,k);
+                            // max over the x,y,z components of the M-error on y-faces of grid
+                            for (int icomp = 0; icomp < 3; ++icomp) {
+                                M_iter_error = amrex::max(M_iter_error, amrex::Math::abs((M_yface(i, j, k, icomp) - M_prev_yface(i, j, k, icomp))) / mag_Ms_yface_arr(i,j,k));
+                            }
                         }
-                    }
-                });
+                        // all the faces above the tolerance write the same value
+                        if (tile_unconverged && M_iter_error > M_tol) *tile_unconverged = 1;
+                        return {M_iter_error};
+                    };
+                for (Box const& bx : LLGPassBoxes(tby, amrex::convert(mfi.validbox(), Hynodal), pass)) {
+                    reduce_op.eval(bx, reduce_data, update_M_yface);
+                }
 
-            amrex::ParallelFor(tbz,
-                [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+                auto const update_M_zface =
+                    [=] AMREX_GPU_DEVICE(int i, int j, int k) -> ReduceTuple {
 
-                    // determine if the material is nonmagnetic or not
-                    if (mag_Ms_zface_arr(i,j,k) > 0._rt){
+                        // relative change of M between two consecutive iterations on this face
+                        amrex::Real M_iter_error = 0._rt;
 
-                        // when working on M_zface(i,j,k,0:2) we have direct access to M_zface(i,j,k,0:2) and Hz(i,j,k)
-                        // Hy and Hz can be acquired by interpolation
+                        // determine if the material is nonmagnetic or not
+                        if (mag_Ms_zface_arr(i,j,k) > 0._rt){
 
-                        // H_bias
-                        amrex::Real Hx_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hznodal, Hx_bias);
-                        amrex::Real Hy_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hznodal, Hy_bias);
-                        amrex::Real Hz_eff = MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hznodal, Hz_bias);
+                            // when working on M_zface(i,j,k,0:2) we have direct access to M_zface(i,j,k,0:2) and Hz(i,j,k)
+                            // Hy and Hz can be acquired by interpolation
 
-                        if (coupling == 1){
-                            // H_eff = H_maxwell + H_bias + H_exchange + H_anisotropy
+                            // H_bias, plus H_maxwell when LLG + Maxwell coupling is on; both are averaged to this face in one pass
+                            amrex::Real Hx_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hxnodal, Hznodal, Hx_bias, Hx)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hznodal, Hx_bias);
+                            amrex::Real Hy_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hynodal, Hznodal, Hy_bias, Hy)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hznodal, Hy_bias);
+                            amrex::Real Hz_eff = (coupling == 1) ? MacroscopicProperties::face_avg_to_face_sum(i, j, k, 0, Hznodal, Hznodal, Hz_bias, Hz)
+                                                                 : MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hznodal, Hz_bias);
 
-                            // H_maxwell - use H^[(new_time),r-1]
-                            Hx_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hxnodal, Hznodal, Hx);
-                            Hy_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hynodal, Hznodal, Hy);
-                            Hz_eff += MacroscopicProperties::face_avg_to_face(i, j, k, 0, Hznodal, Hznodal, Hz);
-                        }
+                            if (demag_coupling == 1){
+                                // H_demag - averaged from the two cells sharing this face
+                                Hx_eff += 0.5_rt * (Hd(i, j, k-1, 0) + Hd(i, j, k, 0));
+                                Hy_eff += 0.5_rt * (Hd(i, j, k-1, 1) + Hd(i, j, k, 1));
+                                Hz_eff += 0.5_rt * (Hd(i, j, k-1, 2) + Hd(i, j, k, 2));
+                            }
 
-                        if (mag_exchange_coupling == 1){
+                            if (mag_exchange_coupling == 1){
 
-                            if (mag_exchange_zface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_zface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
+                                if (mag_exchange_zface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_exchange_zface_arr(i,j,k) is 0.0 while including the exchange coupling term H_exchange for H_eff");
 
-                            // H_exchange - use M^[(new_time),r-1]
-                            amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_zface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_zface_arr(i,j,k) / mag_Ms_zface_arr(i,j,k);
+                                // H_exchange - use M^[(new_time),r-1]
+                                amrex::Real const H_exchange_coeff = 2.0 * mag_exchange_zface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_zface_arr(i,j,k) / mag_Ms_zface_arr(i,j,k);
 
-                            amrex::Real Ms_lo_x = mag_Ms_zface_arr(i-1, j, k);
-                            amrex::Real Ms_hi_x = mag_Ms_zface_arr(i+1, j, k);
-                            amrex::Real Ms_lo_y = mag_Ms_zface_arr(i, j-1, k);
-                            amrex::Real Ms_hi_y = mag_Ms_zface_arr(i, j+1, k);
-                            amrex::Real Ms_lo_z = mag_Ms_zface_arr(i, j, k-1);
-                            amrex::Real Ms_hi_z = mag_Ms_zface_arr(i, j, k+1);
+                                amrex::Real Ms_lo_x = mag_Ms_zface_arr(i-1, j, k);
+                                amrex::Real Ms_hi_x = mag_Ms_zface_arr(i+1, j, k);
+                                amrex::Real Ms_lo_y = mag_Ms_zface_arr(i, j-1, k);
+                                amrex::Real Ms_hi_y = mag_Ms_zface_arr(i, j+1, k);
+                                amrex::Real Ms_lo_z = mag_Ms_zface_arr(i, j, k-1);
+                                amrex::Real Ms_hi_z = mag_Ms_zface_arr(i, j, k+1);
 
-                            Hx_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 0, 2); //Last argument is nodality -- zface = 2
-                            Hy_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 1, 2); //Last argument is nodality -- zface = 2
-                            Hz_eff += H_exchange_coeff * T_Algo::Laplacian_Mag(M_prev_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2, 2); //Last argument is nodality -- zface = 2
-                        }
+                                amrex::GpuArray<amrex::Real,3> const lap_M = T_Algo::Laplacian_Mag_Vec(M_prev_zface, coefs_x, coefs_y, coefs_z, n_coefs_x, n_coefs_y, n_coefs_z, Ms_lo_x, Ms_hi_x, Ms_lo_y, Ms_hi_y, Ms_lo_z, Ms_hi_z, i, j, k, 2); //Last argument is nodality -- zface = 2
+                                Hx_eff += H_exchange_coeff * lap_M[0];
+                                Hy_eff += H_exchange_coeff * lap_M[1];
+                                Hz_eff += H_exchange_coeff * lap_M[2];
+                            }
 
-                        if (mag_anisotropy_coupling == 1){
+                            if (mag_anisotropy_coupling == 1){
 
-                            if (mag_anisotropy_zface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_anisotropy_zface_arr(i,j,k) is 0.0 while including the anisotropy coupling term H_anisotropy for H_eff");
+                                if (mag_anisotropy_zface_arr(i,j,k) == 0._rt) amrex::Abort("The mag_anisotropy_zface_arr(i,j,k) is 0.0 while including the anisotropy coupling term H_anisotropy for H_eff");
 
-                            // H_anisotropy - use M^[(new_time),r-1]
-                            amrex::Real M_dot_anisotropy_axis = 0.0;
-                            for (int comp=0; comp<3; ++comp) {
-                                M_dot_anisotropy_axis += M_zface(i, j, k, comp) * anisotropy_axis[comp];
+                                // H_anisotropy - use M^[(new_time),r-1]
+                                amrex::Real M_dot_anisotropy_axis = 0.0;
+                                for (int comp=0; comp<3; ++comp) {
+                                    M_dot_anisotropy_axis += M_zface(i, j, k, comp) * anisotropy_axis[comp];
+                                }
+                                amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_zface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_zface_arr(i,j,k) / mag_Ms_zface_arr(i,j,k);
+                                Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
+                                Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
+                                Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
                             }
-                            amrex::Real const H_anisotropy_coeff = - 2.0 * mag_anisotropy_zface_arr(i,j,k) / PhysConst::mu0 / mag_Ms_zface_arr(i,j,k) / mag_Ms_zface_arr(i,j,k);
-                            Hx_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[0];
-                            Hy_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[1];
-                            Hz_eff += H_anisotropy_coeff * M_dot_anisotropy_axis * anisotropy_axis[2];
-                        }
-
-                        // calculate the a_temp_dynamic_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
-                        // while in real simulations, the input dt is actually dt/2.0)
-                        amrex::Real a_temp_dynamic_coeff = PhysConst::mu0 * amrex::Math::abs(mag_gamma_zface_arr(i,j,k)) / 2._rt;
 
-                        amrex::GpuArray<amrex::Real,3> H_eff;
-                        H_eff[0] = Hx_eff;
-                        H_eff[1] = Hy_eff;
-                        H_eff[2] = Hz_eff;
-
-                        for (int comp=0; comp<3; ++comp) {
-                            // calculate a_temp_zface
-                            // all components on z-faces of grid
-                            a_temp_zface(i, j, k, comp) = (M_normalization != 0) ? -(dt * a_temp_dynamic_coeff * H_eff[comp] + a_temp_static_zface(i, j, k, comp))
-                                                                              : -(dt * a_temp_dynamic_coeff * H_eff[comp] + 0.5 * a_temp_static_zface(i, j, k, comp)
-                                                                                  + 0.5 * mag_alpha_zface_arr(i,j,k) * 1. / std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) + std::pow(M_zface(i, j, k, 2), 2._rt)) * M_old_zface(i, j, k, comp));
-                        }
+                            // calculate the a_temp_dynamic_coeff (it is divided by 2.0 because the derivation is based on an interger dt,
+                            // while in real simulations, the input dt is actually dt/2.0)
+                            amrex::Real a_temp_dynamic_coeff = PhysConst::mu0 * amrex::Math::abs(mag_gamma_zface_arr(i,j,k)) / 2._rt;
 
-                        for (int comp=0; comp<3; ++comp) {
-                            // update M_zface from a and b using the updateM_field
-                            // all components on z-faces of grid
-                            M_zface(i, j, k, comp) = MacroscopicProperties::updateM_field(i, j, k, comp, a_temp_zface, b_temp_static_zface);
-                        }
+                            amrex::GpuArray<amrex::Real,3> H_eff;
+                            H_eff[0] = Hx_eff;
+                            H_eff[1] = Hy_eff;
+                            H_eff[2] = Hz_eff;
 
-                        // temporary normalized magnitude of M_zface field at the fixed point
-                        // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
-                        amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) + std::pow(M_zface(i, j, k, 2), 2._rt)) / mag_Ms_zface_arr(i,j,k);
+                            // 0 = unsaturated; compute |M| locally.  1 = saturated; use M_s
+                            amrex::Real M_old_magnitude = (M_normalization == 0) ? std::sqrt(std::pow(M_old_zface(i, j, k, 0), 2._rt) + std::pow(M_old_zface(i, j, k, 1), 2._rt) + std::pow(M_old_zface(i, j, k, 2), 2._rt))
+                                                                         : mag_Ms_zface_arr(i,j,k);
+                            // a_temp_static_coeff does not change in the current step for SATURATED materials; but it does change for UNSATURATED ones
+                            amrex::Real a_temp_static_coeff = mag_alpha_zface_arr(i,j,k) / M_old_magnitude;
 
-                        if (M_normalization == 1){
-                            // saturated case; if |M| has drifted from M_s too much, abort.  Otherwise, normalize
-                            // check the normalized error
-                            if (amrex::Math::abs(1. - M_magnitude_normalized) > mag_normalized_error){
-                                amrex::Abort("Exceed the normalized error of the M_zface field");
+                            // right-hand side of vector a; all components on z-faces of grid
+                            amrex::GpuArray<amrex::Real,3> a_temp;
+                            for (int comp=0; comp<3; ++comp) {
+                                // static part α M^(old_time)/|M|
+                                amrex::Real const a_temp_static = a_temp_static_coeff * M_old_zface(i, j, k, comp);
+                                a_temp[comp] = (M_normalization != 0) ? -(dt * a_temp_dynamic_coeff * H_eff[comp] + a_temp_static)
+                                                                      : -(dt * a_temp_dynamic_coeff * H_eff[comp] + 0.5 * a_temp_static
+                                                                          + 0.5 * mag_alpha_zface_arr(i,j,k) * 1. / std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) + std::pow(M_zface(i, j, k, 2), 2._rt)) * M_old_zface(i, j, k, comp));
                             }
-                            // normalize the M_zface field
-                            M_zface(i, j, k, 0) /= M_magnitude_normalized;
-                            M_zface(i, j, k, 1) /= M_magnitude_normalized;
-                            M_zface(i, j, k, 2) /= M_magnitude_normalized;
-                        }
-                        else if (M_normalization == 0){
-                            // check the normalized error
-                            if (M_magnitude_normalized > 1._rt + mag_normalized_error){
-                                amrex::Abort("Caution: Unsaturated material has M_zface exceeding the saturation magnetization");
+
+                            for (int comp=0; comp<3; ++comp) {
+                                // update M_zface from a and b using the updateM_field
+                                // all components on z-faces of grid
+                                M_zface(i, j, k, comp) = MacroscopicProperties::updateM_field(i, j, k, comp, a_temp, b_temp_static_zface);
                             }
-                            else if (M_magnitude_normalized > 1._rt && M_magnitude_normalized <= 1._rt + mag_normalized_error){
+
+                            // temporary normalized magnitude of M_zface field at the fixed point
+                            // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
+                            amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) + std::pow(M_zface(i, j, k, 2), 2._rt)) / mag_Ms_zface_arr(i,j,k);
+
+                            if (M_normalization == 1){
+                                // saturated case; if |M| has drifted from M_s too much, abort.  Otherwise, normalize
+                                // check the normalized error
+                                if (amrex::Math::abs(1. - M_magnitude_normalized) > mag_normalized_error){
+                                    amrex::Abort("Exceed the normalized error of the M_zface field");
+                                }
                                 // normalize the M_zface field
                                 M_zface(i, j, k, 0) /= M_magnitude_normalized;
                                 M_zface(i, j, k, 1) /= M_magnitude_normalized;
                                 M_zface(i, j, k, 2) /= M_magnitude_normalized;
                             }
-                        }
+                            else if (M_normalization == 0){
+                                // check the normalized error
+                                if (M_magnitude_normalized > 1._rt + mag_normalized_error){
+                                    amrex::Abort("Caution: Unsaturated material has M_zface exceeding the saturation magnetization");
+                                }
+                                else if (M_magnitude_normalized > 1._rt && M_magnitude_normalized <= 1._rt + mag_normalized_error){
+                                    // normalize the M_zface field
+                                    M_zface(i, j, k, 0) /= M_magnitude_normalized;
+                                    M_zface(i, j, k, 1) /= M_magnitude_normalized;
+                                    M_zface(i, j, k, 2) /= M_magnitude_normalized;
+                                }
+                            }
 
-                        // calculate M_error_zface
-                        // x,y,z component on z-faces of grid
-                        for (int icomp = 0; icomp < 3; ++icomp) {
-                            M_error_zface(i, j, k, icomp) = amrex::Math::abs((M_zface(i, j, k, icomp) - M_prev_zface(i, j, k, icomp))) / mag_Ms_zface_arr(i,j,k);
+                            // max over the x,y,z components of the M-error on z-faces of grid
+                            for (int icomp = 0; icomp < 3; ++icomp) {
+                                M_iter_error = amrex::max(M_iter_error, amrex::Math::abs((M_zface(i, j, k, icomp) - M_prev_zface(i, j, k, icomp))) / mag_Ms_zface_arr(i,j,k));
+                            }
                         }
-                    }
-                });
+                        // all the faces above the tolerance write the same value
+                        if (tile_unconverged && M_iter_error > M_tol) *tile_unconverged = 1;
+                        return {M_iter_error};
+                    };
+                for (Box const& bx : LLGPassBoxes(tbz, amrex::convert(mfi.validbox(), Hznodal), pass)) {
+                    reduce_op.eval(bx, reduce_data, update_M_zface);
+                }
+
+                if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+                {
+                    amrex::Gpu::synchronize();
+                    wt = amrex::second() - wt;
+                    (*cost)[mfi.index()] += wt;
+                }
+            }
+        }
+
+        // Check the error between Mfield and Mfield_prev and decide whether another iteration is needed
+        // the last allowed iteration is always checked
+        // The error is reduced in the M update above, so it is known before H is updated: the H update of
+        // the last iteration then also normalizes M (M_normalization == 2) and updates B, in the same pass
+        bool const check_iter = ((M_iter + 1) % M_iter_check_interval == 0) || (M_iter + 1 >= M_max_iter);
+        amrex::Real M_iter_maxerror = -1._rt;
+        if (check_iter) {
+            M_iter_maxerror = amrex::get<0>(reduce_data.value());
+            ParallelDescriptor::ReduceRealMax(M_iter_maxerror);
+        }
+        m_llg_stats.last_residuals.push_back(M_iter_maxerror);
+
+        if (check_iter && M_iter_maxerror <= M_tol){
+            stop_iter = 1;
         }
+        int const normalize_M = (stop_iter && M_normalization == 2) ? 1 : 0;
+        int const update_B = (stop_iter && maintain_B) ? 1 : 0;
 
-        // update H
+        // update H, and in the last iteration normalize M and update B
         for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
 
-            auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-            auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-            auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
+            // H only depends on M in the frozen boxes, which has not changed since their last update
+            if (active_set && !stop_iter && !m_llg_active_box[mfi.index()]) continue;
+
 
             // extract material properties
-            Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-            Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-            Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
+            MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+            MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+            MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
 
             // Extract field data for this grid/tile
             Array4<Real> const &Hx = Hfield[0]->array(mfi);
@@ -895,15 +1125,28 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
             Array4<Real> const &Hx_old = Hfield_old[0]->array(mfi);
             Array4<Real> const &Hy_old = Hfield_old[1]->array(mfi);
             Array4<Real> const &Hz_old = Hfield_old[2]->array(mfi);
+            Array4<Real> const &Bx = Bfield[0]->array(mfi);
+            Array4<Real> const &By = Bfield[1]->array(mfi);
+            Array4<Real> const &Bz = Bfield[2]->array(mfi);
             Array4<Real> const &Ex = Efield[0]->array(mfi);
             Array4<Real> const &Ey = Efield[1]->array(mfi);
             Array4<Real> const &Ez = Efield[2]->array(mfi);
-            Array4<Real> const &M_xface = Mfield[0]->array(mfi);         // note M_xface include x,y,z components at |_x faces
-            Array4<Real> const &M_yface = Mfield[1]->array(mfi);         // note M_yface include x,y,z components at |_y faces
-            Array4<Real> const &M_zface = Mfield[2]->array(mfi);         // note M_zface include x,y,z components at |_z faces
-            Array4<Real> const &M_xface_old = Mfield_old[0]->array(mfi); // note M_xface_old include x,y,z components at |_x faces
-            Array4<Real> const &M_yface_old = Mfield_old[1]->array(mfi); // note M_yface_old include x,y,z components at |_y faces
-            Array4<Real> const &M_zface_old = Mfield_old[2]->array(mfi); // note M_zface_old include x,y,z components at |_z faces
+            // M and M_old are only read on the magnetic faces, and only stored in the magnetic boxes
+            int const scratch_index = m_llg_scratch_index[mfi.index()];
+            Array4<Real> M_xface; // note M_xface include x,y,z components at |_x faces
+            Array4<Real> M_yface; // note M_yface include x,y,z components at |_y faces
+            Array4<Real> M_zface; // note M_zface include x,y,z components at |_z faces
+            Array4<LLGStorageReal> M_xface_old; // note M_xface_old include x,y,z components at |_x faces
+            Array4<LLGStorageReal> M_yface_old; // note M_yface_old include x,y,z components at |_y faces
+            Array4<LLGStorageReal> M_zface_old; // note M_zface_old include x,y,z components at |_z faces
+            if (scratch_index >= 0) {
+                M_xface = Mfield[0]->array(scratch_index);
+                M_yface = Mfield[1]->array(scratch_index);
+                M_zface = Mfield[2]->array(scratch_index);
+                M_xface_old = Mfield_old[0]->array(scratch_index);
+                M_yface_old = Mfield_old[1]->array(scratch_index);
+                M_zface_old = Mfield_old[2]->array(scratch_index);
+            }
 
             // Extract stencil coefficients
             amrex::Real const *const AMREX_RESTRICT coefs_x = m_stencil_coefs_x.dataPtr();
@@ -914,6 +1157,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
             int const n_coefs_z = m_stencil_coefs_z.size();
 
             // Extract tileboxes for which to loop
+            // (B, H and M share the same staggering, see MacroscopicProperties::InitData)
             amrex::IntVect Hxnodal = Hfield[0]->ixType().toIntVect();
             amrex::IntVect Hynodal = Hfield[1]->ixType().toIntVect();
             amrex::IntVect Hznodal = Hfield[2]->ixType().toIntVect();
@@ -921,7 +1165,7 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
             Box const &tby = mfi.tilebox(Hynodal);
             Box const &tbz = mfi.tilebox(Hznodal);
 
-            amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
+            MaterialPropertyArray const mu_arr = macroscopic_properties->getmu_arr(mfi);
 
             amrex::Real const mu0_inv = 1. / PhysConst::mu0;
 
@@ -934,12 +1178,34 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         amrex::Real mu_arrx = CoarsenIO::Interp( mu_arr, mu_stag, Hx_stag, macro_cr, i, j, k, 0);
                         Hx(i, j, k) = Hx_old(i, j, k) + 1. / mu_arrx * dt * (T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
                                                                            - T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k));
+                        if (update_B) {
+                            Bx(i, j, k) = mu_arrx * Hx(i, j, k);
+                        }
                     } else if (mag_Ms_xface_arr(i,j,k) > 0){ // magnetic region
                         Hx(i, j, k) = Hx_old(i, j, k) + mu0_inv * dt * (T_Algo::UpwardDz(Ey, coefs_z, n_coefs_z, i, j, k)
                                                                       - T_Algo::UpwardDy(Ez, coefs_y, n_coefs_y, i, j, k));
                         if (coupling == 1) {
                             Hx(i, j, k) += - M_xface(i, j, k, 0) + M_xface_old(i, j, k, 0);
                         }
+                        if (normalize_M) {
+                            // temporary normalized magnitude of M_xface field at the fixed point
+                            // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
+                            amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) +
+                                                                           std::pow(M_xface(i, j, k, 2), 2._rt)) /
+                                                                 mag_Ms_xface_arr(i,j,k);
+
+                            // check the normalized error
+                            if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
+                                amrex::Abort("Exceed the normalized error of the M_xface field");
+                            }
+                            // normalize the M_xface field
+                            M_xface(i, j, k, 0) /= M_magnitude_normalized;
+                            M_xface(i, j, k, 1) /= M_magnitude_normalized;
+                            M_xface(i, j, k, 2) /= M_magnitude_normalized;
+                        }
+                        if (update_B) {
+                            Bx(i, j, k) = PhysConst::mu0 * (M_xface(i, j, k, 0) + Hx(i, j, k));
+                        }
                     }
                 },
 
@@ -949,12 +1215,34 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         amrex::Real mu_arry = CoarsenIO::Interp( mu_arr, mu_stag, Hy_stag, macro_cr, i, j, k, 0);
                         Hy(i, j, k) = Hy_old(i, j, k) + 1. / mu_arry * dt * (T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
                                                                            - T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k));
+                        if (update_B) {
+                            By(i, j, k) = mu_arry * Hy(i, j, k);
+                        }
                     } else if (mag_Ms_yface_arr(i,j,k) > 0){ // magnetic region
                         Hy(i, j, k) = Hy_old(i, j, k) + mu0_inv * dt * (T_Algo::UpwardDx(Ez, coefs_x, n_coefs_x, i, j, k)
                                                                       - T_Algo::UpwardDz(Ex, coefs_z, n_coefs_z, i, j, k));
                         if (coupling == 1){
                             Hy(i, j, k) += - M_yface(i, j, k, 1) + M_yface_old(i, j, k, 1);
                         }
+                        if (normalize_M) {
+                            // temporary normalized magnitude of M_yface field at the fixed point
+                            // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
+                            amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) +
+                                                                           std::pow(M_yface(i, j, k, 2), 2._rt)) /
+                                                                 mag_Ms_yface_arr(i,j,k);
+
+                            // check the normalized error
+                            if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
+                                amrex::Abort("Exceed the normalized error of the M_yface field");
+                            }
+                            // normalize the M_yface field
+                            M_yface(i, j, k, 0) /= M_magnitude_normalized;
+                            M_yface(i, j, k, 1) /= M_magnitude_normalized;
+                            M_yface(i, j, k, 2) /= M_magnitude_normalized;
+                        }
+                        if (update_B) {
+                            By(i, j, k) = PhysConst::mu0 * (M_yface(i, j, k, 1) + Hy(i, j, k));
+                        }
                     }
                 },
 
@@ -964,210 +1252,582 @@ void FiniteDifferenceSolver::MacroscopicEvolveHMCartesian_2nd(
                         amrex::Real mu_arrz = CoarsenIO::Interp( mu_arr, mu_stag, Hz_stag, macro_cr, i, j, k, 0);
                         Hz(i, j, k) = Hz_old(i, j, k) + 1. / mu_arrz * dt * (T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
                                                                            - T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k));
+                        if (update_B) {
+                            Bz(i, j, k) = mu_arrz * Hz(i, j, k);
+                        }
                     } else if (mag_Ms_zface_arr(i,j,k) > 0){ // magnetic region
                         Hz(i, j, k) = Hz_old(i, j, k) + mu0_inv * dt * (T_Algo::UpwardDy(Ex, coefs_y, n_coefs_y, i, j, k)
                                                                       - T_Algo::UpwardDx(Ey, coefs_x, n_coefs_x, i, j, k));
                         if (coupling == 1){
                             Hz(i, j, k) += - M_zface(i, j, k, 2) + M_zface_old(i, j, k, 2);
                         }
+                        if (normalize_M) {
+                            // temporary normalized magnitude of M_zface field at the fixed point
+                            // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
+                            amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) +
+                                                                           std::pow(M_zface(i, j, k, 2), 2._rt)) /
+                                                                 mag_Ms_zface_arr(i,j,k);
+
+                            // check the normalized error
+                            if (amrex::Math::abs(1. - M_magnitude_normalized) > mag_normalized_error){
+                                amrex::Abort("Exceed the normalized error of the M_zface field");
+                            }
+                            // normalize the M_zface field
+                            M_zface(i, j, k, 0) /= M_magnitude_normalized;
+                            M_zface(i, j, k, 1) /= M_magnitude_normalized;
+                            M_zface(i, j, k, 2) /= M_magnitude_normalized;
+                        }
+                        if (update_B) {
+                            Bz(i, j, k) = PhysConst::mu0 * (M_zface(i, j, k, 2) + Hz(i, j, k));
+                        }
                     }
                 }
 
             );
         }
 
-        // Check the error between Mfield and Mfield_prev and decide whether another iteration is needed
-        amrex::Real M_iter_maxerror = -1._rt;
-        for (int iface = 0; iface < 3; iface++){
-            for (int jcomp = 0; jcomp < 3; jcomp++){
-                Real M_iter_error = Mfield_error[iface]->norm0(jcomp);
-                if (M_iter_error >= M_iter_maxerror){
-                    M_iter_maxerror = M_iter_error;
-                }
+        if (!stop_iter && anderson_depth > 0){
+            // Anderson extrapolation of the next iterate from the last ones, instead of M_prev = M
+            AndersonMixLLG(Mfield, Hfield, M_iter, anderson_depth, coupling, period, macroscopic_properties);
+        }
+        else if (!stop_iter){
+            // Copy Mfield to Mfield_previous, whose periodic/interior ghost cells are filled below
+            // (Mfield_prev only covers the magnetic boxes, the frozen ones are already up to date)
+            for (int i = 0; i < 3; i++){
+                CopyToLLGScratch(*Mfield_prev[i], *Mfield[i], active_set);
             }
+            M_prev_exchange_pending = true;
         }
 
-        if (M_iter_maxerror <= M_tol){
-
-            stop_iter = 1;
-
-            // normalize M
-            if (M_normalization == 2){
+        // freeze the converged boxes for the next iterations, once H and M_prev are up to date in them;
+        // the guard cells of the boxes that become active again are filled by the exchange below
+        if (active_set && check_iter && !stop_iter){
+            UpdateLLGActiveSet(Hfield, warpx.getngEB(), period);
+        }
 
-                for (MFIter mfi(*Mfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
+        // H is final for this iteration (the Anderson mixing above also corrects it);
+        // the exchange is completed in the M update of the next iteration
+        if (!stop_iter) BeginLLGExchange(lev, Hfield, M_prev_exchange_pending, period);
 
-                    auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-                    auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-                    auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
+        if (M_iter >= M_max_iter){
+            amrex::Abort("The M_iter = " + std::to_string(M_iter) + " exceeds the M_max_iter = "
+                         + std::to_string(M_max_iter));
+        }
+        else{
+            M_iter++;
+        }
 
-                    // extract material properties
-                    Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-                    Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-                    Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
+    } // end the iteration
+    WARPX_PROFILE_VAR_STOP(blp_llg_iterations);
 
-                    // extract field data
-                    Array4<Real> const &M_xface = Mfield[0]->array(mfi); // note M_xface include x,y,z components at |_x faces
-                    Array4<Real> const &M_yface = Mfield[1]->array(mfi); // note M_yface include x,y,z components at |_y faces
-                    Array4<Real> const &M_zface = Mfield[2]->array(mfi); // note M_zface include x,y,z components at |_z faces
+    m_llg_stats.n_solves += 1;
+    m_llg_stats.n_iter_total += M_iter;
+    m_llg_n_updates_run += M_iter;
+    m_llg_stats.n_iter_max = std::max(m_llg_stats.n_iter_max, M_iter);
+    m_llg_stats.iter_time += amrex::second() - iter_start_time;
+}
 
-                    // extract tileboxes for which to loop
-                    amrex::IntVect Mxface_stag = Mfield[0]->ixType().toIntVect();
-                    amrex::IntVect Myface_stag = Mfield[1]->ixType().toIntVect();
-                    amrex::IntVect Mzface_stag = Mfield[2]->ixType().toIntVect();
-                    Box const &tbx = mfi.tilebox(Mxface_stag); /* just define which grid type */
-                    Box const &tby = mfi.tilebox(Myface_stag);
-                    Box const &tbz = mfi.tilebox(Mzface_stag);
+amrex::Real FiniteDifferenceSolver::LLGMagneticDot (
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const& a,
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const& b,
+    amrex::MultiFab const& Hxface,
+    MacroscopicProperties const& macroscopic_properties) const {
+
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    for (MFIter mfi(Hxface); mfi.isValid(); ++mfi) {
+        int const scratch_index = m_llg_scratch_index[mfi.index()];
+        if (scratch_index < 0) continue;
+        for (int dir = 0; dir < 3; ++dir) {
+            MaterialPropertyArray const Ms_arr = macroscopic_properties.getmag_Ms_arr(dir, mfi);
+            Array4<Real const> const& a_arr = a[dir]->const_array(scratch_index);
+            Array4<Real const> const& b_arr = b[dir]->const_array(scratch_index);
+            reduce_op.eval(LLGMagnetizationStatsBox(mfi, dir), reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple {
+                    if (Ms_arr(i,j,k) == 0._rt) return {0._rt};
+                    return {a_arr(i,j,k,0)*b_arr(i,j,k,0) + a_arr(i,j,k,1)*b_arr(i,j,k,1)
+                          + a_arr(i,j,k,2)*b_arr(i,j,k,2)};
+                });
+        }
+    }
+    return amrex::get<0>(reduce_data.value());
+}
 
-                    // loop over cells and update fields
-                    amrex::ParallelFor(tbx, tby, tbz,
-                        [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+void FiniteDifferenceSolver::AndersonMixLLG (
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &Mfield,
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &Hfield,
+    int const iter, int const anderson_depth, int const coupling,
+    amrex::Periodicity const& period,
+    std::unique_ptr<MacroscopicProperties> const &macroscopic_properties) {
 
-                            if (mag_Ms_xface_arr(i,j,k) > 0._rt){
-                                // temporary normalized magnitude of M_xface field at the fixed point
-                                // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
-                                amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_xface(i, j, k, 0), 2._rt) + std::pow(M_xface(i, j, k, 1), 2._rt) +
-                                                                               std::pow(M_xface(i, j, k, 2), 2._rt)) /
-                                                                     mag_Ms_xface_arr(i,j,k);
+    WARPX_PROFILE("FiniteDifferenceSolver::AndersonMixLLG()");
+
+    // x = M_prev is the current iterate, g = Mfield = G(x) the output of the fixed-point map
+    // and f = g - x the residual. With dF/dG the differences of the last residuals/outputs,
+    // the next iterate is x_new = g - dG gamma, where gamma minimizes |f - dF gamma|.
+    // x is in the LLG storage precision, f, g, x_new and the history in amrex::Real
+    std::array<std::unique_ptr<LLGStorageFab>, 3> &x = m_llg_Mfield_prev;
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &g = Mfield;
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &f_prev = m_llg_aa_f_prev;
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> &g_prev = m_llg_aa_g_prev;
+
+    // the history is restarted at each call of the scheme (iter == 0)
+    // g, x and the history are all on the magnetic boxes
+    if (iter > 0) {
+        int const slot = (iter - 1) % anderson_depth;
+        for (int i = 0; i < 3; i++){
+            IntVect const ng = g[i]->nGrowVect();
+            MultiFab& dF = *m_llg_aa_dF[slot][i];
+            MultiFab& dG = *m_llg_aa_dG[slot][i];
+            MultiFab::Copy(dG, *g[i], 0, 0, 3, ng);
+            LLGResidual(dF, *g[i], *x[i], ng);
+            MultiFab::Subtract(dF, *f_prev[i], 0, 0, 3, ng);
+            MultiFab::Subtract(dG, *g_prev[i], 0, 0, 3, ng);
+        }
+    }
+    for (int i = 0; i < 3; i++){
+        IntVect const ng = g[i]->nGrowVect();
+        MultiFab::Copy(*g_prev[i], *g[i], 0, 0, 3, ng);
+        LLGResidual(*f_prev[i], *g[i], *x[i], ng);
+    }
 
-                                // check the normalized error
-                                if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
-                                    amrex::Abort("Exceed the normalized error of the M_xface field");
-                                }
-                                // normalize the M_xface field
-                                M_xface(i, j, k, 0) /= M_magnitude_normalized;
-                                M_xface(i, j, k, 1) /= M_magnitude_normalized;
-                                M_xface(i, j, k, 2) /= M_magnitude_normalized;
-                            }
-                        },
+    // least-squares problem in the normal form (dF^T dF) gamma = dF^T f, all dot products in one reduction
+    int const m = std::min(iter, anderson_depth);
+    std::vector<amrex::Real> gamma(m, 0._rt);
+    if (m > 0) {
+        // only the magnetic faces, where the residual is defined, each counted once
+        std::vector<amrex::Real> dots(m*m + m, 0._rt);
+        for (int a = 0; a < m; ++a) {
+            for (int b = a; b < m; ++b) {
+                dots[a*m+b] = LLGMagneticDot(m_llg_aa_dF[a], m_llg_aa_dF[b], *Hfield[0], *macroscopic_properties);
+            }
+            dots[m*m+a] = LLGMagneticDot(m_llg_aa_dF[a], f_prev, *Hfield[0], *macroscopic_properties);
+        }
+        ParallelDescriptor::ReduceRealSum(dots.data(), static_cast<int>(dots.size()));
+
+        std::vector<amrex::Real> A(m*m);
+        std::vector<amrex::Real> rhs(m);
+        amrex::Real trace = 0._rt;
+        for (int a = 0; a < m; ++a) {
+            for (int b = 0; b < m; ++b) {
+                A[a*m+b] = (b >= a) ? dots[a*m+b] : dots[b*m+a];
+            }
+            rhs[a] = dots[m*m+a];
+            trace += A[a*m+a];
+        }
+        if (trace > 0._rt) {
+            // small Tikhonov regularization, the differences of successive iterates become nearly collinear
+            for (int a = 0; a < m; ++a) A[a*m+a] += 1.e-10_rt * trace / m;
+
+            // Gaussian elimination with partial pivoting
+            for (int c = 0; c < m; ++c) {
+                int piv = c;
+                for (int r = c+1; r < m; ++r) {
+                    if (std::abs(A[r*m+c]) > std::abs(A[piv*m+c])) piv = r;
+                }
+                for (int cc = 0; cc < m; ++cc) std::swap(A[c*m+cc], A[piv*m+cc]);
+                std::swap(rhs[c], rhs[piv]);
+                for (int r = c+1; r < m; ++r) {
+                    amrex::Real const factor = A[r*m+c] / A[c*m+c];
+                    for (int cc = c; cc < m; ++cc) A[r*m+cc] -= factor * A[c*m+cc];
+                    rhs[r] -= factor * rhs[c];
+                }
+            }
+            for (int r = m-1; r >= 0; --r) {
+                amrex::Real sum = rhs[r];
+                for (int cc = r+1; cc < m; ++cc) sum -= A[r*m+cc] * gamma[cc];
+                gamma[r] = sum / A[r*m+r];
+            }
+        }
+    }
 
-                        [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+    // x_new = g - dG gamma, in place in Mfield (g_prev keeps g)
+    for (int i = 0; i < 3; i++){
+        IntVect const ng = g[i]->nGrowVect();
+        for (int a = 0; a < m; ++a) {
+            MultiFab::Saxpy(*Mfield[i], -gamma[a], *m_llg_aa_dG[a][i], 0, 0, 3, ng);
+        }
+    }
 
-                            if (mag_Ms_yface_arr(i,j,k) > 0._rt){
-                                // temporary normalized magnitude of M_yface field at the fixed point
-                                // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
-                                amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_yface(i, j, k, 0), 2._rt) + std::pow(M_yface(i, j, k, 1), 2._rt) +
-                                                                               std::pow(M_yface(i, j, k, 2), 2._rt)) /
-                                                                     mag_Ms_yface_arr(i,j,k);
+    // H is linear in M on the magnetic faces: H(x_new) = H(g) + g - x_new
+    if (coupling == 1) {
+        for (MFIter mfi(*Hfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
+            if (!macroscopic_properties->is_magnetic_box(mfi)) continue;
 
-                                // check the normalized error
-                                if (amrex::Math::abs(1._rt - M_magnitude_normalized) > mag_normalized_error){
-                                    amrex::Abort("Exceed the normalized error of the M_yface field");
-                                }
-                                // normalize the M_yface field
-                                M_yface(i, j, k, 0) /= M_magnitude_normalized;
-                                M_yface(i, j, k, 1) /= M_magnitude_normalized;
-                                M_yface(i, j, k, 2) /= M_magnitude_normalized;
-                            }
-                        },
+            MaterialPropertyArray const mag_Ms_xface_arr = macroscopic_properties->getmag_Ms_arr(0, mfi);
+            MaterialPropertyArray const mag_Ms_yface_arr = macroscopic_properties->getmag_Ms_arr(1, mfi);
+            MaterialPropertyArray const mag_Ms_zface_arr = macroscopic_properties->getmag_Ms_arr(2, mfi);
+            Array4<Real> const &Hx = Hfield[0]->array(mfi);
+            Array4<Real> const &Hy = Hfield[1]->array(mfi);
+            Array4<Real> const &Hz = Hfield[2]->array(mfi);
+            int const scratch_index = m_llg_scratch_index[mfi.index()];
+            Array4<Real const> const &M_xface = g_prev[0]->const_array(scratch_index);
+            Array4<Real const> const &M_yface = g_prev[1]->const_array(scratch_index);
+            Array4<Real const> const &M_zface = g_prev[2]->const_array(scratch_index);
+            Array4<Real const> const &M_new_xface = Mfield[0]->const_array(scratch_index);
+            Array4<Real const> const &M_new_yface = Mfield[1]->const_array(scratch_index);
+            Array4<Real const> const &M_new_zface = Mfield[2]->const_array(scratch_index);
+
+            Box const &tbx = mfi.tilebox(Hfield[0]->ixType().toIntVect());
+            Box const &tby = mfi.tilebox(Hfield[1]->ixType().toIntVect());
+            Box const &tbz = mfi.tilebox(Hfield[2]->ixType().toIntVect());
 
-                        [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+            amrex::ParallelFor(tbx, tby, tbz,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+                    if (mag_Ms_xface_arr(i,j,k) > 0._rt) Hx(i, j, k) += M_xface(i, j, k, 0) - M_new_xface(i, j, k, 0);
+                },
+                [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+                    if (mag_Ms_yface_arr(i,j,k) > 0._rt) Hy(i, j, k) += M_yface(i, j, k, 1) - M_new_yface(i, j, k, 1);
+                },
+                [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+                    if (mag_Ms_zface_arr(i,j,k) > 0._rt) Hz(i, j, k) += M_zface(i, j, k, 2) - M_new_zface(i, j, k, 2);
+                });
+        }
+    }
 
-                            if (mag_Ms_zface_arr(i,j,k) > 0._rt){
-                                // temporary normalized magnitude of M_zface field at the fixed point
-                                // re-investigate the way we do Ms interp, in case we encounter the case where Ms changes across two adjacent cells that you are doing interp
-                                amrex::Real M_magnitude_normalized = std::sqrt(std::pow(M_zface(i, j, k, 0), 2._rt) + std::pow(M_zface(i, j, k, 1), 2._rt) +
-                                                                               std::pow(M_zface(i, j, k, 2), 2._rt)) /
-                                                                     mag_Ms_zface_arr(i,j,k);
+    // M = x_new and M_prev = x_new in the LLG storage precision, with up-to-date periodic/interior ghost cells
+    for (int i = 0; i < 3; i++){
+        Mfield[i]->FillBoundary(Mfield[i]->nGrowVect(), period);
+        CopyToLLGScratch(*x[i], *Mfield[i]);
+    }
+}
 
-                                // check the normalized error
-                                if (amrex::Math::abs(1. - M_magnitude_normalized) > mag_normalized_error){
-                                    amrex::Abort("Exceed the normalized error of the M_zface field");
-                                }
-                                // normalize the M_zface field
-                                M_zface(i, j, k, 0) /= M_magnitude_normalized;
-                                M_zface(i, j, k, 1) /= M_magnitude_normalized;
-                                M_zface(i, j, k, 2) /= M_magnitude_normalized;
-                            }
-                        });
+void FiniteDifferenceSolver::UpdateLLGActiveSet (
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const& Hfield,
+    amrex::IntVect const& ng_H,
+    amrex::Periodicity const& period) {
+
+    WARPX_PROFILE("FiniteDifferenceSolver::UpdateLLGActiveSet()");
+
+    BoxArray const& ba = m_llg_scratch_src_ba;
+    int const nboxes = static_cast<int>(ba.size());
+
+    // the exchange stencil reaches two faces into the neighbouring boxes, including the periodic images
+    if (static_cast<int>(m_llg_box_neighbors.size()) != nboxes) {
+        m_llg_box_neighbors.resize(nboxes);
+        for (int K = 0; K < nboxes; ++K) {
+            Vector<int>& neighbors = m_llg_box_neighbors[K];
+            neighbors.clear();
+            Box const grown_box = amrex::grow(ba[K], 2);
+            for (IntVect const& shift : period.shiftIntVect()) {
+                for (auto const& isect : ba.intersections(grown_box + shift)) {
+                    if (isect.first != K) neighbors.push_back(isect.first);
                 }
             }
         }
-        else{
-            const auto& period = warpx.Geom(lev).periodicity();
-            // Copy Mfield to Mfield_previous and fill periodic/interior ghost cells
-            for (int i = 0; i < 3; i++){
-                MultiFab::Copy(*Mfield_prev[i], *Mfield[i], 0, 0, 3, Mfield[i]->nGrow());
-                (*Mfield_prev[i]).FillBoundary(Mfield[i]->nGrowVect(), period);
-            }
+    }
+
+    // a box has not converged if any of its tiles is flagged; the frozen boxes have converged
+    Vector<int> tile_unconverged(m_llg_tile_unconverged.size());
+    Gpu::copyAsync(Gpu::deviceToHost, m_llg_tile_unconverged.begin(), m_llg_tile_unconverged.end(),
+                   tile_unconverged.begin());
+    Gpu::streamSynchronize();
+    Vector<int> unconverged(nboxes, 0);
+    for (int t = 0; t < static_cast<int>(tile_unconverged.size()); ++t) {
+        if (tile_unconverged[t]) unconverged[m_llg_tile_box_index[t]] = 1;
+    }
+    ParallelDescriptor::ReduceIntMax(unconverged.data(), nboxes);
+
+    // the converged boxes next to a box that has not converged stay active:
+    // their H_eff depends on M in that box through the exchange term
+    bool changed = false;
+    for (int K = 0; K < nboxes; ++K) {
+        int active = unconverged[K];
+        for (int const nb : m_llg_box_neighbors[K]) {
+            if (unconverged[nb]) active = 1;
         }
+        changed = changed || (active != m_llg_active_box[K]);
+        m_llg_active_box[K] = active;
+    }
+    if (!changed) return;
 
-        if (M_iter >= M_max_iter){
-            amrex::Abort("The M_iter exceeds the M_max_iter");
-            amrex::Print() << "The M_iter = " << M_iter << " exceeds the M_max_iter = " << M_max_iter << std::endl;
+    // the guard cells of the frozen boxes are not read until the end of the iterations
+    m_llg_exchange_active_only = std::find(m_llg_active_box.begin(), m_llg_active_box.end(), 0)
+                                 != m_llg_active_box.end();
+    if (!m_llg_exchange_active_only) return;
+
+    Vector<int> active_scratch(m_llg_scratch_src.size());
+    for (int s = 0; s < static_cast<int>(active_scratch.size()); ++s) {
+        active_scratch[s] = m_llg_active_box[m_llg_scratch_src[s]];
+    }
+    for (int i = 0; i < 3; i++) {
+        DefineLLGActiveHalo(m_llg_halo_H[i], *Hfield[i], m_llg_active_box, ng_H);
+        DefineLLGActiveHalo(m_llg_halo_M_prev[i], *m_llg_Mfield_prev[i], active_scratch,
+                            m_llg_Mfield_prev[i]->nGrowVect());
+    }
+}
+
+template <typename FAB>
+void FiniteDifferenceSolver::DefineLLGActiveHalo (
+    LLGActiveHalo<FAB>& halo, amrex::FabArray<FAB> const& mf,
+    amrex::Vector<int> const& active, amrex::IntVect const& ng) const {
+
+    BoxArray const& ba = mf.boxArray();
+    DistributionMapping const& dm = mf.DistributionMap();
+    BoxList bl(mf.ixType());
+    Vector<int> pmap;
+    halo.owner.clear();
+    for (int K = 0; K < static_cast<int>(ba.size()); ++K) {
+        if (!active[K]) continue;
+        for (Box const& b : amrex::boxDiff(amrex::grow(ba[K], amrex::min(ng, mf.nGrowVect())), ba[K])) {
+            bl.push_back(b);
+            pmap.push_back(dm[K]);
+            halo.owner.push_back(K);
         }
-        else{
-            M_iter++;
-            amrex::Print() << "Finish " << M_iter << " times iteration with M_iter_maxerror = " << M_iter_maxerror << " and M_tol = " << M_tol << std::endl;
+    }
+    if (bl.isEmpty()) {
+        halo.shell.reset();
+        return;
+    }
+    // on the ranks of the boxes they belong to
+    halo.shell = std::make_unique<FabArray<FAB> >(BoxArray(std::move(bl)), DistributionMapping(std::move(pmap)),
+                                                  mf.nComp(), 0);
+}
+
+template <typename FAB>
+void FiniteDifferenceSolver::BeginLLGActiveHaloExchange (
+    LLGActiveHalo<FAB>& halo, amrex::FabArray<FAB>& mf, amrex::Periodicity const& period) const {
+
+    if (!halo.shell) return;
+
+    // the guard cells out of a non-periodic domain are not overwritten by the copy
+    for (MFIter mfi(*halo.shell); mfi.isValid(); ++mfi) {
+        auto const& d = halo.shell->array(mfi);
+        auto const& s = mf.const_array(halo.owner[mfi.index()]);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) { d(i, j, k, n) = s(i, j, k, n); });
+    }
+    halo.shell->ParallelCopy_nowait(mf, 0, 0, mf.nComp(), IntVect(0), IntVect(0), period);
+}
+
+template <typename FAB>
+void FiniteDifferenceSolver::EndLLGActiveHaloExchange (
+    LLGActiveHalo<FAB>& halo, amrex::FabArray<FAB>& mf) const {
+
+    if (!halo.shell) return;
+
+    halo.shell->ParallelCopy_finish();
+    for (MFIter mfi(*halo.shell); mfi.isValid(); ++mfi) {
+        auto const& d = mf.array(halo.owner[mfi.index()]);
+        auto const& s = halo.shell->const_array(mfi);
+        amrex::ParallelFor(mfi.validbox(), mf.nComp(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) { d(i, j, k, n) = s(i, j, k, n); });
+    }
+}
+
+void FiniteDifferenceSolver::BeginLLGExchange (
+    int lev, std::array<std::unique_ptr<amrex::MultiFab>, 3>& Hfield,
+    bool const M_prev, amrex::Periodicity const& period) {
+
+    auto &warpx = WarpX::GetInstance();
+    if (m_llg_exchange_active_only) {
+        warpx.ExchangeHPML(lev);
+        for (int i = 0; i < 3; i++) BeginLLGActiveHaloExchange(m_llg_halo_H[i], *Hfield[i], period);
+    } else {
+        warpx.FillBoundaryH_nowait(lev, warpx.getngEB());
+    }
+    if (!M_prev) return;
+    for (int i = 0; i < 3; i++) {
+        if (m_llg_exchange_active_only) {
+            BeginLLGActiveHaloExchange(m_llg_halo_M_prev[i], *m_llg_Mfield_prev[i], period);
+        } else {
+            m_llg_Mfield_prev[i]->FillBoundary_nowait(0, 3, m_llg_Mfield_prev[i]->nGrowVect(), period);
         }
+    }
+}
 
-    } // end the iteration
+void FiniteDifferenceSolver::EndLLGExchange (
+    int lev, std::array<std::unique_ptr<amrex::MultiFab>, 3>& Hfield, bool const M_prev) {
 
-    // update B
-    for (MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi){
-
-        auto& mag_Ms_xface_mf = macroscopic_properties->getmag_Ms_mf(0);
-        auto& mag_Ms_yface_mf = macroscopic_properties->getmag_Ms_mf(1);
-        auto& mag_Ms_zface_mf = macroscopic_properties->getmag_Ms_mf(2);
-
-        // Extract field data for this grid/tile
-        Array4<Real> const& mag_Ms_xface_arr = mag_Ms_xface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_yface_arr = mag_Ms_yface_mf.array(mfi);
-        Array4<Real> const& mag_Ms_zface_arr = mag_Ms_zface_mf.array(mfi);
-        Array4<Real> const &Hx = Hfield[0]->array(mfi);
-        Array4<Real> const &Hy = Hfield[1]->array(mfi);
-        Array4<Real> const &Hz = Hfield[2]->array(mfi);
-        Array4<Real> const &Bx = Bfield[0]->array(mfi);
-        Array4<Real> const &By = Bfield[1]->array(mfi);
-        Array4<Real> const &Bz = Bfield[2]->array(mfi);
-        Array4<Real> const &M_xface = Mfield[0]->array(mfi); // note M_xface include x,y,z components at |_x faces
-        Array4<Real> const &M_yface = Mfield[1]->array(mfi); // note M_yface include x,y,z components at |_y faces
-        Array4<Real> const &M_zface = Mfield[2]->array(mfi); // note M_zface include x,y,z components at |_z faces
-
-        // Extract tileboxes for which to loop
-        amrex::IntVect Bxnodal = Bfield[0]->ixType().toIntVect();
-        amrex::IntVect Bynodal = Bfield[1]->ixType().toIntVect();
-        amrex::IntVect Bznodal = Bfield[2]->ixType().toIntVect();
-        Box const &tbx = mfi.tilebox(Bxnodal);
-        Box const &tby = mfi.tilebox(Bynodal);
-        Box const &tbz = mfi.tilebox(Bznodal);
-
-        amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
-
-        // Loop over the cells and update the fields
-        amrex::ParallelFor(tbx, tby, tbz,
-
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-
-                if (mag_Ms_xface_arr(i,j,k) == 0._rt){ // nonmagnetic region
-                    amrex::Real mu_arrx = CoarsenIO::Interp( mu_arr, mu_stag, Bx_stag, macro_cr, i, j, k, 0);
-                    Bx(i, j, k) = mu_arrx * Hx(i, j, k);
-                } else if (mag_Ms_xface_arr(i,j,k) > 0){
-                    Bx(i, j, k) = PhysConst::mu0 * (M_xface(i, j, k, 0) + Hx(i, j, k));
-                }
-            },
+    auto &warpx = WarpX::GetInstance();
+    if (m_llg_exchange_active_only) {
+        for (int i = 0; i < 3; i++) EndLLGActiveHaloExchange(m_llg_halo_H[i], *Hfield[i]);
+    } else {
+        warpx.FillBoundaryH_finish(lev);
+    }
+    if (!M_prev) return;
+    for (int i = 0; i < 3; i++) {
+        if (m_llg_exchange_active_only) {
+            EndLLGActiveHaloExchange(m_llg_halo_M_prev[i], *m_llg_Mfield_prev[i]);
+        } else {
+            m_llg_Mfield_prev[i]->FillBoundary_finish();
+        }
+    }
+}
+
+namespace {
+    /** Copy the box K_src of src (with its guard cells) to the box K_dst of dst,
+     *  which has the same index type and number of guard cells */
+    template <typename DST, typename SRC>
+    void CopyLLGBox (amrex::FabArray<DST>& dst, int const K_dst,
+                     amrex::FabArray<SRC> const& src, int const K_src, int const ncomp)
+    {
+        auto const& d = dst.array(K_dst);
+        auto const& s = src.const_array(K_src);
+        using T = typename DST::value_type;
+        amrex::ParallelFor(dst[K_dst].box(), ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                d(i, j, k, n) = static_cast<T>(s(i, j, k, n));
+            });
+    }
+}
 
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+bool FiniteDifferenceSolver::DefineLLGScratchLayout (
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const &Mfield,
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const &Hfield) {
+
+    if (m_llg_scratch_src_ba == Hfield[0]->boxArray() &&
+        m_llg_scratch_src_dm == Hfield[0]->DistributionMap() &&
+        m_llg_scratch_ba[0] == Mfield[0]->boxArray() &&
+        m_llg_scratch_dm == Mfield[0]->DistributionMap()) return false;
+
+    WARPX_PROFILE("FiniteDifferenceSolver::DefineLLGScratchLayout()");
+
+    // M is only stored on the magnetic boxes (see WarpX::CompactMfield), the LLG solver only runs on level 0
+    auto& warpx = WarpX::GetInstance();
+    m_llg_scratch_index = warpx.getMagneticBoxIndex(0);
+    m_llg_scratch_src = warpx.getMagneticBoxes(0);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        static_cast<int>(m_llg_scratch_index.size()) == static_cast<int>(Hfield[0]->size()) &&
+        static_cast<int>(m_llg_scratch_src.size()) == static_cast<int>(Mfield[0]->size()),
+        "the magnetic boxes of M do not match the layout of H");
+    for (int i = 0; i < 3; i++) m_llg_scratch_ba[i] = Mfield[i]->boxArray();
+    m_llg_scratch_dm = Mfield[0]->DistributionMap();
+
+    m_llg_scratch_src_ba = Hfield[0]->boxArray();
+    m_llg_scratch_src_dm = Hfield[0]->DistributionMap();
+    return true;
+}
 
-                if (mag_Ms_yface_arr(i,j,k) == 0._rt){ // nonmagnetic region
-                    amrex::Real mu_arry = CoarsenIO::Interp( mu_arr, mu_stag, By_stag, macro_cr, i, j, k, 0);
-                    By(i, j, k) =  mu_arry * Hy(i, j, k);
-                } else if (mag_Ms_yface_arr(i,j,k) > 0){
-                    By(i, j, k) = PhysConst::mu0 * (M_yface(i, j, k, 1) + Hy(i, j, k));
-                }
-            },
+void FiniteDifferenceSolver::CopyToLLGScratch (
+    amrex::MultiFab& dst, amrex::MultiFab const& src, bool const active_only) const {
 
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+    for (MFIter mfi(dst); mfi.isValid(); ++mfi) {
+        if (active_only && !m_llg_active_box[m_llg_scratch_src[mfi.index()]]) continue;
+        CopyLLGBox(dst, mfi.index(), src, mfi.index(), dst.nComp());
+    }
+}
 
-                if (mag_Ms_zface_arr(i,j,k) == 0._rt){ // nonmagnetic region
-                    amrex::Real mu_arrz = CoarsenIO::Interp( mu_arr, mu_stag, Bz_stag, macro_cr, i, j, k, 0);
-                    Bz(i, j, k) = mu_arrz * Hz(i, j, k);
-                } else if (mag_Ms_zface_arr(i,j,k) > 0){
-                    Bz(i, j, k) = PhysConst::mu0 * (M_zface(i, j, k, 2) + Hz(i, j, k));
-                }
+void FiniteDifferenceSolver::CopyToLLGScratch (
+    LLGStorageFab& dst, amrex::MultiFab const& src, bool const active_only) const {
+
+    for (MFIter mfi(dst); mfi.isValid(); ++mfi) {
+        if (active_only && !m_llg_active_box[m_llg_scratch_src[mfi.index()]]) continue;
+        CopyLLGBox(dst, mfi.index(), src, mfi.index(), dst.nComp());
+    }
+}
+
+void FiniteDifferenceSolver::AllocateLLGWorkspace (
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const &Mfield,
+    std::array<std::unique_ptr<amrex::MultiFab>, 3> const &Hfield,
+    int const anderson_depth) {
+
+    // nothing to do if the scratch data still matches the layout of the fields
+    bool realloc = DefineLLGScratchLayout(Mfield, Hfield);
+    realloc = realloc || (static_cast<int>(m_llg_aa_dF.size()) != anderson_depth);
+    for (int i = 0; i < 3; i++){
+        if (!m_llg_Mfield_old[i] || !m_llg_Hfield_old[i] ||
+            m_llg_Mfield_old[i]->nGrowVect() != Mfield[i]->nGrowVect() ||
+            m_llg_Hfield_old[i]->boxArray() != Hfield[i]->boxArray() ||
+            m_llg_Hfield_old[i]->DistributionMap() != Hfield[i]->DistributionMap() ||
+            m_llg_Hfield_old[i]->nGrowVect() != Hfield[i]->nGrowVect()) {
+            realloc = true;
+        }
+    }
+    if (!realloc) return;
+
+    WARPX_PROFILE("FiniteDifferenceSolver::AllocateLLGWorkspace()");
+
+    // H_old is read by the H update of all the boxes, the scratch data of M only in the magnetic boxes
+    // (nbytes_full_layout is what the scratch data of M would take on all the boxes of H)
+    amrex::Long nbytes = 0;
+    amrex::Long nbytes_full_layout = 0;
+    for (int i = 0; i < 3; i++){
+        m_llg_Hfield_old[i] = std::make_unique<MultiFab>(Hfield[i]->boxArray(), Hfield[i]->DistributionMap(), 1, Hfield[i]->nGrowVect());
+        m_llg_Mfield_old[i] = std::make_unique<LLGStorageFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+        m_llg_Mfield_prev[i] = std::make_unique<LLGStorageFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+        m_llg_b_temp_static[i] = std::make_unique<LLGStorageFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+        for (MFIter mfi(*m_llg_Hfield_old[i]); mfi.isValid(); ++mfi) {
+            nbytes += (*m_llg_Hfield_old[i])[mfi].nBytes();
+            nbytes_full_layout += (*m_llg_Hfield_old[i])[mfi].nBytes()
+                                + 3 * 3 * sizeof(LLGStorageReal) * (*m_llg_Hfield_old[i])[mfi].box().numPts();
+        }
+        // M_old, M_prev and b_temp_static are in the LLG storage precision
+        for (MFIter mfi(*m_llg_Mfield_prev[i]); mfi.isValid(); ++mfi) {
+            nbytes += (*m_llg_Mfield_prev[i])[mfi].nBytes()
+                    + (*m_llg_Mfield_old[i])[mfi].nBytes() + (*m_llg_b_temp_static[i])[mfi].nBytes();
+        }
+    }
+
+    // active set of boxes of the iterations, and their neighbours (built on the first update of the active set)
+    m_llg_active_box.assign(Hfield[0]->size(), 1);
+    m_llg_box_neighbors.clear();
+    m_llg_exchange_active_only = false;
+    for (int i = 0; i < 3; i++) {
+        m_llg_halo_H[i] = LLGActiveHalo<FArrayBox>();
+        m_llg_halo_M_prev[i] = LLGActiveHalo<BaseFab<LLGStorageReal> >();
+    }
+
+    // Anderson acceleration history, 2*(anderson_depth+1) more copies of M
+    m_llg_aa_dF.clear();
+    m_llg_aa_dG.clear();
+    m_llg_aa_dF.resize(anderson_depth);
+    m_llg_aa_dG.resize(anderson_depth);
+    for (int i = 0; i < 3; i++){
+        if (anderson_depth > 0) {
+            m_llg_aa_f_prev[i] = std::make_unique<MultiFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+            m_llg_aa_g_prev[i] = std::make_unique<MultiFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+            // all the Anderson buffers have the layout (and precision) of f_prev
+            for (MFIter mfi(*m_llg_aa_f_prev[i]); mfi.isValid(); ++mfi) {
+                nbytes += 2 * (anderson_depth + 1) * (*m_llg_aa_f_prev[i])[mfi].nBytes();
+            }
+            for (MFIter mfi(*m_llg_Hfield_old[i]); mfi.isValid(); ++mfi) {
+                nbytes_full_layout += 2 * (anderson_depth + 1) * 3 * sizeof(Real) * (*m_llg_Hfield_old[i])[mfi].box().numPts();
             }
+        } else {
+            m_llg_aa_f_prev[i].reset();
+            m_llg_aa_g_prev[i].reset();
+        }
+        for (int a = 0; a < anderson_depth; ++a) {
+            m_llg_aa_dF[a][i] = std::make_unique<MultiFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+            m_llg_aa_dG[a][i] = std::make_unique<MultiFab>(m_llg_scratch_ba[i], m_llg_scratch_dm, 3, Mfield[i]->nGrowVect());
+        }
+    }
+    amrex::Long nbytes_all[2] = {nbytes, nbytes_full_layout};
+    ParallelDescriptor::ReduceLongSum(nbytes_all, 2);
+    Real const ncells = static_cast<Real>(Hfield[0]->boxArray().numPts());
+    amrex::Print() << Utils::TextMsg::Info(
+        "LLG 2nd-order scheme: allocated " + std::to_string(nbytes_all[0]/(1024*1024))
+        + " MiB of persistent scratch data on " + std::to_string(m_llg_scratch_src.size()) + " magnetic boxes out of "
+        + std::to_string(Hfield[0]->size()) + ", " + std::to_string(nbytes_all[0]/ncells) + " bytes per cell ("
+        + std::to_string(nbytes_all[1]/ncells) + " on all the boxes)");
+}
+
+void FiniteDifferenceSolver::BeginLLGBoxUpdates (amrex::FabArrayBase const& mf) {
+
+    if (m_llg_box_updates.boxArray() != mf.boxArray() ||
+        m_llg_box_updates.DistributionMap() != mf.DistributionMap()) {
+        m_llg_box_updates.define(mf.boxArray(), mf.DistributionMap());
+        ResetLLGBoxUpdates();
+    }
+    m_llg_box_update_solves += 1;
+}
+
+void FiniteDifferenceSolver::ResetLLGBoxUpdates () {
 
-        );
+    for (MFIter mfi(m_llg_box_updates); mfi.isValid(); ++mfi) {
+        m_llg_box_updates[mfi] = 0._rt;
     }
+    m_llg_box_update_solves = 0;
+}
+
+amrex::Real FiniteDifferenceSolver::LLGBoxUpdatesPerSolve (int box_index) const {
+
+    // no solve yet, or box_index is not owned by this rank in the current layout
+    if (m_llg_box_update_solves == 0 || m_llg_box_updates.localindex(box_index) < 0) return -1._rt;
+    return m_llg_box_updates[box_index] / static_cast<amrex::Real>(m_llg_box_update_solves);
 }
 #endif // ifdef WARPX_MAG_LLG
 #endif // ifndef WARPX_DIM_RZ
@@ -1,6 +1,10 @@
 #include "MacroscopicProperties.H"
+#include "Parallelization/WarpXCommUtil.H"
 
+#include "Utils/CoarsenIO.H"
 #include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
 #include "WarpX.H"
 
@@ -13,15 +17,20 @@
 #include <AMReX_IndexType.H>
 #include <AMReX_IntVect.H>
 #include <AMReX_MFIter.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Print.H>
 #include <AMReX_RealBox.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_Parser.H>
 
 #include <AMReX_BaseFwd.H>
 
+#include <array>
+#include <limits>
 #include <memory>
 #include <sstream>
+#include <string>
 
 using namespace amrex;
 
@@ -40,154 +49,275 @@ MacroscopicProperties::ReadParameters ()
     // with a warning message to the user to indicate that no value was specified.
 
 
-    // Query input for material conductivity, sigma.
-    bool sigma_specified = false;
-    if (queryWithParser(pp_macroscopic, "sigma", m_sigma)) {
-        m_sigma_s = "constant";
-        sigma_specified = true;
-    }
-    if (pp_macroscopic.query("sigma_function(x,y,z)", m_str_sigma_function) ) {
-        m_sigma_s = "parse_sigma_function";
-        sigma_specified = true;
-    }
-    if (!sigma_specified) {
-        std::stringstream warnMsg;
-        warnMsg << "Material conductivity is not specified. Using default vacuum value of " <<
-            m_sigma << " in the simulation.";
-        WarpX::GetInstance().RecordWarning("Macroscopic properties",
-            warnMsg.str());
-    }
-    // initialization of sigma (conductivity) with parser
-    if (m_sigma_s == "parse_sigma_function") {
-        Store_parserString(pp_macroscopic, "sigma_function(x,y,z)", m_str_sigma_function);
-        m_sigma_parser = std::make_unique<amrex::Parser>(
-                                 makeParser(m_str_sigma_function,{"x","y","z"}));
-    }
+    // The medium is described either by a table of materials, indexed by a material ID
+    // that is the only quantity stored on the grid, or by one MultiFab per property.
+    if (pp_macroscopic.queryarr("materials", m_material_names)) {
+        m_use_material_id = true;
+        ReadMaterialTable();
+    } else {
 
-    bool epsilon_specified = false;
-    if (queryWithParser(pp_macroscopic, "epsilon", m_epsilon)) {
-        m_epsilon_s = "constant";
-        epsilon_specified = true;
-    }
-    if (pp_macroscopic.query("epsilon_function(x,y,z)", m_str_epsilon_function) ) {
-        m_epsilon_s = "parse_epsilon_function";
-        epsilon_specified = true;
-    }
-    if (!epsilon_specified) {
-        std::stringstream warnMsg;
-        warnMsg << "Material permittivity is not specified. Using default vacuum value of " <<
-            m_epsilon << " in the simulation.";
-        WarpX::GetInstance().RecordWarning("Macroscopic properties",
-            warnMsg.str());
-    }
+        // Query input for material conductivity, sigma.
+        bool sigma_specified = false;
+        if (queryWithParser(pp_macroscopic, "sigma", m_sigma)) {
+            m_sigma_s = "constant";
+            sigma_specified = true;
+        }
+        if (pp_macroscopic.query("sigma_function(x,y,z)", m_str_sigma_function) ) {
+            m_sigma_s = "parse_sigma_function";
+            sigma_specified = true;
+        }
+        if (!sigma_specified) {
+            std::stringstream warnMsg;
+            warnMsg << "Material conductivity is not specified. Using default vacuum value of " <<
+                m_sigma << " in the simulation.";
+            WarpX::GetInstance().RecordWarning("Macroscopic properties",
+                warnMsg.str());
+        }
+        // initialization of sigma (conductivity) with parser
+        if (m_sigma_s == "parse_sigma_function") {
+            Store_parserString(pp_macroscopic, "sigma_function(x,y,z)", m_str_sigma_function);
+            m_sigma_parser = std::make_unique<amrex::Parser>(
+                                     makeParser(m_str_sigma_function,{"x","y","z"}));
+        }
 
-    // initialization of epsilon (permittivity) with parser
-    if (m_epsilon_s == "parse_epsilon_function") {
-        Store_parserString(pp_macroscopic, "epsilon_function(x,y,z)", m_str_epsilon_function);
-        m_epsilon_parser = std::make_unique<amrex::Parser>(
-                                 makeParser(m_str_epsilon_function,{"x","y","z"}));
-    }
+        bool epsilon_specified = false;
+        if (queryWithParser(pp_macroscopic, "epsilon", m_epsilon)) {
+            m_epsilon_s = "constant";
+            epsilon_specified = true;
+        }
+        if (pp_macroscopic.query("epsilon_function(x,y,z)", m_str_epsilon_function) ) {
+            m_epsilon_s = "parse_epsilon_function";
+            epsilon_specified = true;
+        }
+        if (!epsilon_specified) {
+            std::stringstream warnMsg;
+            warnMsg << "Material permittivity is not specified. Using default vacuum value of " <<
+                m_epsilon << " in the simulation.";
+            WarpX::GetInstance().RecordWarning("Macroscopic properties",
+                warnMsg.str());
+        }
 
-    // Query input for material permeability, mu
-    bool mu_specified = false;
-    if (queryWithParser(pp_macroscopic, "mu", m_mu)) {
-        m_mu_s = "constant";
-        mu_specified = true;
-    }
-    if (pp_macroscopic.query("mu_function(x,y,z)", m_str_mu_function) ) {
-        m_mu_s = "parse_mu_function";
-        mu_specified = true;
-    }
-    if (!mu_specified) {
-        std::stringstream warnMsg;
-        warnMsg << "Material permittivity is not specified. Using default vacuum value of " <<
-            m_mu << " in the simulation.";
-        WarpX::GetInstance().RecordWarning("Macroscopic properties",
-            warnMsg.str());
-    }
+        // initialization of epsilon (permittivity) with parser
+        if (m_epsilon_s == "parse_epsilon_function") {
+            Store_parserString(pp_macroscopic, "epsilon_function(x,y,z)", m_str_epsilon_function);
+            m_epsilon_parser = std::make_unique<amrex::Parser>(
+                                     makeParser(m_str_epsilon_function,{"x","y","z"}));
+        }
 
-    // initialization of mu (permeability) with parser
-    if (m_mu_s == "parse_mu_function") {
-        Store_parserString(pp_macroscopic, "mu_function(x,y,z)", m_str_mu_function);
-        m_mu_parser = std::make_unique<amrex::Parser>(
-                                 makeParser(m_str_mu_function,{"x","y","z"}));
+        // Query input for material permeability, mu
+        bool mu_specified = false;
+        if (queryWithParser(pp_macroscopic, "mu", m_mu)) {
+            m_mu_s = "constant";
+            mu_specified = true;
+        }
+        if (pp_macroscopic.query("mu_function(x,y,z)", m_str_mu_function) ) {
+            m_mu_s = "parse_mu_function";
+            mu_specified = true;
+        }
+        if (!mu_specified) {
+            std::stringstream warnMsg;
+            warnMsg << "Material permittivity is not specified. Using default vacuum value of " <<
+                m_mu << " in the simulation.";
+            WarpX::GetInstance().RecordWarning("Macroscopic properties",
+                warnMsg.str());
+        }
+
+        // initialization of mu (permeability) with parser
+        if (m_mu_s == "parse_mu_function") {
+            Store_parserString(pp_macroscopic, "mu_function(x,y,z)", m_str_mu_function);
+            m_mu_parser = std::make_unique<amrex::Parser>(
+                                     makeParser(m_str_mu_function,{"x","y","z"}));
+        }
     }
 
+    // The materials are static, so the coefficients of the E-update can be computed
+    // once instead of at every step
+    pp_macroscopic.query("precompute_coefficients", m_precompute_coefficients);
+
 #ifdef WARPX_MAG_LLG
-    auto &warpx = WarpX::GetInstance();
-    pp_macroscopic.get("mag_Ms_init_style", m_mag_Ms_s);
-    if (m_mag_Ms_s == "constant") pp_macroscopic.get("mag_Ms", m_mag_Ms);
-    // _mag_ such that it's clear the Ms variable is only meaningful for magnetic materials
-    //initialization with parser
-    if (m_mag_Ms_s == "parse_mag_Ms_function") {
-        Store_parserString(pp_macroscopic, "mag_Ms_function(x,y,z)", m_str_mag_Ms_function);
-        m_mag_Ms_parser = std::make_unique<amrex::Parser>(
-                                  makeParser(m_str_mag_Ms_function,{"x","y","z"}));
-    }
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        auto &warpx = WarpX::GetInstance();
+        // with macroscopic.materials, the magnetic properties are read per material
+        if (!m_use_material_id) {
+            pp_macroscopic.get("mag_Ms_init_style", m_mag_Ms_s);
+            if (m_mag_Ms_s == "constant") pp_macroscopic.get("mag_Ms", m_mag_Ms);
+            // _mag_ such that it's clear the Ms variable is only meaningful for magnetic materials
+            //initialization with parser
+            if (m_mag_Ms_s == "parse_mag_Ms_function") {
+                Store_parserString(pp_macroscopic, "mag_Ms_function(x,y,z)", m_str_mag_Ms_function);
+                m_mag_Ms_parser = std::make_unique<amrex::Parser>(
+                                          makeParser(m_str_mag_Ms_function,{"x","y","z"}));
+            }
 
-    pp_macroscopic.get("mag_alpha_init_style", m_mag_alpha_s);
-    if (m_mag_alpha_s == "constant") pp_macroscopic.get("mag_alpha", m_mag_alpha);
-    // _mag_ such that it's clear the alpha variable is only meaningful for magnetic materials
-    //initialization with parser
-    if (m_mag_alpha_s == "parse_mag_alpha_function") {
-        Store_parserString(pp_macroscopic, "mag_alpha_function(x,y,z)", m_str_mag_alpha_function);
-        m_mag_alpha_parser = std::make_unique<amrex::Parser>(
-                                  makeParser(m_str_mag_alpha_function,{"x","y","z"}));
-    }
+            pp_macroscopic.get("mag_alpha_init_style", m_mag_alpha_s);
+            if (m_mag_alpha_s == "constant") pp_macroscopic.get("mag_alpha", m_mag_alpha);
+            // _mag_ such that it's clear the alpha variable is only meaningful for magnetic materials
+            //initialization with parser
+            if (m_mag_alpha_s == "parse_mag_alpha_function") {
+                Store_parserString(pp_macroscopic, "mag_alpha_function(x,y,z)", m_str_mag_alpha_function);
+                m_mag_alpha_parser = std::make_unique<amrex::Parser>(
+                                          makeParser(m_str_mag_alpha_function,{"x","y","z"}));
+            }
 
-    pp_macroscopic.get("mag_gamma_init_style", m_mag_gamma_s);
-    if (m_mag_gamma_s == "constant") pp_macroscopic.get("mag_gamma", m_mag_gamma);
-    // _mag_ such that it's clear the gamma variable parsed here is only meaningful for magnetic materials
-    //initialization with parser
-    if (m_mag_gamma_s == "parse_mag_gamma_function") {
-        Store_parserString(pp_macroscopic, "mag_gamma_function(x,y,z)", m_str_mag_gamma_function);
-        m_mag_gamma_parser = std::make_unique<amrex::Parser>(
-                                  makeParser(m_str_mag_gamma_function,{"x","y","z"}));
-    }
+            pp_macroscopic.get("mag_gamma_init_style", m_mag_gamma_s);
+            if (m_mag_gamma_s == "constant") pp_macroscopic.get("mag_gamma", m_mag_gamma);
+            // _mag_ such that it's clear the gamma variable parsed here is only meaningful for magnetic materials
+            //initialization with parser
+            if (m_mag_gamma_s == "parse_mag_gamma_function") {
+                Store_parserString(pp_macroscopic, "mag_gamma_function(x,y,z)", m_str_mag_gamma_function);
+                m_mag_gamma_parser = std::make_unique<amrex::Parser>(
+                                          makeParser(m_str_mag_gamma_function,{"x","y","z"}));
+            }
+
+            if (warpx.mag_LLG_exchange_coupling == 1) { // spin exchange coupling turned off by default
+                pp_macroscopic.get("mag_exchange_init_style", m_mag_exchange_s);
+                if (m_mag_exchange_s == "constant") pp_macroscopic.get("mag_exchange", m_mag_exchange);
+                // _mag_ such that it's clear the exch variable is only meaningful for magnetic materials
+                //initialization with parser
+                if (m_mag_exchange_s == "parse_mag_exchange_function") {
+                    Store_parserString(pp_macroscopic, "mag_exchange_function(x,y,z)", m_str_mag_exchange_function);
+                    m_mag_exchange_parser = std::make_unique<amrex::Parser>(
+                                              makeParser(m_str_mag_exchange_function,{"x","y","z"}));
+                }
+            }
 
-    if (warpx.mag_LLG_exchange_coupling == 1) { // spin exchange coupling turned off by default
-        pp_macroscopic.get("mag_exchange_init_style", m_mag_exchange_s);
-        if (m_mag_exchange_s == "constant") pp_macroscopic.get("mag_exchange", m_mag_exchange);
-        // _mag_ such that it's clear the exch variable is only meaningful for magnetic materials
-        //initialization with parser
-        if (m_mag_exchange_s == "parse_mag_exchange_function") {
-            Store_parserString(pp_macroscopic, "mag_exchange_function(x,y,z)", m_str_mag_exchange_function);
-            m_mag_exchange_parser = std::make_unique<amrex::Parser>(
-                                      makeParser(m_str_mag_exchange_function,{"x","y","z"}));
+            if (warpx.mag_LLG_anisotropy_coupling == 1) { // magnetic crystal is considered as isotropic by default
+                pp_macroscopic.get("mag_anisotropy_init_style", m_mag_anisotropy_s);
+                if (m_mag_anisotropy_s == "constant") pp_macroscopic.get("mag_anisotropy", m_mag_anisotropy);
+                // _mag_ such that it's clear the exch variable is only meaningful for magnetic materials
+                //initialization with parser
+                if (m_mag_anisotropy_s == "parse_mag_anisotropy_function") {
+                    Store_parserString(pp_macroscopic, "mag_anisotropy_function(x,y,z)", m_str_mag_anisotropy_function);
+                    m_mag_anisotropy_parser = std::make_unique<amrex::Parser>(
+                                              makeParser(m_str_mag_anisotropy_function,{"x","y","z"}));
+                }
+            }
         }
-    }
 
-    if (warpx.mag_LLG_anisotropy_coupling == 1) { // magnetic crystal is considered as isotropic by default
-        pp_macroscopic.get("mag_anisotropy_init_style", m_mag_anisotropy_s);
-        if (m_mag_anisotropy_s == "constant") pp_macroscopic.get("mag_anisotropy", m_mag_anisotropy);
-        // _mag_ such that it's clear the exch variable is only meaningful for magnetic materials
-        //initialization with parser
-        if (m_mag_anisotropy_s == "parse_mag_anisotropy_function") {
-            Store_parserString(pp_macroscopic, "mag_anisotropy_function(x,y,z)", m_str_mag_anisotropy_function);
-            m_mag_anisotropy_parser = std::make_unique<amrex::Parser>(
-                                      makeParser(m_str_mag_anisotropy_function,{"x","y","z"}));
+        m_mag_normalized_error = 0.1;
+        pp_macroscopic.query("mag_normalized_error",m_mag_normalized_error);
+
+        m_mag_max_iter = 100;
+        pp_macroscopic.query("mag_max_iter",m_mag_max_iter);
+
+        m_mag_tol = 0.0001;
+        pp_macroscopic.query("mag_tol",m_mag_tol);
+#ifdef WARPX_MAG_LLG_MIXED_PRECISION
+        // M_prev is stored in single precision, the error between two iterations does not go below its rounding
+        if (m_mag_tol < 10._rt * std::numeric_limits<float>::epsilon()) {
+            amrex::Abort("mag_tol must be at least 10 times the single-precision epsilon with WARPX_MAG_LLG_MIXED_PRECISION");
         }
-    }
+#endif
 
-    m_mag_normalized_error = 0.1;
-    pp_macroscopic.query("mag_normalized_error",m_mag_normalized_error);
+        m_mag_iter_check_interval = 1;
+        pp_macroscopic.query("mag_iter_check_interval",m_mag_iter_check_interval);
+        if (m_mag_iter_check_interval < 1) {
+            amrex::Abort("mag_iter_check_interval must be a positive integer");
+        }
 
-    m_mag_max_iter = 100;
-    pp_macroscopic.query("mag_max_iter",m_mag_max_iter);
+        m_mag_anderson_depth = 0;
+        pp_macroscopic.query("mag_anderson_depth",m_mag_anderson_depth);
+        if (m_mag_anderson_depth < 0) {
+            amrex::Abort("mag_anderson_depth must be a non-negative integer");
+        }
 
-    m_mag_tol = 0.0001;
-    pp_macroscopic.query("mag_tol",m_mag_tol);
+        m_mag_active_set = false;
+        pp_macroscopic.query("mag_active_set",m_mag_active_set);
+        if (m_mag_active_set && m_mag_anderson_depth > 0) {
+            // the Anderson extrapolation is global and would modify the frozen boxes
+            amrex::Abort("mag_active_set cannot be combined with mag_anderson_depth > 0");
+        }
 
-    if (warpx.mag_LLG_anisotropy_coupling == 1) {
-        amrex::Vector<amrex::Real> mag_LLG_anisotropy_axis_parser(3,0.0);
-        // The anisotropy_axis for the anisotropy coupling term H_anisotropy in H_eff
-        pp_macroscopic.getarr("mag_LLG_anisotropy_axis", mag_LLG_anisotropy_axis_parser);
-        for (int i = 0; i < 3; i++) {
-            mag_LLG_anisotropy_axis[i] = mag_LLG_anisotropy_axis_parser[i];
+        if (warpx.mag_LLG_anisotropy_coupling == 1) {
+            amrex::Vector<amrex::Real> mag_LLG_anisotropy_axis_parser(3,0.0);
+            // The anisotropy_axis for the anisotropy coupling term H_anisotropy in H_eff
+            pp_macroscopic.getarr("mag_LLG_anisotropy_axis", mag_LLG_anisotropy_axis_parser);
+            for (int i = 0; i < 3; i++) {
+                mag_LLG_anisotropy_axis[i] = mag_LLG_anisotropy_axis_parser[i];
+            }
         }
+
     }
+#endif
+}
+
+void
+MacroscopicProperties::ReadMaterialTable ()
+{
+    ParmParse pp_macroscopic("macroscopic");
+    const int n_materials = static_cast<int>(m_material_names.size());
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(n_materials > 0 && n_materials <= 256,
+        "macroscopic.materials must list between 1 and 256 materials");
+    for (auto const& name : {"sigma", "epsilon", "mu", "sigma_function(x,y,z)",
+                             "epsilon_function(x,y,z)", "mu_function(x,y,z)"}) {
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!pp_macroscopic.contains(name),
+            std::string("macroscopic.") + name + " cannot be used with macroscopic.materials;"
+            + " the properties must be set for each material, e.g. <material>.sigma");
+    }
+
+    // The material ID function returns, at (x,y,z), the index of the material in macroscopic.materials
+    std::string str_material_id_function;
+    Store_parserString(pp_macroscopic, "material_id_function(x,y,z)", str_material_id_function);
+    m_material_id_parser = std::make_unique<amrex::Parser>(
+                             makeParser(str_material_id_function,{"x","y","z"}));
+
+    // Properties of each material, vacuum by default
+    amrex::Vector<amrex::Real> sigma(n_materials, 0._rt);
+    amrex::Vector<amrex::Real> epsilon(n_materials, PhysConst::ep0);
+    amrex::Vector<amrex::Real> mu(n_materials, PhysConst::mu0);
+    for (int m = 0; m < n_materials; ++m) {
+        ParmParse pp_material(m_material_names[m]);
+        queryWithParser(pp_material, "sigma", sigma[m]);
+        queryWithParser(pp_material, "epsilon", epsilon[m]);
+        queryWithParser(pp_material, "mu", mu[m]);
+    }
+    m_sigma_table.resize(n_materials);
+    m_epsilon_table.resize(n_materials);
+    m_mu_table.resize(n_materials);
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, sigma.begin(), sigma.end(), m_sigma_table.begin());
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, epsilon.begin(), epsilon.end(), m_epsilon_table.begin());
+    amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, mu.begin(), mu.end(), m_mu_table.begin());
 
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        // Non-magnetic by default (Ms = 0)
+        amrex::Vector<amrex::Real> Ms(n_materials, 0._rt);
+        amrex::Vector<amrex::Real> alpha(n_materials, 0._rt);
+        amrex::Vector<amrex::Real> gamma(n_materials, 0._rt);
+        amrex::Vector<amrex::Real> exchange(n_materials, 0._rt);
+        amrex::Vector<amrex::Real> anisotropy(n_materials, 0._rt);
+        for (int m = 0; m < n_materials; ++m) {
+            ParmParse pp_material(m_material_names[m]);
+            queryWithParser(pp_material, "mag_Ms", Ms[m]);
+            if (Ms[m] != 0._rt) {
+                getWithParser(pp_material, "mag_alpha", alpha[m]);
+                getWithParser(pp_material, "mag_gamma", gamma[m]);
+            }
+            queryWithParser(pp_material, "mag_exchange", exchange[m]);
+            queryWithParser(pp_material, "mag_anisotropy", anisotropy[m]);
+            if (Ms[m] < 0._rt) {
+                amrex::Abort("Ms must be non-negative values");
+            }
+            if (alpha[m] < 0._rt) {
+                amrex::Abort("alpha should be positive, but the user input has negative values");
+            }
+            if (gamma[m] > 0._rt) {
+                amrex::Abort("gamma should be negative, but the user input has positive values");
+            }
+        }
+        m_mag_Ms_table.resize(n_materials);
+        m_mag_alpha_table.resize(n_materials);
+        m_mag_gamma_table.resize(n_materials);
+        m_mag_exchange_table.resize(n_materials);
+        m_mag_anisotropy_table.resize(n_materials);
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, Ms.begin(), Ms.end(), m_mag_Ms_table.begin());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, alpha.begin(), alpha.end(), m_mag_alpha_table.begin());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, gamma.begin(), gamma.end(), m_mag_gamma_table.begin());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, exchange.begin(), exchange.end(), m_mag_exchange_table.begin());
+        amrex::Gpu::copyAsync(amrex::Gpu::hostToDevice, anisotropy.begin(), anisotropy.end(), m_mag_anisotropy_table.begin());
+    }
 #endif
+    amrex::Gpu::streamSynchronize();
 }
 
 void
@@ -200,143 +330,167 @@ MacroscopicProperties::InitData ()
     amrex::BoxArray ba = warpx.boxArray(lev);
     amrex::DistributionMapping dmap = warpx.DistributionMap(lev);
     const amrex::IntVect ng_EB_alloc = warpx.getngEB();
-    // Define material property multifabs using ba and dmap from WarpX instance
-    // sigma is cell-centered MultiFab
-    m_sigma_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
-    // epsilon is cell-centered MultiFab
-    m_eps_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
-    // mu is cell-centered MultiFab
-    m_mu_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
-
-    // Initialize sigma
-    if (m_sigma_s == "constant") {
+    if (m_use_material_id) {
+        // only the material ID is stored on the grid; it is cell-centered like sigma, epsilon and mu
+        m_material_id = std::make_unique<MaterialIdFab>(ba, dmap, 1, ng_EB_alloc);
+        InitializeMaterialId(*m_material_id, lev);
+    } else {
+        // Define material property multifabs using ba and dmap from WarpX instance
+        // sigma is cell-centered MultiFab
+        m_sigma_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
+        // epsilon is cell-centered MultiFab
+        m_eps_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
+        // mu is cell-centered MultiFab
+        m_mu_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, ng_EB_alloc);
+
+        // Initialize sigma
+        if (m_sigma_s == "constant") {
+
+            m_sigma_mf->setVal(m_sigma);
+
+        } else if (m_sigma_s == "parse_sigma_function") {
+
+            InitializeMacroMultiFabUsingParser(m_sigma_mf.get(), m_sigma_parser->compile<3>(), lev);
+        }
+        // Initialize epsilon
+        if (m_epsilon_s == "constant") {
 
-        m_sigma_mf->setVal(m_sigma);
+            m_eps_mf->setVal(m_epsilon);
 
-    } else if (m_sigma_s == "parse_sigma_function") {
+        } else if (m_epsilon_s == "parse_epsilon_function") {
 
-        InitializeMacroMultiFabUsingParser(m_sigma_mf.get(), m_sigma_parser->compile<3>(), lev);
-    }
-    // Initialize epsilon
-    if (m_epsilon_s == "constant") {
+            InitializeMacroMultiFabUsingParser(m_eps_mf.get(), m_epsilon_parser->compile<3>(), lev);
 
-        m_eps_mf->setVal(m_epsilon);
+        }
 
-    } else if (m_epsilon_s == "parse_epsilon_function") {
+        // Initialize mu
+        if (m_mu_s == "constant") {
 
-        InitializeMacroMultiFabUsingParser(m_eps_mf.get(), m_epsilon_parser->compile<3>(), lev);
+            m_mu_mf->setVal(m_mu);
 
-    }
+        } else if (m_mu_s == "parse_mu_function") {
 
-    // Initialize mu
-    if (m_mu_s == "constant") {
+            InitializeMacroMultiFabUsingParser(m_mu_mf.get(), m_mu_parser->compile<3>(), lev);
 
-        m_mu_mf->setVal(m_mu);
+        }
+    }
 
-    } else if (m_mu_s == "parse_mu_function") {
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
 
-        InitializeMacroMultiFabUsingParser(m_mu_mf.get(), m_mu_parser->compile<3>(), lev);
+        if (m_use_material_id) {
+            // the magnetic properties are looked up from the material ID of each face
+            for (int i=0; i<3; ++i) {
+                m_mag_material_id[i] = std::make_unique<MaterialIdFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
+                InitializeMaterialId(*m_mag_material_id[i], lev);
+            }
+        } else {
+            // all magnetic macroparameters are stored on faces
+            for (int i=0; i<3; ++i) {
+                m_mag_Ms_mf[i]         = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
+                m_mag_alpha_mf[i]      = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
+                m_mag_gamma_mf[i]      = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
+                m_mag_exchange_mf[i]   = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
+                m_mag_anisotropy_mf[i] = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
+            }
 
-    }
-#ifdef WARPX_MAG_LLG
+            // mag_Ms - defined at cell centers
+            if (m_mag_Ms_s == "constant") {
+                m_mag_Ms_mf[0]->setVal(m_mag_Ms);
+                m_mag_Ms_mf[1]->setVal(m_mag_Ms);
+                m_mag_Ms_mf[2]->setVal(m_mag_Ms);
+            }
+            else if (m_mag_Ms_s == "parse_mag_Ms_function"){
+                InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[0].get(), m_mag_Ms_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[1].get(), m_mag_Ms_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[2].get(), m_mag_Ms_parser->compile<3>(), lev);
+            }
+            // if there are regions with Ms=0, the user must provide mur value there
+            for (int i=0; i<3; ++i) {
+                if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) < 0._rt){
+                    amrex::Abort("Ms must be non-negative values");
+                }
+            }
+            for (int i=0; i<3; ++i) {
+                if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) == 0._rt){
+                    if (m_mu_s != "constant" && m_mu_s != "parse_mu_function"){
+                        amrex::Abort("permeability must be specified since part of the simulation domain is non-magnetic !");
+                    }
+                }
+            }
 
-    // all magnetic macroparameters are stored on faces
-    for (int i=0; i<3; ++i) {
-        m_mag_Ms_mf[i]         = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
-        m_mag_alpha_mf[i]      = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
-        m_mag_gamma_mf[i]      = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
-        m_mag_exchange_mf[i]   = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
-        m_mag_anisotropy_mf[i] = std::make_unique<MultiFab>(amrex::convert(ba,IntVect::TheDimensionVector(i)), dmap, 1, ng_EB_alloc);
-    }
+            // mag_alpha - defined at faces
+            if (m_mag_alpha_s == "constant") {
+                m_mag_alpha_mf[0]->setVal(m_mag_alpha);
+                m_mag_alpha_mf[1]->setVal(m_mag_alpha);
+                m_mag_alpha_mf[2]->setVal(m_mag_alpha);
+            }
+            else if (m_mag_alpha_s == "parse_mag_alpha_function"){
+                InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[0].get(), m_mag_alpha_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[1].get(), m_mag_alpha_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[2].get(), m_mag_alpha_parser->compile<3>(), lev);
+            }
+            for (int i=0; i<3; ++i) {
+                if (m_mag_alpha_mf[i]->min(0,m_mag_alpha_mf[i]->nGrow()) < 0._rt) {
+                    amrex::Abort("alpha should be positive, but the user input has negative values");
+                }
+            }
 
-    // mag_Ms - defined at cell centers
-    if (m_mag_Ms_s == "constant") {
-        m_mag_Ms_mf[0]->setVal(m_mag_Ms);
-        m_mag_Ms_mf[1]->setVal(m_mag_Ms);
-        m_mag_Ms_mf[2]->setVal(m_mag_Ms);
-    }
-    else if (m_mag_Ms_s == "parse_mag_Ms_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[0].get(), m_mag_Ms_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[1].get(), m_mag_Ms_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_Ms_mf[2].get(), m_mag_Ms_parser->compile<3>(), lev);
-    }
-    // if there are regions with Ms=0, the user must provide mur value there
-    for (int i=0; i<3; ++i) {
-        if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) < 0._rt){
-            amrex::Abort("Ms must be non-negative values");
-        }
-    }
-    for (int i=0; i<3; ++i) {
-        if (m_mag_Ms_mf[i]->min(0,m_mag_Ms_mf[i]->nGrow()) == 0._rt){
-            if (m_mu_s != "constant" && m_mu_s != "parse_mu_function"){
-                amrex::Abort("permeability must be specified since part of the simulation domain is non-magnetic !");
+            // mag_gamma - defined at faces
+            if (m_mag_gamma_s == "constant") {
+                m_mag_gamma_mf[0]->setVal(m_mag_gamma);
+                m_mag_gamma_mf[1]->setVal(m_mag_gamma);
+                m_mag_gamma_mf[2]->setVal(m_mag_gamma);
+            }
+            else if (m_mag_gamma_s == "parse_mag_gamma_function"){
+                InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[0].get(), m_mag_gamma_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[1].get(), m_mag_gamma_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[2].get(), m_mag_gamma_parser->compile<3>(), lev);
+            }
+            for (int i=0; i<3; ++i) {
+                if (m_mag_gamma_mf[i]->min(0,m_mag_gamma_mf[i]->nGrow()) > 0._rt) {
+                    amrex::Abort("gamma should be negative, but the user input has positive values");
+                }
             }
-        }
-    }
 
-    // mag_alpha - defined at faces
-    if (m_mag_alpha_s == "constant") {
-        m_mag_alpha_mf[0]->setVal(m_mag_alpha);
-        m_mag_alpha_mf[1]->setVal(m_mag_alpha);
-        m_mag_alpha_mf[2]->setVal(m_mag_alpha);
-    }
-    else if (m_mag_alpha_s == "parse_mag_alpha_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[0].get(), m_mag_alpha_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[1].get(), m_mag_alpha_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_alpha_mf[2].get(), m_mag_alpha_parser->compile<3>(), lev);
-    }
-    for (int i=0; i<3; ++i) {
-        if (m_mag_alpha_mf[i]->min(0,m_mag_alpha_mf[i]->nGrow()) < 0._rt) {
-            amrex::Abort("alpha should be positive, but the user input has negative values");
-        }
-    }
+            // mag_exchange - defined at faces
+            if (m_mag_exchange_s == "constant") {
+                m_mag_exchange_mf[0]->setVal(m_mag_exchange);
+                m_mag_exchange_mf[1]->setVal(m_mag_exchange);
+                m_mag_exchange_mf[2]->setVal(m_mag_exchange);
+            }
+            else if (m_mag_exchange_s == "parse_mag_exchange_function"){
+                InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[0].get(), m_mag_exchange_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[1].get(), m_mag_exchange_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[2].get(), m_mag_exchange_parser->compile<3>(), lev);
+            }
 
-    // mag_gamma - defined at faces
-    if (m_mag_gamma_s == "constant") {
-        m_mag_gamma_mf[0]->setVal(m_mag_gamma);
-        m_mag_gamma_mf[1]->setVal(m_mag_gamma);
-        m_mag_gamma_mf[2]->setVal(m_mag_gamma);
-    }
-    else if (m_mag_gamma_s == "parse_mag_gamma_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[0].get(), m_mag_gamma_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[1].get(), m_mag_gamma_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_gamma_mf[2].get(), m_mag_gamma_parser->compile<3>(), lev);
-    }
-    for (int i=0; i<3; ++i) {
-        if (m_mag_gamma_mf[i]->min(0,m_mag_gamma_mf[i]->nGrow()) > 0._rt) {
-            amrex::Abort("gamma should be negative, but the user input has positive values");
+            // mag_anisotropy - defined at faces
+            if (m_mag_anisotropy_s == "constant") {
+                m_mag_anisotropy_mf[0]->setVal(m_mag_anisotropy);
+                m_mag_anisotropy_mf[1]->setVal(m_mag_anisotropy);
+                m_mag_anisotropy_mf[2]->setVal(m_mag_anisotropy);
+            }
+            else if (m_mag_anisotropy_s == "parse_mag_anisotropy_function"){
+                InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[0].get(), m_mag_anisotropy_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[1].get(), m_mag_anisotropy_parser->compile<3>(), lev);
+                InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[2].get(), m_mag_anisotropy_parser->compile<3>(), lev);
+            }
+#ifdef WARPX_MAG_LLG_MIXED_PRECISION
+            StoreMagneticPropertiesInSinglePrecision();
+#endif
         }
-    }
-
-    // mag_exchange - defined at faces
-    if (m_mag_exchange_s == "constant") {
-        m_mag_exchange_mf[0]->setVal(m_mag_exchange);
-        m_mag_exchange_mf[1]->setVal(m_mag_exchange);
-        m_mag_exchange_mf[2]->setVal(m_mag_exchange);
-    }
-    else if (m_mag_exchange_s == "parse_mag_exchange_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[0].get(), m_mag_exchange_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[1].get(), m_mag_exchange_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_exchange_mf[2].get(), m_mag_exchange_parser->compile<3>(), lev);
-    }
 
-    // mag_anisotropy - defined at faces
-    if (m_mag_anisotropy_s == "constant") {
-        m_mag_anisotropy_mf[0]->setVal(m_mag_anisotropy);
-        m_mag_anisotropy_mf[1]->setVal(m_mag_anisotropy);
-        m_mag_anisotropy_mf[2]->setVal(m_mag_anisotropy);
-    }
-    else if (m_mag_anisotropy_s == "parse_mag_anisotropy_function"){
-        InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[0].get(), m_mag_anisotropy_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[1].get(), m_mag_anisotropy_parser->compile<3>(), lev);
-        InitializeMacroMultiFabUsingParser(m_mag_anisotropy_mf[2].get(), m_mag_anisotropy_parser->compile<3>(), lev);
+        // list of the boxes on which the LLG kernels need to run
+        BuildMagneticBoxList();
     }
 #endif
 
 
-    amrex::IntVect sigma_stag = m_sigma_mf->ixType().toIntVect();
-    amrex::IntVect epsilon_stag = m_eps_mf->ixType().toIntVect();
-    amrex::IntVect mu_stag = m_mu_mf->ixType().toIntVect();
+    // sigma, epsilon and mu (or the material ID) are all cell-centered
+    amrex::IntVect sigma_stag = GetCellCenteredLayout().ixType().toIntVect();
+    amrex::IntVect epsilon_stag = sigma_stag;
+    amrex::IntVect mu_stag = sigma_stag;
     amrex::IntVect Ex_stag = warpx.getEfield_fp(0,0).ixType().toIntVect();
     amrex::IntVect Ey_stag = warpx.getEfield_fp(0,1).ixType().toIntVect();
     amrex::IntVect Ez_stag = warpx.getEfield_fp(0,2).ixType().toIntVect();
@@ -344,12 +498,21 @@ MacroscopicProperties::InitData ()
     IntVect By_stag = warpx.getBfield_fp(0,1).ixType().toIntVect();
     IntVect Bz_stag = warpx.getBfield_fp(0,2).ixType().toIntVect();
 #ifdef WARPX_MAG_LLG
-    IntVect Hx_stag = warpx.getHfield_fp(0,0).ixType().toIntVect();
-    IntVect Hy_stag = warpx.getHfield_fp(0,1).ixType().toIntVect();
-    IntVect Hz_stag = warpx.getHfield_fp(0,2).ixType().toIntVect();
-    IntVect Mx_stag = warpx.getMfield_fp(0,0).ixType().toIntVect();
-    IntVect My_stag = warpx.getMfield_fp(0,1).ixType().toIntVect();
-    IntVect Mz_stag = warpx.getMfield_fp(0,2).ixType().toIntVect();
+    // H and M are only allocated with the LLG model; they share the staggering of B
+    IntVect Hx_stag = Bx_stag;
+    IntVect Hy_stag = By_stag;
+    IntVect Hz_stag = Bz_stag;
+    IntVect Mx_stag = Bx_stag;
+    IntVect My_stag = By_stag;
+    IntVect Mz_stag = Bz_stag;
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        Hx_stag = warpx.getHfield_fp(0,0).ixType().toIntVect();
+        Hy_stag = warpx.getHfield_fp(0,1).ixType().toIntVect();
+        Hz_stag = warpx.getHfield_fp(0,2).ixType().toIntVect();
+        Mx_stag = warpx.getMfield_fp(0,0).ixType().toIntVect();
+        My_stag = warpx.getMfield_fp(0,1).ixType().toIntVect();
+        Mz_stag = warpx.getMfield_fp(0,2).ixType().toIntVect();
+    }
 #endif
 
 
@@ -395,6 +558,215 @@ MacroscopicProperties::InitData ()
 #endif
 }
 
+namespace {
+    /** Compute alpha and beta of the T_MacroAlgo E-update from sigma and epsilon,
+     *  interpolated to the location of the E-field component stored in alpha_mf */
+    template<typename T_MacroAlgo>
+    void ComputeECoefficients (amrex::MultiFab& alpha_mf, amrex::MultiFab& beta_mf,
+                               MacroscopicProperties const& macroscopic_properties,
+                               amrex::GpuArray<int, 3> const& E_stag,
+                               amrex::Real const dt)
+    {
+        amrex::GpuArray<int, 3> const& sigma_stag = macroscopic_properties.sigma_IndexType;
+        amrex::GpuArray<int, 3> const& epsilon_stag = macroscopic_properties.epsilon_IndexType;
+        amrex::GpuArray<int, 3> const& macro_cr = macroscopic_properties.macro_cr_ratio;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for ( amrex::MFIter mfi(alpha_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+            MaterialPropertyArray const sigma_arr = macroscopic_properties.getsigma_arr(mfi);
+            MaterialPropertyArray const eps_arr = macroscopic_properties.getepsilon_arr(mfi);
+            amrex::Array4<amrex::Real> const& alpha = alpha_mf.array(mfi);
+            amrex::Array4<amrex::Real> const& beta = beta_mf.array(mfi);
+            const amrex::Box& tb = mfi.growntilebox();
+            amrex::ParallelFor(tb,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    amrex::Real const sigma_interp = CoarsenIO::Interp( sigma_arr, sigma_stag,
+                                               E_stag, macro_cr, i, j, k, 0);
+                    amrex::Real const epsilon_interp = CoarsenIO::Interp( eps_arr, epsilon_stag,
+                                               E_stag, macro_cr, i, j, k, 0);
+                    alpha(i, j, k) = T_MacroAlgo::alpha( sigma_interp, epsilon_interp, dt);
+                    beta(i, j, k) = T_MacroAlgo::beta( sigma_interp, epsilon_interp, dt);
+                }
+            );
+        }
+    }
+}
+
+void
+MacroscopicProperties::UpdateECoefficients (amrex::Real dt)
+{
+    amrex::FabArrayBase const& layout = GetCellCenteredLayout();
+    const bool is_valid = m_alpha_mf[0] != nullptr && dt == m_coefficients_dt
+        && m_alpha_mf[0]->boxArray().CellEqual(layout.boxArray())
+        && m_alpha_mf[0]->DistributionMap() == layout.DistributionMap();
+    if (is_valid) return;
+
+    WARPX_PROFILE("MacroscopicProperties::UpdateECoefficients()");
+
+    auto & warpx = WarpX::GetInstance();
+    const amrex::BoxArray& ba = layout.boxArray();
+    const amrex::DistributionMapping& dmap = layout.DistributionMap();
+    std::array<amrex::GpuArray<int, 3>, 3> const E_stag = {Ex_IndexType, Ey_IndexType, Ez_IndexType};
+
+    // the guard cells advanced by the E-update in the deep-halo mode (warpx.deep_halo_steps)
+    const amrex::IntVect ng_update = warpx.getngDeepHaloUpdate();
+    for (int idim = 0; idim < 3; ++idim) {
+        const amrex::BoxArray eba = amrex::convert(ba, warpx.getEfield_fp(0,idim).ixType());
+        m_alpha_mf[idim] = std::make_unique<amrex::MultiFab>(eba, dmap, 1, ng_update);
+        m_beta_mf[idim] = std::make_unique<amrex::MultiFab>(eba, dmap, 1, ng_update);
+        if (WarpX::macroscopic_solver_algo == MacroscopicSolverAlgo::LaxWendroff) {
+            ComputeECoefficients<LaxWendroffAlgo>(*m_alpha_mf[idim], *m_beta_mf[idim],
+                                                  *this, E_stag[idim], dt);
+        } else {
+            ComputeECoefficients<BackwardEulerAlgo>(*m_alpha_mf[idim], *m_beta_mf[idim],
+                                                    *this, E_stag[idim], dt);
+        }
+    }
+
+    // 1/mu, including the guard cells read by the curl stencil
+    m_inv_mu_mf = std::make_unique<amrex::MultiFab>(ba, dmap, 1, layout.nGrowVect());
+    for ( amrex::MFIter mfi(*m_inv_mu_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+        MaterialPropertyArray const mu_arr = getmu_arr(mfi);
+        amrex::Array4<amrex::Real> const& inv_mu = m_inv_mu_mf->array(mfi);
+        amrex::ParallelFor(mfi.growntilebox(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                inv_mu(i, j, k) = 1._rt / mu_arr(i, j, k);
+            }
+        );
+    }
+
+    m_coefficients_dt = dt;
+}
+
+void
+MacroscopicProperties::RemakeLevel (amrex::DistributionMapping const& dm)
+{
+    WARPX_PROFILE("MacroscopicProperties::RemakeLevel()");
+
+    using WarpXCommUtil::RemakeMultiFab;
+    if (m_use_material_id) {
+        // the material ID is the only state; the dense properties are rebuilt from it when needed
+        RemakeMultiFab(m_material_id, dm, true);
+        m_sigma_mf.reset();
+        m_eps_mf.reset();
+        m_mu_mf.reset();
+    } else {
+        RemakeMultiFab(m_sigma_mf, dm, true);
+        RemakeMultiFab(m_eps_mf, dm, true);
+        RemakeMultiFab(m_mu_mf, dm, true);
+    }
+
+    // the coefficients of the E-update are computed again on the new layout by UpdateECoefficients
+    for (int idim = 0; idim < 3; ++idim) {
+        m_alpha_mf[idim].reset();
+        m_beta_mf[idim].reset();
+    }
+    m_inv_mu_mf.reset();
+
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        for (int idim = 0; idim < 3; ++idim) {
+            if (m_use_material_id) {
+                RemakeMultiFab(m_mag_material_id[idim], dm, true);
+                m_mag_Ms_mf[idim].reset();
+                m_mag_alpha_mf[idim].reset();
+                m_mag_gamma_mf[idim].reset();
+                m_mag_exchange_mf[idim].reset();
+                m_mag_anisotropy_mf[idim].reset();
+            } else {
+#ifdef WARPX_MAG_LLG_MIXED_PRECISION
+                // the single-precision copies are the state; the dense properties are rebuilt from them when needed
+                RemakeMultiFab(m_mag_Ms_sp[idim], dm, true);
+                RemakeMultiFab(m_mag_alpha_sp[idim], dm, true);
+                RemakeMultiFab(m_mag_gamma_sp[idim], dm, true);
+                RemakeMultiFab(m_mag_exchange_sp[idim], dm, true);
+                RemakeMultiFab(m_mag_anisotropy_sp[idim], dm, true);
+                m_mag_Ms_mf[idim].reset();
+                m_mag_alpha_mf[idim].reset();
+                m_mag_gamma_mf[idim].reset();
+                m_mag_exchange_mf[idim].reset();
+                m_mag_anisotropy_mf[idim].reset();
+#else
+                RemakeMultiFab(m_mag_Ms_mf[idim], dm, true);
+                RemakeMultiFab(m_mag_alpha_mf[idim], dm, true);
+                RemakeMultiFab(m_mag_gamma_mf[idim], dm, true);
+                RemakeMultiFab(m_mag_exchange_mf[idim], dm, true);
+                RemakeMultiFab(m_mag_anisotropy_mf[idim], dm, true);
+#endif
+            }
+        }
+
+        BuildMagneticBoxList();
+    }
+#endif
+}
+
+#ifdef WARPX_MAG_LLG
+amrex::Long
+MacroscopicProperties::NumMagneticFaces (amrex::MFIter const& mfi) const
+{
+    amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+    amrex::ReduceData<amrex::Long> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    for (int idim = 0; idim < 3; ++idim) {
+        const amrex::Box& bx = OwnedFaceBox(mfi, idim);
+        MaterialPropertyArray const Ms = getmag_Ms_arr(idim, mfi);
+        reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return {(Ms(i, j, k) > 0._rt) ? 1 : 0};
+            });
+    }
+    return amrex::get<0>(reduce_data.value());
+}
+
+amrex::Box
+MacroscopicProperties::OwnedFaceBox (amrex::MFIter const& mfi, int dir)
+{
+    // a face shared by two boxes is owned by the lower one, except on the upper boundary
+    // of a non-periodic domain, which has no box above it
+    amrex::Geometry const& geom = WarpX::GetInstance().Geom(0);
+    amrex::Box const vbx = amrex::enclosedCells(mfi.validbox());
+    amrex::Box own = amrex::convert(vbx, IntVect::TheDimensionVector(dir));
+    if (geom.isPeriodic(dir) || vbx.bigEnd(dir) < geom.Domain().bigEnd(dir)) own.growHi(dir, -1);
+    return own;
+}
+
+void
+MacroscopicProperties::BuildMagneticBoxList ()
+{
+    auto & warpx = WarpX::GetInstance();
+    m_mag_active_box = std::make_unique<amrex::LayoutData<int>>(GetCellCenteredLayout().boxArray(),
+                                                                GetCellCenteredLayout().DistributionMap());
+    int n_active_boxes = 0;
+    for ( amrex::MFIter mfi(*m_mag_active_box); mfi.isValid(); ++mfi ) {
+        amrex::ReduceOps<amrex::ReduceOpMax> reduce_op;
+        amrex::ReduceData<amrex::Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        for (int idim = 0; idim < 3; ++idim) {
+            // valid faces of this box, and the guard faces advanced in the deep-halo mode,
+            // in the index type of the idim-face
+            const amrex::Box& bx = amrex::convert(amrex::grow(mfi.validbox(), warpx.getngDeepHaloUpdate()),
+                                                  IntVect::TheDimensionVector(idim));
+            MaterialPropertyArray const Ms = getmag_Ms_arr(idim, mfi);
+            reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    return {Ms(i, j, k)};
+                });
+        }
+        const int active = (amrex::get<0>(reduce_data.value()) > 0._rt) ? 1 : 0;
+        (*m_mag_active_box)[mfi] = active;
+        n_active_boxes += active;
+    }
+    amrex::ParallelDescriptor::ReduceIntSum(n_active_boxes);
+    amrex::Print() << Utils::TextMsg::Info(
+        "LLG: " + std::to_string(n_active_boxes) + " out of "
+        + std::to_string(GetCellCenteredLayout().boxArray().size()) + " boxes contain magnetic material");
+}
+#endif
+
 void
 MacroscopicProperties::InitializeMacroMultiFabUsingParser (
                        amrex::MultiFab *macro_mf,
@@ -431,3 +803,111 @@ MacroscopicProperties::InitializeMacroMultiFabUsingParser (
 
     }
 }
+
+void
+MacroscopicProperties::InitializeMaterialId (MaterialIdFab& material_id, const int lev)
+{
+    WarpX& warpx = WarpX::GetInstance();
+    const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx_lev = warpx.Geom(lev).CellSizeArray();
+    const amrex::RealBox& real_box = warpx.Geom(lev).ProbDomain();
+    amrex::IntVect iv = material_id.ixType().toIntVect();
+    auto const id_parser = m_material_id_parser->compile<3>();
+    const int n_materials = static_cast<int>(m_material_names.size());
+    for ( amrex::MFIter mfi(material_id, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+        // Initialize ghost cells in addition to valid cells
+        const amrex::Box& tb = mfi.tilebox( iv, material_id.nGrowVect());
+        amrex::Array4<std::uint8_t> const& id_fab = material_id.array(mfi);
+        amrex::ParallelFor (tb,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                // Shift x, y, z position based on index type
+                amrex::Real fac_x = (1._rt - iv[0]) * dx_lev[0] * 0.5_rt;
+                amrex::Real x = i * dx_lev[0] + real_box.lo(0) + fac_x;
+#if defined(WARPX_DIM_XZ) || defined(WARPX_DIM_RZ)
+                amrex::Real y = 0._rt;
+                amrex::Real fac_z = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
+                amrex::Real z = j * dx_lev[1] + real_box.lo(1) + fac_z;
+#else
+                amrex::Real fac_y = (1._rt - iv[1]) * dx_lev[1] * 0.5_rt;
+                amrex::Real y = j * dx_lev[1] + real_box.lo(1) + fac_y;
+                amrex::Real fac_z = (1._rt - iv[2]) * dx_lev[2] * 0.5_rt;
+                amrex::Real z = k * dx_lev[2] + real_box.lo(2) + fac_z;
+#endif
+                const int id = static_cast<int>(id_parser(x,y,z));
+                if (id < 0 || id >= n_materials) {
+                    amrex::Abort("macroscopic.material_id_function must return an index in macroscopic.materials");
+                }
+                id_fab(i,j,k) = static_cast<std::uint8_t>(id);
+        });
+    }
+}
+
+void
+MacroscopicProperties::InitializeMacroMultiFabUsingMaterialId (
+                       amrex::MultiFab *macro_mf,
+                       amrex::Gpu::DeviceVector<amrex::Real> const& table,
+                       const int lev)
+{
+    MaterialIdFab material_id(macro_mf->boxArray(), macro_mf->DistributionMap(), 1, macro_mf->nGrowVect());
+    InitializeMaterialId(material_id, lev);
+    amrex::Real const* const table_ptr = table.data();
+    for ( amrex::MFIter mfi(*macro_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
+        const amrex::Box& tb = mfi.growntilebox();
+        amrex::Array4<amrex::Real> const& macro_fab = macro_mf->array(mfi);
+        amrex::Array4<std::uint8_t const> const& id_fab = material_id.const_array(mfi);
+        amrex::ParallelFor (tb,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                macro_fab(i,j,k) = table_ptr[id_fab(i,j,k)];
+        });
+    }
+}
+
+amrex::MultiFab*
+MacroscopicProperties::GetDenseProperty (std::unique_ptr<amrex::MultiFab>& mf,
+                                         amrex::Gpu::DeviceVector<amrex::Real> const& table,
+                                         amrex::IntVect const& ixtype)
+{
+    if (m_use_material_id && mf == nullptr) {
+        auto & warpx = WarpX::GetInstance();
+        mf = std::make_unique<amrex::MultiFab>(amrex::convert(warpx.boxArray(0), ixtype),
+                                               warpx.DistributionMap(0), 1, warpx.getngEB());
+        InitializeMacroMultiFabUsingMaterialId(mf.get(), table, 0);
+    }
+    return mf.get();
+}
+
+#ifdef WARPX_MAG_LLG_MIXED_PRECISION
+void
+MacroscopicProperties::StoreMagneticPropertiesInSinglePrecision ()
+{
+    auto store = [] (std::array<std::unique_ptr<amrex::MultiFab>, 3>& mf,
+                     std::array<std::unique_ptr<LLGStorageFab>, 3>& mf_sp)
+    {
+        for (int i = 0; i < 3; ++i) {
+            mf_sp[i] = std::make_unique<LLGStorageFab>(mf[i]->boxArray(), mf[i]->DistributionMap(),
+                                                       mf[i]->nComp(), mf[i]->nGrowVect());
+            WarpXCommUtil::mixedCopy(*mf_sp[i], *mf[i], 0, 0, mf[i]->nComp(), mf[i]->nGrowVect());
+            mf[i].reset();
+        }
+    };
+    store(m_mag_Ms_mf, m_mag_Ms_sp);
+    store(m_mag_alpha_mf, m_mag_alpha_sp);
+    store(m_mag_gamma_mf, m_mag_gamma_sp);
+    store(m_mag_exchange_mf, m_mag_exchange_sp);
+    store(m_mag_anisotropy_mf, m_mag_anisotropy_sp);
+}
+
+amrex::MultiFab*
+MacroscopicProperties::GetDenseProperty (std::unique_ptr<amrex::MultiFab>& mf,
+                                         std::unique_ptr<LLGStorageFab> const& mf_sp,
+                                         amrex::Gpu::DeviceVector<amrex::Real> const& table,
+                                         amrex::IntVect const& ixtype)
+{
+    if (m_use_material_id) return GetDenseProperty(mf, table, ixtype);
+    if (mf == nullptr) {
+        mf = std::make_unique<amrex::MultiFab>(mf_sp->boxArray(), mf_sp->DistributionMap(),
+                                               mf_sp->nComp(), mf_sp->nGrowVect());
+        WarpXCommUtil::mixedCopy(*mf, *mf_sp, 0, 0, mf_sp->nComp(), mf_sp->nGrowVect());
+    }
+    return mf.get();
+}
+#endif
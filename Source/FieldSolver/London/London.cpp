@@ -1,21 +1,30 @@
 #include "London.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "Parallelization/WarpXCommUtil.H"
 #include "Utils/WarpXUtil.H"
 #include "Utils/CoarsenIO.H"
+#include "Utils/TextMsg.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "WarpX.H"
 #include <AMReX_ParmParse.H>
 #include <AMReX_Print.H>
 #include <AMReX_RealVect.H>
 #include <AMReX_REAL.H>
+#include <AMReX_GpuAtomic.H>
 #include <AMReX_GpuQualifiers.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_iMultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Reduce.H>
 #include <AMReX_Scan.H>
+#include <AMReX_Utility.H>
 
 #include <AMReX_BaseFwd.H>
 
 #include <memory>
 #include <sstream>
+#include <string>
 
 London::London ()
 {
@@ -29,6 +38,13 @@ London::ReadParameters ()
     amrex::ParmParse pp_london("london");
     pp_london.get("penetration_depth", m_penetration_depth);
 
+    // the superconductor flags, the edge lists and the London current are only defined on level 0
+    int max_level = 0;
+    amrex::ParmParse pp_amr("amr");
+    pp_amr.query("max_level", max_level);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(max_level == 0,
+        "algo.yee_coupled_solver = MaxwellLondon is not implemented with mesh refinement (amr.max_level > 0)");
+
     Store_parserString(pp_london, "superconductor_function(x,y,z)", m_str_superconductor_function);
     m_superconductor_parser = std::make_unique<amrex::Parser>(
                                    makeParser(m_str_superconductor_function, {"x", "y", "z"}));
@@ -61,75 +77,234 @@ London::InitData()
         jz_IndexType[idim]      = jz_stag[idim];
     }
 
+    BuildSuperconductorEdgeList();
+
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG) AssertNoMagneticSuperconductor();
+#endif
 }
 
+#ifdef WARPX_MAG_LLG
 void
-London::EvolveLondonJ (amrex::Real dt)
+London::AssertNoMagneticSuperconductor () const
 {
-    amrex::Print() << " evolve london J using E\n";
+    using namespace amrex::literals;
+
     auto & warpx = WarpX::GetInstance();
-    const int lev = 0;
+    MacroscopicProperties &macroscopic = warpx.GetMacroscopicProperties();
+
+    // a face is inside the superconductor if its four nodes are superconducting
+    amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+    amrex::ReduceData<amrex::Long> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    for (amrex::MFIter mfi(*m_superconductor_mf); mfi.isValid(); ++mfi) {
+        if (!macroscopic.is_magnetic_box(mfi)) continue;
+        amrex::Array4<amrex::Real const> const& sc_arr = m_superconductor_mf->const_array(mfi);
+        for (int idim = 0; idim < 3; ++idim) {
+            MaterialPropertyArray const Ms = macroscopic.getmag_Ms_arr(idim, mfi);
+            // the two directions of the face
+            int const ax = (idim == 0) ? 0 : 1;
+            int const ay = (idim == 1) ? 0 : 1;
+            int const az = (idim == 2) ? 0 : 1;
+            amrex::Box const bx = amrex::convert(amrex::enclosedCells(mfi.validbox()),
+                                                amrex::IntVect::TheDimensionVector(idim));
+            reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple {
+                    bool const in_sc = sc_arr(i,j,k) == 1 && sc_arr(i+ax,j+ay,k) == 1
+                                    && sc_arr(i+ax,j,k+az) == 1 && sc_arr(i,j+ay,k+az) == 1;
+                    return {(in_sc && Ms(i,j,k) > 0._rt) ? 1 : 0};
+                });
+        }
+    }
+    amrex::Long n_overlap = amrex::get<0>(reduce_data.value());
+    amrex::ParallelDescriptor::ReduceLongSum(n_overlap);
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(n_overlap == 0,
+        "london.superconductor_function and macroscopic.mag_Ms_function overlap on "
+        + std::to_string(n_overlap) + " faces: the superconductor must be non-magnetic (Ms = 0)");
+}
+#endif
+
+void
+London::BuildSuperconductorEdgeList ()
+{
+    WARPX_PROFILE("London::BuildSuperconductorEdgeList()");
 
-    amrex::MultiFab * jx = warpx.get_pointer_current_fp(lev, 0);
-    amrex::MultiFab * jy = warpx.get_pointer_current_fp(lev, 1);
-    amrex::MultiFab * jz = warpx.get_pointer_current_fp(lev, 2);
+    using namespace amrex::literals;
 
-    amrex::MultiFab * Ex = warpx.get_pointer_Efield_fp(lev, 0);
-    amrex::MultiFab * Ey = warpx.get_pointer_Efield_fp(lev, 1);
-    amrex::MultiFab * Ez = warpx.get_pointer_Efield_fp(lev, 2);
+    auto & warpx = WarpX::GetInstance();
+    const int lev = 0;
 
     MacroscopicProperties &macroscopic = warpx.GetMacroscopicProperties();
-    amrex::MultiFab& mu_mf = macroscopic.getmu_mf();
     amrex::GpuArray<int, 3> const& mu_stag = macroscopic.mu_IndexType;
-    amrex::GpuArray<int, 3> const& jx_stag = jx_IndexType;
-    amrex::GpuArray<int, 3> const& jy_stag = jy_IndexType;
-    amrex::GpuArray<int, 3> const& jz_stag = jz_IndexType;
-    amrex::GpuArray<int, 3> const& macro_cr     = macroscopic.macro_cr_ratio;
-
-    // evolve J  = 1/( (lambda*lambda) * mu) * E * dt
-
-    amrex::Real lambda_sq_inv = 1.0/(m_penetration_depth*m_penetration_depth);
-    const int scomp = 0;
-    for (amrex::MFIter mfi(*jx, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-        //Extract field data
-        amrex::Array4<amrex::Real> const& jx_arr = jx->array(mfi);
-        amrex::Array4<amrex::Real> const& jy_arr = jy->array(mfi);
-        amrex::Array4<amrex::Real> const& jz_arr = jz->array(mfi);
-        amrex::Array4<amrex::Real> const& Ex_arr = Ex->array(mfi);
-        amrex::Array4<amrex::Real> const& Ey_arr = Ey->array(mfi);
-        amrex::Array4<amrex::Real> const& Ez_arr = Ez->array(mfi);
-        amrex::Array4<amrex::Real> const& mu_arr = mu_mf.array(mfi);
-        amrex::Array4<amrex::Real> const& sc_arr = m_superconductor_mf->array(mfi);
-        amrex::Box const& tjx = mfi.tilebox(jx->ixType().toIntVect());
-        amrex::Box const& tjy = mfi.tilebox(jy->ixType().toIntVect());
-        amrex::Box const& tjz = mfi.tilebox(jz->ixType().toIntVect());
-
-
-    amrex::ParallelFor(tjx, tjy, tjz,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            if (sc_arr(i,j,k)==1 and sc_arr(i+1,j,k)==1) {
-                amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, jx_stag,
-                                                                macro_cr, i, j, k, scomp);
-                jx_arr(i,j,k) += dt * lambda_sq_inv/mu_interp * Ex_arr(i,j,k);
-            }
-        },
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            if (sc_arr(i,j,k)==1 and sc_arr(i,j+1,k)==1) {
-                amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, jy_stag,
-                                                                macro_cr, i, j, k, scomp);
-                jy_arr(i,j,k) += dt * lambda_sq_inv/mu_interp * Ey_arr(i,j,k);
-            }
-        },
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            if (sc_arr(i,j,k)==1 and sc_arr(i,j,k+1)==1) {
-                amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, jz_stag,
-                                                                macro_cr, i, j, k, scomp);
-                jz_arr(i,j,k) += dt * lambda_sq_inv/mu_interp * Ez_arr(i,j,k);
+    amrex::GpuArray<int, 3> const& macro_cr = macroscopic.macro_cr_ratio;
+    amrex::Real const lambda_sq_inv = 1._rt/(m_penetration_depth*m_penetration_depth);
+
+    amrex::MultiFab const& jx = *warpx.get_pointer_current_fp(lev, 0);
+    m_has_superconductor.define(jx.boxArray(), jx.DistributionMap());
+    for (int idim = 0; idim < 3; ++idim) {
+        m_sc_edge_offset[idim].define(jx.boxArray(), jx.DistributionMap());
+        m_sc_edge_coef[idim].define(jx.boxArray(), jx.DistributionMap());
+    }
+
+    amrex::Long n_sc_edges = 0;
+    amrex::Long n_sc_boxes = 0;
+    for (amrex::MFIter mfi(jx); mfi.isValid(); ++mfi) {
+        amrex::Array4<amrex::Real const> const& sc_arr = m_superconductor_mf->const_array(mfi);
+        MaterialPropertyArray const mu_arr = macroscopic.getmu_arr(mfi);
+
+        // The curl of J in EvolveBLondon reaches one cell beyond the valid box
+        amrex::Box const sc_box = amrex::grow(mfi.validbox(), 1) & (*m_superconductor_mf)[mfi].box();
+        amrex::ReduceOps<amrex::ReduceOpMax> reduce_op;
+        amrex::ReduceData<int> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(sc_box, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple {
+                return {sc_arr(i,j,k) == 1 ? 1 : 0};
+            });
+        m_has_superconductor[mfi] = amrex::get<0>(reduce_data.value());
+        n_sc_boxes += m_has_superconductor[mfi];
+
+        for (int idim = 0; idim < 3; ++idim) {
+            amrex::Gpu::DeviceVector<int>& offsets = m_sc_edge_offset[idim][mfi];
+            amrex::Gpu::DeviceVector<amrex::Real>& coefs = m_sc_edge_coef[idim][mfi];
+            if (!m_has_superconductor[mfi]) {
+                offsets.clear();
+                coefs.clear();
+                continue;
             }
+
+            amrex::IntVect const j_stag_iv = warpx.get_pointer_current_fp(lev, idim)->ixType().toIntVect();
+            amrex::GpuArray<int, 3> const j_stag = (idim == 0) ? jx_IndexType
+                                                 : (idim == 1) ? jy_IndexType : jz_IndexType;
+            amrex::Box const tb = mfi.tilebox(j_stag_iv);
+            // the edge in direction idim joins the nodes (i,j,k) and (i,j,k) + shift
+            int const sx = (idim == 0) ? 1 : 0;
+            int const sy = (idim == 1) ? 1 : 0;
+            int const sz = (idim == 2) ? 1 : 0;
+
+            // the lists are first sized for the whole box, then shrunk to the superconducting edges
+            int const n_cells = static_cast<int>(tb.numPts());
+            offsets.resize(n_cells);
+            coefs.resize(n_cells);
+            int* const AMREX_RESTRICT offset_ptr = offsets.data();
+            amrex::Real* const AMREX_RESTRICT coef_ptr = coefs.data();
+            int const n_sc = amrex::Scan::PrefixSum<int>(n_cells,
+                [=] AMREX_GPU_DEVICE (int n) -> int {
+                    amrex::Dim3 const c = tb.atOffset(n).dim3();
+                    return (sc_arr(c.x,c.y,c.z) == 1 && sc_arr(c.x+sx,c.y+sy,c.z+sz) == 1) ? 1 : 0;
+                },
+                [=] AMREX_GPU_DEVICE (int n, int const& s) {
+                    amrex::Dim3 const c = tb.atOffset(n).dim3();
+                    if (sc_arr(c.x,c.y,c.z) == 1 && sc_arr(c.x+sx,c.y+sy,c.z+sz) == 1) {
+                        amrex::Real const mu_interp = CoarsenIO::Interp(mu_arr, mu_stag, j_stag,
+                                                                        macro_cr, c.x, c.y, c.z, 0);
+                        offset_ptr[s] = n;
+                        coef_ptr[s] = lambda_sq_inv/mu_interp;
+                    }
+                },
+                amrex::Scan::Type::exclusive, amrex::Scan::retSum);
+            offsets.resize(n_sc);
+            offsets.shrink_to_fit();
+            coefs.resize(n_sc);
+            coefs.shrink_to_fit();
+            n_sc_edges += n_sc;
         }
-    );
     }
 
+    amrex::ParallelDescriptor::ReduceLongSum(n_sc_edges);
+    amrex::ParallelDescriptor::ReduceLongSum(n_sc_boxes);
+    amrex::Print() << Utils::TextMsg::Info(
+        "London: " + std::to_string(n_sc_edges) + " superconducting edges in "
+        + std::to_string(n_sc_boxes) + " of " + std::to_string(jx.boxArray().size()) + " boxes");
+}
+
+void
+London::EvolveLondonJ (amrex::Real dt)
+{
+    WARPX_PROFILE("London::EvolveLondonJ()");
+
+    auto & warpx = WarpX::GetInstance();
+    const int lev = 0;
+    AssertLayoutMatches(*warpx.get_pointer_current_fp(lev, 0));
+    amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (amrex::MFIter mfi(m_has_superconductor); mfi.isValid(); ++mfi) {
+        if (!HasSuperconductor(mfi)) continue;
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+        }
+        amrex::Real wt = amrex::second();
+
+        EvolveLondonJ(mfi, dt);
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            amrex::Gpu::synchronize();
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        }
+    }
+}
+
+void
+London::AssertLayoutMatches (amrex::FabArrayBase const& mf) const
+{
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_has_superconductor.boxArray() == mf.boxArray() &&
+        m_has_superconductor.DistributionMap() == mf.DistributionMap(),
+        "The superconducting edges of the London solver were built for another layout: "
+        "the London solver supports load balancing, but not regridding");
+}
+
+void
+London::RemakeLevel (amrex::DistributionMapping const& dm)
+{
+    WARPX_PROFILE("London::RemakeLevel()");
+
+    WarpXCommUtil::RemakeMultiFab(m_superconductor_mf, dm, true);
+    BuildSuperconductorEdgeList();
+}
+
+amrex::Long
+London::NumSuperconductingEdges (int box_index) const
+{
+    if (m_has_superconductor.localindex(box_index) < 0) return 0;
+    amrex::Long n_sc_edges = 0;
+    for (int idim = 0; idim < 3; ++idim) {
+        n_sc_edges += static_cast<amrex::Long>(m_sc_edge_offset[idim][box_index].size());
+    }
+    return n_sc_edges;
+}
+
+void
+London::EvolveLondonJ (amrex::MFIter const& mfi, amrex::Real dt)
+{
+    auto & warpx = WarpX::GetInstance();
+    const int lev = 0;
+
+    // evolve J  = 1/( (lambda*lambda) * mu) * E * dt, on the superconducting edges only
+    for (int idim = 0; idim < 3; ++idim) {
+        int const n_sc = static_cast<int>(m_sc_edge_offset[idim][mfi].size());
+        if (n_sc == 0) continue;
+
+        amrex::MultiFab * j = warpx.get_pointer_current_fp(lev, idim);
+        amrex::MultiFab * E = warpx.get_pointer_Efield_fp(lev, idim);
+        amrex::Array4<amrex::Real> const& j_arr = j->array(mfi);
+        amrex::Array4<amrex::Real const> const& E_arr = E->const_array(mfi);
+        amrex::Box const tb = mfi.tilebox(j->ixType().toIntVect());
+        int const* const AMREX_RESTRICT offset_ptr = m_sc_edge_offset[idim][mfi].data();
+        amrex::Real const* const AMREX_RESTRICT coef_ptr = m_sc_edge_coef[idim][mfi].data();
+
+        amrex::ParallelFor(n_sc,
+            [=] AMREX_GPU_DEVICE (int n) {
+                amrex::Dim3 const c = tb.atOffset(offset_ptr[n]).dim3();
+                j_arr(c.x,c.y,c.z) += dt * coef_ptr[n] * E_arr(c.x,c.y,c.z);
+            });
+    }
 }
 
 void
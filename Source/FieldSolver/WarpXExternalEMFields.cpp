@@ -1,11 +1,17 @@
 #include "WarpX.H"
 #include "BoundaryConditions/PML.H"
 #include "Evolve/WarpXDtType.H"
+#include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
+#include "Utils/WarpXProfilerWrapper.H"
 #include "Utils/WarpXUtil.H"
+#include <AMReX_iMultiFab.H>
+#include <AMReX_LayoutData.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_Parser.H>
 
+#include <algorithm>
+
 using namespace amrex;
 
 /**
@@ -22,15 +28,16 @@ WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype, DtType a
     for (int lev = 0; lev <= finest_level; ++lev) {
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::EfieldExternal) {
             if (E_excitation_grid_s == "parse_e_excitation_grid_function") {
-                ApplyExternalFieldExcitationOnGrid(Efield_fp[lev][0].get(),
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternal,
+                                                   Efield_fp[lev][0].get(),
                                                    Efield_fp[lev][1].get(),
                                                    Efield_fp[lev][2].get(),
                                                    Exfield_xt_grid_parser->compile<4>(),
                                                    Eyfield_xt_grid_parser->compile<4>(),
                                                    Ezfield_xt_grid_parser->compile<4>(),
-                                                   Exfield_flag_parser->compile<3>(),
-                                                   Eyfield_flag_parser->compile<3>(),
-                                                   Ezfield_flag_parser->compile<3>(),
+                                                   *Exfield_flag_parser,
+                                                   *Eyfield_flag_parser,
+                                                   *Ezfield_flag_parser,
                                                    lev, a_dt_type );
             }
         }
@@ -39,58 +46,62 @@ WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype, DtType a
         // As clarified in the documentation, it is important that the parser is valid in the pml region
         if (WarpX::isAnyBoundaryPML() and externalfieldtype == ExternalFieldType::EfieldExternalPML) {
             if (E_excitation_grid_s == "parse_e_excitation_grid_function") {
-                    ApplyExternalFieldExcitationOnGrid(pml[lev]->GetE_fp(0),
+                    ApplyExternalFieldExcitationOnGrid(ExternalFieldType::EfieldExternalPML,
+                                                       pml[lev]->GetE_fp(0),
                                                        pml[lev]->GetE_fp(1),
                                                        pml[lev]->GetE_fp(2),
                                                        Exfield_xt_grid_parser->compile<4>(),
                                                        Eyfield_xt_grid_parser->compile<4>(),
                                                        Ezfield_xt_grid_parser->compile<4>(),
-                                                       Exfield_flag_parser->compile<3>(),
-                                                       Eyfield_flag_parser->compile<3>(),
-                                                       Ezfield_flag_parser->compile<3>(),
+                                                       *Exfield_flag_parser,
+                                                       *Eyfield_flag_parser,
+                                                       *Ezfield_flag_parser,
                                                        lev, a_dt_type );
             }
         }
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::BfieldExternal) {
             if (B_excitation_grid_s == "parse_b_excitation_grid_function") {
-                ApplyExternalFieldExcitationOnGrid(Bfield_fp[lev][0].get(),
+                ApplyExternalFieldExcitationOnGrid(ExternalFieldType::BfieldExternal,
+                                                   Bfield_fp[lev][0].get(),
                                                    Bfield_fp[lev][1].get(),
                                                    Bfield_fp[lev][2].get(),
                                                    Bxfield_xt_grid_parser->compile<4>(),
                                                    Byfield_xt_grid_parser->compile<4>(),
                                                    Bzfield_xt_grid_parser->compile<4>(),
-                                                   Bxfield_flag_parser->compile<3>(),
-                                                   Byfield_flag_parser->compile<3>(),
-                                                   Bzfield_flag_parser->compile<3>(),
+                                                   *Bxfield_flag_parser,
+                                                   *Byfield_flag_parser,
+                                                   *Bzfield_flag_parser,
                                                    lev, a_dt_type );
             }
         }
 #ifdef WARPX_MAG_LLG
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::HfieldExternal) {
             if (H_excitation_grid_s == "parse_h_excitation_grid_function") {
-            ApplyExternalFieldExcitationOnGrid(Hfield_fp[lev][0].get(),
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HfieldExternal,
+                                               Hfield_fp[lev][0].get(),
                                                Hfield_fp[lev][1].get(),
                                                Hfield_fp[lev][2].get(),
                                                Hxfield_xt_grid_parser->compile<4>(),
                                                Hyfield_xt_grid_parser->compile<4>(),
                                                Hzfield_xt_grid_parser->compile<4>(),
-                                               Hxfield_flag_parser->compile<3>(),
-                                               Hyfield_flag_parser->compile<3>(),
-                                               Hzfield_flag_parser->compile<3>(),
+                                               *Hxfield_flag_parser,
+                                               *Hyfield_flag_parser,
+                                               *Hzfield_flag_parser,
                                                lev, a_dt_type );
             }
         }
         if (externalfieldtype == ExternalFieldType::AllExternal || externalfieldtype == ExternalFieldType::HbiasfieldExternal) {
             if (H_bias_excitation_grid_s == "parse_h_bias_excitation_grid_function") {
-            ApplyExternalFieldExcitationOnGrid(H_biasfield_fp[lev][0].get(),
+            ApplyExternalFieldExcitationOnGrid(ExternalFieldType::HbiasfieldExternal,
+                                               H_biasfield_fp[lev][0].get(),
                                                H_biasfield_fp[lev][1].get(),
                                                H_biasfield_fp[lev][2].get(),
                                                Hx_biasfield_xt_grid_parser->compile<4>(),
                                                Hy_biasfield_xt_grid_parser->compile<4>(),
                                                Hz_biasfield_xt_grid_parser->compile<4>(),
-                                               Hx_biasfield_flag_parser->compile<3>(),
-                                               Hy_biasfield_flag_parser->compile<3>(),
-                                               Hz_biasfield_flag_parser->compile<3>(),
+                                               *Hx_biasfield_flag_parser,
+                                               *Hy_biasfield_flag_parser,
+                                               *Hz_biasfield_flag_parser,
                                                lev, a_dt_type );
             }
         }
@@ -98,15 +109,119 @@ WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype, DtType a
     } // for loop over level
 }
 
+WarpX::ExcitationFlags const&
+WarpX::GetExcitationFlags (int const externalfieldtype,
+       amrex::MultiFab const *mfx, amrex::MultiFab const *mfy, amrex::MultiFab const *mfz,
+       amrex::Parser const& xflag_parser,
+       amrex::Parser const& yflag_parser,
+       amrex::Parser const& zflag_parser, const int lev )
+{
+    const auto problo = Geom(lev).ProbLoArray();
+    ExcitationFlags& flags = m_excitation_flags[lev][externalfieldtype];
+
+    // The flags only depend on space, so they are evaluated again only if the grids,
+    // the distribution mapping, or the position of the domain (moving window) changed.
+    bool is_valid = flags.flag[0] != nullptr
+                 && flags.flag[0]->boxArray() == mfx->boxArray()
+                 && flags.flag[0]->DistributionMap() == mfx->DistributionMap();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        is_valid = is_valid && (flags.problo[idim] == problo[idim]);
+    }
+    if (is_valid) return flags;
+
+    WARPX_PROFILE("WarpX::GetExcitationFlags()");
+
+    const auto dx = Geom(lev).CellSizeArray();
+    std::array< amrex::MultiFab const*, 3 > const mf = {mfx, mfy, mfz};
+    std::array< amrex::Parser const*, 3 > const flag_parser = {&xflag_parser, &yflag_parser, &zflag_parser};
+
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        flags.flag[icomp] = std::make_unique<amrex::iMultiFab>(mf[icomp]->boxArray(),
+            mf[icomp]->DistributionMap(), 1, mf[icomp]->nGrowVect());
+    }
+    flags.has_excitation = std::make_unique<amrex::LayoutData<int> >(mfx->boxArray(), mfx->DistributionMap());
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        flags.problo[idim] = problo[idim];
+    }
+    // The E excitation in the PML uses the parsers of the E excitation
+    const int parser_type = (externalfieldtype == ExternalFieldType::EfieldExternalPML) ?
+        ExternalFieldType::EfieldExternal : externalfieldtype;
+    const auto spatial_parser = m_excitation_spatial_parser.find(parser_type);
+    const bool is_separable = (spatial_parser != m_excitation_spatial_parser.end());
+
+    for (int icomp = 0; icomp < 3; ++icomp) {
+        GpuArray<int,3> stag;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            stag[idim] = mf[icomp]->ixType()[idim];
+        }
+        auto const parser = flag_parser[icomp]->compile<3>();
+        for ( MFIter mfi(*flags.flag[icomp]); mfi.isValid(); ++mfi)
+        {
+            amrex::Array4<int> const& flag = flags.flag[icomp]->array(mfi);
+            const amrex::Box& bx = (*flags.flag[icomp])[mfi].box();
+            amrex::ParallelFor(bx,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                    amrex::Real x, y, z;
+                    WarpXUtilAlgo::getCellCoordinates(i, j, k, stag,
+                                                      problo, dx, x, y, z);
+                    auto flag_type = parser(x,y,z);
+                    if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
+                        amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
+                    }
+                    flag(i,j,k) = static_cast<int>(flag_type);
+                }
+            );
+        }
+
+        flags.profile[icomp].reset();
+        if (is_separable) {
+            flags.profile[icomp] = std::make_unique<amrex::MultiFab>(mf[icomp]->boxArray(),
+                mf[icomp]->DistributionMap(), 1, mf[icomp]->nGrowVect());
+            auto const g_parser = spatial_parser->second[icomp]->compile<3>();
+            for ( MFIter mfi(*flags.profile[icomp]); mfi.isValid(); ++mfi)
+            {
+                amrex::Array4<int const> const& flag = flags.flag[icomp]->const_array(mfi);
+                amrex::Array4<amrex::Real> const& g = flags.profile[icomp]->array(mfi);
+                const amrex::Box& bx = (*flags.profile[icomp])[mfi].box();
+                amrex::ParallelFor(bx,
+                    [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+                        if (flag(i,j,k) == 0) {
+                            g(i,j,k) = 0._rt;
+                            return;
+                        }
+                        amrex::Real x, y, z;
+                        WarpXUtilAlgo::getCellCoordinates(i, j, k, stag,
+                                                          problo, dx, x, y, z);
+                        g(i,j,k) = g_parser(x,y,z);
+                    }
+                );
+            }
+        }
+    }
+
+    // Record which boxes have at least one excited cell, so that the others can be skipped
+    for ( MFIter mfi(*flags.has_excitation); mfi.isValid(); ++mfi)
+    {
+        int has_excitation = 0;
+        for (int icomp = 0; icomp < 3; ++icomp) {
+            IArrayBox const& flag_fab = (*flags.flag[icomp])[mfi];
+            has_excitation = std::max(has_excitation, flag_fab.max<RunOn::Device>(flag_fab.box(), 0));
+        }
+        (*flags.has_excitation)[mfi] = has_excitation;
+    }
+
+    return flags;
+}
+
 void
-WarpX::ApplyExternalFieldExcitationOnGrid (
+WarpX::ApplyExternalFieldExcitationOnGrid (int const externalfieldtype,
        amrex::MultiFab *mfx, amrex::MultiFab *mfy, amrex::MultiFab *mfz,
        ParserExecutor<4> const& xfield_parser,
        ParserExecutor<4> const& yfield_parser,
        ParserExecutor<4> const& zfield_parser,
-       ParserExecutor<3> const& xflag_parser,
-       ParserExecutor<3> const& yflag_parser,
-       ParserExecutor<3> const& zflag_parser, const int lev, DtType a_dt_type )
+       amrex::Parser const& xflag_parser,
+       amrex::Parser const& yflag_parser,
+       amrex::Parser const& zflag_parser, const int lev, DtType a_dt_type )
 {
     // This function adds the contribution from an external excitation to the fields.
     // A flag is used to determine the type of excitation.
@@ -114,6 +229,9 @@ WarpX::ApplyExternalFieldExcitationOnGrid (
     // If flag == 2, if is a soft source and the field += excitation
     // If flag == 0, the excitation parser is not computed and the field is unchanged.
     // If flag is not 0, or 1, or 2, the code will Abort!
+    // The flags are evaluated once and cached, see GetExcitationFlags.
+    ExcitationFlags const& flags = GetExcitationFlags(externalfieldtype, mfx, mfy, mfz,
+                                                      xflag_parser, yflag_parser, zflag_parser, lev);
 
     // Gpu vector to store Ex-Bz staggering (Hx-Hz for LLG)
     GpuArray<int,3> mfx_stag, mfy_stag, mfz_stag;
@@ -140,15 +258,80 @@ WarpX::ApplyExternalFieldExcitationOnGrid (
     if (a_dt_type == DtType::FirstHalf or a_dt_type == DtType::SecondHalf ) {
         dt_type_flag = 1;
     }
+
+    // Separable excitation g(x,y,z)*f(t): f is evaluated once here and g was cached
+    // with the flags, so that the update below does not evaluate any parser per cell
+    const int parser_type = (externalfieldtype == ExternalFieldType::EfieldExternalPML) ?
+        ExternalFieldType::EfieldExternal : externalfieldtype;
+    const auto temporal_parser = m_excitation_temporal_parser.find(parser_type);
+    if (temporal_parser != m_excitation_temporal_parser.end()) {
+        const amrex::Real ft_x = temporal_parser->second[0]->compileHost<1>()(t);
+        const amrex::Real ft_y = temporal_parser->second[1]->compileHost<1>()(t);
+        const amrex::Real ft_z = temporal_parser->second[2]->compileHost<1>()(t);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for ( MFIter mfi(*mfx, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            // Skip the boxes without any excited cell
+            if ((*flags.has_excitation)[mfi] == 0) continue;
+
+            amrex::Array4<amrex::Real> const& Fx = mfx->array(mfi);
+            amrex::Array4<amrex::Real> const& Fy = mfy->array(mfi);
+            amrex::Array4<amrex::Real> const& Fz = mfz->array(mfi);
+            amrex::Array4<int const> const& flag_x = flags.flag[0]->const_array(mfi);
+            amrex::Array4<int const> const& flag_y = flags.flag[1]->const_array(mfi);
+            amrex::Array4<int const> const& flag_z = flags.flag[2]->const_array(mfi);
+            amrex::Array4<amrex::Real const> const& gx = flags.profile[0]->const_array(mfi);
+            amrex::Array4<amrex::Real const> const& gy = flags.profile[1]->const_array(mfi);
+            amrex::Array4<amrex::Real const> const& gz = flags.profile[2]->const_array(mfi);
+
+            const amrex::Box& tbx = mfi.tilebox( x_nodal_flag, mfx->nGrowVect() );
+            const amrex::Box& tby = mfi.tilebox( y_nodal_flag, mfy->nGrowVect() );
+            const amrex::Box& tbz = mfi.tilebox( z_nodal_flag, mfz->nGrowVect() );
+
+            amrex::ParallelFor(tbx, nComp_x,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    const int flag_type = flag_x(i,j,k);
+                    if (flag_type == 0) return;
+                    // soft sources are split with a prefactor of 0.5 for FirstHalf/SecondHalf
+                    const amrex::Real dt_type_factor = (flag_type == 2 and dt_type_flag == 1) ? 0.5_rt : 1._rt;
+                    Fx(i,j,k,n) = Fx(i,j,k,n)*(flag_type-1) + dt_type_factor * ft_x * gx(i,j,k);
+                },
+                tby, nComp_y,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    const int flag_type = flag_y(i,j,k);
+                    if (flag_type == 0) return;
+                    const amrex::Real dt_type_factor = (flag_type == 2 and dt_type_flag == 1) ? 0.5_rt : 1._rt;
+                    Fy(i,j,k,n) = Fy(i,j,k,n)*(flag_type-1) + dt_type_factor * ft_y * gy(i,j,k);
+                },
+                tbz, nComp_z,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                    const int flag_type = flag_z(i,j,k);
+                    if (flag_type == 0) return;
+                    const amrex::Real dt_type_factor = (flag_type == 2 and dt_type_flag == 1) ? 0.5_rt : 1._rt;
+                    Fz(i,j,k,n) = Fz(i,j,k,n)*(flag_type-1) + dt_type_factor * ft_z * gz(i,j,k);
+                }
+            );
+        }
+        return;
+    }
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
     for ( MFIter mfi(*mfx, TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
+        // Skip the boxes without any excited cell
+        if ((*flags.has_excitation)[mfi] == 0) continue;
+
         // Extract field data for this grid/tile
         amrex::Array4<amrex::Real> const& Fx = mfx->array(mfi);
         amrex::Array4<amrex::Real> const& Fy = mfy->array(mfi);
         amrex::Array4<amrex::Real> const& Fz = mfz->array(mfi);
+        amrex::Array4<int const> const& flag_x = flags.flag[0]->const_array(mfi);
+        amrex::Array4<int const> const& flag_y = flags.flag[1]->const_array(mfi);
+        amrex::Array4<int const> const& flag_z = flags.flag[2]->const_array(mfi);
 
         const amrex::Box& tbx = mfi.tilebox( x_nodal_flag, mfx->nGrowVect() );
         const amrex::Box& tby = mfi.tilebox( y_nodal_flag, mfy->nGrowVect() );
@@ -157,60 +340,51 @@ WarpX::ApplyExternalFieldExcitationOnGrid (
         // Loop over the cells and update the fields
         amrex::ParallelFor(tbx, nComp_x,
             [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                const int flag_type = flag_x(i,j,k);
+                if (flag_type == 0) return;
                 amrex::Real x, y, z;
                 WarpXUtilAlgo::getCellCoordinates(i, j, k, mfx_stag,
                                                   problo, dx, x, y, z);
-                auto flag_type = xflag_parser(x,y,z);
                 amrex::Real dt_type_factor = 1._rt;
                 // For soft source and FirstHalf/SecondHalf evolve
                 // the excitation is split with a prefector of 0.5
-                if (flag_type == 2._rt and dt_type_flag == 1) {
+                if (flag_type == 2 and dt_type_flag == 1) {
                     dt_type_factor = 0.5_rt;
                 }
-                if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
-                    amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
-                } else if ( flag_type > 0._rt ) {
-                    Fx(i, j, k, n) = Fx(i,j,k,n)*(flag_type-1.0_rt)
-                                   + dt_type_factor * xfield_parser(x,y,z,t);
-                }
+                Fx(i, j, k, n) = Fx(i,j,k,n)*(flag_type-1)
+                               + dt_type_factor * xfield_parser(x,y,z,t);
             },
             tby, nComp_y,
             [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                const int flag_type = flag_y(i,j,k);
+                if (flag_type == 0) return;
                 amrex::Real x, y, z;
                 WarpXUtilAlgo::getCellCoordinates(i, j, k, mfy_stag,
                                                   problo, dx, x, y, z);
-                auto flag_type = yflag_parser(x,y,z);
                 amrex::Real dt_type_factor = 1._rt;
                 // For soft source and FirstHalf/SecondHalf evolve
                 // the excitation is split with a prefector of 0.5
-                if (flag_type == 2._rt and dt_type_flag == 1) {
+                if (flag_type == 2 and dt_type_flag == 1) {
                     dt_type_factor = 0.5_rt;
                 }
-                if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
-                    amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
-                } else if ( flag_type > 0._rt ) {
-                    Fy(i, j, k, n) = Fy(i,j,k,n)*(flag_type-1.0_rt)
-                                   + dt_type_factor * yfield_parser(x,y,z,t);
-                }
+                Fy(i, j, k, n) = Fy(i,j,k,n)*(flag_type-1)
+                               + dt_type_factor * yfield_parser(x,y,z,t);
             },
             tbz, nComp_z,
             [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) {
+                const int flag_type = flag_z(i,j,k);
+                if (flag_type == 0) return;
                 amrex::Real x, y, z;
                 WarpXUtilAlgo::getCellCoordinates(i, j, k, mfz_stag,
                                                   problo, dx, x, y, z);
-                auto flag_type = zflag_parser(x,y,z);
                 amrex::Real dt_type_factor = 1._rt;
                 // For soft source and FirstHalf/SecondHalf evolve
                 // the excitation is split with a prefector of 0.5
-                if (flag_type == 2._rt and dt_type_flag == 1) {
+                if (flag_type == 2 and dt_type_flag == 1) {
                     dt_type_factor = 0.5_rt;
                 }
-                if (flag_type != 0._rt && flag_type != 1._rt && flag_type != 2._rt) {
-                    amrex::Abort("flag type for excitation must be 0, or 1, or 2!");
-                } else if ( flag_type > 0._rt ) {
-                    Fz(i, j, k,n) = Fz(i,j,k,n)*(flag_type-1.0_rt)
-                                  + dt_type_factor * zfield_parser(x,y,z,t);
-                }
+                Fz(i, j, k,n) = Fz(i,j,k,n)*(flag_type-1)
+                              + dt_type_factor * zfield_parser(x,y,z,t);
             }
         );
     }
@@ -229,11 +403,10 @@ WarpX::ReadExcitationParser ()
                B_excitation_grid_s.begin(),
                ::tolower);
 
-#ifdef WARPX_MAG_LLG
-    if (pp_warpx.query("B_excitation_on_grid_style", B_excitation_grid_s)) {
+    if (WarpX::magnetic_model == MagneticModel::LLG &&
+        pp_warpx.contains("B_excitation_on_grid_style")) {
         amrex::Abort("ERROR: Excitation of B field is not allowed in the LLG simulation! \nThe excited magnetic field must be H field! \n");
     }
-#endif
 
     pp_warpx.query("E_excitation_on_grid_style", E_excitation_grid_s);
     std::transform(E_excitation_grid_s.begin(),
@@ -242,16 +415,19 @@ WarpX::ReadExcitationParser ()
                    ::tolower);
 
 #ifdef WARPX_MAG_LLG
-    pp_warpx.query("H_excitation_on_grid_style", H_excitation_grid_s);
-    std::transform(H_excitation_grid_s.begin(),
-                   H_excitation_grid_s.end(),
-                   H_excitation_grid_s.begin(),
-                   ::tolower);
-    pp_warpx.query("H_bias_excitation_on_grid_style", H_bias_excitation_grid_s);
-    std::transform(H_bias_excitation_grid_s.begin(),
-                   H_bias_excitation_grid_s.end(),
-                   H_bias_excitation_grid_s.begin(),
-                   ::tolower);
+    // H and H_bias only exist with the LLG model; otherwise their excitations stay "default"
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        pp_warpx.query("H_excitation_on_grid_style", H_excitation_grid_s);
+        std::transform(H_excitation_grid_s.begin(),
+                       H_excitation_grid_s.end(),
+                       H_excitation_grid_s.begin(),
+                       ::tolower);
+        pp_warpx.query("H_bias_excitation_on_grid_style", H_bias_excitation_grid_s);
+        std::transform(H_bias_excitation_grid_s.begin(),
+                       H_bias_excitation_grid_s.end(),
+                       H_bias_excitation_grid_s.begin(),
+                       ::tolower);
+    }
 #endif
 
     if (E_excitation_grid_s == "parse_e_excitation_grid_function") {
@@ -333,17 +509,48 @@ WarpX::ReadExcitationParser ()
     }
 #endif
 
+    // The excitation of a field can alternatively be given in the separable form g(x,y,z)*f(t),
+    // with F?_excitation_spatial_function(x,y,z) and F?_excitation_temporal_function(t).
+    // g is then evaluated only when the excitation flags are evaluated (see GetExcitationFlags)
+    // and f only once per step. The (x,y,z,t) function is still defined as their product.
+    auto ReadSeparableExcitation = [&] (int const externalfieldtype,
+                                        std::array<std::string, 3> const& names,
+                                        std::array<std::string*, 3> const& str_grid_function)
+    {
+        if (!pp_warpx.contains((names[0] + "_excitation_spatial_function(x,y,z)").c_str())) {
+            return false;
+        }
+        for (int icomp = 0; icomp < 3; ++icomp) {
+            std::string str_spatial, str_temporal;
+            Store_parserString(pp_warpx, names[icomp] + "_excitation_spatial_function(x,y,z)",
+                               str_spatial);
+            Store_parserString(pp_warpx, names[icomp] + "_excitation_temporal_function(t)",
+                               str_temporal);
+            m_excitation_spatial_parser[externalfieldtype][icomp] = std::make_unique<amrex::Parser>(
+                       makeParser(str_spatial,{"x","y","z"}));
+            m_excitation_temporal_parser[externalfieldtype][icomp] = std::make_unique<amrex::Parser>(
+                       makeParser(str_temporal,{"t"}));
+            *str_grid_function[icomp] = "(" + str_spatial + ")*(" + str_temporal + ")";
+        }
+        return true;
+    };
+
     // make parser for the external B-excitation in space-time
     if (B_excitation_grid_s == "parse_b_excitation_grid_function") {
 #ifdef WARPX_DIM_RZ
        amrex::Abort("E and B parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Bx_excitation_grid_function(x,y,z,t)",
-                                                    str_Bx_excitation_grid_function);
-       Store_parserString(pp_warpx, "By_excitation_grid_function(x,y,z,t)",
-                                                    str_By_excitation_grid_function);
-       Store_parserString(pp_warpx, "Bz_excitation_grid_function(x,y,z,t)",
-                                                    str_Bz_excitation_grid_function);
+       if (!ReadSeparableExcitation(ExternalFieldType::BfieldExternal, {"Bx", "By", "Bz"},
+                                    {&str_Bx_excitation_grid_function,
+                                     &str_By_excitation_grid_function,
+                                     &str_Bz_excitation_grid_function})) {
+           Store_parserString(pp_warpx, "Bx_excitation_grid_function(x,y,z,t)",
+                                                        str_Bx_excitation_grid_function);
+           Store_parserString(pp_warpx, "By_excitation_grid_function(x,y,z,t)",
+                                                        str_By_excitation_grid_function);
+           Store_parserString(pp_warpx, "Bz_excitation_grid_function(x,y,z,t)",
+                                                        str_Bz_excitation_grid_function);
+       }
        Bxfield_xt_grid_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Bx_excitation_grid_function,{"x","y","z","t"}));
        Byfield_xt_grid_parser = std::make_unique<amrex::Parser>(
@@ -357,12 +564,17 @@ WarpX::ReadExcitationParser ()
 #ifdef WARPX_DIM_RZ
        amrex::Abort("E and B parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Ex_excitation_grid_function(x,y,z,t)",
-                                                    str_Ex_excitation_grid_function);
-       Store_parserString(pp_warpx, "Ey_excitation_grid_function(x,y,z,t)",
-                                                    str_Ey_excitation_grid_function);
-       Store_parserString(pp_warpx, "Ez_excitation_grid_function(x,y,z,t)",
-                                                    str_Ez_excitation_grid_function);
+       if (!ReadSeparableExcitation(ExternalFieldType::EfieldExternal, {"Ex", "Ey", "Ez"},
+                                    {&str_Ex_excitation_grid_function,
+                                     &str_Ey_excitation_grid_function,
+                                     &str_Ez_excitation_grid_function})) {
+           Store_parserString(pp_warpx, "Ex_excitation_grid_function(x,y,z,t)",
+                                                        str_Ex_excitation_grid_function);
+           Store_parserString(pp_warpx, "Ey_excitation_grid_function(x,y,z,t)",
+                                                        str_Ey_excitation_grid_function);
+           Store_parserString(pp_warpx, "Ez_excitation_grid_function(x,y,z,t)",
+                                                        str_Ez_excitation_grid_function);
+       }
        Exfield_xt_grid_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Ex_excitation_grid_function,{"x","y","z","t"}));
        Eyfield_xt_grid_parser = std::make_unique<amrex::Parser>(
@@ -377,12 +589,17 @@ WarpX::ReadExcitationParser ()
 #ifdef WARPX_DIM_RZ
        amrex::Abort("H parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Hx_excitation_grid_function(x,y,z,t)",
-                                                    str_Hx_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hy_excitation_grid_function(x,y,z,t)",
-                                                    str_Hy_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hz_excitation_grid_function(x,y,z,t)",
-                                                    str_Hz_excitation_grid_function);
+       if (!ReadSeparableExcitation(ExternalFieldType::HfieldExternal, {"Hx", "Hy", "Hz"},
+                                    {&str_Hx_excitation_grid_function,
+                                     &str_Hy_excitation_grid_function,
+                                     &str_Hz_excitation_grid_function})) {
+           Store_parserString(pp_warpx, "Hx_excitation_grid_function(x,y,z,t)",
+                                                        str_Hx_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hy_excitation_grid_function(x,y,z,t)",
+                                                        str_Hy_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hz_excitation_grid_function(x,y,z,t)",
+                                                        str_Hz_excitation_grid_function);
+       }
        Hxfield_xt_grid_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hx_excitation_grid_function,{"x","y","z","t"}));
        Hyfield_xt_grid_parser = std::make_unique<amrex::Parser>(
@@ -395,12 +612,17 @@ WarpX::ReadExcitationParser ()
 #ifdef WARPX_DIM_RZ
        amrex::Abort("H parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Hx_bias_excitation_grid_function(x,y,z,t)",
-                                                    str_Hx_bias_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hy_bias_excitation_grid_function(x,y,z,t)",
-                                                    str_Hy_bias_excitation_grid_function);
-       Store_parserString(pp_warpx, "Hz_bias_excitation_grid_function(x,y,z,t)",
-                                                    str_Hz_bias_excitation_grid_function);
+       if (!ReadSeparableExcitation(ExternalFieldType::HbiasfieldExternal, {"Hx_bias", "Hy_bias", "Hz_bias"},
+                                    {&str_Hx_bias_excitation_grid_function,
+                                     &str_Hy_bias_excitation_grid_function,
+                                     &str_Hz_bias_excitation_grid_function})) {
+           Store_parserString(pp_warpx, "Hx_bias_excitation_grid_function(x,y,z,t)",
+                                                        str_Hx_bias_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hy_bias_excitation_grid_function(x,y,z,t)",
+                                                        str_Hy_bias_excitation_grid_function);
+           Store_parserString(pp_warpx, "Hz_bias_excitation_grid_function(x,y,z,t)",
+                                                        str_Hz_bias_excitation_grid_function);
+       }
        Hx_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
                    makeParser(str_Hx_bias_excitation_grid_function,{"x","y","z","t"}));
        Hy_biasfield_xt_grid_parser = std::make_unique<amrex::Parser>(
@@ -574,12 +574,12 @@ void
 WarpX::EvolveBLondon (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_type)
 {
     amrex::ignore_unused(a_dt_type);
-    // Evolve B field in regular cells
+    // Evolve the London current J over a_dt, and B from the curl of J, in regular cells
     if (patch_type == PatchType::fine) {
         m_fdtd_solver_fp[lev]->EvolveBLondon(Bfield_sc_fp[lev], current_fp[lev], G_fp[lev],
                                        m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
                                        m_flag_info_face[lev], m_borrowing[lev], lev, a_dt,
-                                       m_london->m_penetration_depth);
+                                       m_london->m_penetration_depth, (lev == 0) ? m_london.get() : nullptr);
     } else {
         m_fdtd_solver_cp[lev]->EvolveBLondon(Bfield_sc_fp[lev], current_cp[lev], G_cp[lev],
                                        m_face_areas[lev], m_area_mod[lev], ECTRhofield[lev], Venl[lev],
@@ -602,11 +602,13 @@ void
 WarpX::EvolveB (int lev, amrex::Real a_dt, DtType a_dt_type)
 {
     WARPX_PROFILE("WarpX::EvolveB()");
+    DeepHaloBeginUpdate(lev, DeepHalo::Update::B);
     EvolveB(lev, PatchType::fine, a_dt, a_dt_type);
     if (lev > 0)
     {
         EvolveB(lev, PatchType::coarse, a_dt, a_dt_type);
     }
+    DeepHaloEndUpdate(lev);
 }
 
 void
@@ -652,11 +654,13 @@ void
 WarpX::EvolveE (int lev, amrex::Real a_dt)
 {
     WARPX_PROFILE("WarpX::EvolveE()");
+    DeepHaloBeginUpdate(lev, DeepHalo::Update::E);
     EvolveE(lev, PatchType::fine, a_dt);
     if (lev > 0)
     {
         EvolveE(lev, PatchType::coarse, a_dt);
     }
+    DeepHaloEndUpdate(lev);
 }
 
 void
@@ -678,25 +682,27 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
     // Evolve E field in PML cells
     if (do_pml && pml[lev]->ok()) {
         if (patch_type == PatchType::fine) {
-            m_fdtd_solver_fp[lev]->EvolveEPML(
-                pml[lev]->GetE_fp(),
 #ifdef WARPX_MAG_LLG
-                pml[lev]->GetH_fp(),
+            auto const pml_magnetic_fp = (WarpX::magnetic_model == MagneticModel::LLG) ?
+                pml[lev]->GetH_fp() : pml[lev]->GetB_fp();
 #else
-                pml[lev]->GetB_fp(),
+            auto const pml_magnetic_fp = pml[lev]->GetB_fp();
 #endif
+            m_fdtd_solver_fp[lev]->EvolveEPML(
+                pml[lev]->GetE_fp(), pml_magnetic_fp,
                 pml[lev]->Getj_fp(), pml[lev]->Get_edge_lengths(),
                 pml[lev]->GetF_fp(),
                 pml[lev]->GetMultiSigmaBox_fp(),
                 a_dt, pml_has_particles );
         } else {
-            m_fdtd_solver_cp[lev]->EvolveEPML(
-                pml[lev]->GetE_cp(),
 #ifdef WARPX_MAG_LLG
-                pml[lev]->GetH_cp(),
+            auto const pml_magnetic_cp = (WarpX::magnetic_model == MagneticModel::LLG) ?
+                pml[lev]->GetH_cp() : pml[lev]->GetB_cp();
 #else
-                pml[lev]->GetB_cp(),
+            auto const pml_magnetic_cp = pml[lev]->GetB_cp();
 #endif
+            m_fdtd_solver_cp[lev]->EvolveEPML(
+                pml[lev]->GetE_cp(), pml_magnetic_cp,
                 pml[lev]->Getj_cp(), pml[lev]->Get_edge_lengths(),
                 pml[lev]->GetF_cp(),
                 pml[lev]->GetMultiSigmaBox_cp(),
@@ -834,7 +840,9 @@ WarpX::MacroscopicEvolveE (int lev, amrex::Real a_dt) {
         "Macroscopic EvolveE is not implemented for lev>0, yet."
     );
 
+    DeepHaloBeginUpdate(lev, DeepHalo::Update::E);
     MacroscopicEvolveE(lev, PatchType::fine, a_dt);
+    DeepHaloEndUpdate(lev);
 }
 
 void
@@ -845,24 +853,26 @@ WarpX::MacroscopicEvolveE (int lev, PatchType patch_type, amrex::Real a_dt) {
         patch_type == PatchType::fine,
         "Macroscopic EvolveE is not implemented for lev>0, yet."
     );
-    m_fdtd_solver_fp[lev]->MacroscopicEvolveE( Efield_fp[lev],
-#ifndef WARPX_MAG_LLG
-                                               Bfield_fp[lev],
+    // With the LLG model, E is advanced with the curl of H rather than B/mu
+#ifdef WARPX_MAG_LLG
+    bool const use_H = (WarpX::magnetic_model == MagneticModel::LLG);
+    auto const& magnetic_fp = use_H ? Hfield_fp[lev] : Bfield_fp[lev];
 #else
-                                               Hfield_fp[lev],
+    auto const& magnetic_fp = Bfield_fp[lev];
 #endif
+    m_fdtd_solver_fp[lev]->MacroscopicEvolveE( Efield_fp[lev], magnetic_fp,
                                                current_fp[lev], m_edge_lengths[lev], a_dt,
                                                m_macroscopic_properties);
     // Evolve E field in PML cells
     if (do_pml && pml[lev]->ok()) {
         if (patch_type == PatchType::fine) {
-            m_fdtd_solver_fp[lev]->MacroscopicEvolveEPML(
-                pml[lev]->GetE_fp(),
-#ifndef WARPX_MAG_LLG
-                pml[lev]->GetB_fp(),
+#ifdef WARPX_MAG_LLG
+            auto const pml_magnetic_fp = use_H ? pml[lev]->GetH_fp() : pml[lev]->GetB_fp();
 #else
-                pml[lev]->GetH_fp(),
+            auto const pml_magnetic_fp = pml[lev]->GetB_fp();
 #endif
+            m_fdtd_solver_fp[lev]->MacroscopicEvolveEPML(
+                pml[lev]->GetE_fp(), pml_magnetic_fp,
                 pml[lev]->Getj_fp(), pml[lev]->GetF_fp(),
                 pml[lev]->GetMultiSigmaBox_fp(),
                 a_dt, pml_has_particles,
@@ -871,13 +881,13 @@ WarpX::MacroscopicEvolveE (int lev, PatchType patch_type, amrex::Real a_dt) {
                 pml[lev]->Getmu_fp(),
                 pml[lev]->Getsigma_fp() );
         } else {
-            m_fdtd_solver_cp[lev]->MacroscopicEvolveEPML(
-                pml[lev]->GetE_cp(),
-#ifndef WARPX_MAG_LLG
-                pml[lev]->GetB_cp(),
+#ifdef WARPX_MAG_LLG
+            auto const pml_magnetic_cp = use_H ? pml[lev]->GetH_cp() : pml[lev]->GetB_cp();
 #else
-                pml[lev]->GetH_cp(),
+            auto const pml_magnetic_cp = pml[lev]->GetB_cp();
 #endif
+            m_fdtd_solver_cp[lev]->MacroscopicEvolveEPML(
+                pml[lev]->GetE_cp(), pml_magnetic_cp,
                 pml[lev]->Getj_cp(), pml[lev]->GetF_cp(),
                 pml[lev]->GetMultiSigmaBox_cp(),
                 a_dt, pml_has_particles,
@@ -906,7 +916,9 @@ void
 WarpX::MacroscopicEvolveHM (int lev, amrex::Real a_dt) {
 
     WARPX_PROFILE("WarpX::MacroscopicEvolveHM()");
+    DeepHaloBeginUpdate(lev, DeepHalo::Update::HM);
     MacroscopicEvolveHM(lev, PatchType::fine, a_dt);
+    DeepHaloEndUpdate(lev);
     if (lev > 0) {
         amrex::Abort("Macroscopic EvolveHM is not implemented for lev>0, yet.");
     }
@@ -923,6 +935,7 @@ WarpX::MacroscopicEvolveHM (int lev, PatchType patch_type, amrex::Real a_dt) {
     else {
         amrex::Abort("Macroscopic EvolveHM is not implemented for lev > 0 yet");
     }
+    if (!mag_LLG_maintain_B) m_llg_B_is_stale = true;
 
     // Evolve H field in PML cells
     if (do_pml && pml[lev]->ok()) {
@@ -966,6 +979,7 @@ WarpX::MacroscopicEvolveHM_2nd (int lev, PatchType patch_type, amrex::Real a_dt)
     else {
         amrex::Abort("Macroscopic EvolveHM_2nd is not implemented for lev > 0 yet");
     }
+    if (!mag_LLG_maintain_B) m_llg_B_is_stale = true;
 
     // Evolve H field in PML cells
     if (do_pml && pml[lev]->ok()) {
@@ -979,6 +993,42 @@ WarpX::MacroscopicEvolveHM_2nd (int lev, PatchType patch_type, amrex::Real a_dt)
     }
 }
 
+void
+WarpX::MacroscopicEvolveHMSubsteps (amrex::Real a_dt)
+{
+    WARPX_PROFILE("WarpX::MacroscopicEvolveHMSubsteps()");
+
+    const amrex::Real sub_dt = a_dt / mag_substeps;
+    for (int isub = 0; isub < mag_substeps; ++isub) {
+        // The guard cells of H and M are filled by the caller after the last substep
+        if (isub > 0 && !m_deep_halo.SkipsExchange(2)) {
+            FillBoundaryH(guard_cells.ng_FieldSolver);
+            FillBoundaryM(guard_cells.ng_FieldSolver);
+        }
+        if (mag_time_scheme_order==1) {
+            MacroscopicEvolveHM(sub_dt);
+        } else if (mag_time_scheme_order==2) {
+            MacroscopicEvolveHM_2nd(sub_dt);
+        } else {
+            amrex::Abort("unsupported mag_time_scheme_order for M field");
+        }
+    }
+}
+
+void
+WarpX::SyncLLGBfield ()
+{
+    if (!m_llg_B_is_stale) return;
+
+    WARPX_PROFILE("WarpX::SyncLLGBfield()");
+    // the LLG solver only runs on level 0
+    m_fdtd_solver_fp[0]->ComputeBfromHM(Bfield_fp[0], Hfield_fp[0], Mfield_fp[0], m_macroscopic_properties);
+    FillBoundaryB(0, guard_cells.ng_alloc_EB);
+    // the diagnostics read the auxiliary B
+    UpdateAuxilaryData();
+    m_llg_B_is_stale = false;
+}
+
 #endif
 #endif // ifndef WARPX_DIM_RZ
 
@@ -18,6 +18,9 @@
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#if defined(WARPX_MAG_LLG) && defined(WARPX_USE_PSATD)
+#   include "FieldSolver/Demagnetization/Demagnetization.H"
+#endif
 #include "Filter/BilinearFilter.H"
 #include "Filter/NCIGodfreyFilter.H"
 #include "Particles/MultiParticleContainer.H"
@@ -374,6 +377,21 @@ WarpX::InitData ()
         m_macroscopic_properties->InitData();
     }
 
+#ifdef WARPX_MAG_LLG
+    // M is only kept on the boxes that contain magnetic material, which are known from here on;
+    // the LLG solver only runs on level 0. After a restart, only the valid cells of M were read
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        CompactMfield(0);
+        if (!restart_chkfile.empty()) FillBoundaryM(0, guard_cells.ng_alloc_EB);
+    }
+#endif
+
+#if defined(WARPX_MAG_LLG) && defined(WARPX_USE_PSATD)
+    if (m_demag) {
+        m_demag->InitData();
+    }
+#endif
+
     if (WarpX::yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon) {
         amrex::Print() << " calling london \n";
         m_london->InitData();
@@ -438,6 +456,7 @@ WarpX::InitDiagnostics () {
                                                particle_slice_width_lab);
     }
     reduced_diags->InitData();
+    if (!restart_chkfile.empty()) reduced_diags->ReadCheckpointData(restart_chkfile);
 }
 
 void
@@ -665,11 +684,9 @@ WarpX::InitLevelData (int lev, Real /*time*/)
                    B_ext_grid_s.begin(),
                    ::tolower);
 
-#ifdef WARPX_MAG_LLG
-    if (pp_warpx.query("B_ext_grid_init_style", B_ext_grid_s) ) {
+    if (WarpX::magnetic_model == MagneticModel::LLG && pp_warpx.contains("B_ext_grid_init_style")) {
         amrex::Abort("ERROR: Initialization of B field is not allowed in the LLG simulation! \nThe initial magnetic field must be H and M! \n");
     }
-#endif
 
     pp_warpx.query("E_ext_grid_init_style", E_ext_grid_s);
     std::transform(E_ext_grid_s.begin(),
@@ -677,23 +694,25 @@ WarpX::InitLevelData (int lev, Real /*time*/)
                    E_ext_grid_s.begin(),
                    ::tolower);
 #ifdef WARPX_MAG_LLG
-    pp_warpx.query("M_ext_grid_init_style", M_ext_grid_s); // user-defined initial M
-    std::transform(M_ext_grid_s.begin(),
-                   M_ext_grid_s.end(),
-                   M_ext_grid_s.begin(),
-                   ::tolower);
-
-    pp_warpx.query("H_ext_grid_init_style", H_ext_grid_s); // user-defined initial H
-    std::transform(H_ext_grid_s.begin(),
-                   H_ext_grid_s.end(),
-                   H_ext_grid_s.begin(),
-                   ::tolower);
-
-    pp_warpx.query("H_bias_ext_grid_init_style", H_bias_ext_grid_s); // user-defined initial M
-    std::transform(H_bias_ext_grid_s.begin(),
-                   H_bias_ext_grid_s.end(),
-                   H_bias_ext_grid_s.begin(),
-                   ::tolower);
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        pp_warpx.query("M_ext_grid_init_style", M_ext_grid_s); // user-defined initial M
+        std::transform(M_ext_grid_s.begin(),
+                       M_ext_grid_s.end(),
+                       M_ext_grid_s.begin(),
+                       ::tolower);
+
+        pp_warpx.query("H_ext_grid_init_style", H_ext_grid_s); // user-defined initial H
+        std::transform(H_ext_grid_s.begin(),
+                       H_ext_grid_s.end(),
+                       H_ext_grid_s.begin(),
+                       ::tolower);
+
+        pp_warpx.query("H_bias_ext_grid_init_style", H_bias_ext_grid_s); // user-defined initial M
+        std::transform(H_bias_ext_grid_s.begin(),
+                       H_bias_ext_grid_s.end(),
+                       H_bias_ext_grid_s.begin(),
+                       ::tolower);
+    }
 #endif
 
     // * Functions with the string "arr" in their names get an Array of
@@ -715,14 +734,16 @@ WarpX::InitLevelData (int lev, Real /*time*/)
 
 
 #ifdef WARPX_MAG_LLG
-    if (M_ext_grid_s == "constant")
-        getArrWithParser(pp_warpx, "M_external_grid", M_external_grid);
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        if (M_ext_grid_s == "constant")
+            getArrWithParser(pp_warpx, "M_external_grid", M_external_grid);
 
-    if (H_ext_grid_s == "constant")
-        getArrWithParser(pp_warpx, "H_external_grid", H_external_grid);
+        if (H_ext_grid_s == "constant")
+            getArrWithParser(pp_warpx, "H_external_grid", H_external_grid);
 
-    if (H_bias_ext_grid_s == "constant")
-        getArrWithParser(pp_warpx,"H_bias_external_grid", H_bias_external_grid);
+        if (H_bias_ext_grid_s == "constant")
+            getArrWithParser(pp_warpx,"H_bias_external_grid", H_bias_external_grid);
+    }
 #endif
     // initialize the averaged fields only if the averaged algorithm
     // is activated ('psatd.do_time_averaging=1')
@@ -781,41 +802,42 @@ WarpX::InitLevelData (int lev, Real /*time*/)
         }
 
 #ifdef WARPX_MAG_LLG
-        if (M_ext_grid_s == "constant" || M_ext_grid_s == "default"){
-            // this if condition finds out if the user-input is constant
-            // if not, set initial value to default, default = 0.0
-
-            // Set the value of num_comp components in the valid region of
-            // each FAB in the FabArray, starting at component comp to val.
-            // Also set the value of nghost boundary cells.
-            // template <class F=FAB, class = typename std::enable_if<IsBaseFab<F>::value>::type >
-            // void setVal (value_type val,
-            //              int        comp,
-            //              int        num_comp,
-            //              int        nghost = 0);
-
-            int nghost = 1;
-            for (int icomp = 0; icomp < 3; ++icomp){ // icomp is the index of components at each i face
-                Mfield_fp[lev][i]->setVal(M_external_grid[icomp], icomp, 1, nghost);
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            if (M_ext_grid_s == "constant" || M_ext_grid_s == "default"){
+                // this if condition finds out if the user-input is constant
+                // if not, set initial value to default, default = 0.0
+
+                // Set the value of num_comp components in the valid region of
+                // each FAB in the FabArray, starting at component comp to val.
+                // Also set the value of nghost boundary cells.
+                // template <class F=FAB, class = typename std::enable_if<IsBaseFab<F>::value>::type >
+                // void setVal (value_type val,
+                //              int        comp,
+                //              int        num_comp,
+                //              int        nghost = 0);
+
+                int nghost = 1;
+                for (int icomp = 0; icomp < 3; ++icomp){ // icomp is the index of components at each i face
+                    Mfield_fp[lev][i]->setVal(M_external_grid[icomp], icomp, 1, nghost);
+                }
             }
-        }
 
-        if (H_ext_grid_s == "constant" || H_ext_grid_s == "default") {
-           Hfield_fp[lev][i]->setVal(H_external_grid[i]);
-           if (lev > 0) {
-              Hfield_aux[lev][i]->setVal(H_external_grid[i]);
-              Hfield_cp[lev][i]->setVal(H_external_grid[i]);
-           }
-        }
+            if (H_ext_grid_s == "constant" || H_ext_grid_s == "default") {
+               Hfield_fp[lev][i]->setVal(H_external_grid[i]);
+               if (lev > 0) {
+                  Hfield_aux[lev][i]->setVal(H_external_grid[i]);
+                  Hfield_cp[lev][i]->setVal(H_external_grid[i]);
+               }
+            }
 
-        if (H_bias_ext_grid_s == "constant" || H_bias_ext_grid_s == "default") {
-           H_biasfield_fp[lev][i]->setVal(H_bias_external_grid[i]);
-           if (lev > 0) {
-              H_biasfield_aux[lev][i]->setVal(H_bias_external_grid[i]);
-              H_biasfield_cp[lev][i]->setVal(H_bias_external_grid[i]);
-           }
-        }
+            if (H_bias_ext_grid_s == "constant" || H_bias_ext_grid_s == "default") {
+               H_biasfield_fp[lev][i]->setVal(H_bias_external_grid[i]);
+               if (lev > 0) {
+                  H_biasfield_cp[lev][i]->setVal(H_bias_external_grid[i]);
+               }
+            }
 
+        }
 #endif
    }
 
@@ -957,173 +979,153 @@ WarpX::InitLevelData (int lev, Real /*time*/)
     }
 
 #ifdef WARPX_MAG_LLG
-    // if the input string for the Hbias-field is "parse_h_bias_ext_grid_function",
-    // then the analytical expression or function must be
-    // provided in the input file.
-    if (H_bias_ext_grid_s == "parse_h_bias_ext_grid_function") {
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        // if the input string for the Hbias-field is "parse_h_bias_ext_grid_function",
+        // then the analytical expression or function must be
+        // provided in the input file.
+        if (H_bias_ext_grid_s == "parse_h_bias_ext_grid_function") {
 
 #ifdef WARPX_DIM_RZ
-       amrex::Abort("H bias parser for external fields does not work with RZ -- TO DO");
+           amrex::Abort("H bias parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Hx_bias_external_grid_function(x,y,z)",
-                                                    str_Hx_bias_ext_grid_function);
-       Store_parserString(pp_warpx, "Hy_bias_external_grid_function(x,y,z)",
-                                                    str_Hy_bias_ext_grid_function);
-       Store_parserString(pp_warpx, "Hz_bias_external_grid_function(x,y,z)",
-                                                    str_Hz_bias_ext_grid_function);
-
-       Hx_biasfield_parser = std::make_unique<amrex::Parser>(
-                                makeParser(str_Hx_bias_ext_grid_function,{"x","y","z"}));
-       Hy_biasfield_parser = std::make_unique<amrex::Parser>(
-                                makeParser(str_Hy_bias_ext_grid_function,{"x","y","z"}));
-       Hz_biasfield_parser = std::make_unique<amrex::Parser>(
-                                makeParser(str_Hz_bias_ext_grid_function,{"x","y","z"}));
-
-       // Initialize Efield_fp with external function
-       InitializeExternalFieldsOnGridUsingParser(H_biasfield_fp[lev][0].get(),
-                                                 H_biasfield_fp[lev][1].get(),
-                                                 H_biasfield_fp[lev][2].get(),
-                                                 Hx_biasfield_parser->compile<3>(),
-                                                 Hy_biasfield_parser->compile<3>(),
-                                                 Hz_biasfield_parser->compile<3>(),
-                                                 m_edge_lengths[lev],
-                                                 m_face_areas[lev],
-                                                 'H',
-                                                 lev);
-       if (lev > 0) {
-          InitializeExternalFieldsOnGridUsingParser(H_biasfield_aux[lev][0].get(),
-                                                    H_biasfield_aux[lev][1].get(),
-                                                    H_biasfield_aux[lev][2].get(),
-                                                    Hx_biasfield_parser->compile<3>(),
-                                                    Hy_biasfield_parser->compile<3>(),
-                                                    Hz_biasfield_parser->compile<3>(),
-                                                    m_edge_lengths[lev],
-                                                    m_face_areas[lev],
-                                                    'H',
-                                                    lev);
-
-          InitializeExternalFieldsOnGridUsingParser(H_biasfield_cp[lev][0].get(),
-                                                    H_biasfield_cp[lev][1].get(),
-                                                    H_biasfield_cp[lev][2].get(),
-                                                    Hx_biasfield_parser->compile<3>(),
-                                                    Hy_biasfield_parser->compile<3>(),
-                                                    Hz_biasfield_parser->compile<3>(),
-                                                    m_edge_lengths[lev],
-                                                    m_face_areas[lev],
-                                                    'H',
-                                                    lev);
-       }
-    }
+           Store_parserString(pp_warpx, "Hx_bias_external_grid_function(x,y,z)",
+                                                        str_Hx_bias_ext_grid_function);
+           Store_parserString(pp_warpx, "Hy_bias_external_grid_function(x,y,z)",
+                                                        str_Hy_bias_ext_grid_function);
+           Store_parserString(pp_warpx, "Hz_bias_external_grid_function(x,y,z)",
+                                                        str_Hz_bias_ext_grid_function);
+
+           Hx_biasfield_parser = std::make_unique<amrex::Parser>(
+                                    makeParser(str_Hx_bias_ext_grid_function,{"x","y","z"}));
+           Hy_biasfield_parser = std::make_unique<amrex::Parser>(
+                                    makeParser(str_Hy_bias_ext_grid_function,{"x","y","z"}));
+           Hz_biasfield_parser = std::make_unique<amrex::Parser>(
+                                    makeParser(str_Hz_bias_ext_grid_function,{"x","y","z"}));
+
+           // Initialize Efield_fp with external function
+           InitializeExternalFieldsOnGridUsingParser(H_biasfield_fp[lev][0].get(),
+                                                     H_biasfield_fp[lev][1].get(),
+                                                     H_biasfield_fp[lev][2].get(),
+                                                     Hx_biasfield_parser->compile<3>(),
+                                                     Hy_biasfield_parser->compile<3>(),
+                                                     Hz_biasfield_parser->compile<3>(),
+                                                     m_edge_lengths[lev],
+                                                     m_face_areas[lev],
+                                                     'H',
+                                                     lev);
+           if (lev > 0) {
+              InitializeExternalFieldsOnGridUsingParser(H_biasfield_cp[lev][0].get(),
+                                                        H_biasfield_cp[lev][1].get(),
+                                                        H_biasfield_cp[lev][2].get(),
+                                                        Hx_biasfield_parser->compile<3>(),
+                                                        Hy_biasfield_parser->compile<3>(),
+                                                        Hz_biasfield_parser->compile<3>(),
+                                                        m_edge_lengths[lev],
+                                                        m_face_areas[lev],
+                                                        'H',
+                                                        lev);
+           }
+        }
 
-    if (H_ext_grid_s == "parse_h_ext_grid_function") {
+        if (H_ext_grid_s == "parse_h_ext_grid_function") {
 
 #ifdef WARPX_DIM_RZ
-       amrex::Abort("H parser for external fields does not work with RZ -- TO DO");
+           amrex::Abort("H parser for external fields does not work with RZ -- TO DO");
 #endif
-       Store_parserString(pp_warpx, "Hx_external_grid_function(x,y,z)",
-                                                    str_Hx_ext_grid_function);
-       Store_parserString(pp_warpx, "Hy_external_grid_function(x,y,z)",
-                                                    str_Hy_ext_grid_function);
-       Store_parserString(pp_warpx, "Hz_external_grid_function(x,y,z)",
-                                                    str_Hz_ext_grid_function);
-
-       Hxfield_parser = std::make_unique<amrex::Parser>(
-                                makeParser(str_Hx_ext_grid_function,{"x","y","z"}));
-       Hyfield_parser = std::make_unique<amrex::Parser>(
-                                makeParser(str_Hy_ext_grid_function,{"x","y","z"}));
-       Hzfield_parser = std::make_unique<amrex::Parser>(
-                                makeParser(str_Hz_ext_grid_function,{"x","y","z"}));
-
-       // Initialize Hfield_fp with external function
-       InitializeExternalFieldsOnGridUsingParser(Hfield_fp[lev][0].get(),
-                                                 Hfield_fp[lev][1].get(),
-                                                 Hfield_fp[lev][2].get(),
-                                                 Hxfield_parser->compile<3>(),
-                                                 Hyfield_parser->compile<3>(),
-                                                 Hzfield_parser->compile<3>(),
-                                                 m_edge_lengths[lev],
-                                                 m_face_areas[lev],
-                                                 'H',
-                                                 lev);
-       if (lev > 0) {
-          InitializeExternalFieldsOnGridUsingParser(Hfield_aux[lev][0].get(),
-                                                    Hfield_aux[lev][1].get(),
-                                                    Hfield_aux[lev][2].get(),
-                                                    Hxfield_parser->compile<3>(),
-                                                    Hyfield_parser->compile<3>(),
-                                                    Hzfield_parser->compile<3>(),
-                                                    m_edge_lengths[lev],
-                                                    m_face_areas[lev],
-                                                    'H',
-                                                    lev);
-
-          InitializeExternalFieldsOnGridUsingParser(Hfield_cp[lev][0].get(),
-                                                    Hfield_cp[lev][1].get(),
-                                                    Hfield_cp[lev][2].get(),
-                                                    Hxfield_parser->compile<3>(),
-                                                    Hyfield_parser->compile<3>(),
-                                                    Hzfield_parser->compile<3>(),
-                                                    m_edge_lengths[lev],
-                                                    m_face_areas[lev],
-                                                    'H',
-                                                    lev);
-       }
-    }
+           Store_parserString(pp_warpx, "Hx_external_grid_function(x,y,z)",
+                                                        str_Hx_ext_grid_function);
+           Store_parserString(pp_warpx, "Hy_external_grid_function(x,y,z)",
+                                                        str_Hy_ext_grid_function);
+           Store_parserString(pp_warpx, "Hz_external_grid_function(x,y,z)",
+                                                        str_Hz_ext_grid_function);
+
+           Hxfield_parser = std::make_unique<amrex::Parser>(
+                                    makeParser(str_Hx_ext_grid_function,{"x","y","z"}));
+           Hyfield_parser = std::make_unique<amrex::Parser>(
+                                    makeParser(str_Hy_ext_grid_function,{"x","y","z"}));
+           Hzfield_parser = std::make_unique<amrex::Parser>(
+                                    makeParser(str_Hz_ext_grid_function,{"x","y","z"}));
+
+           // Initialize Hfield_fp with external function
+           InitializeExternalFieldsOnGridUsingParser(Hfield_fp[lev][0].get(),
+                                                     Hfield_fp[lev][1].get(),
+                                                     Hfield_fp[lev][2].get(),
+                                                     Hxfield_parser->compile<3>(),
+                                                     Hyfield_parser->compile<3>(),
+                                                     Hzfield_parser->compile<3>(),
+                                                     m_edge_lengths[lev],
+                                                     m_face_areas[lev],
+                                                     'H',
+                                                     lev);
+           if (lev > 0) {
+              InitializeExternalFieldsOnGridUsingParser(Hfield_aux[lev][0].get(),
+                                                        Hfield_aux[lev][1].get(),
+                                                        Hfield_aux[lev][2].get(),
+                                                        Hxfield_parser->compile<3>(),
+                                                        Hyfield_parser->compile<3>(),
+                                                        Hzfield_parser->compile<3>(),
+                                                        m_edge_lengths[lev],
+                                                        m_face_areas[lev],
+                                                        'H',
+                                                        lev);
+
+              InitializeExternalFieldsOnGridUsingParser(Hfield_cp[lev][0].get(),
+                                                        Hfield_cp[lev][1].get(),
+                                                        Hfield_cp[lev][2].get(),
+                                                        Hxfield_parser->compile<3>(),
+                                                        Hyfield_parser->compile<3>(),
+                                                        Hzfield_parser->compile<3>(),
+                                                        m_edge_lengths[lev],
+                                                        m_face_areas[lev],
+                                                        'H',
+                                                        lev);
+           }
+        }
 
-    if (M_ext_grid_s == "parse_m_ext_grid_function") {
+        if (M_ext_grid_s == "parse_m_ext_grid_function") {
 #ifdef WARPX_DIM_RZ
-        amrex::Abort("M-field parser for external fields does not work with RZ");
+            amrex::Abort("M-field parser for external fields does not work with RZ");
 #endif
-        Store_parserString(pp_warpx, "Mx_external_grid_function(x,y,z)",
-                                                    str_Mx_ext_grid_function);
-        Store_parserString(pp_warpx, "My_external_grid_function(x,y,z)",
-                                                    str_My_ext_grid_function);
-        Store_parserString(pp_warpx, "Mz_external_grid_function(x,y,z)",
-                                                    str_Mz_ext_grid_function);
-
-        Mxfield_parser = std::make_unique<amrex::Parser>(
-                                 makeParser(str_Mx_ext_grid_function,{"x","y","z"}));
-        Myfield_parser = std::make_unique<amrex::Parser>(
-                                 makeParser(str_My_ext_grid_function,{"x","y","z"}));
-        Mzfield_parser = std::make_unique<amrex::Parser>(
-                                 makeParser(str_Mz_ext_grid_function,{"x","y","z"}));
-
-       // Initialize Mfield_fp with external function directly on the faces
-       InitializeExternalFieldsOnGridUsingParser(Mfield_fp[lev][0].get(),
-                                                 Mfield_fp[lev][1].get(),
-                                                 Mfield_fp[lev][2].get(),
-                                                 Mxfield_parser->compile<3>(),
-                                                 Myfield_parser->compile<3>(),
-                                                 Mzfield_parser->compile<3>(),
-                                                 m_edge_lengths[lev],
-                                                 m_face_areas[lev],
-                                                 'M',
-                                                 lev);
-       if (lev > 0) {
-          InitializeExternalFieldsOnGridUsingParser(Mfield_aux[lev][0].get(),
-                                                    Mfield_aux[lev][1].get(),
-                                                    Mfield_aux[lev][2].get(),
-                                                    Mxfield_parser->compile<3>(),
-                                                    Myfield_parser->compile<3>(),
-                                                    Mzfield_parser->compile<3>(),
-                                                    m_edge_lengths[lev],
-                                                    m_face_areas[lev],
-                                                    'M',
-                                                    lev);
+            Store_parserString(pp_warpx, "Mx_external_grid_function(x,y,z)",
+                                                        str_Mx_ext_grid_function);
+            Store_parserString(pp_warpx, "My_external_grid_function(x,y,z)",
+                                                        str_My_ext_grid_function);
+            Store_parserString(pp_warpx, "Mz_external_grid_function(x,y,z)",
+                                                        str_Mz_ext_grid_function);
+
+            Mxfield_parser = std::make_unique<amrex::Parser>(
+                                     makeParser(str_Mx_ext_grid_function,{"x","y","z"}));
+            Myfield_parser = std::make_unique<amrex::Parser>(
+                                     makeParser(str_My_ext_grid_function,{"x","y","z"}));
+            Mzfield_parser = std::make_unique<amrex::Parser>(
+                                     makeParser(str_Mz_ext_grid_function,{"x","y","z"}));
+
+           // Initialize Mfield_fp with external function directly on the faces
+           InitializeExternalFieldsOnGridUsingParser(Mfield_fp[lev][0].get(),
+                                                     Mfield_fp[lev][1].get(),
+                                                     Mfield_fp[lev][2].get(),
+                                                     Mxfield_parser->compile<3>(),
+                                                     Myfield_parser->compile<3>(),
+                                                     Mzfield_parser->compile<3>(),
+                                                     m_edge_lengths[lev],
+                                                     m_face_areas[lev],
+                                                     'M',
+                                                     lev);
+           if (lev > 0) {
+              InitializeExternalFieldsOnGridUsingParser(Mfield_cp[lev][0].get(),
+                                                        Mfield_cp[lev][1].get(),
+                                                        Mfield_cp[lev][2].get(),
+                                                        Mxfield_parser->compile<3>(),
+                                                        Myfield_parser->compile<3>(),
+                                                        Mzfield_parser->compile<3>(),
+                                                        m_edge_lengths[lev],
+                                                        m_face_areas[lev],
+                                                        'M',
+                                                        lev);
+           }
+        }
 
-          InitializeExternalFieldsOnGridUsingParser(Mfield_cp[lev][0].get(),
-                                                    Mfield_cp[lev][1].get(),
-                                                    Mfield_cp[lev][2].get(),
-                                                    Mxfield_parser->compile<3>(),
-                                                    Myfield_parser->compile<3>(),
-                                                    Mzfield_parser->compile<3>(),
-                                                    m_edge_lengths[lev],
-                                                    m_face_areas[lev],
-                                                    'M',
-                                                    lev);
-       }
     }
-
 #endif //closes #ifdef WARPX_MAG_LLG
 
     if (F_fp[lev]) {
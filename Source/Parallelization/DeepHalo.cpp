@@ -0,0 +1,170 @@
+/* Copyright 2022 The WarpX Community
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "DeepHalo.H"
+
+#include "Utils/TextMsg.H"
+
+#include <AMReX.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace amrex::literals;
+
+void
+DeepHalo::Init (int n_steps, bool llg, int n_hm_updates, int m_reach)
+{
+    m_n_steps = n_steps;
+    m_llg = llg;
+    m_m_reach = m_reach;
+    m_halo = 0;
+    m_w = Widths{};
+    if (!enabled()) return;
+
+    // The widths decrease by the same amounts whatever they start from: run the updates of
+    // n_steps time steps from a zero halo, the halo is then the opposite of the lowest region
+    Widths w;
+    int lowest = 0;
+    auto advance = [&] (Update u) {
+        int region = 0;
+        w = Advance(w, u, region);
+        lowest = std::min(lowest, region);
+    };
+    for (int step = 0; step < n_steps; ++step) {
+        if (llg) {
+            for (int i = 0; i < n_hm_updates; ++i) advance(Update::HM);
+            advance(Update::E);
+            for (int i = 0; i < n_hm_updates; ++i) advance(Update::HM);
+        } else {
+            advance(Update::B);
+            advance(Update::E);
+            advance(Update::B);
+        }
+    }
+    m_halo = -lowest;
+}
+
+DeepHalo::Widths
+DeepHalo::Advance (Widths w, Update u, int& region) const
+{
+    switch (u) {
+    case Update::B:
+        // curl E
+        w.B = std::min(w.E - 1, w.B);
+        region = w.B;
+        break;
+    case Update::E:
+        // curl B, or curl H with the LLG model
+        w.E = std::min((m_llg ? w.H : w.B) - 1, w.E);
+        region = w.E;
+        break;
+    case Update::HM:
+        // M from the face averages of H and the exchange stencil of M, then H from curl E
+        // and M on the same region; B = mu0 (H + M) follows H
+        w.M = std::min(w.H - 1, w.M - m_m_reach);
+        w.H = std::min({w.E - 1, w.M, w.H});
+        w.M = w.H;
+        w.B = w.H;
+        region = w.H;
+        break;
+    }
+    return w;
+}
+
+bool
+DeepHalo::NeedsExchange (Update u) const
+{
+    int region = 0;
+    Advance(m_w, u, region);
+    return region < 0;
+}
+
+void
+DeepHalo::Exchanged (amrex::Real exchange_time)
+{
+    m_w.E = m_halo;
+    m_w.B = m_halo;
+    m_w.H = m_halo;
+    m_w.M = m_halo;
+    ++m_n_exchanges;
+    m_exchange_time += exchange_time;
+}
+
+int
+DeepHalo::BeginUpdate (Update u)
+{
+    int region = 0;
+    m_w = Advance(m_w, u, region);
+    AMREX_ALWAYS_ASSERT(region >= 0);
+    m_update_start = amrex::second();
+    return region;
+}
+
+void
+DeepHalo::EndUpdate ()
+{
+    amrex::Gpu::synchronize();
+    m_update_time += amrex::second() - m_update_start;
+}
+
+void
+DeepHalo::RecordCells (amrex::Long n_valid, amrex::Long n_updated)
+{
+    m_n_cells_valid += n_valid;
+    m_n_cells_updated += n_updated;
+}
+
+bool
+DeepHalo::SkipsExchange (int n_fields)
+{
+    if (!enabled()) return false;
+    m_n_skipped += n_fields;
+    return true;
+}
+
+void
+DeepHalo::PrintReport () const
+{
+    if (!enabled()) return;
+
+    amrex::Real exchange_time = m_exchange_time;
+    amrex::Real update_time = m_update_time;
+    amrex::ParallelDescriptor::ReduceRealMax(exchange_time);
+    amrex::ParallelDescriptor::ReduceRealMax(update_time);
+
+    // number of vector fields exchanged together: E and B, or E, H and M
+    amrex::Long const n_deep = static_cast<amrex::Long>(m_n_exchanges) * (m_llg ? 3 : 2);
+    amrex::Real const redundancy = (m_n_cells_valid > 0) ?
+        static_cast<amrex::Real>(m_n_cells_updated) / static_cast<amrex::Real>(m_n_cells_valid) : 1._rt;
+
+    // The default time loop updates the valid cells only, and does the skipped exchanges of a
+    // few guard cells. These are estimated to cost as much as the exchanges of the whole halo,
+    // which holds for latency-bound exchanges: the estimate is an upper bound otherwise
+    amrex::Real const exchange_cost = (n_deep > 0) ? exchange_time / static_cast<amrex::Real>(n_deep) : 0._rt;
+    amrex::Real const default_time = update_time / redundancy
+                                     + static_cast<amrex::Real>(m_n_skipped) * exchange_cost;
+    amrex::Real const deep_time = update_time + exchange_time;
+
+    std::stringstream ss;
+    ss << std::setprecision(3)
+       << "Deep halo: " << m_halo << " guard cells exchanged every "
+       << m_n_steps << " steps (" << m_n_exchanges << " exchanges)\n"
+       << "  field exchanges: " << n_deep << " instead of " << m_n_skipped;
+    if (n_deep > 0) ss << " (" << static_cast<amrex::Real>(m_n_skipped) / static_cast<amrex::Real>(n_deep) << "x fewer)";
+    ss << "\n  cells updated: " << redundancy << "x the valid cells\n"
+       << "  time in field updates: " << update_time << " s, in exchanges: " << exchange_time << " s\n";
+    if (deep_time > 0._rt) {
+        ss << "  estimated speedup of the field solve (latency-bound exchanges): "
+           << default_time / deep_time << "x";
+    }
+    amrex::Print() << Utils::TextMsg::Info(ss.str());
+}
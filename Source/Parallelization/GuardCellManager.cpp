@@ -19,6 +19,7 @@
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXUtil.H"
+#include "WarpX.H"
 
 #include <AMReX_Config.H>
 #include <AMReX_INT.H>
@@ -55,9 +56,6 @@ guardCellManager::Init (
     const int pml_ncell,
     const amrex::Vector<amrex::IntVect>& ref_ratios)
 {
-#ifdef WARPX_MAG_LLG
-    amrex::ignore_unused(do_multi_J, fft_do_time_averaging);
-#endif
     // When using subcycling, the particles on the fine level perform two pushes
     // before being redistributed ; therefore, we need one extra guard cell
     // (the particles may move by 2*c*dt)
@@ -136,8 +134,9 @@ guardCellManager::Init (
     // Electromagnetic simulations: account for change in particle positions within half a time step
     // for current deposition and within one time step for charge deposition (since rho is needed
     // both at the beginning and at the end of the PIC iteration)
-#ifndef WARPX_MAG_LLG
-    if (do_electrostatic == ElectrostaticSolverAlgo::None)
+    // The LLG model does not account for particle motion in the guard cells
+    if (do_electrostatic == ElectrostaticSolverAlgo::None &&
+        WarpX::magnetic_model != MagneticModel::LLG)
     {
         for (int i = 0; i < AMREX_SPACEDIM; i++)
         {
@@ -159,9 +158,6 @@ guardCellManager::Init (
             ng_alloc_J[i]   += static_cast<int>(std::ceil(PhysConst::c * dt_J / dx[i]));
         }
     }
-#else
-    amrex::ignore_unused(do_electrostatic, dt, dx);
-#endif
     // Number of guard cells for local deposition of J and rho
     ng_depos_J   = ng_alloc_J;
     ng_depos_rho = ng_alloc_Rho;
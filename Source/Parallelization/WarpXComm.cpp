@@ -12,6 +12,7 @@
 #if (defined WARPX_DIM_RZ) && (defined WARPX_USE_PSATD)
 #   include "BoundaryConditions/PML_RZ.H"
 #endif
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
 #include "Filter/BilinearFilter.H"
 #include "Utils/CoarsenMR.H"
 #include "Utils/IntervalsParser.H"
@@ -40,6 +41,7 @@
 #include <AMReX_MakeType.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_REAL.H>
+#include <AMReX_Utility.H>
 #include <AMReX_Vector.H>
 
 #include <algorithm>
@@ -717,7 +719,8 @@ WarpX::FillBoundaryM (int lev, PatchType patch_type, IntVect ng)
         // ExchangeM not needed for PML algorithm
     }
 
-    // Fill guard cells in valid domain
+    // Fill guard cells in valid domain; M is only stored on the magnetic boxes (see CompactMfield),
+    // so only these exchange their guard cells
     for (int i = 0; i < 3; ++i)
     {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
@@ -788,6 +791,60 @@ WarpX::FillBoundaryH (int lev, PatchType patch_type, IntVect ng)
     }
 
 }
+
+void
+WarpX::ExchangeHPML (int lev)
+{
+    // Exchange data between valid domain and PML
+    // Fill guard cells in PML
+    if (do_pml)
+    {
+        if (pml[lev] && pml[lev]->ok())
+        {
+            std::array<amrex::MultiFab*,3> mf = {Hfield_fp[lev][0].get(), Hfield_fp[lev][1].get(), Hfield_fp[lev][2].get()};
+            pml[lev]->Exchange(pml[lev]->GetH_fp(), mf, PatchType::fine, do_pml_in_domain);
+            pml[lev]->FillBoundaryH(PatchType::fine);
+        }
+    }
+}
+
+void
+WarpX::FillBoundaryH_nowait (int lev, IntVect ng)
+{
+    if (lev > 0) FillBoundaryH(lev, PatchType::coarse, ng);
+
+    std::array<amrex::MultiFab*,3> mf = {Hfield_fp[lev][0].get(), Hfield_fp[lev][1].get(), Hfield_fp[lev][2].get()};
+    const amrex::Periodicity period = Geom(lev).periodicity();
+
+    ExchangeHPML(lev);
+
+    // Start filling the guard cells in valid domain
+    for (int i = 0; i < 3; ++i)
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            ng <= mf[i]->nGrowVect(),
+            "Error: in FillBoundaryH_nowait, requested more guard cells than allocated");
+
+        const amrex::IntVect nghost = (safe_guard_cells) ? mf[i]->nGrowVect() : ng;
+        // the single-precision exchange goes through a temporary MultiFab, and is not left in flight
+        if (do_single_precision_comms) {
+            WarpXCommUtil::FillBoundary(*mf[i], nghost, period);
+        } else {
+            mf[i]->FillBoundary_nowait(0, mf[i]->nComp(), nghost, period);
+        }
+    }
+}
+
+void
+WarpX::FillBoundaryH_finish (int lev)
+{
+    if (do_single_precision_comms) return;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        Hfield_fp[lev][i]->FillBoundary_finish();
+    }
+}
 #endif
 
 void
@@ -1001,10 +1058,64 @@ WarpX::FillBoundaryAux (int lev, IntVect ng)
     WarpXCommUtil::FillBoundary(*Bfield_aux[lev][1], ng, period);
     WarpXCommUtil::FillBoundary(*Bfield_aux[lev][2], ng, period);
 #ifdef WARPX_MAG_LLG
-    WarpXCommUtil::FillBoundary(*Mfield_aux[lev][0], ng, period);
-    WarpXCommUtil::FillBoundary(*Mfield_aux[lev][1], ng, period);
-    WarpXCommUtil::FillBoundary(*Mfield_aux[lev][2], ng, period);
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        WarpXCommUtil::FillBoundary(*Mfield_aux[lev][0], ng, period);
+        WarpXCommUtil::FillBoundary(*Mfield_aux[lev][1], ng, period);
+        WarpXCommUtil::FillBoundary(*Mfield_aux[lev][2], ng, period);
+    }
+#endif
+}
+
+void
+WarpX::DeepHaloExchange ()
+{
+    WARPX_PROFILE("WarpX::DeepHaloExchange()");
+
+    amrex::Real const t_start = amrex::second();
+    const amrex::IntVect ng(m_deep_halo.halo());
+    FillBoundaryE(ng);
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+#ifdef WARPX_MAG_LLG
+        FillBoundaryH(ng);
+        FillBoundaryM(ng);
 #endif
+    } else {
+        FillBoundaryB(ng);
+    }
+    m_deep_halo.Exchanged(amrex::second() - t_start);
+}
+
+void
+WarpX::DeepHaloBeginUpdate (int lev, DeepHalo::Update u)
+{
+    if (!m_deep_halo.enabled()) return;
+
+    if (m_deep_halo.NeedsExchange(u)) DeepHaloExchange();
+    const int ng = m_deep_halo.BeginUpdate(u);
+
+    // The guard cells outside of the domain are left to the boundary conditions,
+    // except across the periodic boundaries
+    amrex::Box domain = Geom(lev).Domain();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (Geom(lev).isPeriodic(idim)) domain.grow(idim, ng);
+    }
+    m_fdtd_solver_fp[lev]->SetUpdateGuardCells(amrex::IntVect(ng), domain);
+
+    const amrex::BoxArray& ba = boxArray(lev);
+    amrex::Long n_updated = 0;
+    for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+        n_updated += (amrex::grow(ba[i], ng) & domain).numPts();
+    }
+    m_deep_halo.RecordCells(ba.numPts(), n_updated);
+}
+
+void
+WarpX::DeepHaloEndUpdate (int lev)
+{
+    if (!m_deep_halo.enabled()) return;
+
+    m_fdtd_solver_fp[lev]->SetUpdateGuardCells(amrex::IntVect(0), Geom(lev).Domain());
+    m_deep_halo.EndUpdate();
 }
 
 void
@@ -10,6 +10,10 @@
 
 #include "Diagnostics/MultiDiagnostics.H"
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
+#include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
+#include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#include "FieldSolver/London/London.H"
+#include "Parallelization/WarpXCommUtil.H"
 #include "Particles/MultiParticleContainer.H"
 #include "Particles/ParticleBoundaryBuffer.H"
 #include "Particles/WarpXParticleContainer.H"
@@ -45,6 +49,7 @@
 #include <vector>
 
 using namespace amrex;
+using WarpXCommUtil::RemakeMultiFab;
 
 void
 WarpX::LoadBalance ()
@@ -144,17 +149,6 @@ WarpX::LoadBalance ()
 }
 
 
-template <typename MultiFabType> void
-RemakeMultiFab (std::unique_ptr<MultiFabType>& mf, const DistributionMapping& dm,
-                const bool redistribute)
-{
-    if (mf == nullptr) return;
-    const IntVect& ng = mf->nGrowVect();
-    auto pmf = std::make_unique<MultiFabType>(mf->boxArray(), dm, mf->nComp(), ng);
-    if (redistribute) pmf->Redistribute(*mf, 0, 0, mf->nComp(), ng);
-    mf = std::move(pmf);
-}
-
 void
 WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const DistributionMapping& dm)
 {
@@ -162,13 +156,32 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
     {
         if (ParallelDescriptor::NProcs() == 1) return;
 
+        // The cached excitation flags are evaluated again on the new distribution mapping
+        // at the next call to ApplyExternalFieldExcitationOnGrid
+        m_excitation_flags[lev].clear();
+
+        // The guard cells of the deep halo are exchanged again before the next field update
+        m_deep_halo.Invalidate();
+
+        // With the London model, J and B_sc are part of the state of the superconductor
+        const bool london = (yee_coupled_solver_algo == CoupledYeeSolver::MaxwellLondon);
+
         // Fine patch
         for (int idim=0; idim < 3; ++idim)
         {
             RemakeMultiFab(Bfield_fp[lev][idim], dm, true);
             RemakeMultiFab(Efield_fp[lev][idim], dm, true);
-            RemakeMultiFab(current_fp[lev][idim], dm, false);
+            RemakeMultiFab(current_fp[lev][idim], dm, london);
             RemakeMultiFab(current_store[lev][idim], dm, false);
+            RemakeMultiFab(Bfield_sc_fp[lev][idim], dm, london);
+#ifdef WARPX_MAG_LLG
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                // M only covers the magnetic boxes, which follow the boxes of the level they come from
+                RemakeMultiFab(Mfield_fp[lev][idim], MagneticDistributionMap(lev, dm), true);
+                RemakeMultiFab(Hfield_fp[lev][idim], dm, true);
+                RemakeMultiFab(H_biasfield_fp[lev][idim], dm, true);
+            }
+#endif
 
 #ifdef AMREX_USE_EB
             if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::Yee ||
@@ -255,6 +268,32 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
                 RemakeMultiFab(Efield_aux[lev][idim], dm, false);
             }
         }
+#ifdef WARPX_MAG_LLG
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            // M and H_bias aux are always aliases of fp; H aux is one at level 0 unless it is
+            // nodal or the fields are time-averaged (in which case it may not be allocated)
+            const bool H_aux_is_alias = lev == 0 && !WarpX::fft_do_time_averaging &&
+                Hfield_aux[lev][0] != nullptr && Hfield_aux[lev][0]->ixType() == Hfield_fp[lev][0]->ixType();
+            for (int idim = 0; idim < 3; ++idim) {
+                Mfield_aux[lev][idim] = std::make_unique<MultiFab>(*Mfield_fp[lev][idim], amrex::make_alias, 0, Mfield_fp[lev][idim]->nComp());
+                H_biasfield_aux[lev][idim] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][idim], amrex::make_alias, 0, H_biasfield_fp[lev][idim]->nComp());
+                if (H_aux_is_alias) {
+                    Hfield_aux[lev][idim] = std::make_unique<MultiFab>(*Hfield_fp[lev][idim], amrex::make_alias, 0, Hfield_fp[lev][idim]->nComp());
+                } else {
+                    RemakeMultiFab(Hfield_aux[lev][idim], dm, false);
+                }
+            }
+        }
+#endif
+
+        // The material properties and the superconductor only exist on level 0; the London
+        // solver reads mu and the layout of J, so it is remade after both
+        if (lev == 0 && m_macroscopic_properties) {
+            m_macroscopic_properties->RemakeLevel(dm);
+        }
+        if (lev == 0 && m_london) {
+            m_london->RemakeLevel(dm);
+        }
 
         // Coarse patch
         if (lev > 0) {
@@ -263,6 +302,11 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
                 RemakeMultiFab(Bfield_cp[lev][idim], dm, true);
                 RemakeMultiFab(Efield_cp[lev][idim], dm, true);
                 RemakeMultiFab(current_cp[lev][idim], dm, false);
+#ifdef WARPX_MAG_LLG
+                RemakeMultiFab(Mfield_cp[lev][idim], dm, true);
+                RemakeMultiFab(Hfield_cp[lev][idim], dm, true);
+                RemakeMultiFab(H_biasfield_cp[lev][idim], dm, true);
+#endif
             }
             RemakeMultiFab(F_cp[lev], dm, true);
             RemakeMultiFab(rho_cp[lev], dm, false);
@@ -308,6 +352,11 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
                 RemakeMultiFab(Bfield_cax[lev][idim], dm, false);
                 RemakeMultiFab(Efield_cax[lev][idim], dm, false);
                 RemakeMultiFab(current_buf[lev][idim], dm, false);
+#ifdef WARPX_MAG_LLG
+                RemakeMultiFab(Mfield_cax[lev][idim], dm, false);
+                RemakeMultiFab(Hfield_cax[lev][idim], dm, false);
+                RemakeMultiFab(H_biasfield_cax[lev][idim], dm, false);
+#endif
             }
             RemakeMultiFab(charge_buf[lev], dm, false);
             // we can avoid redistributing these since we immediately re-build the values via BuildBufferMasks()
@@ -370,6 +419,30 @@ WarpX::ComputeCostsHeuristic (amrex::Vector<std::unique_ptr<amrex::LayoutData<am
             const Box& gbx = mfi.growntilebox();
             (*a_costs[lev])[mfi.index()] += costs_heuristic_cells_wt*gbx.numPts();
         }
+
+        if (lev > 0) continue;
+        // Magnetic faces and superconducting edges, which only exist on level 0
+#if defined(WARPX_MAG_LLG) && !defined(WARPX_DIM_RZ)
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            const Real n_solves = 2._rt*mag_substeps;
+            for (MFIter mfi(*Ex, false); mfi.isValid(); ++mfi)
+            {
+                if (!m_macroscopic_properties->is_magnetic_box(mfi)) continue;
+                // before the first LLG solve, each magnetic face is assumed to be updated once per solve
+                Real updates = m_fdtd_solver_fp[lev]->LLGBoxUpdatesPerSolve(mfi.index());
+                if (updates < 0._rt) updates = 1._rt;
+                (*a_costs[lev])[mfi.index()] += costs_heuristic_magnetic_wt*n_solves*updates
+                                                *m_macroscopic_properties->NumMagneticFaces(mfi);
+            }
+        }
+#endif
+        if (m_london) {
+            for (MFIter mfi(*Ex, false); mfi.isValid(); ++mfi)
+            {
+                (*a_costs[lev])[mfi.index()] += costs_heuristic_superconductor_wt
+                                                *m_london->NumSuperconductingEdges(mfi.index());
+            }
+        }
     }
 }
 
@@ -385,4 +458,10 @@ WarpX::ResetCosts ()
             (*costs[lev])[i] = 0.0;
         }
     }
+#if defined(WARPX_MAG_LLG) && !defined(WARPX_DIM_RZ)
+    // The LLG iteration counts of the cost model are measured again until the next load balance
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        m_fdtd_solver_fp[0]->ResetLLGBoxUpdates();
+    }
+#endif
 }
@@ -117,6 +117,16 @@ const std::map<std::string, int> CoupledYeeSolver_algo_to_int = {
     {"default", CoupledYeeSolver::None}
 };
 
+const std::map<std::string, int> MagneticModel_algo_to_int = {
+    {"none", MagneticModel::None},
+    {"llg", MagneticModel::LLG},
+#ifdef WARPX_MAG_LLG
+    {"default", MagneticModel::LLG}
+#else
+    {"default", MagneticModel::None}
+#endif
+};
+
 int
 GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
 
@@ -154,6 +164,11 @@ GetAlgorithmInteger( amrex::ParmParse& pp, const char* pp_search_key ){
         algo_to_int = IntegrationType_algo_to_int;
     } else if (0 == std::strcmp(pp_search_key, "yee_coupled_solver")) {
         algo_to_int = CoupledYeeSolver_algo_to_int;
+    } else if (0 == std::strcmp(pp_search_key, "magnetic_model")) {
+        algo_to_int = MagneticModel_algo_to_int;
+        // LLG is only meaningful in a macroscopic medium
+        if (WarpX::em_solver_medium != MediumForEM::Macroscopic)
+            algo_to_int["default"] = MagneticModel::None;
     } else {
         std::string pp_search_string = pp_search_key;
         amrex::Abort("Unknown algorithm type: " + pp_search_string);
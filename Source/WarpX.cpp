@@ -17,6 +17,9 @@
 #include "Diagnostics/ReducedDiags/MultiReducedDiags.H"
 #include "FieldSolver/FiniteDifferenceSolver/FiniteDifferenceSolver.H"
 #include "FieldSolver/FiniteDifferenceSolver/MacroscopicProperties/MacroscopicProperties.H"
+#if defined(WARPX_MAG_LLG) && defined(WARPX_USE_PSATD)
+#   include "FieldSolver/Demagnetization/Demagnetization.H"
+#endif
 #ifdef WARPX_USE_PSATD
 #   include "FieldSolver/SpectralSolver/SpectralKSpace.H"
 #   ifdef WARPX_DIM_RZ
@@ -201,6 +204,7 @@ amrex::Vector<int> WarpX::field_boundary_hi(AMREX_SPACEDIM,0);
 amrex::Vector<ParticleBoundaryType> WarpX::particle_boundary_lo(AMREX_SPACEDIM,ParticleBoundaryType::Absorbing);
 amrex::Vector<ParticleBoundaryType> WarpX::particle_boundary_hi(AMREX_SPACEDIM,ParticleBoundaryType::Absorbing);
 int WarpX::yee_coupled_solver_algo;
+int WarpX::magnetic_model;
 
 bool WarpX::do_current_centering = false;
 
@@ -369,6 +373,8 @@ WarpX::WarpX ()
     Bfield_sc_fp.resize(nlevs_max);
 #ifdef WARPX_MAG_LLG
     Mfield_fp.resize(nlevs_max);
+    m_mag_box_index.resize(nlevs_max);
+    m_mag_boxes.resize(nlevs_max);
     Hfield_fp.resize(nlevs_max);
     H_biasfield_fp.resize(nlevs_max);
 #endif
@@ -380,6 +386,7 @@ WarpX::WarpX ()
     m_distance_to_eb.resize(nlevs_max);
     m_flag_info_face.resize(nlevs_max);
     m_flag_ext_face.resize(nlevs_max);
+    m_excitation_flags.resize(nlevs_max);
     m_borrowing.resize(nlevs_max);
     m_area_mod.resize(nlevs_max);
 
@@ -446,6 +453,12 @@ WarpX::WarpX ()
         m_london = std::make_unique<London>();
     }
 
+#if defined(WARPX_MAG_LLG) && defined(WARPX_USE_PSATD)
+    if (magnetic_model == MagneticModel::LLG && mag_LLG_demag_coupling == 1) {
+        m_demag = std::make_unique<Demagnetization>();
+    }
+#endif
+
     // Set default values for particle and cell weights for costs update;
     // Default values listed here for the case AMREX_USE_GPU are determined
     // from single-GPU tests on Summit.
@@ -491,6 +504,9 @@ WarpX::WarpX ()
         costs_heuristic_particles_wt = 0.9_rt;
 #endif // AMREX_USE_GPU
     }
+    // By default, updating a magnetic face or a superconducting edge costs as much as a cell
+    if (costs_heuristic_magnetic_wt < 0.) costs_heuristic_magnetic_wt = costs_heuristic_cells_wt;
+    if (costs_heuristic_superconductor_wt < 0.) costs_heuristic_superconductor_wt = costs_heuristic_cells_wt;
 
     // Allocate field solver objects
 #ifdef WARPX_USE_PSATD
@@ -1007,23 +1023,6 @@ WarpX::ReadParameters ()
             );
         }
 
-#ifdef WARPX_MAG_LLG
-        // Read the value of the time advancement scheme of M field
-        pp_warpx.query("mag_time_scheme_order", mag_time_scheme_order);
-        // turn on LLG + Maxwell coupling
-        pp_warpx.query("mag_LLG_coupling",mag_LLG_coupling);
-        // magnetization M magnitude normalization strategy
-        pp_warpx.get("mag_M_normalization", mag_M_normalization);
-        if (mag_M_normalization < 0){
-            printf("mag_M_normalization = %d \n", mag_M_normalization);
-            amrex::Abort("Caution: mag_M_normalization must be a non-negative number !");
-        }
-        // turn on the exchange coupling term H_exchange for H_eff in the LLG equation
-        pp_warpx.query("mag_LLG_exchange_coupling",mag_LLG_exchange_coupling);
-        // turn on the anisotropy coupling term H_anisotropy for H_eff in the LLG equation
-        pp_warpx.query("mag_LLG_anisotropy_coupling",mag_LLG_anisotropy_coupling);
-#endif
-
 #ifdef WARPX_DIM_RZ
         WARPX_ALWAYS_ASSERT_WITH_MESSAGE( isAnyBoundaryPML() == false || maxwell_solver_id == MaxwellSolverAlgo::PSATD,
             "PML are not implemented in RZ geometry with FDTD; please set a different boundary condition using boundary.field_lo and boundary.field_hi.");
@@ -1158,11 +1157,70 @@ WarpX::ReadParameters ()
         if (em_solver_medium == MediumForEM::Macroscopic ) {
             macroscopic_solver_algo = GetAlgorithmInteger(pp_algo,"macroscopic_sigma_method");
         }
+        yee_coupled_solver_algo = GetAlgorithmInteger(pp_algo, "yee_coupled_solver");
+
+        // The magnetic model is read after the medium, since its default depends on it
+        magnetic_model = GetAlgorithmInteger(pp_algo, "magnetic_model");
+        if (magnetic_model == MagneticModel::LLG) {
+#ifndef WARPX_MAG_LLG
+            amrex::Abort(Utils::TextMsg::Err(
+                "algo.magnetic_model = llg requires WarpX to be compiled with USE_LLG=TRUE"));
+#endif
+#ifdef WARPX_DIM_RZ
+            amrex::Abort(Utils::TextMsg::Err("algo.magnetic_model = llg is not implemented in RZ geometry"));
+#endif
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(em_solver_medium == MediumForEM::Macroscopic,
+                "algo.magnetic_model = llg requires algo.em_solver_medium = macroscopic");
+            // the macroscopic properties, H and M are only evolved on level 0
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(max_level == 0,
+                "algo.magnetic_model = llg is not implemented with mesh refinement (amr.max_level > 0)");
+#ifdef WARPX_MAG_LLG
+            ParmParse pp_warpx("warpx");
+            // Read the value of the time advancement scheme of M field
+            pp_warpx.query("mag_time_scheme_order", mag_time_scheme_order);
+            // Number of LLG substeps per half Maxwell step
+            pp_warpx.query("mag_substeps", mag_substeps);
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(mag_substeps >= 1,
+                "warpx.mag_substeps must be a positive integer");
+            // turn on LLG + Maxwell coupling
+            pp_warpx.query("mag_LLG_coupling",mag_LLG_coupling);
+            // magnetization M magnitude normalization strategy
+            pp_warpx.get("mag_M_normalization", mag_M_normalization);
+            if (mag_M_normalization < 0){
+                printf("mag_M_normalization = %d \n", mag_M_normalization);
+                amrex::Abort("Caution: mag_M_normalization must be a non-negative number !");
+            }
+            // turn on the exchange coupling term H_exchange for H_eff in the LLG equation
+            pp_warpx.query("mag_LLG_exchange_coupling",mag_LLG_exchange_coupling);
+            // turn on the anisotropy coupling term H_anisotropy for H_eff in the LLG equation
+            pp_warpx.query("mag_LLG_anisotropy_coupling",mag_LLG_anisotropy_coupling);
+            // B is only needed by the particles and the diagnostics in LLG runs
+            pp_warpx.query("mag_LLG_maintain_B", mag_LLG_maintain_B);
+            if (!mag_LLG_maintain_B) {
+                ParmParse pp_particles("particles");
+                std::vector<std::string> species_names;
+                pp_particles.queryarr("species_names", species_names);
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(species_names.empty(),
+                    "warpx.mag_LLG_maintain_B = 0 cannot be used with particles, which gather B");
+            }
+            // turn on the demagnetizing field term H_demag for H_eff in the LLG equation
+            pp_warpx.query("mag_LLG_demag_coupling", mag_LLG_demag_coupling);
+            if (mag_LLG_demag_coupling == 1) {
+#if !defined(WARPX_USE_PSATD) || !defined(WARPX_DIM_3D)
+                amrex::Abort(Utils::TextMsg::Err(
+                    "warpx.mag_LLG_demag_coupling = 1 requires a 3D build with USE_PSATD=TRUE, for the FFTs"));
+#endif
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(mag_LLG_coupling == 0,
+                    "warpx.mag_LLG_demag_coupling = 1 requires warpx.mag_LLG_coupling = 0, "
+                    "since the Maxwell H already contains the field of M");
+                pp_warpx.query("mag_LLG_demag_every_iteration", mag_LLG_demag_every_iteration);
+            }
+#endif
+        }
+
         // Read field excitation flags and parsers
         ReadExcitationParser();
 
-        yee_coupled_solver_algo = GetAlgorithmInteger(pp_algo, "yee_coupled_solver");
-
         // Load balancing parameters
         std::vector<std::string> load_balance_intervals_string_vec = {"0"};
         pp_algo.queryarr("load_balance_intervals", load_balance_intervals_string_vec);
@@ -1174,6 +1232,8 @@ WarpX::ReadParameters ()
         load_balance_costs_update_algo = GetAlgorithmInteger(pp_algo, "load_balance_costs_update");
         queryWithParser(pp_algo, "costs_heuristic_cells_wt", costs_heuristic_cells_wt);
         queryWithParser(pp_algo, "costs_heuristic_particles_wt", costs_heuristic_particles_wt);
+        queryWithParser(pp_algo, "costs_heuristic_magnetic_wt", costs_heuristic_magnetic_wt);
+        queryWithParser(pp_algo, "costs_heuristic_superconductor_wt", costs_heuristic_superconductor_wt);
 
         // Parse algo.particle_shape and check that input is acceptable
         // (do this only if there is at least one particle or laser species)
@@ -1232,6 +1292,47 @@ WarpX::ReadParameters ()
             for (int i=0; i<AMREX_SPACEDIM; i++)
                 sort_bin_size[i] = vect_sort_bin_size[i];
         }
+
+        // Communication-avoiding deep-halo mode of the field solve
+        queryWithParser(pp_warpx, "deep_halo_steps", deep_halo_steps);
+        WARPX_ALWAYS_ASSERT_WITH_MESSAGE(deep_halo_steps >= 1,
+            "warpx.deep_halo_steps must be a positive integer");
+        if (deep_halo_steps > 1) {
+#ifdef WARPX_DIM_RZ
+            amrex::Abort(Utils::TextMsg::Err("warpx.deep_halo_steps > 1 is not implemented in RZ geometry"));
+#endif
+#ifdef AMREX_USE_EB
+            amrex::Abort(Utils::TextMsg::Err("warpx.deep_halo_steps > 1 is not implemented with embedded boundaries"));
+#endif
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                maxwell_solver_id == MaxwellSolverAlgo::Yee && !do_nodal,
+                "warpx.deep_halo_steps > 1 requires algo.maxwell_solver = yee on a staggered grid");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                do_electrostatic == ElectrostaticSolverAlgo::None,
+                "warpx.deep_halo_steps > 1 is not implemented with the electrostatic solvers");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(maxLevel() == 0,
+                "warpx.deep_halo_steps > 1 is not implemented with mesh refinement");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!isAnyBoundaryPML() && !do_moving_window,
+                "warpx.deep_halo_steps > 1 is not implemented with PML boundaries or a moving window");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(!do_dive_cleaning && !do_divb_cleaning,
+                "warpx.deep_halo_steps > 1 is not implemented with divergence cleaning");
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(
+                yee_coupled_solver_algo != CoupledYeeSolver::MaxwellLondon,
+                "warpx.deep_halo_steps > 1 is not implemented with algo.yee_coupled_solver = maxwelllondon");
+            // the particles gather and deposit in the guard cells at every step
+            WARPX_ALWAYS_ASSERT_WITH_MESSAGE(species_names.empty() && lasers_names.empty(),
+                "warpx.deep_halo_steps > 1 is not implemented with particles or lasers");
+#ifdef WARPX_MAG_LLG
+            if (magnetic_model == MagneticModel::LLG) {
+                // the iterations of the 2nd-order scheme and the demagnetizing field exchange
+                // the guard cells of H and M at each iteration
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(mag_time_scheme_order == 1,
+                    "warpx.deep_halo_steps > 1 requires warpx.mag_time_scheme_order = 1");
+                WARPX_ALWAYS_ASSERT_WITH_MESSAGE(mag_LLG_demag_coupling == 0,
+                    "warpx.deep_halo_steps > 1 is not implemented with warpx.mag_LLG_demag_coupling = 1");
+            }
+#endif
+        }
     }
 
     {
@@ -1770,6 +1871,12 @@ WarpX::ClearLevel (int lev)
     }
 #endif
 
+    m_excitation_flags[lev].clear();
+#ifdef WARPX_MAG_LLG
+    m_mag_box_index[lev].clear();
+    m_mag_boxes[lev].clear();
+#endif
+
     costs[lev].reset();
     load_balance_efficiency[lev] = -1;
 }
@@ -1811,6 +1918,14 @@ WarpX::AllocLevelData (int lev, const BoxArray& ba, const DistributionMapping& d
         WarpX::pml_ncell,
         this->refRatio());
 
+    // The deep halo is exchanged with the guard cells allocated for E and B
+#ifdef WARPX_MAG_LLG
+    m_deep_halo.Init(deep_halo_steps, magnetic_model == MagneticModel::LLG,
+                     mag_substeps, mag_LLG_exchange_coupling ? 2 : 0);
+#else
+    m_deep_halo.Init(deep_halo_steps, false, 1, 0);
+#endif
+    guard_cells.ng_alloc_EB.max(amrex::IntVect(m_deep_halo.halo()));
 
 #ifdef AMREX_USE_EB
         int max_guard = guard_cells.ng_FieldSolver.max();
@@ -1996,18 +2111,21 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
     Bfield_sc_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Bz_nodal_flag),dm,ncomps,ngEB,tag("Bfield_sc_fp[z]"));
 
 #ifdef WARPX_MAG_LLG
-    // each Mfield[] is three components
-    Mfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngEB);
-    Mfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngEB);
-    Mfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngEB);
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        // each Mfield[] is three components; it is allocated on all the boxes until the
+        // boxes that contain magnetic material are known, see CompactMfield
+        Mfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngEB);
+        Mfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngEB);
+        Mfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngEB);
 
-    Hfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngEB);
-    Hfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngEB);
-    Hfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngEB);
+        Hfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngEB);
+        Hfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngEB);
+        Hfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngEB);
 
-    H_biasfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-    H_biasfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-    H_biasfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+        H_biasfield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
+        H_biasfield_fp[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
+        H_biasfield_fp[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+    }
 #endif
 
     Efield_fp[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Ex_nodal_flag),dm,ncomps,ngEB,tag("Efield_fp[x]"));
@@ -2197,17 +2315,11 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         BoxArray const nba = amrex::convert(ba,IntVect::TheNodeVector());
 
 #ifdef WARPX_MAG_LLG
-        Mfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,3     ,ngEB);
-        Mfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,3     ,ngEB);
-        Mfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,3     ,ngEB);
-
-        Hfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        Hfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        Hfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-
-        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
-        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            Hfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
+            Hfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
+            Hfield_aux[lev][2] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB);
+        }
 #endif
         Bfield_aux[lev][0] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB,tag("Bfield_aux[x]"));
         Bfield_aux[lev][1] = std::make_unique<MultiFab>(nba,dm,ncomps,ngEB,tag("Bfield_aux[y]"));
@@ -2228,17 +2340,11 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
             Bfield_aux[lev][2] = std::make_unique<MultiFab>(*Bfield_fp[lev][2], amrex::make_alias, 0, ncomps);
 
 #ifdef WARPX_MAG_LLG
-            H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][0], amrex::make_alias, 0, ncomps);
-            H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][1], amrex::make_alias, 0, ncomps);
-            H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][2], amrex::make_alias, 0, ncomps);
-
-            Hfield_aux[lev][0] = std::make_unique<MultiFab>(*Hfield_fp[lev][0], amrex::make_alias, 0, ncomps);
-            Hfield_aux[lev][1] = std::make_unique<MultiFab>(*Hfield_fp[lev][1], amrex::make_alias, 0, ncomps);
-            Hfield_aux[lev][2] = std::make_unique<MultiFab>(*Hfield_fp[lev][2], amrex::make_alias, 0, ncomps);
-
-            Mfield_aux[lev][0] = std::make_unique<MultiFab>(*Mfield_fp[lev][0], amrex::make_alias, 0, 3);
-            Mfield_aux[lev][1] = std::make_unique<MultiFab>(*Mfield_fp[lev][1], amrex::make_alias, 0, 3);
-            Mfield_aux[lev][2] = std::make_unique<MultiFab>(*Mfield_fp[lev][2], amrex::make_alias, 0, 3);
+            if (WarpX::magnetic_model == MagneticModel::LLG) {
+                Hfield_aux[lev][0] = std::make_unique<MultiFab>(*Hfield_fp[lev][0], amrex::make_alias, 0, ncomps);
+                Hfield_aux[lev][1] = std::make_unique<MultiFab>(*Hfield_fp[lev][1], amrex::make_alias, 0, ncomps);
+                Hfield_aux[lev][2] = std::make_unique<MultiFab>(*Hfield_fp[lev][2], amrex::make_alias, 0, ncomps);
+            }
 #endif
         } else {
             Efield_aux[lev][0] = std::make_unique<MultiFab>(*Efield_avg_fp[lev][0], amrex::make_alias, 0, ncomps);
@@ -2259,19 +2365,27 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         Efield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Ez_nodal_flag),dm,ncomps,ngEB,tag("Efield_aux[z]"));
 
 #ifdef WARPX_MAG_LLG
-        Mfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Mx_nodal_flag),dm,3     ,ngEB);
-        Mfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,My_nodal_flag),dm,3     ,ngEB);
-        Mfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Mz_nodal_flag),dm,3     ,ngEB);
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            Hfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngEB);
+            Hfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngEB);
+            Hfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngEB);
+        }
+#endif
+    }
 
-        Hfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_nodal_flag),dm,ncomps,ngEB);
-        Hfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_nodal_flag),dm,ncomps,ngEB);
-        Hfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_nodal_flag),dm,ncomps,ngEB);
+#ifdef WARPX_MAG_LLG
+    if (WarpX::magnetic_model == MagneticModel::LLG) {
+        // M and H_bias are never gathered by the particles nor interpolated from the coarser level,
+        // so their aux MultiFabs are always aliases of the fp ones rather than duplicate copies
+        Mfield_aux[lev][0] = std::make_unique<MultiFab>(*Mfield_fp[lev][0], amrex::make_alias, 0, 3);
+        Mfield_aux[lev][1] = std::make_unique<MultiFab>(*Mfield_fp[lev][1], amrex::make_alias, 0, 3);
+        Mfield_aux[lev][2] = std::make_unique<MultiFab>(*Mfield_fp[lev][2], amrex::make_alias, 0, 3);
 
-        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(amrex::convert(ba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(amrex::convert(ba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(amrex::convert(ba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
-#endif
+        H_biasfield_aux[lev][0] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][0], amrex::make_alias, 0, ncomps);
+        H_biasfield_aux[lev][1] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][1], amrex::make_alias, 0, ncomps);
+        H_biasfield_aux[lev][2] = std::make_unique<MultiFab>(*H_biasfield_fp[lev][2], amrex::make_alias, 0, ncomps);
     }
+#endif
 
     //
     // The coarse patch
@@ -2283,21 +2397,22 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         std::array<Real,3> cdx = CellSize(lev-1);
 
 #ifdef WARPX_MAG_LLG
-    // Create the MultiFabs for M
-        Mfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Mx_nodal_flag),dm,3     ,ngEB);
-        Mfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,My_nodal_flag),dm,3     ,ngEB);
-        Mfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Mz_nodal_flag),dm,3     ,ngEB);
-
-        // Create the MultiFabs for H
-        Hfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_nodal_flag),dm,ncomps,ngEB);
-        Hfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_nodal_flag),dm,ncomps,ngEB);
-        Hfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_nodal_flag),dm,ncomps,ngEB);
+        if (WarpX::magnetic_model == MagneticModel::LLG) {
+            // Create the MultiFabs for M
+            Mfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Mx_nodal_flag),dm,3     ,ngEB);
+            Mfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,My_nodal_flag),dm,3     ,ngEB);
+            Mfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Mz_nodal_flag),dm,3     ,ngEB);
 
-        // Create the MultiFabs for H_bias
-        H_biasfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-        H_biasfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+            // Create the MultiFabs for H
+            Hfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_nodal_flag),dm,ncomps,ngEB);
+            Hfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_nodal_flag),dm,ncomps,ngEB);
+            Hfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_nodal_flag),dm,ncomps,ngEB);
 
+            // Create the MultiFabs for H_bias
+            H_biasfield_cp[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
+            H_biasfield_cp[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
+            H_biasfield_cp[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+        }
 #endif
 
         // Create the MultiFabs for B
@@ -2405,15 +2520,17 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
             if (aux_is_nodal) {
                 BoxArray const& cnba = amrex::convert(cba,IntVect::TheNodeVector());
 #ifdef WARPX_MAG_LLG
-                Mfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,3     ,ngEB);
-                Mfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,3     ,ngEB);
-                Mfield_cax[lev][2] = std::make_unique<MultiFab>(cnba,dm,3     ,ngEB);
-                Hfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
-                Hfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
-                Hfield_cax[lev][2] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
-                H_biasfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
-                H_biasfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
-                H_biasfield_cax[lev][2] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                if (WarpX::magnetic_model == MagneticModel::LLG) {
+                    Mfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,3     ,ngEB);
+                    Mfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,3     ,ngEB);
+                    Mfield_cax[lev][2] = std::make_unique<MultiFab>(cnba,dm,3     ,ngEB);
+                    Hfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                    Hfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                    Hfield_cax[lev][2] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                    H_biasfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                    H_biasfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                    H_biasfield_cax[lev][2] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB);
+                }
 #endif
                 Bfield_cax[lev][0] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB,tag("Bfield_cax[x]"));
                 Bfield_cax[lev][1] = std::make_unique<MultiFab>(cnba,dm,ncomps,ngEB,tag("Bfield_cax[y]"));
@@ -2428,20 +2545,22 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
                 Bfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Bz_nodal_flag),dm,ncomps,ngEB,tag("Bfield_cax[z]"));
 
 #ifdef WARPX_MAG_LLG
-                // Create the MultiFabs for M
-                Mfield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Mx_nodal_flag),dm,3     ,ngEB);
-                Mfield_cax[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,My_nodal_flag),dm,3     ,ngEB);
-                Mfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Mz_nodal_flag),dm,3     ,ngEB);
-
-                // Create the MultiFabs for H
-                Hfield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_nodal_flag),dm,ncomps,ngEB);
-                Hfield_cax[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_nodal_flag),dm,ncomps,ngEB);
-                Hfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_nodal_flag),dm,ncomps,ngEB);
-
-                // Create the MultiFabs for H_bias
-                H_biasfield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
-                H_biasfield_cax[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
-                H_biasfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+                if (WarpX::magnetic_model == MagneticModel::LLG) {
+                    // Create the MultiFabs for M
+                    Mfield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Mx_nodal_flag),dm,3     ,ngEB);
+                    Mfield_cax[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,My_nodal_flag),dm,3     ,ngEB);
+                    Mfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Mz_nodal_flag),dm,3     ,ngEB);
+
+                    // Create the MultiFabs for H
+                    Hfield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_nodal_flag),dm,ncomps,ngEB);
+                    Hfield_cax[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_nodal_flag),dm,ncomps,ngEB);
+                    Hfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_nodal_flag),dm,ncomps,ngEB);
+
+                    // Create the MultiFabs for H_bias
+                    H_biasfield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Hx_bias_nodal_flag),dm,ncomps,ngEB);
+                    H_biasfield_cax[lev][1] = std::make_unique<MultiFab>(amrex::convert(cba,Hy_bias_nodal_flag),dm,ncomps,ngEB);
+                    H_biasfield_cax[lev][2] = std::make_unique<MultiFab>(amrex::convert(cba,Hz_bias_nodal_flag),dm,ncomps,ngEB);
+                }
 #endif
                 // Create the MultiFabs for E
                 Efield_cax[lev][0] = std::make_unique<MultiFab>(amrex::convert(cba,Ex_nodal_flag),dm,ncomps,ngEB,tag("Efield_cax[x]"));
@@ -2474,6 +2593,81 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
     }
 }
 
+#ifdef WARPX_MAG_LLG
+void
+WarpX::CompactMfield (int lev)
+{
+    WARPX_PROFILE("WarpX::CompactMfield()");
+
+    MultiFab const& Mx_dense = *Mfield_fp[lev][0];
+    BoxArray const& ba = Hfield_fp[lev][0]->boxArray();
+    DistributionMapping const& dm = Hfield_fp[lev][0]->DistributionMap();
+    WARPX_ALWAYS_ASSERT_WITH_MESSAGE(Mx_dense.boxArray() == ba && Mx_dense.DistributionMap() == dm,
+        "CompactMfield: M is expected on all the boxes of the level");
+
+    // the magnetic boxes are only known by the ranks that own them
+    int const nboxes = static_cast<int>(ba.size());
+    Vector<int> is_magnetic(nboxes, 0);
+    for (MFIter mfi(*Hfield_fp[lev][0]); mfi.isValid(); ++mfi) {
+        is_magnetic[mfi.index()] = m_macroscopic_properties->is_magnetic_box(mfi) ? 1 : 0;
+    }
+    ParallelDescriptor::ReduceIntSum(is_magnetic.data(), nboxes);
+
+    m_mag_box_index[lev].assign(nboxes, -1);
+    m_mag_boxes[lev].clear();
+    for (int K = 0; K < nboxes; ++K) {
+        if (!is_magnetic[K]) continue;
+        m_mag_box_index[lev][K] = static_cast<int>(m_mag_boxes[lev].size());
+        m_mag_boxes[lev].push_back(K);
+    }
+    DistributionMapping const mag_dm = MagneticDistributionMap(lev, dm);
+
+    for (int i = 0; i < 3; ++i) {
+        MultiFab const& M_dense = *Mfield_fp[lev][i];
+        BoxList bl(M_dense.ixType());
+        for (int const K : m_mag_boxes[lev]) bl.push_back(M_dense.boxArray()[K]);
+        auto M = std::make_unique<MultiFab>(BoxArray(std::move(bl)), mag_dm, M_dense.nComp(),
+                                            M_dense.nGrowVect());
+        // each fab has the same box and owner as the box of the level it comes from
+        for (MFIter mfi(*M); mfi.isValid(); ++mfi) {
+            auto const& d = M->array(mfi);
+            auto const& s = M_dense.const_array(m_mag_boxes[lev][mfi.index()]);
+            ParallelFor(mfi.fabbox(), M->nComp(),
+                [=] AMREX_GPU_DEVICE (int ii, int jj, int kk, int n) { d(ii, jj, kk, n) = s(ii, jj, kk, n); });
+        }
+        Mfield_fp[lev][i] = std::move(M);
+        Mfield_aux[lev][i] = std::make_unique<MultiFab>(*Mfield_fp[lev][i], amrex::make_alias, 0,
+                                                        Mfield_fp[lev][i]->nComp());
+    }
+}
+
+amrex::DistributionMapping
+WarpX::MagneticDistributionMap (int lev, amrex::DistributionMapping const& dm) const
+{
+    Vector<int> pmap;
+    pmap.reserve(m_mag_boxes[lev].size());
+    for (int const K : m_mag_boxes[lev]) pmap.push_back(dm[K]);
+    return DistributionMapping(std::move(pmap));
+}
+
+std::unique_ptr<amrex::MultiFab>
+WarpX::MakeDenseMfield (int lev, int direction, amrex::IntVect const& ng) const
+{
+    MultiFab const& M = *Mfield_fp[lev][direction];
+    auto M_dense = std::make_unique<MultiFab>(Hfield_fp[lev][direction]->boxArray(),
+                                              Hfield_fp[lev][direction]->DistributionMap(),
+                                              M.nComp(), ng);
+    M_dense->setVal(0._rt);
+    for (MFIter mfi(M); mfi.isValid(); ++mfi) {
+        auto const& d = M_dense->array(m_mag_boxes[lev][mfi.index()]);
+        auto const& s = M.const_array(mfi);
+        ParallelFor(amrex::grow(mfi.validbox(), amrex::min(ng, M.nGrowVect())), M.nComp(),
+            [=] AMREX_GPU_DEVICE (int ii, int jj, int kk, int n) { d(ii, jj, kk, n) = s(ii, jj, kk, n); });
+    }
+    return M_dense;
+}
+#endif
+
 #ifdef WARPX_USE_PSATD
 #   ifdef WARPX_DIM_RZ
 /* \brief Allocate spectral Maxwell solver (RZ dimensions) at a level
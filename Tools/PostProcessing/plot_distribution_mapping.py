@@ -70,21 +70,27 @@ class SimData:
             unique_headers=[''.join([l for l in w if not l.isdigit()])
                             for w in h.split()][2::]
 
-        # Either 9 or 10 depending if GPU
-        n_data_fields = 9 if len(set(unique_headers))%9 == 0 else 10
+        # One header per data field of a box (12, or 13 with GPU)
+        n_data_fields = len(set(unique_headers))
         f.close()
 
         # From data header, data layout is:
         #     [step, time,
         #      cost_box_0, proc_box_0, lev_box_0, i_low_box_0, j_low_box_0,
         #           k_low_box_0, num_cells_0, num_macro_particles_0,
+        #           num_magnetic_faces_0, llg_updates_per_solve_0,
+        #           num_superconducting_edges_0,
         #           (, gpu_ID_box_0 if GPU run), hostname_box_0,
         #      cost_box_1, proc_box_1, lev_box_1, i_low_box_1, j_low_box_1,
         #           k_low_box_1, num_cells_1, num_macro_particles_1,
+        #           num_magnetic_faces_1, llg_updates_per_solve_1,
+        #           num_superconducting_edges_1,
         #           (, gpu_ID_box_1 if GPU run), hostname_box_1
         #      ...
         #      cost_box_n, proc_box_n, lev_box_n, i_low_box_n, j_low_box_n,
         #           k_low_box_n, num_cells_n, num_macro_particles_n,
+        #           num_magnetic_faces_n, llg_updates_per_solve_n,
+        #           num_superconducting_edges_n,
         #           (, gpu_ID_box_n if GPU run), hostname_box_n
         i, j, k = (data[0,3::n_data_fields],
                    data[0,4::n_data_fields],
@@ -381,6 +381,7 @@ function(warpx_print_summary)
     message("    OPENPMD: ${WarpX_OPENPMD}")
     message("    QED: ${WarpX_QED}")
     message("    LLG: ${WarpX_MAG_LLG}")
+    message("    LLG mixed precision: ${WarpX_MAG_LLG_MIXED_PRECISION}")
     message("    QED table generation: ${WarpX_QED_TABLE_GEN}")
     message("    SENSEI: ${WarpX_SENSEI}")
     message("")